@@ -0,0 +1,13 @@
+# Adds the shared colour conversion kernels (indipixelkernels target) to a driver build.
+# The sources live in the top level pixelkernels directory, or next to the driver
+# when it is packaged on its own by make_deb_pkgs.
+
+if (NOT TARGET indipixelkernels)
+    if (EXISTS ${CMAKE_CURRENT_SOURCE_DIR}/pixelkernels/pixelkernels.cpp)
+        set(PIXELKERNELS_SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/pixelkernels)
+    else ()
+        set(PIXELKERNELS_SOURCE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/../pixelkernels)
+    endif ()
+
+    add_subdirectory(${PIXELKERNELS_SOURCE_DIR} ${CMAKE_BINARY_DIR}/pixelkernels)
+endif ()
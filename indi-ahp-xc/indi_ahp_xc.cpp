@@ -23,6 +23,8 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <sys/file.h>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <regex>
 #include <indicom.h>
@@ -358,6 +360,111 @@ uint8_t* AHP_XC::getBuffer(dsp_stream_p in, uint32_t *dims, int **sizes)
 }
 
 
+// Magnitudes of one packet sample as the next row of a spectrogram
+static void appendRow(XCSpectrogram &spectrogram, const ahp_xc_sample &sample)
+{
+    double *row = spectrogram.appendRow();
+    if(row == nullptr)
+        return;
+    size_t len = std::min(static_cast<size_t>(sample.lag_size), spectrogram.width());
+    for(size_t i = 0; i < len; i++)
+        row[i] = sample.correlations[i].magnitude;
+    for(size_t i = len; i < spectrogram.width(); i++)
+        row[i] = 0;
+}
+
+void* AHP_XC::createFITS(size_t *memsize, const XCSpectrogram &spectrogram)
+{
+    fitsfile *fptr = nullptr;
+    void *memptr;
+    int status    = 0;
+    long naxes[2] = { static_cast<long>(spectrogram.width()), static_cast<long>(spectrogram.rows()) };
+    char error_status[MAXINDINAME];
+
+    // Header and data in one allocation, the memfile does not have to grow
+    size_t datasize = spectrogram.width() * spectrogram.rows() * sizeof(double);
+    *memsize = (datasize + 2880 - 1) / 2880 * 2880 + 5760;
+    memptr  = malloc(*memsize);
+    if (!memptr)
+    {
+        LOGF_ERROR("Error: failed to allocate memory: %lu", *memsize);
+        return nullptr;
+    }
+
+    fits_create_memfile(&fptr, &memptr, memsize, 2880, realloc, &status);
+    fits_create_img(fptr, DOUBLE_IMG, 2, naxes, &status);
+
+    size_t rows = 0;
+    const double *chunk = spectrogram.chunk(0, &rows);
+    if (!status)
+    {
+        addFITSKeywords(fptr, reinterpret_cast<uint8_t*>(const_cast<double*>(chunk)), static_cast<int>(rows * naxes[0] * sizeof(double)));
+
+        // The keywords above only saw the first chunk, the data range has to cover all of them
+        double min_val = 0, max_val = 0;
+        spectrogram.minMax(&min_val, &max_val);
+        fits_update_key(fptr, TDOUBLE, "DATAMIN", &min_val, "Minimum value", &status);
+        fits_update_key(fptr, TDOUBLE, "DATAMAX", &max_val, "Maximum value", &status);
+    }
+
+    // Write the rows chunk by chunk, straight from the spectrogram
+    LONGLONG first = 1;
+    for (size_t c = 0; !status && c < spectrogram.chunks(); c++)
+    {
+        chunk = spectrogram.chunk(c, &rows);
+        LONGLONG nelements = static_cast<LONGLONG>(rows * spectrogram.width());
+        fits_write_img(fptr, TDOUBLE, first, nelements, const_cast<double*>(chunk), &status);
+        first += nelements;
+    }
+
+    // The buffer was allocated for the worst case header size, only send the file itself
+    LONGLONG headstart = 0, datastart = 0, dataend = 0;
+    if (!status)
+        fits_get_hduaddrll(fptr, &headstart, &datastart, &dataend, &status);
+
+    if (status)
+    {
+        fits_report_error(stderr, status); /* print out any error messages */
+        fits_get_errstatus(status, error_status);
+        fits_close_file(fptr, &status);
+        free(memptr);
+        LOGF_ERROR("FITS Error: %s", error_status);
+        return nullptr;
+    }
+    fits_close_file(fptr, &status);
+    *memsize = static_cast<size_t>(dataend);
+
+    return memptr;
+}
+
+void AHP_XC::sendSpectrograms(XCSpectrogram *spectrograms, IBLOB *Blobs, IBLOBVectorProperty BlobP, unsigned int len)
+{
+    // One FITS file at a time, so only a single spectrogram is ever copied into memory
+    for(unsigned int x = 0; x < len; x++)
+    {
+        Blobs[x].blob = nullptr;
+        Blobs[x].bloblen = 0;
+        if(spectrograms[x].rows() == 0)
+            continue;
+        size_t memsize = 0;
+        void* fits = createFITS(&memsize, spectrograms[x]);
+        if(fits == nullptr)
+            continue;
+        Blobs[x].blob = fits;
+        Blobs[x].bloblen = static_cast<int>(memsize);
+        Blobs[x].size = static_cast<int>(memsize);
+
+        IBLOBVectorProperty single = BlobP;
+        single.bp  = &Blobs[x];
+        single.nbp = 1;
+        sendFile(&Blobs[x], single, 1);
+
+        free(Blobs[x].blob);
+        Blobs[x].blob = nullptr;
+        Blobs[x].bloblen = 0;
+    }
+}
+
 void AHP_XC::Callback()
 {
     ahp_xc_packet* packet = ahp_xc_alloc_packet();
@@ -457,7 +564,12 @@ void AHP_XC::Callback()
                 // We're done exposing
                 LOG_INFO("Integration complete, downloading plots...");
                 // Additional BLOBs
-                char **blobs = static_cast<char**>(malloc(sizeof(char*)*static_cast<unsigned int>(plotBP.nbp) + 1));
+                if(nplots > 0)
+                {
+                    gridder.readout(plot_str[0]->buf);
+                    if(gridder.dropped() > 0)
+                        LOGF_WARN("%llu packets were not plotted on the UV plane", static_cast<unsigned long long>(gridder.dropped()));
+                }
                 for(unsigned int x = 0; x < nplots; x++)
                 {
                     if(HasDSP())
@@ -466,140 +578,61 @@ void AHP_XC::Callback()
                     }
                     size_t memsize = static_cast<unsigned int>(plot_str[x]->len) * sizeof(double);
                     void* fits = createFITS(-64, &memsize, plot_str[x]);
-                    if(fits != nullptr)
-                    {
-                        blobs[x] = static_cast<char*>(malloc(memsize));
-                        memcpy(blobs[x], fits, memsize);
-                        plotB[x].blob = blobs[x];
-                        plotB[x].bloblen = static_cast<int>(memsize);
-                        free(fits);
-                    }
+                    plotB[x].blob = fits;
+                    plotB[x].bloblen = (fits != nullptr) ? static_cast<int>(memsize) : 0;
                 }
                 LOG_INFO("Plots BLOBs generated, downloading...");
                 sendFile(plotB, plotBP, nplots);
                 for(unsigned int x = 0; x < nplots; x++)
                 {
-                    free(blobs[x]);
-                    memset(plot_str[x]->buf, 0, sizeof(dsp_t)*static_cast<size_t>(plot_str[x]->len));
+                    free(plotB[x].blob);
+                    plotB[x].blob = nullptr;
                 }
                 LOG_INFO("Generating additional BLOBs...");
+                std::lock_guard<std::mutex> lock(spectrogramsMutex);
                 if(ahp_xc_get_nlines() > 0 && ahp_xc_get_autocorrelator_lagsize() > 1)
                 {
-                    blobs = static_cast<char**>(realloc(blobs, sizeof(char*)*static_cast<unsigned int>(autocorrelationsBP.nbp) + 1));
-                    for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
-                    {
-                        size_t memsize = static_cast<unsigned int>(autocorrelations_str[x]->len) * sizeof(double);
-                        void* fits = createFITS(-64, &memsize, autocorrelations_str[x]);
-                        if(fits != nullptr)
-                        {
-                            blobs[x] = static_cast<char*>(malloc(memsize));
-                            memcpy(blobs[x], fits, memsize);
-                            autocorrelationsB[x].blob = blobs[x];
-                            autocorrelationsB[x].bloblen = static_cast<int>(memsize);
-                            free(fits);
-                        }
-                        autocorrelations_str[x]->sizes[1] = 1;
-                        autocorrelations_str[x]->len = autocorrelations_str[x]->sizes[0];
-                        dsp_stream_alloc_buffer(autocorrelations_str[x], autocorrelations_str[x]->len);
-                    }
-                    LOG_INFO("Autocorrelations BLOBs generated, downloading...");
-                    sendFile(autocorrelationsB, autocorrelationsBP, ahp_xc_get_nlines());
-                    for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
-                    {
-                        free(blobs[x]);
-                    }
+                    sendSpectrograms(autocorrelations_spectrogram.get(), autocorrelationsB, autocorrelationsBP, ahp_xc_get_nlines());
+                    LOG_INFO("Autocorrelations BLOBs downloaded.");
                 }
                 if(ahp_xc_get_nbaselines() > 0 && ahp_xc_get_crosscorrelator_lagsize() > 1)
                 {
-                    blobs = static_cast<char**>(realloc(blobs, sizeof(char*)*static_cast<unsigned int>(crosscorrelationsBP.nbp) + 1));
-                    idx = 0;
-                    for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
-                    {
-                        for(unsigned int y = x + 1; y < ahp_xc_get_nlines(); y++)
-                        {
-                            size_t memsize = static_cast<unsigned int>(crosscorrelations_str[x]->len) * sizeof(double);
-                            void* fits = createFITS(-64, &memsize, crosscorrelations_str[x]);
-                            if(fits != nullptr)
-                            {
-                                blobs[x] = static_cast<char*>(malloc(memsize));
-                                memcpy(blobs[x], fits, memsize);
-                                crosscorrelationsB[x].blob = blobs[x];
-                                crosscorrelationsB[x].bloblen = static_cast<int>(memsize);
-                                free(fits);
-                            }
-                            crosscorrelations_str[idx]->sizes[1] = 1;
-                            crosscorrelations_str[idx]->len = crosscorrelations_str[idx]->sizes[0];
-                            dsp_stream_alloc_buffer(crosscorrelations_str[idx], crosscorrelations_str[idx]->len);
-                            idx++;
-                        }
-                    }
-                    LOG_INFO("Crosscorrelations BLOBs generated, downloading...");
-                    sendFile(crosscorrelationsB, crosscorrelationsBP, ahp_xc_get_nbaselines());
-                    for(unsigned int x = 0; x < ahp_xc_get_nbaselines(); x++)
-                    {
-                        free(blobs[x]);
-                    }
+                    sendSpectrograms(crosscorrelations_spectrogram.get(), crosscorrelationsB, crosscorrelationsBP, ahp_xc_get_nbaselines());
+                    LOG_INFO("Crosscorrelations BLOBs downloaded.");
                 }
-                free(blobs);
                 LOG_INFO("Download complete.");
             }
             else
             {
-                // Filling BLOBs
-                if(nplots > 0)
+                // Filling BLOBs, the UV plane is gridded by the gridder threads
+                if(nplots > 0 && gridder.isRunning())
                 {
                     idx = 0;
                     for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
                     {
                         for(unsigned int y = x + 1; y < ahp_xc_get_nlines(); y++)
                         {
-                            if((lineEnableSP[x].sp[0].s == ISS_ON) && lineEnableSP[y].sp[0].s == ISS_ON)
-                            {
-                                int w = plot_str[0]->sizes[0];
-                                int h = plot_str[0]->sizes[1];
-                                INDI::Correlator::UVCoordinate uv = baselines[idx]->getUVCoordinates(Altitude, Azimuth);
-                                int xx = static_cast<int>(w * uv.u / 2.0);
-                                int yy = static_cast<int>(h * uv.v / 2.0);
-                                int z = w * h / 2 + w / 2 + xx + yy * w;
-                                if(xx >= -w / 2 && xx < w / 2 && yy >= -w / 2 && yy < h / 2)
-                                {
-                                    plot_str[0]->buf[z] += (double)packet->crosscorrelations[idx].correlations[packet->crosscorrelations[idx].lag_size /
-                                                           2].magnitude / (double)packet->crosscorrelations[idx].correlations[packet->crosscorrelations[idx].lag_size /
-                                                                   2].counts;
-                                    plot_str[0]->buf[w * h - 1 - z] += (double)
-                                                                       packet->crosscorrelations[idx].correlations[packet->crosscorrelations[idx].lag_size / 2].magnitude /
-                                                                       packet->crosscorrelations[idx].correlations[packet->crosscorrelations[idx].lag_size / 2].counts;
-                                }
-                            }
+                            const ahp_xc_correlation &center =
+                                packet->crosscorrelations[idx].correlations[packet->crosscorrelations[idx].lag_size / 2];
+                            if((lineEnableSP[x].sp[0].s == ISS_ON) && lineEnableSP[y].sp[0].s == ISS_ON && center.counts > 0)
+                                gridderValues[idx] = static_cast<double>(center.magnitude) / center.counts;
+                            else
+                                gridderValues[idx] = NAN;
                             idx++;
                         }
                     }
+                    gridder.push(Altitude, Azimuth, gridderValues.data());
                 }
+                std::lock_guard<std::mutex> lock(spectrogramsMutex);
                 if(ahp_xc_get_nlines() > 0 && ahp_xc_get_autocorrelator_lagsize() > 1)
                 {
                     for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
-                    {
-                        int pos = autocorrelations_str[x]->len - autocorrelations_str[x]->sizes[0];
-                        autocorrelations_str[x]->sizes[1]++;
-                        autocorrelations_str[x]->len += autocorrelations_str[x]->sizes[0];
-                        autocorrelations_str[x]->buf = (dsp_t*)realloc(autocorrelations_str[x]->buf,
-                                                       sizeof(dsp_t) * static_cast<unsigned int>(autocorrelations_str[x]->len));
-                        for(unsigned int i = 0; i < packet->autocorrelations[x].lag_size; i++)
-                            autocorrelations_str[x]->buf[pos++] = packet->autocorrelations[x].correlations[i].magnitude;
-                    }
+                        appendRow(autocorrelations_spectrogram[x], packet->autocorrelations[x]);
                 }
                 if(ahp_xc_get_nbaselines() > 0 && ahp_xc_get_crosscorrelator_lagsize() > 1)
                 {
                     for(unsigned int x = 0; x < ahp_xc_get_nbaselines(); x++)
-                    {
-                        int pos = crosscorrelations_str[x]->len - crosscorrelations_str[x]->sizes[0];
-                        crosscorrelations_str[x]->sizes[1]++;
-                        crosscorrelations_str[x]->len += crosscorrelations_str[x]->sizes[0];
-                        crosscorrelations_str[x]->buf = (dsp_t*)realloc(crosscorrelations_str[x]->buf,
-                                                        sizeof(dsp_t) * static_cast<unsigned int>(crosscorrelations_str[x]->len));
-                        for(unsigned int i = 0; i < packet->crosscorrelations[x].lag_size; i++)
-                            crosscorrelations_str[x]->buf[pos++] = packet->crosscorrelations[x].correlations[i].magnitude;
-                    }
+                        appendRow(crosscorrelations_spectrogram[x], packet->crosscorrelations[x]);
                 }
             }
         }
@@ -660,8 +693,6 @@ AHP_XC::AHP_XC()
 
     correlationsN = static_cast<INumber*>(malloc(1));
 
-    autocorrelations_str = static_cast<dsp_stream_p*>(malloc(1));
-    crosscorrelations_str = static_cast<dsp_stream_p*>(malloc(1));
     plot_str = static_cast<dsp_stream_p*>(malloc(1));
 
     framebuffer = static_cast<double*>(malloc(1));
@@ -681,28 +712,20 @@ bool AHP_XC::Disconnect()
     }
     for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
     {
-        if(ahp_xc_get_autocorrelator_lagsize() > 1)
-        {
-            dsp_stream_free_buffer(autocorrelations_str[x]);
-            dsp_stream_free(autocorrelations_str[x]);
-        }
         ActiveLine(x, false, false, false, false);
         usleep(10000);
     }
-    for(unsigned int x = 0; x < ahp_xc_get_nbaselines(); x++)
-    {
-        if(ahp_xc_get_crosscorrelator_lagsize() > 1)
-        {
-            dsp_stream_free_buffer(crosscorrelations_str[x]);
-            dsp_stream_free(crosscorrelations_str[x]);
-        }
-    }
-
     threadsRunning = false;
 
     readThread->join();
     readThread->~thread();
 
+    // The workers project through the baselines, stop them first
+    gridder.stop();
+
+    autocorrelations_spectrogram.reset();
+    crosscorrelations_spectrogram.reset();
+
     ahp_xc_disconnect();
 
     return true;
@@ -732,6 +755,9 @@ bool AHP_XC::saveConfigItems(FILE *fp)
         }
     }
     IUSaveConfigNumber(fp, &settingsNP);
+    IUSaveConfigNumber(fp, &spillNP);
+    IUSaveConfigSwitch(fp, &gridderKernelSP);
+    IUSaveConfigSwitch(fp, &gridderWeightingSP);
 
     INDI::Spectrograph::saveConfigItems(fp);
     return true;
@@ -755,6 +781,20 @@ bool AHP_XC::initProperties()
     IUFillNumberVector(&settingsNP, settingsN, 2, getDeviceName(), "INTERFEROMETER_SETTINGS", "AHP_XC Settings",
                        MAIN_CONTROL_TAB, IP_RW, 60, IPS_IDLE);
 
+    IUFillNumber(&spillN[0], "SPILL_THRESHOLD", "Memory limit (MiB)", "%.0f", 0, 65536, 16, 256);
+    IUFillNumberVector(&spillNP, spillN, 1, getDeviceName(), "SPECTROGRAM_SPILL", "Spectrograms",
+                       OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
+    IUFillSwitch(&gridderKernelS[0], "KERNEL_PILLBOX", "Pillbox", ISS_ON);
+    IUFillSwitch(&gridderKernelS[1], "KERNEL_GAUSSIAN", "Gaussian", ISS_OFF);
+    IUFillSwitchVector(&gridderKernelSP, gridderKernelS, 2, getDeviceName(), "UV_GRIDDING_KERNEL", "UV kernel",
+                       OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    IUFillSwitch(&gridderWeightingS[0], "WEIGHTING_NATURAL", "Natural", ISS_ON);
+    IUFillSwitch(&gridderWeightingS[1], "WEIGHTING_UNIFORM", "Uniform", ISS_OFF);
+    IUFillSwitchVector(&gridderWeightingSP, gridderWeightingS, 2, getDeviceName(), "UV_GRIDDING_WEIGHTING", "UV weighting",
+                       OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
     // Set minimum exposure speed to 0.001 seconds
     setMinMaxStep("SENSOR_INTEGRATION", "SENSOR_INTEGRATION_VALUE", 1.0, STELLAR_DAY, 1, false);
     setDefaultPollingPeriod(500);
@@ -786,6 +826,9 @@ void AHP_XC::ISGetProperties(const char *dev)
             defineProperty(&crosscorrelationsBP);
         defineProperty(&correlationsNP);
         defineProperty(&settingsNP);
+        defineProperty(&spillNP);
+        defineProperty(&gridderKernelSP);
+        defineProperty(&gridderWeightingSP);
 
         // Define our properties
     }
@@ -822,6 +865,9 @@ bool AHP_XC::updateProperties()
             defineProperty(&crosscorrelationsBP);
         defineProperty(&correlationsNP);
         defineProperty(&settingsNP);
+        defineProperty(&spillNP);
+        defineProperty(&gridderKernelSP);
+        defineProperty(&gridderWeightingSP);
     }
     else
         // We're disconnected
@@ -832,6 +878,9 @@ bool AHP_XC::updateProperties()
             deleteProperty(crosscorrelationsBP.name);
         deleteProperty(correlationsNP.name);
         deleteProperty(settingsNP.name);
+        deleteProperty(spillNP.name);
+        deleteProperty(gridderKernelSP.name);
+        deleteProperty(gridderWeightingSP.name);
         for (unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
         {
             deleteProperty(lineEnableSP[x].name);
@@ -863,6 +912,18 @@ void AHP_XC::setupParams()
         plot_str[0]->sizes[1] = size;
         plot_str[0]->len = size * size;
         dsp_stream_alloc_buffer(plot_str[0], plot_str[0]->len);
+
+        gridderValues.assign(ahp_xc_get_nbaselines(), NAN);
+        bool started = gridder.start(size, size, ahp_xc_get_nbaselines(),
+                                     [this](unsigned int idx, double alt, double az, double * u, double * v)
+        {
+            INDI::Correlator::UVCoordinate uv = baselines[idx]->getUVCoordinates(alt, az);
+            *u = uv.u;
+            *v = uv.v;
+            return true;
+        });
+        if(!started)
+            LOG_ERROR("Could not start the UV plane gridder, no plots will be generated");
     }
 }
 
@@ -875,6 +936,34 @@ bool AHP_XC::StartIntegration(double duration)
         return false;
 
     IntegrationRequest = static_cast<double>(duration);
+
+    // One row per packet, allocated now rather than while the packets come in
+    size_t rows = static_cast<size_t>(duration / std::max(ahp_xc_get_packettime(), 1.0E-6)) + 1;
+    size_t spill = static_cast<size_t>(spillN[0].value * 1024.0 * 1024.0);
+    {
+        std::lock_guard<std::mutex> lock(spectrogramsMutex);
+        if(ahp_xc_get_autocorrelator_lagsize() > 1)
+        {
+            for(unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
+            {
+                autocorrelations_spectrogram[x].setSpillLimit(spill / (ahp_xc_get_nlines() + ahp_xc_get_nbaselines()));
+                autocorrelations_spectrogram[x].begin(ahp_xc_get_autocorrelator_lagsize(), rows);
+            }
+        }
+        if(ahp_xc_get_crosscorrelator_lagsize() > 1)
+        {
+            for(unsigned int x = 0; x < ahp_xc_get_nbaselines(); x++)
+            {
+                crosscorrelations_spectrogram[x].setSpillLimit(spill / (ahp_xc_get_nlines() + ahp_xc_get_nbaselines()));
+                crosscorrelations_spectrogram[x].begin(ahp_xc_get_crosscorrelator_lagsize() * 2 - 1, rows);
+            }
+        }
+    }
+
+    gridder.setKernel(gridderKernelS[1].s == ISS_ON ? XCGridder::KERNEL_GAUSSIAN : XCGridder::KERNEL_PILLBOX);
+    gridder.setWeighting(gridderWeightingS[1].s == ISS_ON ? XCGridder::WEIGHTING_UNIFORM : XCGridder::WEIGHTING_NATURAL);
+    gridder.clear();
+
     gettimeofday(&ExpStart, nullptr);
     InIntegration = true;
     // We're done
@@ -928,6 +1017,15 @@ bool AHP_XC::ISNewNumber(const char *dev, const char *name, double values[], cha
         }
     }
 
+    if(!strcmp(spillNP.name, name))
+    {
+        // Applies from the next integration
+        IUUpdateNumber(&spillNP, values, names, n);
+        spillNP.s = IPS_OK;
+        IDSetNumber(&spillNP, nullptr);
+        return true;
+    }
+
     if(!strcmp(settingsNP.name, name))
     {
         IUUpdateNumber(&settingsNP, values, names, n);
@@ -976,6 +1074,23 @@ bool AHP_XC::ISNewSwitch(const char *dev, const char *name, ISState *states, cha
         }
     }
 
+    if(!strcmp(name, gridderKernelSP.name))
+    {
+        // Applies from the next integration
+        IUUpdateSwitch(&gridderKernelSP, states, names, n);
+        gridderKernelSP.s = IPS_OK;
+        IDSetSwitch(&gridderKernelSP, nullptr);
+        return true;
+    }
+
+    if(!strcmp(name, gridderWeightingSP.name))
+    {
+        IUUpdateSwitch(&gridderWeightingSP, states, names, n);
+        gridderWeightingSP.s = IPS_OK;
+        IDSetSwitch(&gridderWeightingSP, nullptr);
+        return true;
+    }
+
     for(unsigned int x = 0; x < ahp_xc_get_nbaselines(); x++)
         baselines[x]->ISNewSwitch(dev, name, states, names, n);
 
@@ -1221,12 +1336,8 @@ bool AHP_XC::Connect()
     if(nplots > 0)
         plotB = static_cast<IBLOB*>(realloc(plotB, static_cast<unsigned long>(nplots) * sizeof(IBLOB) + 1));
 
-    if(ahp_xc_get_autocorrelator_lagsize() > 1)
-        autocorrelations_str = static_cast<dsp_stream_p*>(realloc(autocorrelations_str,
-                               static_cast<unsigned long>(ahp_xc_get_nlines()) * sizeof(dsp_stream_p) + 1));
-    if(ahp_xc_get_crosscorrelator_lagsize() > 1)
-        crosscorrelations_str = static_cast<dsp_stream_p*>(realloc(crosscorrelations_str,
-                                static_cast<unsigned long>(ahp_xc_get_nbaselines()) * sizeof(dsp_stream_p) + 1));
+    autocorrelations_spectrogram.reset(new XCSpectrogram[ahp_xc_get_nlines()]);
+    crosscorrelations_spectrogram.reset(new XCSpectrogram[ahp_xc_get_nbaselines()]);
     if(nplots > 0)
         plot_str = static_cast<dsp_stream_p*>(realloc(plot_str, static_cast<unsigned long>(nplots) * sizeof(dsp_stream_p) + 1));
 
@@ -1244,13 +1355,6 @@ bool AHP_XC::Connect()
     memset (totalcorrelations, 0, static_cast<unsigned long>(ahp_xc_get_nbaselines())*sizeof(ahp_xc_correlation) + 1);
     for(unsigned int x = 0; x < ahp_xc_get_nbaselines(); x++)
     {
-        if(ahp_xc_get_crosscorrelator_lagsize() > 1)
-        {
-            crosscorrelations_str[x] = dsp_stream_new();
-            dsp_stream_add_dim(crosscorrelations_str[x], static_cast<int>(ahp_xc_get_crosscorrelator_lagsize() * 2 - 1));
-            dsp_stream_add_dim(crosscorrelations_str[x], 1);
-            dsp_stream_alloc_buffer(crosscorrelations_str[x], crosscorrelations_str[x]->len);
-        }
         baselines[x] = new baseline();
         baselines[x]->initProperties();
     }
@@ -1277,14 +1381,6 @@ bool AHP_XC::Connect()
 
     for (unsigned int x = 0; x < ahp_xc_get_nlines(); x++)
     {
-        if(ahp_xc_get_autocorrelator_lagsize() > 1)
-        {
-            autocorrelations_str[x] = dsp_stream_new();
-            dsp_stream_add_dim(autocorrelations_str[x], static_cast<int>(ahp_xc_get_autocorrelator_lagsize()));
-            dsp_stream_add_dim(autocorrelations_str[x], 1);
-            dsp_stream_alloc_buffer(autocorrelations_str[x], autocorrelations_str[x]->len);
-        }
-
         IUFillNumber(&lineLocationN[x * 3 + 0], "LOCATION_X", "X Location (m)", "%g", -EARTHRADIUSMEAN, EARTHRADIUSMEAN, 1.0E-9, 0);
         IUFillNumber(&lineLocationN[x * 3 + 1], "LOCATION_Y", "Y Location (m)", "%g", -EARTHRADIUSMEAN, EARTHRADIUSMEAN, 1.0E-9, 0);
         IUFillNumber(&lineLocationN[x * 3 + 2], "LOCATION_Z", "Z Location (m)", "%g", -EARTHRADIUSMEAN, EARTHRADIUSMEAN, 1.0E-9, 0);
@@ -22,8 +22,14 @@
 
 #include "indispectrograph.h"
 #include "indicorrelator.h"
+#include "xc_spectrogram.h"
+#include "xc_gridder.h"
 #include <ahp/ahp_xc.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 class baseline : public INDI::Correlator
 {
 public:
@@ -76,8 +82,6 @@ public:
         free(crosscorrelationsB);
         free(plotB);
 
-        free(autocorrelations_str);
-        free(crosscorrelations_str);
         free(plot_str);
 
         free(totalcounts);
@@ -167,13 +171,28 @@ private:
     IBLOB *crosscorrelationsB;
     IBLOBVectorProperty crosscorrelationsBP;
 
-    dsp_stream_p *autocorrelations_str;
-    dsp_stream_p *crosscorrelations_str;
+    // Lag rows of the current integration, one spectrogram per line and per baseline
+    std::unique_ptr<XCSpectrogram[]> autocorrelations_spectrogram;
+    std::unique_ptr<XCSpectrogram[]> crosscorrelations_spectrogram;
+    std::mutex spectrogramsMutex;
     dsp_stream_p *plot_str;
 
+    // UV plane of the current integration, filled by the gridder threads
+    XCGridder gridder;
+    std::vector<double> gridderValues;
+
     INumber settingsN[2];
     INumberVectorProperty settingsNP;
 
+    INumber spillN[1];
+    INumberVectorProperty spillNP;
+
+    ISwitch gridderKernelS[2];
+    ISwitchVectorProperty gridderKernelSP;
+
+    ISwitch gridderWeightingS[2];
+    ISwitchVectorProperty gridderWeightingSP;
+
     unsigned int clock_frequency;
     unsigned int clock_divider;
 
@@ -190,6 +209,8 @@ private:
     void EnableCapture(bool start);
     void sendFile(IBLOB* Blobs, IBLOBVectorProperty BlobP, unsigned int len);
     void* createFITS(int bpp, size_t *size, dsp_stream *buf);
+    void* createFITS(size_t *size, const XCSpectrogram &spectrogram);
+    void sendSpectrograms(XCSpectrogram *spectrograms, IBLOB* Blobs, IBLOBVectorProperty BlobP, unsigned int len);
     uint8_t* getBuffer(dsp_stream_p in, uint32_t *dims, int **sizes);
     int getFileIndex(const char * dir, const char * prefix, const char * ext);
     // Struct to keep timing
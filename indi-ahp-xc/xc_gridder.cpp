@@ -0,0 +1,253 @@
+/*
+    indi_interferometer - a telescope array driver for INDI
+    Support for AHP cross-correlators
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "xc_gridder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Per worker grids are not worth more memory than this
+static const size_t MAX_GRIDS_BYTES = 256 * 1024 * 1024;
+// Gaussian kernel sigma in cells
+static const double GAUSSIAN_SIGMA = 0.5;
+
+XCGridder::~XCGridder()
+{
+    stop();
+}
+
+bool XCGridder::start(int width, int height, unsigned int baselines, Projection projection, size_t depth)
+{
+    stop();
+
+    if (width <= 0 || height <= 0 || baselines == 0 || !projection)
+        return false;
+
+    mWidth      = width;
+    mHeight     = height;
+    mTilesX     = (width + TILE - 1) / TILE;
+    mBaselines  = baselines;
+    mProjection = projection;
+
+    size_t cells = static_cast<size_t>(mTilesX) * ((height + TILE - 1) / TILE) * TILE * TILE;
+    size_t gridBytes = cells * sizeof(double) * 2;
+
+    // Leave a core to the capture thread
+    unsigned int threads = std::max(2U, std::thread::hardware_concurrency()) - 1;
+    threads = std::min(threads, baselines);
+    threads = std::max(static_cast<size_t>(1), std::min(static_cast<size_t>(threads), MAX_GRIDS_BYTES / gridBytes));
+
+    mSamples.resize(std::max(depth, static_cast<size_t>(2)));
+    for (auto &sample : mSamples)
+        sample.values.resize(baselines);
+    mHead.store(0, std::memory_order_relaxed);
+    mDropped.store(0, std::memory_order_relaxed);
+
+    mRunning = true;
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->grid.assign(cells, 0.0);
+        worker->weights.assign(cells, 0.0);
+        mWorkers.push_back(std::move(worker));
+    }
+    for (unsigned int i = 0; i < threads; i++)
+        mWorkers[i]->thread = std::thread(&XCGridder::run, this, i);
+
+    return true;
+}
+
+void XCGridder::stop()
+{
+    if (mWorkers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mWakeLock);
+        mRunning = false;
+    }
+    mWake.notify_all();
+    for (auto &worker : mWorkers)
+        worker->thread.join();
+    mWorkers.clear();
+    mSamples.clear();
+}
+
+bool XCGridder::push(double alt, double az, const double *values)
+{
+    if (mWorkers.empty())
+        return false;
+
+    size_t head = mHead.load(std::memory_order_relaxed);
+    for (auto &worker : mWorkers)
+    {
+        if (head - worker->tail.load(std::memory_order_acquire) >= mSamples.size())
+        {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    Sample &sample = mSamples[head % mSamples.size()];
+    sample.alt = alt;
+    sample.az  = az;
+    std::copy(values, values + mBaselines, sample.values.begin());
+    mHead.store(head + 1, std::memory_order_release);
+
+    mWake.notify_all();
+    return true;
+}
+
+void XCGridder::run(unsigned int index)
+{
+    Worker &worker = *mWorkers[index];
+    unsigned int stride = static_cast<unsigned int>(mWorkers.size());
+
+    while (mRunning)
+    {
+        size_t tail = worker.tail.load(std::memory_order_relaxed);
+        if (tail == mHead.load(std::memory_order_acquire))
+        {
+            // The timeout covers a notification sent between the check and the wait
+            std::unique_lock<std::mutex> lock(mWakeLock);
+            mWake.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        const Sample &sample = mSamples[tail % mSamples.size()];
+        {
+            std::lock_guard<std::mutex> lock(worker.lock);
+            for (unsigned int b = index; b < mBaselines; b += stride)
+            {
+                double value = sample.values[b], u = 0, v = 0;
+                if (std::isnan(value) || !mProjection(b, sample.alt, sample.az, &u, &v))
+                    continue;
+                add(worker, mWidth * u / 2.0, mHeight * v / 2.0, value);
+            }
+        }
+        worker.tail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+void XCGridder::addCell(Worker &worker, int x, int y, double value, double weight)
+{
+    if (x < 0 || x >= mWidth || y < 0 || y >= mHeight)
+        return;
+    size_t cell = offset(x, y);
+    worker.grid[cell] += value * weight;
+    worker.weights[cell] += weight;
+    // Hermitian mirror
+    cell = offset(mWidth - 1 - x, mHeight - 1 - y);
+    worker.grid[cell] += value * weight;
+    worker.weights[cell] += weight;
+}
+
+void XCGridder::add(Worker &worker, double gx, double gy, double value)
+{
+    if (mKernel == KERNEL_PILLBOX)
+    {
+        // Cell of the sample relative to the center of the grid, truncated as the plots always were
+        int xx = static_cast<int>(gx);
+        int yy = static_cast<int>(gy);
+        if (xx < -mWidth / 2 || xx >= mWidth / 2 || yy < -mHeight / 2 || yy >= mHeight / 2)
+            return;
+        addCell(worker, mWidth / 2 + xx, mHeight / 2 + yy, value, 1.0);
+        return;
+    }
+
+    // Separable gaussian centered on the exact position, normalized over the 3x3 support
+    double cx = std::floor(gx), cy = std::floor(gy);
+    if (cx < -mWidth / 2 - 1 || cx > mWidth / 2 || cy < -mHeight / 2 - 1 || cy > mHeight / 2)
+        return;
+    int x = mWidth / 2 + static_cast<int>(cx);
+    int y = mHeight / 2 + static_cast<int>(cy);
+    double fx = gx - cx - 0.5, fy = gy - cy - 0.5;
+    double wx[3], wy[3], sx = 0, sy = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        double dx = (i - 1) - fx, dy = (i - 1) - fy;
+        wx[i] = std::exp(-dx * dx / (2 * GAUSSIAN_SIGMA * GAUSSIAN_SIGMA));
+        wy[i] = std::exp(-dy * dy / (2 * GAUSSIAN_SIGMA * GAUSSIAN_SIGMA));
+        sx += wx[i];
+        sy += wy[i];
+    }
+    for (int j = 0; j < 3; j++)
+        for (int i = 0; i < 3; i++)
+            addCell(worker, x + i - 1, y + j - 1, value, wx[i] * wy[j] / (sx * sy));
+}
+
+void XCGridder::waitIdle()
+{
+    size_t head = mHead.load(std::memory_order_acquire);
+    for (auto &worker : mWorkers)
+    {
+        while (mRunning && worker->tail.load(std::memory_order_acquire) < head)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void XCGridder::readout(double *out)
+{
+    if (mWorkers.empty())
+        return;
+
+    waitIdle();
+
+    bool uniform = (mWeighting == WEIGHTING_UNIFORM);
+    std::vector<double> weights(uniform ? static_cast<size_t>(mWidth) : 0);
+
+    for (int y = 0; y < mHeight; y++)
+    {
+        double *row = out + static_cast<size_t>(y) * mWidth;
+        std::fill(row, row + mWidth, 0.0);
+        std::fill(weights.begin(), weights.end(), 0.0);
+
+        for (auto &worker : mWorkers)
+        {
+            std::lock_guard<std::mutex> lock(worker->lock);
+            // A tile row at a time
+            for (int x0 = 0; x0 < mWidth; x0 += TILE)
+            {
+                size_t base = offset(x0, y);
+                int n = std::min(TILE, mWidth - x0);
+                for (int i = 0; i < n; i++)
+                    row[x0 + i] += worker->grid[base + i];
+                if (uniform)
+                    for (int i = 0; i < n; i++)
+                        weights[x0 + i] += worker->weights[base + i];
+            }
+        }
+
+        if (uniform)
+            for (int x = 0; x < mWidth; x++)
+                row[x] = weights[x] > 0 ? row[x] / weights[x] : 0.0;
+    }
+}
+
+void XCGridder::clear()
+{
+    for (auto &worker : mWorkers)
+    {
+        std::lock_guard<std::mutex> lock(worker->lock);
+        std::fill(worker->grid.begin(), worker->grid.end(), 0.0);
+        std::fill(worker->weights.begin(), worker->weights.end(), 0.0);
+    }
+}
@@ -0,0 +1,158 @@
+/*
+    indi_interferometer - a telescope array driver for INDI
+    Support for AHP cross-correlators
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The XCGridder class accumulates baseline visibilities on the UV plane in worker threads.
+ *
+ * The capture thread pushes one sample per packet: the pointing and the value of every baseline.
+ * Pushing never blocks, samples are dropped if the workers fall behind. Baselines are split
+ * across the workers, each projects its baselines on the UV plane and adds them, with their
+ * hermitian mirror, into its own grid. The grids are kept in square tiles so a convolution
+ * kernel touches few cache lines. Readout adds the worker grids into a row major image.
+ */
+class XCGridder
+{
+    public:
+        enum Kernel
+        {
+            KERNEL_PILLBOX,     // nearest cell
+            KERNEL_GAUSSIAN,    // 3x3 cells
+        };
+
+        enum Weighting
+        {
+            WEIGHTING_NATURAL,  // sum of the samples
+            WEIGHTING_UNIFORM,  // sum divided by the weight of the cell
+        };
+
+        /** UV coordinates of a baseline for a pointing, both in [-1, 1). Called from the worker threads. */
+        typedef std::function<bool(unsigned int baseline, double alt, double az, double *u, double *v)> Projection;
+
+        XCGridder() = default;
+        ~XCGridder();
+
+        XCGridder(const XCGridder &) = delete;
+        XCGridder &operator=(const XCGridder &) = delete;
+
+        /**
+         * @brief Allocate the grids and start the workers.
+         * @param width grid width in cells
+         * @param height grid height in cells
+         * @param baselines number of baselines in a sample
+         * @param projection UV coordinates of a baseline
+         * @param depth samples that can be queued
+         */
+        bool start(int width, int height, unsigned int baselines, Projection projection, size_t depth = 256);
+
+        /** Stop the workers and free the grids */
+        void stop();
+
+        bool isRunning() const
+        {
+            return !mWorkers.empty();
+        }
+
+        /** Kernel and weighting of the following samples and readouts */
+        void setKernel(Kernel kernel)
+        {
+            mKernel = kernel;
+        }
+        void setWeighting(Weighting weighting)
+        {
+            mWeighting = weighting;
+        }
+
+        /**
+         * @brief Queue one sample, capture thread only.
+         * @param values one value per baseline, NaN for baselines not to grid
+         * @return false if the queue was full and the sample was dropped
+         */
+        bool push(double alt, double az, const double *values);
+
+        /** Wait for the queued samples, then write the grid as width x height row major values */
+        void readout(double *out);
+
+        /** Zero the grids */
+        void clear();
+
+        /** Samples dropped since start() */
+        uint64_t dropped() const
+        {
+            return mDropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static const int TILE = 16;
+
+        struct Sample
+        {
+            double alt {0};
+            double az {0};
+            std::vector<double> values;
+        };
+
+        struct Worker
+        {
+            std::thread thread;
+            std::mutex lock;                    // held while the grids are updated
+            std::vector<double> grid;
+            std::vector<double> weights;
+            std::atomic<size_t> tail {0};
+        };
+
+        void run(unsigned int index);
+        void add(Worker &worker, double gx, double gy, double value);
+        void addCell(Worker &worker, int x, int y, double value, double weight);
+        size_t offset(int x, int y) const
+        {
+            return (static_cast<size_t>(y / TILE) * mTilesX + x / TILE) * TILE * TILE + (y % TILE) * TILE + x % TILE;
+        }
+        void waitIdle();
+
+        int mWidth {0};
+        int mHeight {0};
+        int mTilesX {0};
+        unsigned int mBaselines {0};
+        Projection mProjection;
+        std::atomic<Kernel> mKernel {KERNEL_PILLBOX};
+        std::atomic<Weighting> mWeighting {WEIGHTING_NATURAL};
+
+        // Single producer, every worker reads every sample
+        std::vector<Sample> mSamples;
+        std::atomic<size_t> mHead {0};
+        std::atomic<uint64_t> mDropped {0};
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+
+        std::atomic<bool> mRunning {false};
+        std::mutex mWakeLock;
+        std::condition_variable mWake;
+};
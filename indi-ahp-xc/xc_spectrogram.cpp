@@ -0,0 +1,188 @@
+/*
+    indi_interferometer - a telescope array driver for INDI
+    Support for AHP cross-correlators
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "xc_spectrogram.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Chunks are about this size unless the whole integration fits in less
+static const size_t CHUNK_BYTES = 1024 * 1024;
+
+XCSpectrogram::~XCSpectrogram()
+{
+    release();
+}
+
+bool XCSpectrogram::begin(size_t width, size_t expectedRows)
+{
+    if (width == 0)
+        return false;
+
+    if (width != mWidth)
+    {
+        release();
+
+        // Whole pages, so spilled chunks map at page aligned file offsets
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t rowBytes = width * sizeof(double);
+        mChunkRows  = (CHUNK_BYTES + rowBytes - 1) / rowBytes;
+        mChunkBytes = (mChunkRows * rowBytes + page - 1) / page * page;
+        mChunkRows  = mChunkBytes / rowBytes;
+        mWidth      = width;
+    }
+    mRows = 0;
+
+    // Allocate up front what the integration needs, a row append then never allocates.
+    // Chunks left over from a longer integration are given back, spilled ones first as they are last.
+    size_t needed = (expectedRows + mChunkRows - 1) / mChunkRows;
+    while (mChunks.size() > needed)
+    {
+        Chunk &chunk = mChunks.back();
+        if (chunk.mapped)
+        {
+            munmap(chunk.data, mChunkBytes);
+            mSpillSize -= mChunkBytes;
+        }
+        else
+        {
+            free(chunk.data);
+            mMemoryBytes -= mChunkBytes;
+        }
+        mChunks.pop_back();
+    }
+    // Failing to shrink the file only keeps its disk space
+    if (mSpillFD >= 0 && ftruncate(mSpillFD, static_cast<off_t>(mSpillSize)) != 0)
+        mSpillSize = static_cast<size_t>(lseek(mSpillFD, 0, SEEK_END));
+    // Spill chunks are only mapped once rows reach them
+    while (mChunks.size() < needed && (mSpillLimit == 0 || mMemoryBytes + mChunkBytes <= mSpillLimit))
+    {
+        if (!addChunk())
+            return false;
+    }
+    return true;
+}
+
+bool XCSpectrogram::addChunk()
+{
+    Chunk chunk;
+
+    if (mSpillLimit == 0 || mMemoryBytes + mChunkBytes <= mSpillLimit)
+    {
+        chunk.data = static_cast<double *>(malloc(mChunkBytes));
+        if (chunk.data == nullptr)
+            return false;
+        mMemoryBytes += mChunkBytes;
+    }
+    else
+    {
+        if (mSpillFD < 0)
+        {
+            const char *dir = getenv("TMPDIR");
+            std::string path = std::string(dir != nullptr ? dir : "/tmp") + "/indi_ahp_xc_XXXXXX";
+            mSpillFD = mkstemp(&path[0]);
+            if (mSpillFD < 0)
+                return false;
+            // Nobody else needs the file, it goes away with the descriptor
+            unlink(path.c_str());
+            mSpillSize = 0;
+        }
+
+        if (ftruncate(mSpillFD, static_cast<off_t>(mSpillSize + mChunkBytes)) != 0)
+            return false;
+        void *data = mmap(nullptr, mChunkBytes, PROT_READ | PROT_WRITE, MAP_SHARED, mSpillFD,
+                          static_cast<off_t>(mSpillSize));
+        if (data == MAP_FAILED)
+            return false;
+        mSpillSize += mChunkBytes;
+        chunk.data   = static_cast<double *>(data);
+        chunk.mapped = true;
+    }
+
+    mChunks.push_back(chunk);
+    return true;
+}
+
+double *XCSpectrogram::appendRow()
+{
+    if (mWidth == 0)
+        return nullptr;
+
+    size_t index = mRows / mChunkRows;
+    if (index >= mChunks.size() && !addChunk())
+        return nullptr;
+
+    double *row = mChunks[index].data + (mRows % mChunkRows) * mWidth;
+    mRows++;
+    return row;
+}
+
+const double *XCSpectrogram::chunk(size_t index, size_t *rows) const
+{
+    if (index >= chunks())
+    {
+        *rows = 0;
+        return nullptr;
+    }
+    *rows = (index == chunks() - 1) ? mRows - index * mChunkRows : mChunkRows;
+    return mChunks[index].data;
+}
+
+void XCSpectrogram::minMax(double *min, double *max) const
+{
+    *min = 0;
+    *max = 0;
+    bool first = true;
+    for (size_t c = 0; c < chunks(); c++)
+    {
+        size_t rows = 0;
+        const double *data = chunk(c, &rows);
+        for (size_t i = 0; i < rows * mWidth; i++)
+        {
+            if (first || data[i] < *min)
+                *min = data[i];
+            if (first || data[i] > *max)
+                *max = data[i];
+            first = false;
+        }
+    }
+}
+
+void XCSpectrogram::release()
+{
+    for (auto &chunk : mChunks)
+    {
+        if (chunk.mapped)
+            munmap(chunk.data, mChunkBytes);
+        else
+            free(chunk.data);
+    }
+    mChunks.clear();
+
+    if (mSpillFD >= 0)
+        close(mSpillFD);
+    mSpillFD     = -1;
+    mSpillSize   = 0;
+    mMemoryBytes = 0;
+    mWidth       = 0;
+    mRows        = 0;
+}
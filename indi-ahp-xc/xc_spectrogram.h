@@ -0,0 +1,108 @@
+/*
+    indi_interferometer - a telescope array driver for INDI
+    Support for AHP cross-correlators
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The XCSpectrogram class stores the lag rows of one correlation over an integration.
+ *
+ * Rows are appended into fixed size chunks, so a row is never copied again however long the
+ * integration runs. Chunks are kept between integrations of the same row width.
+ * Once the chunks held in memory reach the spill limit, the next ones are mapped from an
+ * unlinked temporary file and the kernel can write them back to disk instead of keeping them
+ * in RAM.
+ */
+class XCSpectrogram
+{
+    public:
+        XCSpectrogram() = default;
+        ~XCSpectrogram();
+
+        XCSpectrogram(const XCSpectrogram &) = delete;
+        XCSpectrogram &operator=(const XCSpectrogram &) = delete;
+
+        /**
+         * @brief Start a new integration, dropping the rows of the previous one.
+         * @param width samples per row
+         * @param expectedRows rows expected for the integration, the memory chunks for them are allocated now
+         */
+        bool begin(size_t width, size_t expectedRows);
+
+        /** Room for one more row of width() samples, nullptr if no memory or spill space is left */
+        double *appendRow();
+
+        /** Free all chunks and close the spill file */
+        void release();
+
+        /** Chunks held in memory above this many bytes come from the spill file, 0 never spills */
+        void setSpillLimit(size_t bytes)
+        {
+            mSpillLimit = bytes;
+        }
+
+        size_t width() const
+        {
+            return mWidth;
+        }
+
+        size_t rows() const
+        {
+            return mRows;
+        }
+
+        bool isSpilled() const
+        {
+            return mSpillFD >= 0;
+        }
+
+        /** Number of chunks holding rows, and the rows they hold */
+        size_t chunks() const
+        {
+            return mWidth > 0 ? (mRows + mChunkRows - 1) / mChunkRows : 0;
+        }
+        const double *chunk(size_t index, size_t *rows) const;
+
+        /** Smallest and largest sample over all chunks, both 0 when there are no rows */
+        void minMax(double *min, double *max) const;
+
+    private:
+        struct Chunk
+        {
+            double *data {nullptr};
+            bool mapped {false};
+        };
+
+        bool addChunk();
+
+        size_t mWidth {0};
+        size_t mRows {0};
+        size_t mChunkRows {0};
+        size_t mChunkBytes {0};
+        std::vector<Chunk> mChunks;
+
+        size_t mSpillLimit {0};
+        size_t mMemoryBytes {0};
+        int mSpillFD {-1};
+        size_t mSpillSize {0};
+};
@@ -684,7 +684,6 @@ bool ApogeeCCD::UpdateCCDBin(int binx, int biny)
 
 int ApogeeCCD::grabImage()
 {
-    std::vector<uint16_t> pImageData;
     uint16_t *image = reinterpret_cast<uint16_t*>(PrimaryCCD.getFrameBuffer());
 
     try
@@ -698,10 +697,18 @@ int ApogeeCCD::grabImage()
         }
         else
         {
-            ApgCam->GetImage(pImageData);
             imageWidth  = ApgCam->GetRoiNumCols();
             imageHeight = ApgCam->GetRoiNumRows();
-            copy(pImageData.begin(), pImageData.end(), image);
+            // With bulk download (sequences) the library writes the rows of all images at once
+            int const images = ApgCam->IsBulkDownloadOn() ? ApgCam->GetImageCount() : 1;
+            int const rows   = imageHeight * images;
+            if (imageWidth * rows * static_cast<int>(sizeof(uint16_t)) > PrimaryCCD.getFrameBufferSize())
+            {
+                LOGF_ERROR("Frame buffer too small for %d %dx%d image(s).", images, imageWidth, imageHeight);
+                return -1;
+            }
+            // Reassembled by libapogee straight into the frame buffer
+            ApgCam->GetImage(image, imageWidth);
         }
         guard.unlock();
     }
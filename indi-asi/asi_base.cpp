@@ -25,6 +25,8 @@
 
 #include "config.h"
 
+#include <pixelkernels.h>
+
 #include <stream/streammanager.h>
 #include <indielapsedtimer.h>
 
@@ -32,6 +34,7 @@
 #include <cmath>
 #include <vector>
 #include <map>
+#include <thread>
 #include <unistd.h>
 
 #define MAX_EXP_RETRIES         3
@@ -40,6 +43,7 @@
 #define TEMP_THRESHOLD          .25  /* Differential temperature threshold (C)*/
 
 #define CONTROL_TAB "Controls"
+#define STREAM_STATS_TAB "Streaming"
 
 static bool warn_roi_height = true;
 static bool warn_roi_width = true;
@@ -61,21 +65,48 @@ void ASIBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
         LOGF_ERROR("Failed to set exposure duration (%s).", Helpers::toString(ret));
     }
 
+    // The SDK reads the next frame into a free slot while the sender thread
+    // is still passing the previous one to the streamer.
+    if (mVideoRing.allocate(PrimaryCCD.getFrameBufferSize()) == false)
+    {
+        Streamer->setStream(false);
+        LOGF_ERROR("Failed to allocate video buffers (%u bytes).", PrimaryCCD.getFrameBufferSize());
+        return;
+    }
+
     ret = ASIStartVideoCapture(mCameraInfo.CameraID);
     if (ret != ASI_SUCCESS)
     {
         LOGF_ERROR("Failed to start video capture (%s).", Helpers::toString(ret));
     }
 
+    std::atomic_bool isSenderAboutToQuit {false};
+    std::thread sender(&ASIBase::workerSendVideo, this, std::cref(isSenderAboutToQuit));
+
     while (!isAboutToQuit)
     {
-        uint8_t *targetFrame = PrimaryCCD.getFrameBuffer();
         uint32_t totalBytes  = PrimaryCCD.getFrameBufferSize();
         int waitMS           = static_cast<int>((ExposureRequest * 2000.0) + 500);
 
+        if (totalBytes > mVideoRing.frameSize())
+        {
+            Streamer->setStream(false);
+            LOGF_ERROR("Frame size changed while streaming (%u > %zu bytes).", totalBytes, mVideoRing.frameSize());
+            break;
+        }
+
+        uint8_t *targetFrame = mVideoRing.beginWrite();
+        if (targetFrame == nullptr)
+        {
+            usleep(100);
+            continue;
+        }
+
         ret = ASIGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
         if (ret != ASI_SUCCESS)
         {
+            mVideoRing.endWrite(0, false);
+
             if (ret != ASI_ERROR_TIMEOUT)
             {
                 Streamer->setStream(false);
@@ -87,14 +118,58 @@ void ASIBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
             continue;
         }
 
-        if (mCurrentVideoFormat == ASI_IMG_RGB24)
-            for (uint32_t i = 0; i < totalBytes; i += 3)
-                std::swap(targetFrame[i], targetFrame[i + 2]);
-
-        Streamer->newFrame(targetFrame, totalBytes);
+        mVideoRing.endWrite(totalBytes);
     }
 
     ASIStopVideoCapture(mCameraInfo.CameraID);
+
+    isSenderAboutToQuit = true;
+    mVideoRing.abort();
+    sender.join();
+
+    updateStreamStats();
+    mVideoRing.release();
+}
+
+void ASIBase::workerSendVideo(const std::atomic_bool &isAboutToQuit)
+{
+    INDI::ElapsedTimer statsTimer;
+
+    while (!isAboutToQuit)
+    {
+        size_t totalBytes = 0;
+        uint8_t *targetFrame = mVideoRing.beginRead(totalBytes, 100);
+
+        if (targetFrame != nullptr)
+        {
+            if (mCurrentVideoFormat == ASI_IMG_RGB24)
+                PixelKernels::swapRB(targetFrame, totalBytes / 3, 3);
+
+            Streamer->newFrame(targetFrame, totalBytes);
+            mVideoRing.endRead();
+        }
+
+        if (statsTimer.elapsed() >= 1000)
+        {
+            updateStreamStats();
+            statsTimer.start();
+        }
+    }
+}
+
+void ASIBase::updateStreamStats()
+{
+    FrameRing::Stats stats = mVideoRing.stats();
+
+    int sdkDropped = 0;
+    ASIGetDroppedFrames(mCameraInfo.CameraID, &sdkDropped);
+
+    StreamStatsNP[STREAM_QUEUED     ].setValue(stats.queued);
+    StreamStatsNP[STREAM_DROPPED    ].setValue(stats.dropped);
+    StreamStatsNP[STREAM_LATE       ].setValue(stats.late);
+    StreamStatsNP[STREAM_SDK_DROPPED].setValue(sdkDropped);
+    StreamStatsNP.setState((stats.dropped > 0 || sdkDropped > 0) ? IPS_BUSY : IPS_OK);
+    StreamStatsNP.apply();
 }
 
 void ASIBase::workerBlinkExposure(const std::atomic_bool &isAboutToQuit, int blinks, float duration)
@@ -344,6 +419,12 @@ bool ASIBase::initProperties()
     BlinkNP.fill(getDeviceName(), "BLINK", "Blink", CONTROL_TAB, IP_RW, 60, IPS_IDLE);
     BlinkNP.load();
 
+    StreamStatsNP[STREAM_QUEUED     ].fill("STREAM_QUEUED",      "Queued",      "%.f", 0, 1e9, 0, 0);
+    StreamStatsNP[STREAM_DROPPED    ].fill("STREAM_DROPPED",     "Dropped",     "%.f", 0, 1e9, 0, 0);
+    StreamStatsNP[STREAM_LATE       ].fill("STREAM_LATE",        "Late",        "%.f", 0, 1e9, 0, 0);
+    StreamStatsNP[STREAM_SDK_DROPPED].fill("STREAM_SDK_DROPPED", "SDK Dropped", "%.f", 0, 1e9, 0, 0);
+    StreamStatsNP.fill(getDeviceName(), "STREAM_STATS", "Stream Stats", STREAM_STATS_TAB, IP_RO, 60, IPS_IDLE);
+
     IUSaveText(&BayerT[2], getBayerString());
 
     ADCDepthNP[0].fill("BITS", "Bits", "%2.0f", 0, 32, 1, mCameraInfo.BitDepth);
@@ -480,6 +561,7 @@ bool ASIBase::updateProperties()
         }
 
         defineProperty(BlinkNP);
+        defineProperty(StreamStatsNP);
         defineProperty(ADCDepthNP);
         defineProperty(SDKVersionSP);
         if (!mSerialNumber.empty())
@@ -513,6 +595,7 @@ bool ASIBase::updateProperties()
             deleteProperty(VideoFormatSP.getName());
 
         deleteProperty(BlinkNP.getName());
+        deleteProperty(StreamStatsNP.getName());
         deleteProperty(SDKVersionSP.getName());
         if (!mSerialNumber.empty())
         {
@@ -579,6 +662,8 @@ bool ASIBase::Disconnect()
         ASICloseCamera(mCameraInfo.CameraID);
     }
 
+    mStagingBuffer.release();
+
     LOG_INFO("Camera is offline.");
 
 
@@ -1176,12 +1261,18 @@ int ASIBase::grabImage(float duration)
 
     if (type == ASI_IMG_RGB24)
     {
-        buffer = static_cast<uint8_t *>(malloc(nTotalBytes));
+        // Kept across exposures, only reallocated when the frame size changes
+        buffer = mStagingBuffer.get(nTotalBytes);
         if (buffer == nullptr)
         {
-            LOGF_ERROR("%s: %d malloc failed (RGB 24).", getDeviceName());
+            LOGF_ERROR("Failed to allocate RGB 24 staging buffer (%zu bytes).", nTotalBytes);
             return -1;
         }
+
+        const PixelKernels::StagingBuffer::Stats &stats = mStagingBuffer.stats();
+        LOGF_DEBUG("RGB 24 staging buffer: %zu bytes%s, %llu allocation(s), %llu reuse(s).",
+                   stats.capacity, stats.hugePages ? " (huge pages)" : "",
+                   static_cast<unsigned long long>(stats.allocations), static_cast<unsigned long long>(stats.reuses));
     }
 
     ret = ASIGetDataAfterExp(mCameraInfo.CameraID, buffer, nTotalBytes);
@@ -1191,28 +1282,14 @@ int ASIBase::grabImage(float duration)
             "Failed to get data after exposure (%dx%d #%d channels) (%s).",
             subW, subH, nChannels, Helpers::toString(ret)
         );
-        if (type == ASI_IMG_RGB24)
-            free(buffer);
         return -1;
     }
 
     if (type == ASI_IMG_RGB24)
     {
-        uint8_t *dstR = image;
-        uint8_t *dstG = image + subW * subH;
-        uint8_t *dstB = image + subW * subH * 2;
-
-        const uint8_t *src = buffer;
-        const uint8_t *end = buffer + subW * subH * 3;
-
-        while (src != end)
-        {
-            *dstB++ = *src++;
-            *dstG++ = *src++;
-            *dstR++ = *src++;
-        }
-
-        free(buffer);
+        // BGR24 from the SDK into R, G and B planes
+        uint8_t *planes[3] = { image + subW * subH * 2, image + subW * subH, image };
+        PixelKernels::deinterleave(buffer, planes, subW * subH, 3);
     }
     guard.unlock();
 
@@ -28,6 +28,9 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "asi_framering.h"
+
+#include <stagingbuffer.h>
 
 #include <vector>
 
@@ -86,6 +89,7 @@ class ASIBase : public INDI::CCD
     protected:
         INDI::SingleThreadPool mWorker;
         void workerStreamVideo(const std::atomic_bool &isAboutToQuit);
+        void workerSendVideo(const std::atomic_bool &isAboutToQuit);
         void workerBlinkExposure(const std::atomic_bool &isAboutToQuit, int blinks, float duration);
         void workerExposure(const std::atomic_bool &isAboutToQuit, float duration);
 
@@ -117,6 +121,9 @@ class ASIBase : public INDI::CCD
         /** Return user selected image type */
         ASI_IMG_TYPE getImageType() const;
 
+        /** Publish video ring counters */
+        void updateStreamStats();
+
         /** Update SER recorder video format */
         void updateRecorderFormat();
 
@@ -152,6 +159,15 @@ class ASIBase : public INDI::CCD
             BLINK_DURATION
         };
 
+        INDI::PropertyNumber  StreamStatsNP {4};
+        enum
+        {
+            STREAM_QUEUED,
+            STREAM_DROPPED,
+            STREAM_LATE,
+            STREAM_SDK_DROPPED
+        };
+
         INDI::PropertySwitch  FlipSP {2};
         enum
         {
@@ -164,4 +180,10 @@ class ASIBase : public INDI::CCD
         uint8_t mExposureRetry {0};
         ASI_IMG_TYPE mCurrentVideoFormat;
         std::vector<ASI_CONTROL_CAPS> mControlCaps;
+
+        /** Video frames travel from ASIGetVideoData to the streamer through this ring */
+        FrameRing mVideoRing {4};
+
+        /** BGR frames are read here before being split into planes */
+        PixelKernels::StagingBuffer mStagingBuffer;
 };
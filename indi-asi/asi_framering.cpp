@@ -0,0 +1,174 @@
+/*
+    ASI Frame Ring
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "asi_framering.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <unistd.h>
+
+FrameRing::FrameRing(size_t slots)
+    : mSlots(slots < 2 ? 2 : slots)
+{ }
+
+FrameRing::~FrameRing()
+{
+    release();
+}
+
+bool FrameRing::allocate(size_t frameSize)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0)
+        pageSize = 4096;
+
+    mFree.clear();
+    mFilled.clear();
+    mWriteSlot = mReadSlot = -1;
+    mAborted = false;
+    mStats = Stats();
+
+    for (size_t i = 0; i < mSlots.size(); i++)
+    {
+        Slot &slot = mSlots[i];
+        if (frameSize != mFrameSize || slot.data == nullptr)
+        {
+            free(slot.data);
+            slot.data = nullptr;
+            if (posix_memalign(reinterpret_cast<void **>(&slot.data), pageSize, frameSize) != 0)
+            {
+                slot.data = nullptr;
+                mFrameSize = 0;
+                return false;
+            }
+        }
+        slot.bytes = 0;
+        mFree.push_back(i);
+    }
+
+    mFrameSize = frameSize;
+    return true;
+}
+
+void FrameRing::release()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (auto &slot : mSlots)
+    {
+        free(slot.data);
+        slot.data = nullptr;
+        slot.bytes = 0;
+    }
+    mFree.clear();
+    mFilled.clear();
+    mWriteSlot = mReadSlot = -1;
+    mFrameSize = 0;
+}
+
+uint8_t *FrameRing::beginWrite()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    if (mFrameSize == 0)
+        return nullptr;
+
+    if (mFree.empty())
+    {
+        // Consumer is behind, sacrifice the oldest frame it has not picked up yet.
+        if (mFilled.empty())
+            return nullptr;
+        mFree.push_back(mFilled.front());
+        mFilled.pop_front();
+        mStats.dropped++;
+    }
+
+    mWriteSlot = static_cast<int>(mFree.front());
+    mFree.pop_front();
+    return mSlots[mWriteSlot].data;
+}
+
+void FrameRing::endWrite(size_t bytes, bool valid)
+{
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mWriteSlot < 0)
+            return;
+
+        if (valid)
+        {
+            mSlots[mWriteSlot].bytes = bytes;
+            mFilled.push_back(mWriteSlot);
+            mStats.queued++;
+        }
+        else
+            mFree.push_front(mWriteSlot);
+
+        mWriteSlot = -1;
+    }
+    mCondition.notify_one();
+}
+
+uint8_t *FrameRing::beginRead(size_t &bytes, int timeoutMS)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    mCondition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [this]
+    {
+        return mAborted || !mFilled.empty();
+    });
+
+    if (mAborted || mFilled.empty())
+        return nullptr;
+
+    if (mFilled.size() > 1)
+        mStats.late++;
+
+    mReadSlot = static_cast<int>(mFilled.front());
+    mFilled.pop_front();
+    bytes = mSlots[mReadSlot].bytes;
+    return mSlots[mReadSlot].data;
+}
+
+void FrameRing::endRead()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mReadSlot < 0)
+        return;
+
+    mFree.push_back(mReadSlot);
+    mReadSlot = -1;
+}
+
+void FrameRing::abort()
+{
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mAborted = true;
+    }
+    mCondition.notify_all();
+}
+
+FrameRing::Stats FrameRing::stats() const
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mStats;
+}
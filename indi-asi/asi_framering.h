@@ -0,0 +1,102 @@
+/*
+    ASI Frame Ring
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief The FrameRing class holds a small set of preallocated, page aligned
+ * video frame buffers shared between the thread reading frames from the camera
+ * and the thread passing them on to the streamer.
+ *
+ * The producer never blocks: when the consumer falls behind and no slot is free,
+ * the oldest queued frame is dropped and its slot is reused.
+ */
+class FrameRing
+{
+    public:
+        struct Stats
+        {
+            uint64_t queued  {0};   // frames handed to the consumer
+            uint64_t dropped {0};   // frames overwritten before the consumer got to them
+            uint64_t late    {0};   // frames picked up while a newer frame was already waiting
+        };
+
+    public:
+        explicit FrameRing(size_t slots);
+        ~FrameRing();
+
+        FrameRing(const FrameRing &) = delete;
+        FrameRing &operator=(const FrameRing &) = delete;
+
+        /** Allocate all slots to hold frameSize bytes. Resets statistics. */
+        bool allocate(size_t frameSize);
+
+        /** Free all slots. */
+        void release();
+
+        /** Capacity of a single slot in bytes. */
+        size_t frameSize() const
+        {
+            return mFrameSize;
+        }
+
+        /** Producer: get a slot to write the next frame into. */
+        uint8_t *beginWrite();
+
+        /** Producer: publish the slot obtained from beginWrite, or give it back if the read failed. */
+        void endWrite(size_t bytes, bool valid = true);
+
+        /** Consumer: wait for a filled slot. Returns nullptr on timeout or when aborted. */
+        uint8_t *beginRead(size_t &bytes, int timeoutMS);
+
+        /** Consumer: return the slot obtained from beginRead. */
+        void endRead();
+
+        /** Wake up a consumer waiting in beginRead and make it return nullptr. */
+        void abort();
+
+        Stats stats() const;
+
+    private:
+        struct Slot
+        {
+            uint8_t *data {nullptr};
+            size_t   bytes {0};
+        };
+
+        std::vector<Slot> mSlots;
+        std::deque<size_t> mFree;
+        std::deque<size_t> mFilled;
+        int mWriteSlot {-1};
+        int mReadSlot {-1};
+        size_t mFrameSize {0};
+        bool mAborted {false};
+        Stats mStats;
+
+        mutable std::mutex mMutex;
+        std::condition_variable mCondition;
+};
@@ -489,3 +489,83 @@ void AUXCommand::setData(uint32_t value, uint8_t bytes)
             break;
     }
 }
+
+////////////////////////////////////////////////
+//////  AUXFrameParser class
+////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////////////
+void AUXFrameParser::feed(const uint8_t *data, size_t size)
+{
+    // Compact once the consumed part dominates, keeps the buffer from growing
+    if (m_Start > 0 && m_Start >= m_Buffer.size() / 2)
+    {
+        m_Buffer.erase(m_Buffer.begin(), m_Buffer.begin() + m_Start);
+        m_Start = 0;
+    }
+    m_Buffer.insert(m_Buffer.end(), data, data + size);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Packet: 0x3b <len> <src> <dst> <cmd> <len-3 data bytes> <checksum>
+/////////////////////////////////////////////////////////////////////////////////////
+bool AUXFrameParser::next(AUXBuffer &packet)
+{
+    while (m_Start < m_Buffer.size())
+    {
+        if (m_Buffer[m_Start] != 0x3b)
+        {
+            m_Start++;
+            m_Dropped++;
+            continue;
+        }
+
+        if (m_Start + 1 >= m_Buffer.size())
+            return false;
+
+        // A corrupted length would otherwise hold up the packets behind it
+        uint8_t len = m_Buffer[m_Start + 1];
+        if (len < 3 || len > MAX_CMD_LEN)
+        {
+            m_Start++;
+            m_Dropped++;
+            continue;
+        }
+
+        size_t size = len + 3;
+        if (m_Start + size > m_Buffer.size())
+            return false;
+
+        int cs = 0;
+        for (size_t i = 1; i < size - 1; i++)
+            cs += m_Buffer[m_Start + i];
+
+        // A preamble byte inside some other packet, look for the next one
+        if (static_cast<uint8_t>((~cs + 1) & 0xFF) != m_Buffer[m_Start + size - 1])
+        {
+            m_Start++;
+            m_Dropped++;
+            continue;
+        }
+
+        packet.assign(m_Buffer.begin() + m_Start, m_Buffer.begin() + m_Start + size);
+        m_Start += size;
+        return true;
+    }
+
+    m_Buffer.clear();
+    m_Start = 0;
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////////////
+void AUXFrameParser::reset()
+{
+    m_Buffer.clear();
+    m_Start = 0;
+}
+
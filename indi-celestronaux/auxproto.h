@@ -170,3 +170,37 @@ class AUXCommand
 
 
 };
+
+/**
+ * @brief The AUXFrameParser class splits the byte stream received from the mount into AUX packets.
+ *
+ * Bytes are fed in whatever chunks they arrive in. Anything before a preamble and packets with a
+ * bad checksum are skipped, so the parser resynchronizes by itself after line noise or a partial read.
+ */
+class AUXFrameParser
+{
+    public:
+        /** Append received bytes */
+        void feed(const uint8_t *data, size_t size);
+
+        /**
+         * @brief next Extract the next complete packet.
+         * @param packet whole packet, from preamble to checksum.
+         * @return True if a packet was extracted, false if more bytes are needed.
+         */
+        bool next(AUXBuffer &packet);
+
+        /** Drop any partial packet */
+        void reset();
+
+        /** Number of bytes skipped while looking for valid packets */
+        uint32_t dropped() const
+        {
+            return m_Dropped;
+        }
+
+    private:
+        AUXBuffer m_Buffer;
+        size_t m_Start {0};
+        uint32_t m_Dropped {0};
+};
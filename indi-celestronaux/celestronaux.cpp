@@ -29,6 +29,7 @@
 #include <termios.h>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <thread>
 #include <chrono>
@@ -147,6 +148,9 @@ bool CelestronAUX::Handshake()
         else
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
+        // Drop anything received before we were ready, responses are matched from here on.
+        resetAUXStream();
+
         // read firmware version, if read ok, detected scope
         LOG_DEBUG("Communicating with mount motor controllers...");
         if (getVersion(AZM) && getVersion(ALT))
@@ -208,6 +212,8 @@ void CelestronAUX::ISGetProperties(const char *dev)
 {
     INDI::Telescope::ISGetProperties(dev);
     defineProperty(PortTypeSP);
+    defineProperty(AUXTimingNP);
+    loadConfig(true, AUXTimingNP.getName());
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -360,6 +366,13 @@ bool CelestronAUX::initProperties()
     PortTypeSP[PORT_AUX_PC].fill("PORT_AUX_PC", "AUX/PC", m_ConfigPortType == PORT_AUX_PC ? ISS_ON : ISS_OFF);
     PortTypeSP[PORT_HC_USB].fill("PORT_HC_USB", "USB/HC", m_ConfigPortType == PORT_AUX_PC ? ISS_OFF : ISS_ON);
     PortTypeSP.fill(getDeviceName(), "PORT_TYPE", "Port Type", CONNECTION_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
+    // Commands are pipelined where the link allows it. The frame gap spaces out consecutive packets for
+    // adapters that need it, the turnaround is the delay before releasing RTS on the half duplex AUX/PC port.
+    AUXTimingNP[AUX_RESPONSE_TIMEOUT].fill("AUX_RESPONSE_TIMEOUT", "Response timeout (ms)", "%.f", 50, 5000, 50, 1000);
+    AUXTimingNP[AUX_FRAME_GAP].fill("AUX_FRAME_GAP", "Frame gap (ms)", "%.f", 0, 100, 1, 0);
+    AUXTimingNP[AUX_RTS_TURNAROUND].fill("AUX_RTS_TURNAROUND", "RTS turnaround (ms)", "%.f", 0, 100, 1, 5);
+    AUXTimingNP.fill(getDeviceName(), "AUX_TIMING", "AUX Timing", CONNECTION_TAB, IP_RW, 60, IPS_IDLE);
     /////////////////////////////////////////////////////////////////////////////////////
     /// Mount Information
     /////////////////////////////////////////////////////////////////////////////////////
@@ -718,6 +731,7 @@ bool CelestronAUX::saveConfigItems(FILE *fp)
 
     //MountTypeSP.save(fp);
     PortTypeSP.save(fp);
+    AUXTimingNP.save(fp);
     CordWrapToggleSP.save(fp);
     CordWrapPositionSP.save(fp);
     CordWrapBaseSP.save(fp);
@@ -771,6 +785,16 @@ bool CelestronAUX::ISNewNumber(const char *dev, const char *name, double values[
 {
     if (strcmp(dev, getDeviceName()) == 0)
     {
+        // AUX link timing
+        if (AUXTimingNP.isNameMatch(name))
+        {
+            AUXTimingNP.update(values, names, n);
+            AUXTimingNP.setState(IPS_OK);
+            AUXTimingNP.apply();
+            saveConfig(true, AUXTimingNP.getName());
+            return true;
+        }
+
         // Axis1 PID
         if (Axis1PIDNP.isNameMatch(name))
         {
@@ -1368,26 +1392,30 @@ bool CelestronAUX::ReadScopeStatus()
     if (!isConnected())
         return false;
 
-    if (!getStatus(AXIS_AZ))
-        return false;
-    if (!getStatus(AXIS_ALT))
-        return false;
-
     double axis1 = EncoderNP[AXIS_AZ].getValue();
     double axis2 = EncoderNP[AXIS_ALT].getValue();
 
-    if (!getEncoder(AXIS_AZ))
+    // Slew status and encoders of both axes in one batch, pipelined where the link allows it.
+    std::vector<AUXCommand> queries;
+    queries.reserve(4);
+    for (int axis = AXIS_AZ; axis <= AXIS_ALT; axis++)
     {
-        if (EncoderNP.getState() != IPS_ALERT)
-        {
-            EncoderNP.setState(IPS_ALERT);
-            AngleNP.setState(IPS_ALERT);
-            EncoderNP.apply();
-            AngleNP.apply();
-        }
-        return false;
+        AUXTargets target = (axis == AXIS_AZ) ? AZM : ALT;
+        if (m_AxisStatus[axis] == SLEWING && ScopeStatus != SLEWING_MANUAL)
+            queries.emplace_back(MC_SLEW_DONE, APP, target);
+        queries.emplace_back(MC_GET_POSITION, APP, target);
     }
-    if (!getEncoder(AXIS_ALT))
+
+    // A slew done query without response is asked again on the next poll, only the encoders are required
+    std::vector<AUXCommands> missed;
+    bool encodersRead = sendAUXCommands(queries, &missed);
+    if (!encodersRead)
+        encodersRead = !missed.empty() && std::all_of(missed.begin(), missed.end(), [](AUXCommands id)
+    {
+        return id == MC_SLEW_DONE;
+    });
+
+    if (!encodersRead)
     {
         if (EncoderNP.getState() != IPS_ALERT)
         {
@@ -2812,9 +2840,9 @@ bool CelestronAUX::getStatus(INDI_HO_AXIS axis)
 bool CelestronAUX::getEncoder(INDI_HO_AXIS axis)
 {
     AUXCommand command(MC_GET_POSITION, APP, axis == AXIS_AZ ? AZM : ALT);
-    sendAUXCommand(command);
-    readAUXResponse(command);
-    return true;
+    if (!sendAUXCommand(command))
+        return false;
+    return readAUXResponse(command);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3114,7 +3142,7 @@ bool CelestronAUX::processResponse(AUXCommand &m)
 /////////////////////////////////////////////////////////////////////////////////////
 ///
 /////////////////////////////////////////////////////////////////////////////////////
-bool CelestronAUX::serialReadResponse(AUXCommand c)
+bool CelestronAUX::passthroughReadResponse(AUXCommand c)
 {
     int n;
     unsigned char buf[32];
@@ -3125,152 +3153,234 @@ bool CelestronAUX::serialReadResponse(AUXCommand c)
     if ( PortFD <= 0 )
         return false;
 
-    if (m_IsRTSCTS || !m_isHandController)
-    {
-        // if connected to AUX or PC ports, receive AUX command response.
-        // search for packet preamble (0x3b)
-        do
-        {
-            if (aux_tty_read((char*)buf, 1, READ_TIMEOUT, &n) != TTY_OK)
-                return false;
-        }
-        while (buf[0] != 0x3b);
-
-        // packet preamble is found, now read packet length.
-        if (aux_tty_read((char*)(buf + 1), 1, READ_TIMEOUT, &n) != TTY_OK)
-            return false;
-
-        // now packet length is known, read the rest of the packet.
-        if (aux_tty_read((char*)(buf + 2), buf[1] + 1, READ_TIMEOUT, &n)
-                != TTY_OK || n != buf[1] + 1)
-        {
-            LOG_DEBUG("Did not got whole packet. Dropping out.");
-            return false;
-        }
+    // if connected to HC serial, build up the AUX command response from
+    // given AUX command and passthrough response without checksum.
+    // read passthrough response
+    if ((tty_read(PortFD, (char *)buf + 5, response_data_size + 1, READ_TIMEOUT, &n) !=
+            TTY_OK) || (n != response_data_size + 1))
+        return false;
 
-        AUXBuffer b(buf, buf + (n + 2));
-        hex_dump(hexbuf, b, b.size());
-        DEBUGF(DBG_SERIAL, "RES <%s>", hexbuf);
-        cmd.parseBuf(b);
-    }
-    else
+    // if last char is not '#', there was an error.
+    if (buf[response_data_size + 5] != '#')
     {
-        // if connected to HC serial, build up the AUX command response from
-        // given AUX command and passthrough response without checksum.
-        // read passthrough response
-        if ((tty_read(PortFD, (char *)buf + 5, response_data_size + 1, READ_TIMEOUT, &n) !=
-                TTY_OK) || (n != response_data_size + 1))
-            return false;
-
-        // if last char is not '#', there was an error.
-        if (buf[response_data_size + 5] != '#')
-        {
-            LOGF_ERROR("Resp. char %d is %2.2x ascii %c", n, buf[n + 5], (char)buf[n + 5]);
-            AUXBuffer b(buf, buf + (response_data_size + 5));
-            hex_dump(hexbuf, b, b.size());
-            LOGF_ERROR("RES <%s>", hexbuf);
-            return false;
-        }
-
-        buf[0] = 0x3b;
-        buf[1] = response_data_size + 1;
-        buf[2] = c.destination();
-        buf[3] = c.source();
-        buf[4] = c.command();
-
+        LOGF_ERROR("Resp. char %d is %2.2x ascii %c", n, buf[n + 5], (char)buf[n + 5]);
         AUXBuffer b(buf, buf + (response_data_size + 5));
         hex_dump(hexbuf, b, b.size());
-        DEBUGF(DBG_SERIAL, "RES (%d B): <%s>", (int)b.size(), hexbuf);
-        cmd.parseBuf(b, false);
+        LOGF_ERROR("RES <%s>", hexbuf);
+        return false;
     }
 
-    // Got the packet, process it
-    // n:length field >=3
-    // The buffer of n+2>=5 bytes contains:
-    // 0x3b <n>=3> <from> <to> <type> <n-3 bytes> <xsum>
+    buf[0] = 0x3b;
+    buf[1] = response_data_size + 1;
+    buf[2] = c.destination();
+    buf[3] = c.source();
+    buf[4] = c.command();
+
+    AUXBuffer b(buf, buf + (response_data_size + 5));
+    hex_dump(hexbuf, b, b.size());
+    DEBUGF(DBG_SERIAL, "RES (%d B): <%s>", (int)b.size(), hexbuf);
+    cmd.parseBuf(b, false);
 
-    DEBUGF(DBG_SERIAL, "Got %d bytes:  ; payload length field: %d ; MSG:", n, buf[1]);
-    logBytes(buf, n + 2, getDeviceName(), DBG_SERIAL);
     processResponse(cmd);
     return true;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Only the AUX/PC port handshake (half duplex) and the HC passthrough (responses
+/// without header) need strict command/response alternation.
+/////////////////////////////////////////////////////////////////////////////////////
+bool CelestronAUX::canPipeline() const
+{
+    if (getActiveConnection() != serialConnection)
+        return true;
+
+    return !m_IsRTSCTS && !m_isHandController;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 ///
 /////////////////////////////////////////////////////////////////////////////////////
-bool CelestronAUX::tcpReadResponse()
+void CelestronAUX::expectResponse(const AUXCommand &command)
 {
-    int n, i;
-    unsigned char buf[BUFFER_SIZE] = {0};
-    AUXCommand cmd;
+    // The response comes back from the target of the command
+    m_PendingResponses.push_back({command.destination(), command.source(), command.command()});
+}
 
-    // We are not connected. Nothing to do.
-    if ( PortFD <= 0 )
+/////////////////////////////////////////////////////////////////////////////////////
+/// Read packets as they arrive and dispatch them until all pending responses are in.
+/// Unsolicited packets (echoes, GPS requests from the HC) are processed on the way.
+/////////////////////////////////////////////////////////////////////////////////////
+bool CelestronAUX::waitForResponses(std::vector<AUXCommands> *missed)
+{
+    if (PortFD <= 0)
+    {
+        if (missed)
+            for (auto &pending : m_PendingResponses)
+                missed->push_back(pending.command);
+        m_PendingResponses.clear();
         return false;
+    }
 
-    timeval tv;
-    tv.tv_sec  = 0;
-    tv.tv_usec = 50000;
-    setsockopt(PortFD, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(struct timeval));
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(static_cast<int>(AUXTimingNP[AUX_RESPONSE_TIMEOUT].getValue()));
+    uint8_t buf[BUFFER_SIZE];
+    AUXBuffer packet;
 
-    // Drain the channel
-    while ((n = recv(PortFD, buf, sizeof(buf), MSG_DONTWAIT | MSG_PEEK)) > 0)
-    {
-        //        DEBUGF(DBG_CAUX, "Got %d bytes: ", n);
-        //        for (i = 0; i < n; i++)
-        //            IDLog("%02x ", buf[i]);
+    // PC port behaves as half duplex, RTS off to receive.
+    if (m_IsRTSCTS)
+        setRTS(0);
 
-        for (i = 0; i < n;)
+    while (!m_PendingResponses.empty())
+    {
+        while (m_AUXParser.next(packet))
         {
-            if (buf[i] == 0x3b)
-            {
-                int shft;
-                shft = i + buf[i + 1] + 3;
-                if (shft <= n)
-                {
-                    AUXBuffer b(buf + i, buf + shft);
-                    cmd.parseBuf(b);
-
-                    char hexbuf[32 * 3] = {0};
-                    hex_dump(hexbuf, b, b.size());
-                    DEBUGF(DBG_SERIAL, "RES <%s>", hexbuf);
+            char hexbuf[32 * 3] = {0};
+            hex_dump(hexbuf, packet, std::min<size_t>(packet.size(), 32));
+            DEBUGF(DBG_SERIAL, "RES <%s>", hexbuf);
 
-                    processResponse(cmd);
-                }
-                else
-                {
-                    DEBUGF(DBG_SERIAL, "Partial message recv. dropping (i=%d %d/%d)", i, shft, n);
-                    logBytes(buf + i, n - i, getDeviceName(), DBG_SERIAL);
-                    recv(PortFD, buf, n, MSG_DONTWAIT);
-                    break;
-                }
-                i = shft;
-            }
-            else
+            AUXCommand cmd(packet);
+            auto match = std::find_if(m_PendingResponses.begin(), m_PendingResponses.end(),
+                                      [&cmd](const AUXPendingResponse & pending)
             {
-                i++;
-            }
+                return pending.source == cmd.source() && pending.destination == cmd.destination() &&
+                       pending.command == cmd.command();
+            });
+            if (match != m_PendingResponses.end())
+                m_PendingResponses.erase(match);
+
+            processResponse(cmd);
         }
-        // Actually consume data we parsed. Leave the rest for later.
-        if (i > 0)
+
+        if (m_PendingResponses.empty())
+            break;
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+            break;
+
+        pollfd pfd {PortFD, POLLIN, 0};
+        int rc = poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            break;
+
+        ssize_t n = read(PortFD, buf, sizeof(buf));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN))
+            continue;
+        if (n <= 0)
         {
-            n = recv(PortFD, buf, i, MSG_DONTWAIT);
-            //DEBUGF(DBG_CAUX, "Consumed %d/%d bytes", n, i);
+            LOGF_ERROR("AUX read error: %s", n == 0 ? "connection closed" : strerror(errno));
+            break;
         }
+        m_AUXParser.feed(buf, n);
     }
-    return true;
+
+    if (m_PendingResponses.empty())
+        return true;
+
+    for (auto &pending : m_PendingResponses)
+    {
+        DEBUGF(DBG_CAUX, "No response to 0x%02x from 0x%02x.", pending.command, pending.source);
+        if (missed)
+            missed->push_back(pending.command);
+    }
+    m_PendingResponses.clear();
+    return false;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Move bytes already received into the frame parser without waiting, so late responses and
+/// other bus traffic are still dispatched by the next waitForResponses().
+/////////////////////////////////////////////////////////////////////////////////////
+void CelestronAUX::drainAUXInput()
+{
+    uint8_t buf[BUFFER_SIZE];
+    pollfd pfd {PortFD, POLLIN, 0};
+    while (PortFD > 0 && poll(&pfd, 1, 0) > 0)
+    {
+        ssize_t n = read(PortFD, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        m_AUXParser.feed(buf, n);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////////////
+void CelestronAUX::resetAUXStream()
+{
+    if (PortFD > 0 && getActiveConnection() == serialConnection)
+        tcflush(PortFD, TCIOFLUSH);
+    m_AUXParser.reset();
+    m_PendingResponses.clear();
+}
 
 /////////////////////////////////////////////////////////////////////////////////////
 ///
 /////////////////////////////////////////////////////////////////////////////////////
 bool CelestronAUX::readAUXResponse(AUXCommand c)
 {
-    if (getActiveConnection() == serialConnection)
-        return serialReadResponse(c);
+    if (getActiveConnection() == serialConnection && !m_IsRTSCTS && m_isHandController)
+        return passthroughReadResponse(c);
+
+    expectResponse(c);
+    return waitForResponses();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////////////
+bool CelestronAUX::sendAUXCommands(std::vector<AUXCommand> &commands, std::vector<AUXCommands> *missed)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool rc = true;
+    size_t sent = 0;
+
+    if (canPipeline())
+    {
+        for (; sent < commands.size(); sent++)
+        {
+            if (!sendAUXCommand(commands[sent]))
+            {
+                rc = false;
+                break;
+            }
+            expectResponse(commands[sent]);
+        }
+        // Collect whatever was sent even if a write failed
+        rc = waitForResponses(missed) && rc;
+    }
     else
-        return tcpReadResponse();
+    {
+        for (; sent < commands.size(); sent++)
+        {
+            if (!sendAUXCommand(commands[sent]))
+            {
+                rc = false;
+                break;
+            }
+            // Each command stands on its own, a missing response does not stop the batch
+            if (!readAUXResponse(commands[sent]))
+            {
+                rc = false;
+                if (missed)
+                    missed->push_back(commands[sent].command());
+            }
+        }
+    }
+
+    // Commands after a failed write were never sent
+    if (missed)
+        for (size_t i = sent; i < commands.size(); i++)
+            missed->push_back(commands[i].command());
+
+    DEBUGF(DBG_CAUX, "%d commands completed in %.1f ms", static_cast<int>(commands.size()),
+           std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return rc;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3282,10 +3392,15 @@ int CelestronAUX::sendBuffer(AUXBuffer buf)
     {
         int n;
 
+        // Some adapters lose packets written back to back, space them out if configured.
+        auto gap = std::chrono::milliseconds(static_cast<int>(AUXTimingNP[AUX_FRAME_GAP].getValue()));
+        if (gap.count() > 0)
+            std::this_thread::sleep_until(m_LastFrameTime + gap);
+
         if (aux_tty_write((char*)buf.data(), buf.size(), CTS_TIMEOUT, &n) != TTY_OK)
             return 0;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        m_LastFrameTime = std::chrono::steady_clock::now();
         if (n == -1)
             LOG_ERROR("CAUX::sendBuffer");
         if ((unsigned)n != buf.size())
@@ -3310,8 +3425,14 @@ bool CelestronAUX::sendAUXCommand(AUXCommand &command)
     command.logCommand();
 
     if (m_IsRTSCTS || !m_isHandController || getActiveConnection() != serialConnection)
+    {
         // Direct connection (AUX/PC/USB port)
         command.fillBuf(buf);
+
+        // The half duplex PC port echoes what is written, bytes already waiting would be taken for the echo.
+        if (m_IsRTSCTS && getActiveConnection() == serialConnection)
+            drainAUXInput();
+    }
     else
     {
         // connection is through HC serial and destination is not HC,
@@ -3331,9 +3452,11 @@ bool CelestronAUX::sendAUXCommand(AUXCommand &command)
             buf[i + 4] = command.data()[i];
         }
         buf[7] = response_data_size = command.responseDataSize();
+
+        // Passthrough responses carry no header, anything left over would be taken for this response.
+        tcflush(PortFD, TCIFLUSH);
     }
 
-    tcflush(PortFD, TCIOFLUSH);
     return (sendBuffer(buf) == static_cast<int>(buf.size()));
 }
 
@@ -3493,7 +3616,8 @@ int CelestronAUX::aux_tty_write(char *buf, int bufsiz, float timeout, int *n)
     if (m_IsRTSCTS)
     {
         DEBUG(DBG_SERIAL, "aux_tty_write: clear RTS");
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        tcdrain(PortFD);
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(AUXTimingNP[AUX_RTS_TURNAROUND].getValue())));
         setRTS(0);
 
         // ports requiring hardware flow control echo all sent characters,
@@ -39,6 +39,10 @@
 #include <pid.h>
 #include <termios.h>
 
+#include <chrono>
+#include <deque>
+#include <vector>
+
 #include "auxproto.h"
 
 class CelestronAUX :
@@ -312,13 +316,26 @@ class CelestronAUX :
         /// Auxiliary Command Communication
         /////////////////////////////////////////////////////////////////////////////////////
         bool sendAUXCommand(AUXCommand &command);
+        /**
+         * @brief sendAUXCommands Send a batch of commands and wait for all their responses.
+         * @note On full duplex links all commands are written back to back and the responses are
+         * collected afterwards. Half duplex and hand controller links send one command at a time.
+         * @param missed if not null, receives the ids of the commands that could not be sent or got no response.
+         */
+        bool sendAUXCommands(std::vector<AUXCommand> &commands, std::vector<AUXCommands> *missed = nullptr);
         void closeConnection();
         void emulateGPS(AUXCommand &m);
-        bool serialReadResponse(AUXCommand c);
-        bool tcpReadResponse();
+        bool passthroughReadResponse(AUXCommand c);
         bool readAUXResponse(AUXCommand c);
         bool processResponse(AUXCommand &cmd);
         int sendBuffer(AUXBuffer buf);
+
+        // Response matching
+        bool canPipeline() const;
+        void expectResponse(const AUXCommand &command);
+        bool waitForResponses(std::vector<AUXCommands> *missed = nullptr);
+        void drainAUXInput();
+        void resetAUXStream();
         void formatModelString(char *s, int n, uint16_t model);
         void formatVersionString(char *s, int n, uint8_t *verBuf);
 
@@ -373,6 +390,17 @@ class CelestronAUX :
         bool m_IsRTSCTS {false};
         bool m_isHandController {false};
 
+        // Responses still owed by the mount, matched by source, destination and command id
+        struct AUXPendingResponse
+        {
+            AUXTargets source;
+            AUXTargets destination;
+            AUXCommands command;
+        };
+        std::deque<AUXPendingResponse> m_PendingResponses;
+        AUXFrameParser m_AUXParser;
+        std::chrono::steady_clock::time_point m_LastFrameTime;
+
         ///////////////////////////////////////////////////////////////////////////////
         /// Celestron AUX Properties
         ///////////////////////////////////////////////////////////////////////////////
@@ -443,6 +471,15 @@ class CelestronAUX :
 
         int m_ConfigPortType {PORT_AUX_PC};
 
+        // AUX link timing
+        INDI::PropertyNumber AUXTimingNP {3};
+        enum
+        {
+            AUX_RESPONSE_TIMEOUT,
+            AUX_FRAME_GAP,
+            AUX_RTS_TURNAROUND,
+        };
+
         // Home/Level
         INDI::PropertySwitch HomeSP {3};
         enum
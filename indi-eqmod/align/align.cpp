@@ -397,10 +397,9 @@ void Align::AlignNearest(double jd, INDI::IGeographicCoordinates *position, doub
     //double pointaz = (pointset->range24(lst - currentRA - 12.0) * 360.0) / 24.0;
     //double pointalt = currentDEC + pointset->lat;
     double pointaz, pointalt;
-    std::set<PointSet::Distance, bool (*)(PointSet::Distance, PointSet::Distance)> *sortedpoints;
     pointset->AltAzFromRaDec(currentRA, currentDEC, jd, &pointalt, &pointaz, position);
-    sortedpoints = pointset->ComputeDistances(pointalt, pointaz, PointSet::None, ingoto);
-    if (sortedpoints->empty())
+    PointSet::Point *point = pointset->findNearest(pointalt, pointaz, ingoto);
+    if (point == nullptr)
     {
         *alignedRA  = currentRA;
         *alignedDEC = currentDEC;
@@ -408,7 +407,6 @@ void Align::AlignNearest(double jd, INDI::IGeographicCoordinates *position, doub
     }
     else
     {
-        PointSet::Point *point = pointset->getPoint(sortedpoints->begin()->htmID);
         if (lastnearestindex != point->index)
             LOGF_INFO("Align: current point is %d\n", point->index);
         lastnearestindex = point->index;
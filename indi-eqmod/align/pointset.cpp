@@ -24,6 +24,7 @@
 #include <libnova/sidereal_time.h>
 #include <libnova/transform.h>
 
+#include <algorithm>
 #include <math.h>
 #include <string.h>
 #include <wordexp.h>
@@ -111,9 +112,59 @@ double sphere_unit_distance(double theta1, double theta2, double phi1, double ph
                       (sqrt_haversin_long * sqrt_haversin_long))));
 }
 
-bool compelt(PointSet::Distance d1, PointSet::Distance d2)
+/* Unit vector of an alt/az position, same convention as the point coordinates */
+static void unit_vector(double alt, double az, double *v)
 {
-    return d1.value < d2.value;
+    double horangle = range360(-180.0 - az) * M_PI / 180.0;
+    double altangle = alt * M_PI / 180.0;
+    v[0]            = cos(altangle) * cos(horangle);
+    v[1]            = cos(altangle) * sin(horangle);
+    v[2]            = sin(altangle);
+}
+
+/* The chord length grows with the great circle distance, so the closest vector is also the closest point */
+template <typename Node>
+static void kdtree_build(Node *begin, Node *end, int axis)
+{
+    if (end - begin < 2)
+        return;
+    Node *median = begin + (end - begin) / 2;
+    std::nth_element(begin, median, end, [axis](const Node &a, const Node &b)
+    {
+        return a.v[axis] < b.v[axis];
+    });
+    kdtree_build(begin, median, (axis + 1) % 3);
+    kdtree_build(median + 1, end, (axis + 1) % 3);
+}
+
+template <typename Node>
+static void kdtree_nearest(const Node *begin, const Node *end, int axis, const double *v, const Node **best,
+                           double *bestd2)
+{
+    if (begin >= end)
+        return;
+    const Node *median = begin + (end - begin) / 2;
+    double dx = median->v[0] - v[0], dy = median->v[1] - v[1], dz = median->v[2] - v[2];
+    double d2 = dx * dx + dy * dy + dz * dz;
+    if (d2 < *bestd2)
+    {
+        *bestd2 = d2;
+        *best   = median;
+    }
+    double delta = v[axis] - median->v[axis];
+    int next     = (axis + 1) % 3;
+    if (delta < 0)
+    {
+        kdtree_nearest(begin, median, next, v, best, bestd2);
+        if (delta * delta < *bestd2)
+            kdtree_nearest(median + 1, end, next, v, best, bestd2);
+    }
+    else
+    {
+        kdtree_nearest(median + 1, end, next, v, best, bestd2);
+        if (delta * delta < *bestd2)
+            kdtree_nearest(begin, median, next, v, best, bestd2);
+    }
 }
 
 PointSet::PointSet(INDI::Telescope *t)
@@ -128,36 +179,43 @@ const char *PointSet::getDeviceName()
     return telescope->getDeviceName();
 }
 
-std::set<PointSet::Distance, bool (*)(PointSet::Distance, PointSet::Distance)> *
-PointSet::ComputeDistances(double alt, double az, PointFilter filter, bool ingoto)
+void PointSet::BuildIndex(std::vector<IndexNode> &index, bool ingoto)
 {
-    INDI_UNUSED(filter);
     std::map<HtmID, Point>::iterator it;
-    std::set<Distance, bool (*)(Distance, Distance)> *distances =
-        new std::set<Distance, bool (*)(Distance, Distance)>(compelt);
-    std::set<Distance>::iterator distit;
-    std::pair<std::set<Distance>::iterator, bool> ret;
-    /* IDLog("Compute distances for point alt=%f az=%f\n", alt, az);*/
+
+    index.clear();
+    index.reserve(PointSetMap->size());
     for (it = PointSetMap->begin(); it != PointSetMap->end(); it++)
     {
-        double d;
-        if (ingoto)
-            d = sphere_unit_distance(az, (*it).second.celestialAZ, alt, (*it).second.celestialALT);
-        else
-            d = sphere_unit_distance(az, (*it).second.telescopeAZ, alt, (*it).second.telescopeALT);
-        Distance elt;
-        elt.htmID = (*it).first;
-        elt.value = d;
-        ret       = distances->insert(elt);
-        /*IDLog("  Point %lld (alt=%f az=%f): distance %f \n",  elt.htmID, (*it).second.celestialALT, (*it).second.celestialAZ, elt.value);*/
+        IndexNode node;
+        node.htmID = (*it).first;
+        node.v[0]  = ingoto ? (*it).second.cx : (*it).second.tx;
+        node.v[1]  = ingoto ? (*it).second.cy : (*it).second.ty;
+        node.v[2]  = ingoto ? (*it).second.cz : (*it).second.tz;
+        index.push_back(node);
     }
-    /*
-    IDLog("  Ordered distances for point alt=%f az=%f\n", alt, az);
-    for ( distit=distances->begin() ; distit != distances->end(); distit++ ) {
-    IDLog("  Point %lld: distance %f \n",  distit->htmID, distit->value);
+    kdtree_build(index.data(), index.data() + index.size(), 0);
+}
+
+PointSet::Point *PointSet::findNearest(double alt, double az, bool ingoto)
+{
+    if (!indexValid)
+    {
+        BuildIndex(celestialIndex, true);
+        BuildIndex(telescopeIndex, false);
+        indexValid = true;
     }
-    */
-    return distances;
+
+    std::vector<IndexNode> &index = ingoto ? celestialIndex : telescopeIndex;
+    if (index.empty())
+        return nullptr;
+
+    double v[3];
+    const IndexNode *best = nullptr;
+    double bestd2         = 5.0; // larger than the largest squared chord, 4
+    unit_vector(alt, az, v);
+    kdtree_nearest(index.data(), index.data() + index.size(), 0, v, &best, &bestd2);
+    return getPoint(best->htmID);
 }
 
 void PointSet::AddPoint(AlignData aligndata, INDI::IGeographicCoordinates *pos)
@@ -197,7 +255,10 @@ void PointSet::AddPoint(AlignData aligndata, INDI::IGeographicCoordinates *pos)
     cc_ID2name(point.htmname, point.htmID);
     point.index = getNbPoints();
     PointSetMap->insert(std::pair<HtmID, Point>(point.htmID, point));
+    indexValid = false;
     Triangulation->AddPoint(point.htmID);
+    // Face indices refer to the previous triangulation
+    currentFace = -1;
     LOGF_INFO("Align Pointset: added point %d alt = %g az = %g\n", point.index,
               point.celestialALT, point.celestialAZ);
     LOGF_INFO("Align Triangulate: number of faces is %d\n", Triangulation->getFaces().size());
@@ -235,6 +296,8 @@ void PointSet::Init()
 void PointSet::Reset()
 {
     current.clear();
+    currentFace = -1;
+    indexValid  = false;
     if (PointSetMap)
     {
         PointSetMap->clear();
@@ -315,6 +378,10 @@ char *PointSet::LoadDataFile(const char *filename)
     lnalignpos->longitude = lon;
     lnalignpos->latitude = lat;
     PointSetMap->clear();
+    Triangulation->Reset();
+    current.clear();
+    currentFace = -1;
+    indexValid  = false;
     alignxml     = nextXMLEle(sitexml, 1);
     aligndata.jd = -1.0;
     while (alignxml)
@@ -491,26 +558,35 @@ double PointSet::scalarTripleProduct(Point *p, Point *e1, Point *e2, bool ingoto
     return res;
 }
 
-bool PointSet::isPointInside(Point *p, std::vector<HtmID> f, bool ingoto)
+bool PointSet::isPointInside(Point *p, const std::vector<HtmID> &f, bool ingoto)
+{
+    if (f.size() < 3)
+        return false;
+    Face face(f[0], f[1], f[2]);
+    face.p[0] = &PointSetMap->at(f[0]);
+    face.p[1] = &PointSetMap->at(f[1]);
+    face.p[2] = &PointSetMap->at(f[2]);
+    return isPointInside(p, face, ingoto);
+}
+
+bool PointSet::isPointInside(Point *p, const Face &f, bool ingoto)
 {
     double r;
     bool left  = false;
     bool right = false;
-    if (f.size() < 3)
-        return false;
-    r = scalarTripleProduct(p, &PointSetMap->at(f[2]), &PointSetMap->at(f[0]), ingoto);
+    r = scalarTripleProduct(p, f.p[2], f.p[0], ingoto);
     if (r < 0)
         left = true;
     else
         right = true;
-    r = scalarTripleProduct(p, &PointSetMap->at(f[0]), &PointSetMap->at(f[1]), ingoto);
+    r = scalarTripleProduct(p, f.p[0], f.p[1], ingoto);
     if (r < 0)
         left = true;
     else
         right = true;
     if (left && right)
         return false;
-    r = scalarTripleProduct(p, &PointSetMap->at(f[1]), &PointSetMap->at(f[2]), ingoto);
+    r = scalarTripleProduct(p, f.p[1], f.p[2], ingoto);
     if (r < 0)
         left = true;
     else
@@ -520,15 +596,46 @@ bool PointSet::isPointInside(Point *p, std::vector<HtmID> f, bool ingoto)
     return true;
 }
 
+/* Walk from face to face towards p, crossing the edge p lies beyond. Returns -1 when the walk leaves
+   the triangulation, which does not need to be convex, the caller then falls back to a full scan. */
+int PointSet::WalkToFace(Point *p, int start, bool ingoto)
+{
+    const std::vector<Face> &faces = Triangulation->getFaces();
+    int f                          = start;
+
+    for (size_t step = 0; f >= 0 && step < faces.size(); step++)
+    {
+        const Face &face = faces[f];
+        if (isPointInside(p, face, ingoto))
+            return f;
+
+        int next = -1;
+        for (int e = 0; e < 3 && next < 0; e++)
+        {
+            Point *a = face.p[e], *b = face.p[(e + 1) % 3], *c = face.p[(e + 2) % 3];
+            // Opposite vertex as seen from the edge, in the coordinates the test uses
+            Point side = *c;
+            if (!ingoto)
+            {
+                side.cx = c->tx;
+                side.cy = c->ty;
+                side.cz = c->tz;
+            }
+            if (scalarTripleProduct(p, a, b, ingoto) * scalarTripleProduct(&side, a, b, ingoto) < 0)
+                next = face.neighbour[e];
+        }
+        f = next;
+    }
+    return -1;
+}
+
 std::vector<HtmID> PointSet::findFace(double currentRA, double currentDEC, double jd, double pointalt, double pointaz,
                                       INDI::IGeographicCoordinates *position, bool ingoto)
 {
     INDI_UNUSED(pointalt);
     INDI_UNUSED(pointaz);
     Point point;
-    double horangle = 0, altangle = 0;
-    std::vector<Face *> faces;
-    std::vector<Face *>::iterator it;
+    int found = -1;
 
     point.aligndata.jd        = jd;
     point.aligndata.targetRA  = currentRA;
@@ -536,30 +643,45 @@ std::vector<HtmID> PointSet::findFace(double currentRA, double currentDEC, doubl
     AltAzFromRaDec(point.aligndata.targetRA, point.aligndata.targetDEC, point.aligndata.jd, &point.celestialALT,
                    &point.celestialAZ, position);
 
-    horangle = range360(-180.0 - point.celestialAZ) * M_PI / 180.0;
-    altangle = point.celestialALT * M_PI / 180.0;
-    point.cx = cos(altangle) * cos(horangle);
-    point.cy = cos(altangle) * sin(horangle);
-    point.cz = sin(altangle);
+    double v[3];
+    unit_vector(point.celestialALT, point.celestialAZ, v);
+    point.cx = v[0];
+    point.cy = v[1];
+    point.cz = v[2];
 
-    if (Triangulation->isValid() && isPointInside(&point, current, ingoto))
-        return current;
-    faces = Triangulation->getFaces();
-    it    = faces.begin();
-    while (it < faces.end())
+    // currentFace is reset whenever the faces are rebuilt, see AddPoint
+    const std::vector<Face> &faces = Triangulation->getFaces();
+
+    if (!faces.empty())
     {
-        if (isPointInside(&point, (*it)->v, ingoto))
+        // Start from the last face found, or from a face of the closest point
+        int start = currentFace;
+        if (start < 0)
         {
-            currentFace = *it;
-            current     = (*it)->v;
-            LOGF_INFO("Align: current face is {%d, %d, %d}", PointSetMap->at(current[0]).index,
-                      PointSetMap->at(current[1]).index, PointSetMap->at(current[2]).index);
-            return current;
+            Point *nearest = findNearest(point.celestialALT, point.celestialAZ, ingoto);
+            start          = nearest ? Triangulation->getVertexFace(nearest->htmID) : -1;
         }
-        it++;
+        if (start >= 0)
+            found = WalkToFace(&point, start, ingoto);
+        for (size_t i = 0; found < 0 && i < faces.size(); i++)
+        {
+            if (isPointInside(&point, faces[i], ingoto))
+                found = i;
+        }
+    }
+
+    if (found >= 0)
+    {
+        if (found != currentFace)
+            LOGF_INFO("Align: current face is {%d, %d, %d}", faces[found].p[0]->index, faces[found].p[1]->index,
+                      faces[found].p[2]->index);
+        currentFace = found;
+        current.assign(faces[found].v, faces[found].v + 3);
+        return current;
     }
     if (current.size() > 0)
         LOG_INFO("Align: current face is empty");
+    currentFace = -1;
     current.clear();
     return current;
 }
@@ -75,8 +75,8 @@ class PointSet
 
         void setPointBlobData(IBLOB *blob);
         void setTriangulationBlobData(IBLOB *blob);
-        std::set<Distance, bool (*)(Distance, Distance)> *ComputeDistances(double alt, double az, PointFilter filter,
-                bool ingoto);
+        // Closest sync point to alt/az, in celestial (ingoto) or telescope coordinates. nullptr if the set is empty.
+        Point *findNearest(double alt, double az, bool ingoto);
         std::vector<HtmID> findFace(double currentRA, double currentDEC, double jd, double pointalt, double pointaz,
                                     INDI::IGeographicCoordinates *position, bool ingoto);
         double lat, lon, alt;
@@ -84,16 +84,28 @@ class PointSet
         void AltAzFromRaDecSidereal(double ra, double dec, double lst, double *alt, double *az, INDI::IGeographicCoordinates *pos);
         void RaDecFromAltAz(double alt, double az, double jd, double *ra, double *dec, INDI::IGeographicCoordinates *pos);
         double scalarTripleProduct(Point *p, Point *e1, Point *e2, bool ingoto);
-        bool isPointInside(Point *p, std::vector<HtmID> f, bool ingoto);
+        bool isPointInside(Point *p, const std::vector<HtmID> &f, bool ingoto);
+        bool isPointInside(Point *p, const Face &f, bool ingoto);
 
     protected:
     private:
+        // k-d tree of the unit vectors of the points, stored in place: the median of a range is its node
+        typedef struct IndexNode
+        {
+            double v[3];
+            HtmID htmID;
+        } IndexNode;
+        void BuildIndex(std::vector<IndexNode> &index, bool ingoto);
+        int WalkToFace(Point *p, int start, bool ingoto);
+
         XMLEle *PointSetXmlRoot;
         std::map<HtmID, Point> *PointSetMap;
         bool PointSetInitialized;
         TriangulateCHull *Triangulation;
-        Face *currentFace;
+        int currentFace {-1};
         std::vector<HtmID> current;
+        std::vector<IndexNode> celestialIndex, telescopeIndex;
+        bool indexValid {false};
         // to get access to lat/long data
         INDI::Telescope *telescope;
         // from align data file
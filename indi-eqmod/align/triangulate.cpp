@@ -17,6 +17,8 @@
 
 #include "triangulate.h"
 
+#include <algorithm>
+
 Triangulate::Triangulate(std::map<HtmID, PointSet::Point> *p)
 {
     pmap = p;
@@ -27,6 +29,7 @@ void Triangulate::Reset()
     isvalid = false;
     vvertices.clear();
     vfaces.clear();
+    vertexfaces.clear();
 }
 
 void Triangulate::AddPoint(HtmID id)
@@ -38,7 +41,7 @@ void Triangulate::AddPoint(HtmID id)
 XMLEle *Triangulate::toXML()
 {
     XMLEle *root;
-    std::vector<Face *>::iterator it;
+    std::vector<Face>::iterator it;
 
     root = addXMLEle(nullptr, "triangulation");
 
@@ -49,20 +52,20 @@ XMLEle *Triangulate::toXML()
         char pcdata[10];
         face   = addXMLEle(root, "face");
         vertex = addXMLEle(face, "vindex");
-        snprintf(pcdata, sizeof(pcdata), "%d", pmap->at((*it)->v[0]).index);
+        snprintf(pcdata, sizeof(pcdata), "%d", pmap->at(it->v[0]).index);
         editXMLEle(vertex, pcdata);
         vertex = addXMLEle(face, "vindex");
-        snprintf(pcdata, sizeof(pcdata), "%d", pmap->at((*it)->v[1]).index);
+        snprintf(pcdata, sizeof(pcdata), "%d", pmap->at(it->v[1]).index);
         editXMLEle(vertex, pcdata);
         vertex = addXMLEle(face, "vindex");
-        snprintf(pcdata, sizeof(pcdata), "%d", pmap->at((*it)->v[2]).index);
+        snprintf(pcdata, sizeof(pcdata), "%d", pmap->at(it->v[2]).index);
         editXMLEle(vertex, pcdata);
     }
 
     return (root);
 }
 
-std::vector<Face *> Triangulate::getFaces()
+const std::vector<Face> &Triangulate::getFaces()
 {
     isvalid = true;
     return vfaces;
@@ -72,3 +75,37 @@ bool Triangulate::isValid()
 {
     return isvalid;
 }
+
+int Triangulate::getVertexFace(HtmID id)
+{
+    std::map<HtmID, int>::iterator it = vertexfaces.find(id);
+    return (it == vertexfaces.end()) ? -1 : it->second;
+}
+
+void Triangulate::LinkFaces()
+{
+    // Each edge is shared by at most two faces, whatever their orientation
+    std::map<std::pair<HtmID, HtmID>, int> edges;
+
+    vertexfaces.clear();
+    for (size_t i = 0; i < vfaces.size(); i++)
+    {
+        Face &f = vfaces[i];
+        for (int e = 0; e < 3; e++)
+        {
+            HtmID a = f.v[e], b = f.v[(e + 1) % 3];
+            f.p[e]         = &pmap->at(a);
+            f.neighbour[e] = -1;
+            vertexfaces[a] = i;
+
+            std::pair<std::map<std::pair<HtmID, HtmID>, int>::iterator, bool> ret =
+                edges.insert(std::make_pair(std::make_pair(std::min(a, b), std::max(a, b)), i * 3 + e));
+            if (!ret.second)
+            {
+                int other = ret.first->second;
+                vfaces[other / 3].neighbour[other % 3] = i;
+                f.neighbour[e] = other / 3;
+            }
+        }
+    }
+}
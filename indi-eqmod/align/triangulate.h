@@ -22,31 +22,37 @@
 class Face
 {
   public:
-    Face(HtmID v0, HtmID v1, HtmID v2) : v(3, 0)
+    Face(HtmID v0, HtmID v1, HtmID v2)
     {
         v[0] = v0;
         v[1] = v1;
         v[2] = v2;
     }
-    std::vector<HtmID> v;
+    HtmID v[3];
+    // Vertices, and the face across the edge v[i] v[i + 1] (-1 on the border), set by LinkFaces
+    PointSet::Point *p[3] {nullptr, nullptr, nullptr};
+    int neighbour[3] {-1, -1, -1};
 };
 
 class Triangulate
 {
-    //  typedef struct Face {
-    //  HtmID v[3];
-    //} Face;
   public:
     Triangulate(std::map<HtmID, PointSet::Point> *p);
     virtual void Reset();
     virtual void AddPoint(HtmID id);
     virtual XMLEle *toXML();
-    virtual std::vector<Face *> getFaces();
+    virtual const std::vector<Face> &getFaces();
     virtual bool isValid();
+    // Index of a face having this vertex, -1 if none
+    int getVertexFace(HtmID id);
 
   protected:
+    void LinkFaces();
+
     std::map<HtmID, PointSet::Point> *pmap;
     std::vector<HtmID> vvertices;
-    std::vector<Face *> vfaces;
+    // Rebuilt in place on each insertion, the storage is kept
+    std::vector<Face> vfaces;
+    std::map<HtmID, int> vertexfaces;
     bool isvalid {false};
 };
@@ -90,11 +90,12 @@ void TriangulateCHull::AddPoint(HtmID id)
             f = f->next;
             continue;
         }
-        vfaces.push_back(new Face(vvertices.at(f->vertex[0]->vnum - 1), vvertices.at(f->vertex[1]->vnum - 1),
-                                  vvertices.at(f->vertex[2]->vnum - 1)));
+        vfaces.emplace_back(vvertices.at(f->vertex[0]->vnum - 1), vvertices.at(f->vertex[1]->vnum - 1),
+                            vvertices.at(f->vertex[2]->vnum - 1));
         //fprintf(stderr, "Triangulate addpoint: added face (%d total)\n", vfaces.size());
         f = f->next;
     } while (f != faces);
+    LinkFaces();
 }
 
 //XMLEle *TriangulateCHull::toXML()
@@ -320,6 +320,7 @@ void EQMod::ISGetProperties(const char *dev)
         defineProperty(SteppersNP);
         defineProperty(CurrentSteppersNP);
         defineProperty(PeriodsNP);
+        defineProperty(PollLatencyNP);
         defineProperty(JulianNP);
         defineProperty(TimeLSTNP);
         defineProperty(RAStatusLP);
@@ -400,6 +401,7 @@ bool EQMod::loadProperties()
     SteppersNP         = getNumber("STEPPERS");
     CurrentSteppersNP  = getNumber("CURRENTSTEPPERS");
     PeriodsNP          = getNumber("PERIODS");
+    PollLatencyNP      = getNumber("POLL_LATENCY");
     JulianNP           = getNumber("JULIAN");
     TimeLSTNP          = getNumber("TIME_LST");
     RAStatusLP         = getLight("RASTATUS");
@@ -504,6 +506,7 @@ bool EQMod::updateProperties()
         defineProperty(SteppersNP);
         defineProperty(CurrentSteppersNP);
         defineProperty(PeriodsNP);
+        defineProperty(PollLatencyNP);
         defineProperty(JulianNP);
         defineProperty(TimeLSTNP);
         defineProperty(RAStatusLP);
@@ -616,6 +619,7 @@ bool EQMod::updateProperties()
         deleteProperty(SteppersNP);
         deleteProperty(CurrentSteppersNP);
         deleteProperty(PeriodsNP);
+        deleteProperty(PollLatencyNP);
         deleteProperty(JulianNP);
         deleteProperty(TimeLSTNP);
         deleteProperty(RAStatusLP);
@@ -799,6 +803,7 @@ bool EQMod::ReadScopeStatus()
     const char *datenames[] = { "LST", "JULIANDATE", "UTC" };
     double periods[2];
     const char *periodsnames[] = { "RAPERIOD", "DEPERIOD" };
+    const char *latencynames[] = { "LAST", "AVERAGE", "QUERIES" };
     double horizvalues[2];
     const char *horiznames[2] = { "AZ", "ALT" };
     double steppervalues[2];
@@ -822,6 +827,21 @@ bool EQMod::ReadScopeStatus()
     try
     {
         TelescopePierSide pierSide;
+
+        // Encoders, motor status and aux encoders of both axes in one exchange
+        struct timespec starttime, endtime;
+        clock_gettime(CLOCK_MONOTONIC, &starttime);
+        int queries = mount->ReadAxesStatus();
+        clock_gettime(CLOCK_MONOTONIC, &endtime);
+        double latency =
+            (endtime.tv_sec - starttime.tv_sec) * 1000.0 + ((endtime.tv_nsec - starttime.tv_nsec) / 1000000.0);
+        double average = PollLatencyNP.findWidgetByName("AVERAGE")->getValue();
+        double latencyvalues[3] = { latency, average == 0.0 ? latency : 0.9 * average + 0.1 * latency,
+                                    static_cast<double>(queries) };
+        PollLatencyNP.update(latencyvalues, (char **)latencynames, 3);
+        PollLatencyNP.setState(IPS_OK);
+        PollLatencyNP.apply();
+
         currentRAEncoder = mount->GetRAEncoder();
         currentDEEncoder = mount->GetDEEncoder();
         DEBUGF(DBG_SCOPE_STATUS, "Current encoders RA=%ld DE=%ld", static_cast<long>(currentRAEncoder),
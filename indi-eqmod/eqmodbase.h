@@ -94,6 +94,7 @@ protected:
     INDI::PropertyNumber   SteppersNP          {INDI::Property()};
     INDI::PropertyNumber   CurrentSteppersNP   {INDI::Property()};
     INDI::PropertyNumber   PeriodsNP           {INDI::Property()};
+    INDI::PropertyNumber   PollLatencyNP       {INDI::Property()};
     INDI::PropertyNumber   JulianNP            {INDI::Property()};
     INDI::PropertyNumber   TimeLSTNP           {INDI::Property()};
     INDI::PropertyLight    RAStatusLP          {INDI::Property()};
@@ -55,6 +55,8 @@ void Skywatcher::setPortFD(int value)
 
 void Skywatcher::setSimulation(bool enable)
 {
+    if (enable != simulation)
+        mountCache = SkywatcherMountCache();
     simulation = enable;
 }
 bool Skywatcher::isSimulation()
@@ -83,6 +85,18 @@ bool Skywatcher::Handshake()
     tmpMCVersion = Revu24str2long(response + 1);
     MCVersion    = ((tmpMCVersion & 0xFF) << 16) | ((tmpMCVersion & 0xFF00)) | ((tmpMCVersion & 0xFF0000) >> 16);
     MountCode    = MCVersion & 0xFF;
+
+    // Values cached for another motor controller are no use
+    if (MCVersion != mountCache.MCVersion)
+    {
+        mountCache           = SkywatcherMountCache();
+        mountCache.MCVersion = MCVersion;
+    }
+    pipelineQueries  = true;
+    pipelineFailures = 0;
+    for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+        polledEncoder[axis] = polledStatus[axis] = polledAuxEncoder[axis] = false;
+
     /* Check supported mounts here */
     if ((MountCode == 0x80) || (MountCode == 0x81) /*|| (MountCode == 0x82)*/ || (MountCode == 0x90))
     {
@@ -112,18 +126,75 @@ bool Skywatcher::Disconnect()
     return true;
 }
 
-uint32_t Skywatcher::GetRAEncoder()
+int Skywatcher::ReadAxesStatus()
 {
-    // Axis Position
-    dispatch_command(GetAxisPosition, Axis1, nullptr);
+    SkywatcherQuery queries[6];
+    int count = 0;
+
+    for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+    {
+        queries[count].cmd    = GetAxisPosition;
+        queries[count++].axis = static_cast<SkywatcherAxis>(axis);
+        queries[count].cmd    = GetAxisStatus;
+        queries[count++].axis = static_cast<SkywatcherAxis>(axis);
+        if (HasAuxEncoders())
+        {
+            queries[count].cmd    = InquireAuxEncoder;
+            queries[count++].axis = static_cast<SkywatcherAxis>(axis);
+        }
+    }
+
+    dispatch_queries(queries, count);
 
-    uint32_t steps = Revu24str2long(response + 1);
+    for (int i = 0; i < count; i++)
+    {
+        SkywatcherAxis axis = queries[i].axis;
+        switch (queries[i].cmd)
+        {
+            case GetAxisPosition:
+                ParseEncoder(axis, queries[i].response);
+                polledEncoder[axis] = true;
+                break;
+            case GetAxisStatus:
+                ParseMotorStatus(axis, queries[i].response);
+                polledStatus[axis] = true;
+                break;
+            case InquireAuxEncoder:
+                AuxEncoder[axis]       = Revu24str2long(queries[i].response + 1);
+                polledAuxEncoder[axis] = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return count;
+}
+
+void Skywatcher::ParseEncoder(SkywatcherAxis axis, const char *reply)
+{
+    uint32_t steps = Revu24str2long((char *)reply + 1);
     if (steps & 0x80000000)
-        DEBUGF(telescope->DBG_SCOPE_STATUS, "%s() = Ignoring invalid response %s", __FUNCTION__, response);
-    else
+        DEBUGF(telescope->DBG_SCOPE_STATUS, "%s() = Ignoring invalid response %s", __FUNCTION__, reply);
+    else if (axis == Axis1)
         RAStep = steps;
+    else
+        DEStep = steps;
+
+    gettimeofday(&lastreadmotorposition[axis], nullptr);
+}
+
+uint32_t Skywatcher::GetRAEncoder()
+{
+    // Axis Position
+    if (polledEncoder[Axis1])
+        polledEncoder[Axis1] = false;
+    else
+    {
+        dispatch_command(GetAxisPosition, Axis1, nullptr);
+        ParseEncoder(Axis1, response);
+    }
 
-    gettimeofday(&lastreadmotorposition[Axis1], nullptr);
     if (RAStep != lastRAStep)
     {
         DEBUGF(telescope->DBG_SCOPE_STATUS, "%s() = %ld", __FUNCTION__, static_cast<long>(RAStep));
@@ -135,14 +206,14 @@ uint32_t Skywatcher::GetRAEncoder()
 uint32_t Skywatcher::GetDEEncoder()
 {
     // Axis Position
-    dispatch_command(GetAxisPosition, Axis2, nullptr);
-
-    uint32_t steps = Revu24str2long(response + 1);
-    if (steps & 0x80000000)
-        DEBUGF(telescope->DBG_SCOPE_STATUS, "%s() = Ignoring invalid response %s", __FUNCTION__, response);
+    if (polledEncoder[Axis2])
+        polledEncoder[Axis2] = false;
     else
-        DEStep = steps;
-    gettimeofday(&lastreadmotorposition[Axis2], nullptr);
+    {
+        dispatch_command(GetAxisPosition, Axis2, nullptr);
+        ParseEncoder(Axis2, response);
+    }
+
     if (DEStep != lastDEStep)
     {
         DEBUGF(telescope->DBG_SCOPE_STATUS, "%s() = %ld", __FUNCTION__, static_cast<long>(DEStep));
@@ -226,7 +297,7 @@ uint32_t Skywatcher::GetlastreadDEIndexer()
 // deprecated
 void Skywatcher::GetRAMotorStatus(ILightVectorProperty *motorLP)
 {
-    ReadMotorStatus(Axis1);
+    UsePolledMotorStatus(Axis1);
     if (!RAInitialized)
     {
         IUFindLight(motorLP, "RAInitialized")->s = IPS_ALERT;
@@ -247,7 +318,7 @@ void Skywatcher::GetRAMotorStatus(ILightVectorProperty *motorLP)
 
 void Skywatcher::GetRAMotorStatus(INDI::PropertyLight motorLP)
 {
-    ReadMotorStatus(Axis1);
+    UsePolledMotorStatus(Axis1);
     if (!RAInitialized)
     {
         motorLP.findWidgetByName("RAInitialized")->setState(IPS_ALERT);
@@ -269,7 +340,7 @@ void Skywatcher::GetRAMotorStatus(INDI::PropertyLight motorLP)
 // deprecated
 void Skywatcher::GetDEMotorStatus(ILightVectorProperty *motorLP)
 {
-    ReadMotorStatus(Axis2);
+    UsePolledMotorStatus(Axis2);
     if (!DEInitialized)
     {
         IUFindLight(motorLP, "DEInitialized")->s = IPS_ALERT;
@@ -290,7 +361,7 @@ void Skywatcher::GetDEMotorStatus(ILightVectorProperty *motorLP)
 
 void Skywatcher::GetDEMotorStatus(INDI::PropertyLight motorLP)
 {
-    ReadMotorStatus(Axis2);
+    UsePolledMotorStatus(Axis2);
     if (!DEInitialized)
     {
         motorLP.findWidgetByName("DEInitialized")->setState(IPS_ALERT);
@@ -587,6 +658,17 @@ void Skywatcher::InquireBoardVersion(char **boardinfo)
 void Skywatcher::InquireFeatures()
 {
     uint32_t rafeatures = 0, defeatures = 0;
+
+    if (mountCache.hasFeatures)
+    {
+        // PPEC state is not cached, it is read again by GetPPECStatus
+        SetFeatures(Axis1, mountCache.features[Axis1]);
+        SetFeatures(Axis2, mountCache.features[Axis2]);
+        LOGF_DEBUG("%s(): using cached features RA %x DE %x", __FUNCTION__, mountCache.features[Axis1],
+                   mountCache.features[Axis2]);
+        return;
+    }
+
     try
     {
         GetFeature(Axis1, GET_FEATURES_CMD);
@@ -614,26 +696,29 @@ void Skywatcher::InquireFeatures()
     {
         LOGF_WARN("%s(): Found DE PPEC training on", __FUNCTION__);
     }
-    AxisFeatures[Axis1].inPPECTraining         = rafeatures & 0x00000010;
-    AxisFeatures[Axis1].inPPEC                 = rafeatures & 0x00000020;
-    AxisFeatures[Axis1].hasEncoder             = rafeatures & 0x00000001;
-    AxisFeatures[Axis1].hasPPEC                = rafeatures & 0x00000002;
-    AxisFeatures[Axis1].hasHomeIndexer         = rafeatures & 0x00000004;
-    AxisFeatures[Axis1].isAZEQ                 = rafeatures & 0x00000008;
-    AxisFeatures[Axis1].hasPolarLed            = rafeatures & 0x00001000;
-    AxisFeatures[Axis1].hasCommonSlewStart     = rafeatures & 0x00002000; // supports :J3
-    AxisFeatures[Axis1].hasHalfCurrentTracking = rafeatures & 0x00004000;
-    AxisFeatures[Axis1].hasWifi                = rafeatures & 0x00008000;
-    AxisFeatures[Axis2].inPPECTraining         = defeatures & 0x00000010;
-    AxisFeatures[Axis2].inPPEC                 = defeatures & 0x00000020;
-    AxisFeatures[Axis2].hasEncoder             = defeatures & 0x00000001;
-    AxisFeatures[Axis2].hasPPEC                = defeatures & 0x00000002;
-    AxisFeatures[Axis2].hasHomeIndexer         = defeatures & 0x00000004;
-    AxisFeatures[Axis2].isAZEQ                 = defeatures & 0x00000008;
-    AxisFeatures[Axis2].hasPolarLed            = defeatures & 0x00001000;
-    AxisFeatures[Axis2].hasCommonSlewStart     = defeatures & 0x00002000; // supports :J3
-    AxisFeatures[Axis2].hasHalfCurrentTracking = defeatures & 0x00004000;
-    AxisFeatures[Axis2].hasWifi                = defeatures & 0x00008000;
+    AxisFeatures[Axis1].inPPECTraining = rafeatures & 0x00000010;
+    AxisFeatures[Axis1].inPPEC         = rafeatures & 0x00000020;
+    AxisFeatures[Axis2].inPPECTraining = defeatures & 0x00000010;
+    AxisFeatures[Axis2].inPPEC         = defeatures & 0x00000020;
+    SetFeatures(Axis1, rafeatures);
+    SetFeatures(Axis2, defeatures);
+
+    // A mount without the features command is not asked again on reconnection either
+    mountCache.features[Axis1] = rafeatures;
+    mountCache.features[Axis2] = defeatures;
+    mountCache.hasFeatures     = true;
+}
+
+void Skywatcher::SetFeatures(SkywatcherAxis axis, uint32_t features)
+{
+    AxisFeatures[axis].hasEncoder             = features & 0x00000001;
+    AxisFeatures[axis].hasPPEC                = features & 0x00000002;
+    AxisFeatures[axis].hasHomeIndexer         = features & 0x00000004;
+    AxisFeatures[axis].isAZEQ                 = features & 0x00000008;
+    AxisFeatures[axis].hasPolarLed            = features & 0x00001000;
+    AxisFeatures[axis].hasCommonSlewStart     = features & 0x00002000; // supports :J3
+    AxisFeatures[axis].hasHalfCurrentTracking = features & 0x00004000;
+    AxisFeatures[axis].hasWifi                = features & 0x00008000;
 }
 
 bool Skywatcher::HasHomeIndexers()
@@ -729,44 +814,60 @@ void Skywatcher::InquireEncoderInfo(SkywatcherAxis axis, double *steppersvalues)
       HighspeedRatio = &DEHighspeedRatio;
     }
 
-    // Steps per 360 degrees
-    dispatch_command(InquireGridPerRevolution, axis, nullptr);
-    //read_eqmod();
-    *Steps360        = Revu24str2long(response + 1);
-
-    // Steps per Worm
-    dispatch_command(InquireTimerInterruptFreq, axis, nullptr);
-    //read_eqmod();
-    *StepsWorm = Revu24str2long(response + 1);
-    // There is a bug in the earlier version firmware(Before 2.00) of motor controller MC001.
-    // Overwrite the GearRatio reported by the MC for 80GT mount and 114GT mount.
-    if ((MCVersion & 0x0000FF) == 0x80)
-    {
-        LOGF_WARN("%s: forcing %sStepsWorm for 80GT Mount (%x in place of %x)", __FUNCTION__,
-                  axis == Axis1 ? "RA" : "DE", 0x162B97, *StepsWorm);
-        *StepsWorm = 0x162B97; // for 80GT mount
-    }
-    if ((MCVersion & 0x0000FF) == 0x82)
+    // Grid, timer frequency and high speed ratio are fixed for a motor controller
+    if (mountCache.hasEncoderInfo[axis])
     {
-        LOGF_WARN("%s: forcing %sStepsWorm for 114GT Mount (%x in place of %x)", __FUNCTION__,
-                  axis == Axis1 ? "RA" : "DE", 0x205318, *StepsWorm);
-        *StepsWorm = 0x205318; // for 114GT mount
+        *Steps360       = mountCache.Steps360[axis];
+        *StepsWorm      = mountCache.StepsWorm[axis];
+        *HighspeedRatio = mountCache.HighspeedRatio[axis];
+        LOGF_DEBUG("%s: using cached %s encoder info", __FUNCTION__, axis == Axis1 ? "RA" : "DE");
     }
-    // HEQ5 with firmware 106, use same rate as RA
-    // drift correction = 1.00455,  64935/1.00455 = 64640 = 0xFC80
-    if (MCVersion == 0x10601)
+    else
     {
-        LOGF_WARN("%s: forcing %sStepsWorm for HEQ5 with firmware 106 (%x in place of %x)", __FUNCTION__,
-                  axis == Axis1 ? "RA" : "DE", 0xFC80, *StepsWorm);
-        *StepsWorm = 0xFC80;
-    }
+        // Steps per 360 degrees
+        dispatch_command(InquireGridPerRevolution, axis, nullptr);
+        //read_eqmod();
+        *Steps360        = Revu24str2long(response + 1);
 
+        // Steps per Worm
+        dispatch_command(InquireTimerInterruptFreq, axis, nullptr);
+        //read_eqmod();
+        *StepsWorm = Revu24str2long(response + 1);
+        // There is a bug in the earlier version firmware(Before 2.00) of motor controller MC001.
+        // Overwrite the GearRatio reported by the MC for 80GT mount and 114GT mount.
+        if ((MCVersion & 0x0000FF) == 0x80)
+        {
+            LOGF_WARN("%s: forcing %sStepsWorm for 80GT Mount (%x in place of %x)", __FUNCTION__,
+                      axis == Axis1 ? "RA" : "DE", 0x162B97, *StepsWorm);
+            *StepsWorm = 0x162B97; // for 80GT mount
+        }
+        if ((MCVersion & 0x0000FF) == 0x82)
+        {
+            LOGF_WARN("%s: forcing %sStepsWorm for 114GT Mount (%x in place of %x)", __FUNCTION__,
+                      axis == Axis1 ? "RA" : "DE", 0x205318, *StepsWorm);
+            *StepsWorm = 0x205318; // for 114GT mount
+        }
+        // HEQ5 with firmware 106, use same rate as RA
+        // drift correction = 1.00455,  64935/1.00455 = 64640 = 0xFC80
+        if (MCVersion == 0x10601)
+        {
+            LOGF_WARN("%s: forcing %sStepsWorm for HEQ5 with firmware 106 (%x in place of %x)", __FUNCTION__,
+                      axis == Axis1 ? "RA" : "DE", 0xFC80, *StepsWorm);
+            *StepsWorm = 0xFC80;
+        }
 
-    // Highspeed Ratio
-    dispatch_command(InquireHighSpeedRatio, axis, nullptr);
-    //read_eqmod();
-    //HighspeedRatio=Revu24str2long(response+1);
-    *HighspeedRatio  = Highstr2long(response + 1);
+
+        // Highspeed Ratio
+        dispatch_command(InquireHighSpeedRatio, axis, nullptr);
+        //read_eqmod();
+        //HighspeedRatio=Revu24str2long(response+1);
+        *HighspeedRatio  = Highstr2long(response + 1);
+
+        mountCache.Steps360[axis]       = *Steps360;
+        mountCache.StepsWorm[axis]      = *StepsWorm;
+        mountCache.HighspeedRatio[axis] = *HighspeedRatio;
+        mountCache.hasEncoderInfo[axis] = true;
+    }
 
     steppersvalues[0] = (double)(*Steps360);
     steppersvalues[1] = static_cast<double>(*StepsWorm);
@@ -795,40 +896,53 @@ bool Skywatcher::IsDERunning()
     return (DERunning);
 }
 
+void Skywatcher::UsePolledMotorStatus(SkywatcherAxis axis)
+{
+    if (polledStatus[axis])
+        polledStatus[axis] = false;
+    else
+        ReadMotorStatus(axis);
+}
+
 void Skywatcher::ReadMotorStatus(SkywatcherAxis axis)
 {
     dispatch_command(GetAxisStatus, axis, nullptr);
     //read_eqmod();
+    ParseMotorStatus(axis, response);
+}
+
+void Skywatcher::ParseMotorStatus(SkywatcherAxis axis, const char *reply)
+{
     switch (axis)
     {
         case Axis1:
-            RAInitialized = (response[3] & 0x01);
-            RARunning     = (response[2] & 0x01);
-            if (response[1] & 0x01)
+            RAInitialized = (reply[3] & 0x01);
+            RARunning     = (reply[2] & 0x01);
+            if (reply[1] & 0x01)
                 RAStatus.slewmode = SLEW;
             else
                 RAStatus.slewmode = GOTO;
-            if (response[1] & 0x02)
+            if (reply[1] & 0x02)
                 RAStatus.direction = BACKWARD;
             else
                 RAStatus.direction = FORWARD;
-            if (response[1] & 0x04)
+            if (reply[1] & 0x04)
                 RAStatus.speedmode = HIGHSPEED;
             else
                 RAStatus.speedmode = LOWSPEED;
             break;
         case Axis2:
-            DEInitialized = (response[3] & 0x01);
-            DERunning     = (response[2] & 0x01);
-            if (response[1] & 0x01)
+            DEInitialized = (reply[3] & 0x01);
+            DERunning     = (reply[2] & 0x01);
+            if (reply[1] & 0x01)
                 DEStatus.slewmode = SLEW;
             else
                 DEStatus.slewmode = GOTO;
-            if (response[1] & 0x02)
+            if (reply[1] & 0x02)
                 DEStatus.direction = BACKWARD;
             else
                 DEStatus.direction = FORWARD;
-            if (response[1] & 0x04)
+            if (reply[1] & 0x04)
                 DEStatus.speedmode = HIGHSPEED;
             else
                 DEStatus.speedmode = LOWSPEED;
@@ -1364,12 +1478,18 @@ uint32_t Skywatcher::ReadEncoder(SkywatcherAxis axis)
 
 uint32_t Skywatcher::GetRAAuxEncoder()
 {
-    return ReadEncoder(Axis1);
+    if (!polledAuxEncoder[Axis1])
+        return ReadEncoder(Axis1);
+    polledAuxEncoder[Axis1] = false;
+    return AuxEncoder[Axis1];
 }
 
 uint32_t Skywatcher::GetDEAuxEncoder()
 {
-    return ReadEncoder(Axis2);
+    if (!polledAuxEncoder[Axis2])
+        return ReadEncoder(Axis2);
+    polledAuxEncoder[Axis2] = false;
+    return AuxEncoder[Axis2];
 }
 
 void Skywatcher::SetST4RAGuideRate(unsigned char r)
@@ -1784,14 +1904,7 @@ bool Skywatcher::dispatch_command(SkywatcherCommand cmd, SkywatcherAxis axis, ch
 {
     for (uint8_t i = 0; i < EQMOD_MAX_RETRY; i++)
     {
-        // Clear string
-        command[0] = '\0';
-
-        if (command_arg == nullptr)
-            snprintf(command, SKYWATCHER_MAX_CMD, "%c%c%c%c", SkywatcherLeadingChar, cmd, AxisCmd[axis], SkywatcherTrailingChar);
-        else
-            snprintf(command, SKYWATCHER_MAX_CMD, "%c%c%c%s%c", SkywatcherLeadingChar, cmd, AxisCmd[axis], command_arg,
-                     SkywatcherTrailingChar);
+        format_command(cmd, axis, command_arg);
 
         int nbytes_written = 0;
         if (!isSimulation())
@@ -1812,7 +1925,7 @@ bool Skywatcher::dispatch_command(SkywatcherCommand cmd, SkywatcherAxis axis, ch
                     struct timespec wait;
                     wait.tv_sec  = 0;
                     wait.tv_nsec = 100000000; // 100ms
-                    nanosleep(nullptr, &wait);
+                    nanosleep(&wait, nullptr);
                     continue;
                 }
             }
@@ -1854,6 +1967,84 @@ bool Skywatcher::dispatch_command(SkywatcherCommand cmd, SkywatcherAxis axis, ch
     return true;
 }
 
+void Skywatcher::format_command(SkywatcherCommand cmd, SkywatcherAxis axis, char *command_arg)
+{
+    // Clear string
+    command[0] = '\0';
+
+    if (command_arg == nullptr)
+        snprintf(command, SKYWATCHER_MAX_CMD, "%c%c%c%c", SkywatcherLeadingChar, cmd, AxisCmd[axis], SkywatcherTrailingChar);
+    else
+        snprintf(command, SKYWATCHER_MAX_CMD, "%c%c%c%s%c", SkywatcherLeadingChar, cmd, AxisCmd[axis], command_arg,
+                 SkywatcherTrailingChar);
+}
+
+void Skywatcher::dispatch_queries(SkywatcherQuery *queries, int count)
+{
+    if (pipelineQueries && !isSimulation() && count > 1)
+    {
+        try
+        {
+            if (pipeline_queries(queries, count))
+                return;
+        }
+        catch (EQModError ex)
+        {
+            DEBUGF(telescope->DBG_COMM, "pipelined queries failed: %s", ex.message);
+        }
+
+        if (++pipelineFailures >= EQMOD_MAX_PIPELINE_FAILURES)
+        {
+            pipelineQueries = false;
+            LOGF_WARN("%s() : mount link drops pipelined queries, falling back to one query at a time.", __FUNCTION__);
+        }
+    }
+
+    // One command at a time, with the usual retries
+    for (int i = 0; i < count; i++)
+    {
+        dispatch_command(queries[i].cmd, queries[i].axis, nullptr);
+        strncpy(queries[i].response, response, SKYWATCHER_MAX_CMD);
+        queries[i].response[SKYWATCHER_MAX_CMD - 1] = '\0';
+    }
+}
+
+bool Skywatcher::pipeline_queries(SkywatcherQuery *queries, int count)
+{
+    int err_code = 0, nbytes_written = 0;
+
+    // Write all queries back to back, the motor controllers answer them in order.
+    // Each one is written separately so it stays a single datagram on UDP links.
+    tcflush(PortFD, TCIOFLUSH);
+    for (int i = 0; i < count; i++)
+    {
+        format_command(queries[i].cmd, queries[i].axis, nullptr);
+        if ((err_code = tty_write_string(PortFD, command, &nbytes_written)) != TTY_OK)
+        {
+            char ttyerrormsg[ERROR_MSG_LENGTH];
+            tty_error_msg(err_code, ttyerrormsg, ERROR_MSG_LENGTH);
+            DEBUGF(telescope->DBG_COMM, "pipelined write failed: %s", ttyerrormsg);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        // Restore the command text for read_eqmod error messages
+        format_command(queries[i].cmd, queries[i].axis, nullptr);
+        command[strlen(command) - 1] = '\0';
+        debugnextread = true;
+        if (!read_eqmod())
+            return false;
+        DEBUGF(telescope->DBG_COMM, "pipelined query: \"%s\"", command);
+        strncpy(queries[i].response, response, SKYWATCHER_MAX_CMD);
+        queries[i].response[SKYWATCHER_MAX_CMD - 1] = '\0';
+    }
+
+    pipelineFailures = 0;
+    return true;
+}
+
 bool Skywatcher::read_eqmod()
 {
     int err_code = 0, nbytes_read = 0;
@@ -65,6 +65,11 @@ class Skywatcher
         bool HasSnapPort2();
         bool HasPolarLed();
 
+        // Read encoders, motor status and aux encoders of both axes in one exchange.
+        // The next GetRAEncoder/GetDEEncoder, Get*MotorStatus and Get*AuxEncoder calls use these values.
+        // Returns the number of queries sent.
+        int ReadAxesStatus();
+
         uint32_t GetRAEncoder();
         uint32_t GetDEEncoder();
         uint32_t GetRAEncoderZero();
@@ -262,6 +267,26 @@ class Skywatcher
             ER_3
         };
 
+        // One query of a pipelined exchange
+        typedef struct SkywatcherQuery
+        {
+            SkywatcherCommand cmd;
+            SkywatcherAxis axis;
+            char response[SKYWATCHER_MAX_CMD];
+        } SkywatcherQuery;
+
+        // Values that do not change for a given motor controller, kept across reconnections
+        typedef struct SkywatcherMountCache
+        {
+            bool hasEncoderInfo[NUMBER_OF_SKYWATCHERAXIS] = {false, false};
+            uint32_t Steps360[NUMBER_OF_SKYWATCHERAXIS];
+            uint32_t StepsWorm[NUMBER_OF_SKYWATCHERAXIS];
+            uint32_t HighspeedRatio[NUMBER_OF_SKYWATCHERAXIS];
+            bool hasFeatures = false;
+            uint32_t features[NUMBER_OF_SKYWATCHERAXIS];
+            uint32_t MCVersion = 0;
+        } SkywatcherMountCache;
+
         struct timeval lastreadmotorstatus[NUMBER_OF_SKYWATCHERAXIS];
         struct timeval lastreadmotorposition[NUMBER_OF_SKYWATCHERAXIS];
 
@@ -269,6 +294,10 @@ class Skywatcher
         void InquireEncoderInfo(SkywatcherAxis axis, double *steppersvalues);
         void CheckMotorStatus(SkywatcherAxis axis);
         void ReadMotorStatus(SkywatcherAxis axis);
+        void UsePolledMotorStatus(SkywatcherAxis axis);
+        void ParseMotorStatus(SkywatcherAxis axis, const char *reply);
+        void ParseEncoder(SkywatcherAxis axis, const char *reply);
+        void SetFeatures(SkywatcherAxis axis, uint32_t features);
         void SetMotion(SkywatcherAxis axis, SkywatcherAxisStatus newstatus);
         void SetSpeed(SkywatcherAxis axis, uint32_t period);
         void SetTarget(SkywatcherAxis axis, uint32_t increment);
@@ -291,6 +320,9 @@ class Skywatcher
 
         bool read_eqmod();
         bool dispatch_command(SkywatcherCommand cmd, SkywatcherAxis axis, char *arg);
+        void format_command(SkywatcherCommand cmd, SkywatcherAxis axis, char *arg);
+        void dispatch_queries(SkywatcherQuery *queries, int count);
+        bool pipeline_queries(SkywatcherQuery *queries, int count);
 
         uint32_t Revu24str2long(char *);
         uint32_t Highstr2long(char *);
@@ -354,8 +386,20 @@ class Skywatcher
 
         uint32_t lastreadIndexer[NUMBER_OF_SKYWATCHERAXIS];
 
+        // Results of the last ReadAxesStatus not yet handed out
+        bool polledEncoder[NUMBER_OF_SKYWATCHERAXIS] {false, false};
+        bool polledStatus[NUMBER_OF_SKYWATCHERAXIS] {false, false};
+        bool polledAuxEncoder[NUMBER_OF_SKYWATCHERAXIS] {false, false};
+        uint32_t AuxEncoder[NUMBER_OF_SKYWATCHERAXIS] {0, 0};
+
+        SkywatcherMountCache mountCache;
+        // Queries are sent back to back until the link shows it cannot keep up
+        bool pipelineQueries {true};
+        uint8_t pipelineFailures {0};
+
         bool snapportstatus[NUMBER_OF_SKYWATCHERAXIS];
 
         const long EQMOD_TIMEOUT = 200000; // us
         const uint8_t EQMOD_MAX_RETRY = 10;
+        const uint8_t EQMOD_MAX_PIPELINE_FAILURES = 3;
 };
@@ -22,6 +22,7 @@
 */
 
 #include <memory>
+#include <errno.h>
 #include <time.h>
 #include <math.h>
 #include <unistd.h>
@@ -661,22 +662,34 @@ bool FLICCD::grabImage()
     }
     else
     {
-        bool success = true;
-        for (int i = 0; i < height; i++)
+        size_t grabbed = 0;
+        err = FLIGrabFrame(fli_dev, image, PrimaryCCD.getFrameBufferSize(), &grabbed);
+
+        // Older libfli only have a stub for FLIGrabFrame, grab row by row then
+        if (err == -EINVAL && grabbed == 0)
         {
-            if ((err = FLIGrabRow(fli_dev, image + (i * row_size), width)))
+            bool success = true;
+            for (int i = 0; i < height; i++)
             {
-                /* print this error once but read to the end to flush the array */
-                if (success)
+                if ((err = FLIGrabRow(fli_dev, image + (i * row_size), width)))
                 {
-                    LOGF_ERROR("FLIGrabRow() failed at row %d. %s.", i, strerror(-err));
-                    success = false;
+                    /* print this error once but read to the end to flush the array */
+                    if (success)
+                    {
+                        LOGF_ERROR("FLIGrabRow() failed at row %d. %s.", i, strerror(-err));
+                        success = false;
+                    }
                 }
             }
-        }
 
-        if (!success)
+            if (!success)
+                return false;
+        }
+        else if (err)
+        {
+            LOGF_ERROR("FLIGrabFrame() failed after %zu of %d bytes. %s.", grabbed, height * row_size, strerror(-err));
             return false;
+        }
     }
     guard.unlock();
 
@@ -101,6 +101,10 @@ bool ArvGeneric::_stream_active()
 {
     return this->stream_active;
 }
+bool ArvGeneric::is_streaming()
+{
+    return this->streaming;
+}
 
 ArvGeneric::ArvGeneric(void *camera_device) : ArvCamera(camera_device)
 {
@@ -136,7 +140,7 @@ bool ArvGeneric::connect()
         this->cam.vendor_name = arv_camera_get_vendor_name(this->camera, &(this->error));
         this->cam.device_id   = arv_camera_get_device_id(this->camera, &(this->error));
     }
-    return true;
+    return this->_configure();
 }
 
 bool ArvGeneric::_configure(void)
@@ -152,6 +156,10 @@ void ArvGeneric::_init()
     this->stream        = nullptr;
     this->stream_active = false;
 
+    this->streaming       = false;
+    this->stream_callback = nullptr;
+    this->stream_usr_ptr  = nullptr;
+
     /* Don't clear device_id, its needed to re-attach with connect() */
 }
 
@@ -160,6 +168,7 @@ bool ArvGeneric::disconnect()
     if (this->is_connected())
     {
         this->_test_exposure_and_abort();
+        this->stream_stop();
         g_clear_object(&this->camera);
     }
     this->_init();
@@ -171,11 +180,13 @@ bool ArvGeneric::_set_initial_config()
      *      (1) disable auto exposure
      *      (2) disable auto framerate (to enable maximum possible exposure time)
      *      (3) set binning to 1x1
-     *      (4) set software trigger */
+     *      (4) set software trigger
+     *      (5) 16 bit pixels, the only depth the driver handles */
     arv_camera_set_binning(camera, 1, 1, &error);
     arv_camera_set_gain_auto(camera, ARV_AUTO_OFF, &error);
     arv_camera_set_exposure_time_auto(camera, ARV_AUTO_OFF, &error);
     arv_camera_set_trigger(camera, "Software", &error);
+    arv_camera_set_pixel_format(camera, ARV_PIXEL_FORMAT_MONO_16, &error);
     return true;
 }
 
@@ -316,6 +327,7 @@ void ArvGeneric::_trigger_exposure()
 
 void ArvGeneric::exposure_start(void)
 {
+    this->stream_stop();
     this->_test_exposure_and_abort();
     this->stream = this->_stream_create();
     this->buffer = this->_buffer_create();
@@ -382,3 +394,97 @@ ARV_EXPOSURE_STATUS ArvGeneric::exposure_poll(void (*fn_image_callback)(void *co
             return ARV_EXPOSURE_UNKNOWN;
     }
 }
+
+void ArvGeneric::_stream_new_buffer(::ArvStream *stream, void *usr_ptr)
+{
+    ArvGeneric *const cls = static_cast<ArvGeneric *>(usr_ptr);
+    ::ArvBuffer *buffer   = arv_stream_try_pop_buffer(stream);
+    if (buffer == nullptr)
+        return;
+
+    if (arv_buffer_get_status(buffer) == ARV_BUFFER_STATUS_SUCCESS && cls->stream_callback != nullptr)
+    {
+        size_t size;
+        uint8_t const *const data = (uint8_t const *const)arv_buffer_get_data(buffer, &size);
+        cls->stream_callback(cls->stream_usr_ptr, data, size);
+    }
+
+    /* Straight back into the ring for the next frame */
+    arv_stream_push_buffer(stream, buffer);
+}
+
+bool ArvGeneric::stream_start(int const n_buffers, void (*fn_frame_callback)(void *const, uint8_t const *const, size_t),
+                              void *const usr_ptr)
+{
+    this->_test_exposure_and_abort();
+    this->stream_stop();
+
+    this->stream = this->_stream_create();
+    if (this->stream == nullptr)
+        return false;
+
+    /* Preallocate the whole ring, no allocations while streaming */
+    gint const payload = arv_camera_get_payload(this->camera, &(this->error));
+    for (int i = 0; i < n_buffers; i++)
+        arv_stream_push_buffer(this->stream, arv_buffer_new(payload, nullptr));
+
+    this->stream_callback = fn_frame_callback;
+    this->stream_usr_ptr  = usr_ptr;
+    g_signal_connect(this->stream, "new-buffer", G_CALLBACK(ArvGeneric::_stream_new_buffer), this);
+    arv_stream_set_emit_signals(this->stream, TRUE);
+
+    /* Free running, as fast as the exposure time allows */
+    arv_camera_clear_triggers(this->camera, &(this->error));
+    double const exposure_s = this->cam.exposure.val() / 1000000.0;
+    if (exposure_s > 0 && this->cam.frame_rate.max() > 0)
+    {
+        double const rate = 1.0 / exposure_s;
+        arv_camera_set_frame_rate(this->camera, rate < this->cam.frame_rate.max() ? rate : this->cam.frame_rate.max(),
+                                  &(this->error));
+    }
+    arv_camera_set_acquisition_mode(this->camera, ARV_ACQUISITION_MODE_CONTINUOUS, &(this->error));
+    arv_camera_start_acquisition(this->camera, &(this->error));
+
+    this->streaming = true;
+    return true;
+}
+
+void ArvGeneric::stream_stop(void)
+{
+    if (!this->streaming)
+        return;
+
+    arv_camera_stop_acquisition(this->camera, &(this->error));
+    arv_stream_set_emit_signals(this->stream, FALSE);
+
+    /* Joins the stream thread and frees the ring */
+    g_clear_object(&this->stream);
+    this->stream_callback = nullptr;
+    this->stream_usr_ptr  = nullptr;
+    this->streaming       = false;
+
+    /* Back to software triggered single frames */
+    arv_camera_set_trigger(this->camera, "Software", &(this->error));
+}
+
+ARV_STREAM_STATS ArvGeneric::stream_stats()
+{
+    ARV_STREAM_STATS stats = {};
+    if (!this->streaming || this->stream == nullptr)
+        return stats;
+
+    guint64 completed, failures, underruns;
+    arv_stream_get_statistics(this->stream, &completed, &failures, &underruns);
+    stats.completed = completed;
+    stats.failures  = failures;
+    stats.underruns = underruns;
+
+    if (ARV_IS_GV_STREAM(this->stream))
+    {
+        guint64 resent, missing;
+        arv_gv_stream_get_statistics(ARV_GV_STREAM(this->stream), &resent, &missing);
+        stats.resent_packets  = resent;
+        stats.missing_packets = missing;
+    }
+    return stats;
+}
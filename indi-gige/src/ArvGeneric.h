@@ -66,9 +66,15 @@ class ArvGeneric : public arv::ArvCamera
     ARV_EXPOSURE_STATUS exposure_poll(void (*fn_image_callback)(void *const, uint8_t const *const, size_t),
                                       void *const usr_ptr);
 
+    bool stream_start(int const n_buffers, void (*fn_frame_callback)(void *const, uint8_t const *const, size_t),
+                      void *const usr_ptr);
+    void stream_stop(void);
+    bool is_streaming();
+    ARV_STREAM_STATS stream_stats();
+
   protected:
     void _init(void);
-    bool _configure(void);
+    virtual bool _configure(void);
     void _test_exposure_and_abort(void);
     template <typename T>
     bool _get_bounds(void (*fn_arv_bounds)(::ArvCamera *, T *min, T *max, GError**), min_max_property<T> *prop);
@@ -76,8 +82,8 @@ class ArvGeneric : public arv::ArvCamera
     void _set_cam_exposure_property(void (*arv_set)(::ArvCamera *, T, GError**), min_max_property<T> *prop, T const new_val);
 
     const char *_str_val(const char *s);
-    bool _get_initial_config();
-    bool _set_initial_config();
+    virtual bool _get_initial_config();
+    virtual bool _set_initial_config();
     void _get_image(void (*fn_image_callback)(void *const, uint8_t const *const, size_t), void *const usr_ptr);
 
     /* aravis library state variables */
@@ -97,6 +103,12 @@ class ArvGeneric : public arv::ArvCamera
 
     bool stream_active;
 
+    /* continuous acquisition: a ring of buffers recycled through the stream */
+    static void _stream_new_buffer(::ArvStream *stream, void *usr_ptr);
+    bool streaming;
+    void (*stream_callback)(void *const, uint8_t const *const, size_t);
+    void *stream_usr_ptr;
+
     /* Camera properties */
     struct
     {
@@ -33,6 +33,14 @@ typedef enum {
 
 } ARV_EXPOSURE_STATUS;
 
+typedef struct {
+    uint64_t completed;       //!< Frames received complete
+    uint64_t failures;        //!< Frames received incomplete or corrupted
+    uint64_t underruns;       //!< Frames lost because no buffer was free in the ring
+    uint64_t resent_packets;  //!< Packets the camera had to resend
+    uint64_t missing_packets; //!< Packets that never arrived
+} ARV_STREAM_STATS;
+
 template <class T>
 class min_max_property
 {
@@ -109,6 +117,13 @@ class ArvCamera
     virtual void exposure_abort(void)                      = 0;
     virtual ARV_EXPOSURE_STATUS exposure_poll(void (*fn_image_callback)(void *const, uint8_t const *const, size_t),
                                               void *const) = 0;
+
+    /* Continuous acquisition, fn_frame_callback is called from the stream thread */
+    virtual bool stream_start(int const n_buffers, void (*fn_frame_callback)(void *const, uint8_t const *const, size_t),
+                              void *const) = 0;
+    virtual void stream_stop(void)            = 0;
+    virtual bool is_streaming()               = 0;
+    virtual ARV_STREAM_STATS stream_stats()   = 0;
 };
 
 class ArvFactory
@@ -72,12 +72,8 @@ error:
 bool BlackFly::connect(void)
 {
     printf("%s\n", __PRETTY_FUNCTION__);
-    bool const ret = ArvGeneric::connect();
-    if (ret)
-    {
-        this->_configure();
-    }
-    return ret;
+    /* ArvGeneric::connect() runs our _configure() */
+    return ArvGeneric::connect();
 }
 
 void BlackFly::_fixup(void)
@@ -115,6 +111,14 @@ void BlackFly::exposure_start(void)
     ArvGeneric::exposure_start();
 }
 
+bool BlackFly::stream_start(int const n_buffers, void (*fn_frame_callback)(void *const, uint8_t const *const, size_t),
+                            void *const usr_ptr)
+{
+    printf("%s\n", __PRETTY_FUNCTION__);
+    this->_fixup();
+    return ArvGeneric::stream_start(n_buffers, fn_frame_callback, usr_ptr);
+}
+
 bool BlackFly::_configure(void)
 {
     printf("%s\n", __PRETTY_FUNCTION__);
@@ -133,11 +137,12 @@ bool BlackFly::_get_initial_config(void)
     /* Probably can find this somewhere in genicam, too, but it depends on framerate
      * and the maximum exposure is consequently not published */
     this->cam.exposure.update(5000, 11900000);
+    return true;
 }
 
 bool BlackFly::_set_initial_config(void)
 {
     printf("%s\n", __PRETTY_FUNCTION__);
     ArvGeneric::_set_initial_config();
-    this->_custom_settings();
+    return this->_custom_settings();
 }
@@ -43,7 +43,10 @@
 #define TIMER_US_TO_MS (1000)
 #define TIMER_US_TO_S  (1000000)
 #define TIMER_TICK_MS  (100)
-#define CAPS           (CCD_CAN_ABORT | CCD_CAN_BIN | CCD_CAN_SUBFRAME)
+#define CAPS           (CCD_CAN_ABORT | CCD_CAN_BIN | CCD_CAN_SUBFRAME | CCD_HAS_STREAMING)
+
+#define STREAM_BUFFERS_DEFAULT (8)
+#define STREAM_STATS_TICKS     (10) /* Refresh the stream counters once a second */
 
 static class Loader
 {
@@ -125,14 +128,30 @@ void GigECCD::_update_indi_properties(void)
     IUFillTextVector(&indiprop_info_prop, indiprop_info, 3, getDeviceName(), "Camera Info", "", MAIN_CONTROL_TAB, IP_RO,
                      0, IPS_IDLE);
 
+    IUFillNumber(&this->indiprop_stream_buffers[0], "BUFFERS", "Buffers", "%.f", 2, 64, 1, STREAM_BUFFERS_DEFAULT);
+    IUFillNumberVector(&this->indiprop_stream_buffers_prop, this->indiprop_stream_buffers, 1, getDeviceName(),
+                       "STREAM_BUFFERS", "Stream Ring", "Streaming", IP_RW, 60, IPS_IDLE);
+
+    IUFillNumber(&this->indiprop_stream_stats[0], "FRAMES", "Frames", "%.f", 0, 0, 0, 0);
+    IUFillNumber(&this->indiprop_stream_stats[1], "FAILURES", "Failed frames", "%.f", 0, 0, 0, 0);
+    IUFillNumber(&this->indiprop_stream_stats[2], "UNDERRUNS", "Buffer underruns", "%.f", 0, 0, 0, 0);
+    IUFillNumber(&this->indiprop_stream_stats[3], "RESENT", "Resent packets", "%.f", 0, 0, 0, 0);
+    IUFillNumber(&this->indiprop_stream_stats[4], "MISSING", "Missing packets", "%.f", 0, 0, 0, 0);
+    IUFillNumberVector(&this->indiprop_stream_stats_prop, this->indiprop_stream_stats, 5, getDeviceName(),
+                       "STREAM_STATS", "Stream Stats", "Streaming", IP_RO, 0, IPS_IDLE);
+
     defineProperty(&indiprop_info_prop);
     defineProperty(&this->indiprop_gain_prop);
+    defineProperty(&this->indiprop_stream_buffers_prop);
+    defineProperty(&this->indiprop_stream_stats_prop);
 }
 
 void GigECCD::_delete_indi_properties(void)
 {
     this->deleteProperty(this->indiprop_gain_prop.name);
     this->deleteProperty(this->indiprop_info_prop.name);
+    this->deleteProperty(this->indiprop_stream_buffers_prop.name);
+    this->deleteProperty(this->indiprop_stream_stats_prop.name);
 }
 
 //Initial call
@@ -178,6 +197,12 @@ bool GigECCD::Disconnect()
 bool GigECCD::StartExposure(float duration)
 {
     LOGF_INFO("%s exposure_time=%.4f", __PRETTY_FUNCTION__, duration);
+    if (camera->is_streaming())
+    {
+        LOG_ERROR("Cannot take an exposure while streaming.");
+        return false;
+    }
+
     /* Driver will clamp to lowest possible exposure */
     if (PrimaryCCD.getFrameType() == INDI::CCDChip::BIAS_FRAME)
         duration = 0;
@@ -198,6 +223,62 @@ bool GigECCD::AbortExposure()
     return true;
 }
 
+bool GigECCD::StartStreaming()
+{
+    /* The frame rate follows the exposure, see ArvGeneric::stream_start().
+       The single frame exposure is put back when the stream stops. */
+    this->stream_saved_exposure_us = camera->get_exposure().val();
+    camera->set_exposure_time(1000000.0 / Streamer->getTargetFPS());
+    LOGF_INFO("Streaming exposure set to %.4f s, was %.4f s", camera->get_exposure().val() / 1000000.0,
+              this->stream_saved_exposure_us / 1000000.0);
+
+    /* Frames arrive as MONO_16 at the camera geometry, see _update_geometry() */
+    Streamer->setPixelFormat(INDI_MONO, PrimaryCCD.getBPP());
+    Streamer->setSize(this->camera->get_width().val(), this->camera->get_height().val());
+
+    int const n_buffers = (int)this->indiprop_stream_buffers[0].value;
+    if (!camera->stream_start(n_buffers, this->_receive_frame_hook, this))
+    {
+        LOG_ERROR("Failed to start the acquisition stream.");
+        return false;
+    }
+
+    LOGF_INFO("Streaming with a ring of %d buffers", n_buffers);
+    this->stats_ticks = 0;
+    return true;
+}
+
+bool GigECCD::StopStreaming()
+{
+    /* Final counters, the stream is gone after stopping */
+    this->_update_stream_stats();
+    camera->stream_stop();
+
+    if (this->stream_saved_exposure_us > 0)
+        camera->set_exposure_time(this->stream_saved_exposure_us);
+    return true;
+}
+
+void GigECCD::_receive_frame_hook(void *const class_ptr, uint8_t const *const data, size_t size)
+{
+    /* Runs in the aravis stream thread, the streamer copies the frame */
+    GigECCD *const cls = static_cast<GigECCD *const>(class_ptr);
+    if (size == (size_t)cls->PrimaryCCD.getFrameBufferSize())
+        cls->Streamer->newFrame(data, size);
+}
+
+void GigECCD::_update_stream_stats(void)
+{
+    arv::ARV_STREAM_STATS const stats = camera->stream_stats();
+    this->indiprop_stream_stats[0].value = stats.completed;
+    this->indiprop_stream_stats[1].value = stats.failures;
+    this->indiprop_stream_stats[2].value = stats.underruns;
+    this->indiprop_stream_stats[3].value = stats.resent_packets;
+    this->indiprop_stream_stats[4].value = stats.missing_packets;
+    this->indiprop_stream_stats_prop.s   = (stats.underruns || stats.failures) ? IPS_ALERT : IPS_OK;
+    IDSetNumber(&this->indiprop_stream_stats_prop, nullptr);
+}
+
 void GigECCD::_update_image(uint8_t const *const data, size_t size)
 {
     LOGF_INFO("Receiving %i bytes image", size);
@@ -263,6 +344,11 @@ void GigECCD::_handle_timeout(struct timeval *const tv, uint32_t timeout_us)
 void GigECCD::TimerHit()
 {
     this->timer_id = this->SetTimer(TIMER_TICK_MS);
+    if (this->camera->is_connected() && this->camera->is_streaming() && ++this->stats_ticks >= STREAM_STATS_TICKS)
+    {
+        this->stats_ticks = 0;
+        this->_update_stream_stats();
+    }
     if (!this->camera->is_connected() || !this->camera->is_exposing())
         return;
 
@@ -302,6 +388,15 @@ bool GigECCD::ISNewNumber(const char *dev, const char *name, double values[], ch
             IDSetNumber(&this->indiprop_gain_prop, nullptr);
             return true;
         }
+
+        if (!strcmp(name, this->indiprop_stream_buffers_prop.name))
+        {
+            /* Takes effect when the next stream starts */
+            IUUpdateNumber(&this->indiprop_stream_buffers_prop, values, names, n);
+            this->indiprop_stream_buffers_prop.s = IPS_OK;
+            IDSetNumber(&this->indiprop_stream_buffers_prop, nullptr);
+            return true;
+        }
     }
 
     return INDI::CCD::ISNewNumber(dev, name, values, names, n);
@@ -44,6 +44,9 @@ class GigECCD : public INDI::CCD
     bool StartExposure(float duration);
     bool AbortExposure();
 
+    bool StartStreaming();
+    bool StopStreaming();
+
   protected:
     void TimerHit();
     virtual bool UpdateCCDFrame(int x, int y, int w, int h);
@@ -56,6 +59,8 @@ class GigECCD : public INDI::CCD
     bool _update_geometry(void);
     void _update_image(uint8_t const *const data, size_t size);
     static void _receive_image_hook(void *const class_ptr, uint8_t const *const data, size_t size);
+    static void _receive_frame_hook(void *const class_ptr, uint8_t const *const data, size_t size);
+    void _update_stream_stats(void);
 
     void _handle_failed(void);
     void _handle_timeout(struct timeval *const tv, uint32_t timeout_us);
@@ -63,6 +68,8 @@ class GigECCD : public INDI::CCD
     arv::ArvCamera *camera;
     char name[32];
     int timer_id;
+    int stats_ticks {0};
+    double stream_saved_exposure_us {0};
     struct timeval exposure_start_time;
     struct timeval exposure_transfer_time;
 
@@ -72,6 +79,10 @@ class GigECCD : public INDI::CCD
     INumberVectorProperty indiprop_gain_prop;
     IText indiprop_info[3] {};
     ITextVectorProperty indiprop_info_prop;
+    INumber indiprop_stream_buffers[1];
+    INumberVectorProperty indiprop_stream_buffers_prop;
+    INumber indiprop_stream_stats[5];
+    INumberVectorProperty indiprop_stream_stats_prop;
 
     virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n);
 
@@ -1198,8 +1198,13 @@ bool GPhotoCCD::grabImage()
     }
     else if (EncodeFormatSP[FORMAT_FITS].getState() == ISS_ON || EncodeFormatSP[FORMAT_XISF].getState() == ISS_ON)
     {
-        char filename[MAXRBUF] = "/tmp/indi_XXXXXX";
+        char filename[MAXRBUF] = {0};
         const char *extension = "unknown";
+        // In-memory copy of the image file as downloaded by gphoto, owned by the driver until gphoto_free_buffer
+        const char *gphotoFileData = nullptr;
+        unsigned long gphotoFileSize = 0;
+        // True once the raw reader already copied just the requested subframe
+        bool rawCropped = false;
         if (isSimulation())
         {
             if (uploadFile == nullptr || !uploadFile[0])
@@ -1208,7 +1213,7 @@ bool GPhotoCCD::grabImage()
                 return false;
             }
 
-            strncpy(filename, uploadFile, MAXRBUF);
+            strncpy(filename, uploadFile, MAXRBUF - 1);
             const char *found = strchr(filename, '.');
             if (found == nullptr)
             {
@@ -1219,20 +1224,22 @@ bool GPhotoCCD::grabImage()
         }
         else
         {
-            int fd = mkstemp(filename);
-            int ret = gphoto_read_exposure_fd(gphotodrv, fd);
-            if (ret != GP_OK || fd == -1)
+            int ret = gphoto_read_exposure(gphotodrv);
+            if (ret != GP_OK)
             {
-                if (fd == -1)
-                    LOGF_ERROR("Exposure failed to save image. Cannot create temp file %s", tmpfile);
-                else
-                {
-                    LOGF_ERROR("Exposure failed to save image... %s", gp_result_as_string(ret));
-                    // As suggested on INDI forums, this result could be misleading.
-                    if (ret == GP_ERROR_DIRECTORY_NOT_FOUND)
-                        LOG_INFO("Make sure BULB switch is ON in the camera. Try setting AF switch to OFF.");
-                }
-                unlink(filename);
+                LOGF_ERROR("Exposure failed to save image... %s", gp_result_as_string(ret));
+                // As suggested on INDI forums, this result could be misleading.
+                if (ret == GP_ERROR_DIRECTORY_NOT_FOUND)
+                    LOG_INFO("Make sure BULB switch is ON in the camera. Try setting AF switch to OFF.");
+                gphoto_free_buffer(gphotodrv);
+                return false;
+            }
+
+            gphoto_get_buffer(gphotodrv, &gphotoFileData, &gphotoFileSize);
+            if (gphotoFileData == nullptr || gphotoFileSize == 0)
+            {
+                LOG_ERROR("Exposure failed to download image.");
+                gphoto_free_buffer(gphotodrv);
                 return false;
             }
 
@@ -1242,6 +1249,8 @@ bool GPhotoCCD::grabImage()
         if (!strcmp(extension, "unknown"))
         {
             LOG_ERROR("Exposure failed.");
+            if (!isSimulation())
+                gphoto_free_buffer(gphotodrv);
             return false;
         }
 
@@ -1251,50 +1260,48 @@ bool GPhotoCCD::grabImage()
 
         if (strcasecmp(extension, "jpg") == 0 || strcasecmp(extension, "jpeg") == 0)
         {
-            if (read_jpeg(filename, &memptr, &memsize, &naxis, &w, &h))
+            int rc = isSimulation() ? read_jpeg(filename, &memptr, &memsize, &naxis, &w, &h) :
+                     read_jpeg_planar_mem(reinterpret_cast<const unsigned char *>(gphotoFileData), gphotoFileSize,
+                                          &memptr, &memsize, &naxis, &w, &h);
+            if (!isSimulation())
+                gphoto_free_buffer(gphotodrv);
+            if (rc)
             {
                 LOG_ERROR("Exposure failed to parse jpeg.");
-                if (!isSimulation())
-                    unlink(filename);
                 return false;
             }
 
-            LOGF_DEBUG("read_jpeg: memsize (%d) naxis (%d) w (%d) h (%d) bpp (%d)", memsize, naxis, w, h, bpp);
+            LOGF_DEBUG("read_jpeg: memsize (%zu) naxis (%d) w (%d) h (%d) bpp (%d)", memsize, naxis, w, h, bpp);
 
             SetCCDCapability(GetCCDCapability() & ~CCD_HAS_BAYER);
         }
         else
         {
             char bayer_pattern[8] = {};
-            auto libraw_ok = false;
-
-            // In case the file read operation fails due to some disk delay (unlikely)
-            // Try again before giving up.
-            for (int i = 0; i < 2; i++)
-            {
-                // On error, try again in 500ms
-                if (read_libraw(filename, &memptr, &memsize, &naxis, &w, &h, &bpp, bayer_pattern))
-                    usleep(500000);
-                else
-                {
-                    libraw_ok = true;
-                    break;
-                }
-            }
 
-            if (libraw_ok == false)
+            // Subframes are cut out while copying the samples out of LibRaw
+            PixelKernels::RawWindow crop;
+            crop.x      = PrimaryCCD.getSubX();
+            crop.y      = PrimaryCCD.getSubY();
+            crop.width  = PrimaryCCD.getSubW();
+            crop.height = PrimaryCCD.getSubH();
+
+            // The image is decoded straight from the downloaded buffer, there is no file to wait for
+            int rc = isSimulation() ? read_libraw(filename, &memptr, &memsize, &naxis, &w, &h, &bpp, bayer_pattern, &crop) :
+                     read_libraw_mem(gphotoFileData, gphotoFileSize, &memptr, &memsize, &naxis, &w, &h, &bpp,
+                                     bayer_pattern, &crop);
+            if (!isSimulation())
+                gphoto_free_buffer(gphotodrv);
+            if (rc)
             {
                 LOG_ERROR("Exposure failed to parse raw image.");
-                if (!isSimulation())
-                    unlink(filename);
                 return false;
             }
 
-            LOGF_DEBUG("read_libraw: memsize (%d) naxis (%d) w (%d) h (%d) bpp (%d) bayer pattern (%s)",
+            LOGF_DEBUG("read_libraw: memsize (%zu) naxis (%d) w (%d) h (%d) bpp (%d) bayer pattern (%s)",
                        memsize, naxis, w, h, bpp, bayer_pattern);
 
-            if (!isSimulation())
-                unlink(filename);
+            rawCropped = crop.width > 0 && crop.height > 0;
 
             IUSaveText(&BayerT[2], bayer_pattern);
             IDSetText(&BayerTP, nullptr);
@@ -1336,10 +1343,14 @@ bool GPhotoCCD::grabImage()
 
             if (naxis == 2)
             {
-                // JM 2020-08-29: Using memmove since regions are overlaping
-                // as proposed by Camiel Severijns on INDI forums.
-                for (int i = subY; i < subY + subH; i++)
-                    memmove(memptr + (i - subY) * lineW, memptr + (i * w + subX) * bpp / 8, lineW);
+                // Raw images are already cropped by the reader
+                if (!rawCropped)
+                {
+                    // JM 2020-08-29: Using memmove since regions are overlaping
+                    // as proposed by Camiel Severijns on INDI forums.
+                    for (int i = subY; i < subY + subH; i++)
+                        memmove(memptr + (i - subY) * lineW, memptr + (i * w + subX) * bpp / 8, lineW);
+                }
             }
             else
             {
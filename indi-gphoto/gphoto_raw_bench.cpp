@@ -0,0 +1,116 @@
+/*
+    GPhoto raw ingest benchmark
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja AT ikarustech DOT com)
+
+    This library is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+    or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+    License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this library; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+
+*/
+
+/*
+    Times the raw ingest (LibRaw raw_image to INDI frame) over a set of sample raw files:
+
+        gphoto_raw_bench [-i iterations] file.cr2 file.nef ...
+
+    For every file it reports the LibRaw unpack time and the copy rate with one thread
+    and with all threads.
+*/
+
+#include <librawingest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double run(const PixelKernels::RawImage &image, std::vector<uint16_t> &frame, unsigned threads, int iterations)
+{
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+        PixelKernels::ingestRaw(image, frame.data(), 0, threads);
+    return frame.size() * sizeof(uint16_t) * iterations / seconds(start) / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = 10;
+    int first = 1;
+
+    if (argc > 2 && !strcmp(argv[1], "-i"))
+    {
+        iterations = atoi(argv[2]);
+        first = 3;
+    }
+
+    if (first >= argc || iterations <= 0)
+    {
+        fprintf(stderr, "Usage: %s [-i iterations] raw_file...\n", argv[0]);
+        return 1;
+    }
+
+    unsigned cores = std::thread::hardware_concurrency();
+    double totalBytes = 0, totalSeconds = 0;
+
+    printf("%-32s %9s %10s %12s %12s\n", "file", "MP", "unpack ms", "1 thread", "threads");
+
+    for (int i = first; i < argc; i++)
+    {
+        LibRaw processor;
+        PixelKernels::RawImage image;
+        char bayer[5];
+        auto start = Clock::now();
+        int ret = processor.open_file(argv[i]);
+        if (ret == LIBRAW_SUCCESS)
+            ret = PixelKernels::unpackLibRaw(processor, &image, bayer);
+        double unpackMs = seconds(start) * 1000.0;
+
+        if (ret != LIBRAW_SUCCESS)
+        {
+            fprintf(stderr, "%s: %s\n", argv[i], libraw_strerror(ret));
+            continue;
+        }
+
+        std::vector<uint16_t> frame(static_cast<size_t>(image.width) * image.height);
+
+        // Warm up, faults the frame in
+        PixelKernels::ingestRaw(image, frame.data());
+
+        double single = run(image, frame, 1, iterations);
+        auto threadedStart = Clock::now();
+        double threaded = run(image, frame, cores, iterations);
+        totalSeconds += seconds(threadedStart);
+        totalBytes += frame.size() * sizeof(uint16_t) * iterations;
+
+        const char *name = strrchr(argv[i], '/');
+        printf("%-32.32s %9.1f %10.1f %7.0f MB/s %7.0f MB/s\n", name ? name + 1 : argv[i],
+               frame.size() / 1e6, unpackMs, single, threaded);
+
+        processor.recycle();
+    }
+
+    if (totalSeconds > 0)
+        printf("Overall %.0f MB/s with %u threads\n", totalBytes / totalSeconds / 1e6, cores);
+
+    return 0;
+}
@@ -6,11 +6,7 @@
 
 #include <jpeglib.h>
 #include <fitsio.h>
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-// the older libraw uses auto_ptr
-#include <libraw.h>
-#pragma GCC diagnostic pop
+#include <librawingest.h>
 
 
 #include <unistd.h>
@@ -137,145 +133,132 @@ int dcraw_parse_header_info(const char *filename, struct dcraw_header *header)
     return 0;
 }
 
-int read_libraw(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel,
-                char *bayer_pattern)
+// Unpack the raw image opened by RawProcessor and copy it, or the crop window, into a 16 bit bayered frame
+static int unpack_libraw(LibRaw &RawProcessor, const char *name, uint8_t **memptr, size_t *memsize, int *n_axis, int *w,
+                         int *h, int *bitsperpixel, char *bayer_pattern, PixelKernels::RawWindow *crop)
 {
-    int ret = 0;
-    // Creation of image processing object
-    LibRaw RawProcessor;
-
-    // Let us open the file
-    if ((ret = RawProcessor.open_file(filename)) != LIBRAW_SUCCESS)
-    {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot open %s: %s", filename, libraw_strerror(ret));
-        RawProcessor.recycle();
-        return -1;
-    }
-
-    // Let us unpack the image
-    if ((ret = RawProcessor.unpack()) != LIBRAW_SUCCESS)
-    {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot unpack %s: %s", filename, libraw_strerror(ret));
-        RawProcessor.recycle();
-        return -1;
-    }
-
-    // Covert to image
-    if ((ret = RawProcessor.raw2image()) != LIBRAW_SUCCESS)
+    PixelKernels::RawImage image;
+    int ret = PixelKernels::unpackLibRaw(RawProcessor, &image, bayer_pattern);
+    if (ret != LIBRAW_SUCCESS)
     {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot convert %s : %s", filename, libraw_strerror(ret));
-        RawProcessor.recycle();
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot unpack %s: %s", name, libraw_strerror(ret));
         return -1;
     }
 
     *n_axis       = 2;
-    *w            = RawProcessor.imgdata.rawdata.sizes.width;
-    *h            = RawProcessor.imgdata.rawdata.sizes.height;
+    *w            = image.width;
+    *h            = image.height;
     *bitsperpixel = 16;
-    // cdesc contains counter-clock wise e.g. RGBG CFA pattern while we want it sequential as RGGB
-    bayer_pattern[0] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(0, 0)];
-    bayer_pattern[1] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(0, 1)];
-    bayer_pattern[2] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(1, 0)];
-    bayer_pattern[3] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(1, 1)];
-    bayer_pattern[4] = '\0';
-
-    int first_visible_pixel = RawProcessor.imgdata.rawdata.sizes.raw_width * RawProcessor.imgdata.sizes.top_margin +
-                              RawProcessor.imgdata.sizes.left_margin;
 
     DEBUGFDEVICE(device, INDI::Logger::DBG_DEBUG,
-                 "read_libraw: raw_width: %d top_margin %d left_margin %d first_visible_pixel %d",
-                 RawProcessor.imgdata.rawdata.sizes.raw_width, RawProcessor.imgdata.sizes.top_margin,
-                 RawProcessor.imgdata.sizes.left_margin, first_visible_pixel);
+                 "read_libraw: raw_width: %d raw_pitch %zu top_margin %d left_margin %d",
+                 RawProcessor.imgdata.rawdata.sizes.raw_width, image.pitch, image.top, image.left);
+
+    PixelKernels::RawWindow window = PixelKernels::fitRawWindow(image, crop);
 
-    *memsize = RawProcessor.imgdata.rawdata.sizes.width * RawProcessor.imgdata.rawdata.sizes.height * sizeof(uint16_t);
+    *memsize = window.width * window.height * sizeof(uint16_t);
     *memptr  = static_cast<uint8_t *>(IDSharedBlobRealloc(*memptr, *memsize));
     if (*memptr == nullptr)
         *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
     if (*memptr == nullptr)
     {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
         return -1;
     }
 
     DEBUGFDEVICE(device, INDI::Logger::DBG_DEBUG,
-                 "read_libraw: rawdata.sizes.width: %d rawdata.sizes.height %d memsize %d bayer_pattern %s",
-                 RawProcessor.imgdata.rawdata.sizes.width, RawProcessor.imgdata.rawdata.sizes.height, *memsize,
-                 bayer_pattern);
+                 "read_libraw: rawdata.sizes.width: %d rawdata.sizes.height %d memsize %zu bayer_pattern %s",
+                 image.width, image.height, *memsize, bayer_pattern);
 
-    uint16_t *image = reinterpret_cast<uint16_t *>(*memptr);
-    uint16_t *src   = RawProcessor.imgdata.rawdata.raw_image + first_visible_pixel;
-
-    for (int i = 0; i < RawProcessor.imgdata.rawdata.sizes.height; i++)
+    if (!PixelKernels::ingestRaw(image, window, reinterpret_cast<uint16_t *>(*memptr)))
     {
-        memcpy(image, src, RawProcessor.imgdata.rawdata.sizes.width * 2);
-        image += RawProcessor.imgdata.rawdata.sizes.width;
-        src += RawProcessor.imgdata.rawdata.sizes.raw_width;
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot copy %s: invalid raw image geometry", name);
+        return -1;
     }
 
     return 0;
 }
 
-int read_jpeg(const char *filename, uint8_t **memptr, size_t *memsize, int *naxis, int *w, int *h)
+int read_libraw(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel,
+                char *bayer_pattern, PixelKernels::RawWindow *crop)
 {
-    unsigned char *r_data = nullptr, *g_data = nullptr, *b_data = nullptr;
+    int ret = 0;
+    // Creation of image processing object
+    LibRaw RawProcessor;
 
-    /* these are standard libjpeg structures for reading(decompression) */
-    struct jpeg_decompress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    /* libjpeg data structure for storing one row, that is, scanline of an image */
-    JSAMPROW row_pointer[1] = { nullptr };
+    // Let us open the file
+    if ((ret = RawProcessor.open_file(filename)) != LIBRAW_SUCCESS)
+    {
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot open %s: %s", filename, libraw_strerror(ret));
+        RawProcessor.recycle();
+        return -1;
+    }
 
-    FILE *infile = fopen(filename, "rb");
+    return unpack_libraw(RawProcessor, filename, memptr, memsize, n_axis, w, h, bitsperpixel, bayer_pattern, crop);
+}
 
-    if (!infile)
+int read_libraw_mem(const void *inBuffer, size_t inSize, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h,
+                    int *bitsperpixel, char *bayer_pattern, PixelKernels::RawWindow *crop)
+{
+    int ret = 0;
+    // Creation of image processing object
+    LibRaw RawProcessor;
+
+    // LibRaw decodes straight from the downloaded file, the buffer must stay valid until we are done
+    if ((ret = RawProcessor.open_buffer(const_cast<void *>(inBuffer), inSize)) != LIBRAW_SUCCESS)
     {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_DEBUG, "Error opening jpeg file %s!", filename);
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "Cannot open raw buffer: %s", libraw_strerror(ret));
+        RawProcessor.recycle();
         return -1;
     }
-    /* here we set up the standard libjpeg error handler */
-    cinfo.err = jpeg_std_error(&jerr);
-    /* setup decompression process and source, then read JPEG header */
-    jpeg_create_decompress(&cinfo);
-    /* this makes the library read from infile */
-    jpeg_stdio_src(&cinfo, infile);
+
+    return unpack_libraw(RawProcessor, "raw buffer", memptr, memsize, n_axis, w, h, bitsperpixel, bayer_pattern, crop);
+}
+
+// Decompress into planar RGB (or mono), the source must be set on cinfo already
+static int decompress_jpeg_planar(jpeg_decompress_struct *cinfo, uint8_t **memptr, size_t *memsize, int *naxis, int *w,
+                                  int *h)
+{
+    unsigned char *r_data = nullptr, *g_data = nullptr, *b_data = nullptr, *mono_data = nullptr;
+    /* libjpeg data structure for storing one row, that is, scanline of an image */
+    JSAMPROW row_pointer[1] = { nullptr };
+
     /* reading the image header which contains image information */
-    jpeg_read_header(&cinfo, (boolean)TRUE);
+    jpeg_read_header(cinfo, (boolean)TRUE);
 
     /* Start decompression jpeg here */
-    jpeg_start_decompress(&cinfo);
+    jpeg_start_decompress(cinfo);
 
-    *memsize = cinfo.output_width * cinfo.output_height * cinfo.num_components;
+    *memsize = cinfo->output_width * cinfo->output_height * cinfo->num_components;
     *memptr  = static_cast<uint8_t *>(IDSharedBlobRealloc(*memptr, *memsize));
     if (*memptr == nullptr)
         *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
     if (*memptr == nullptr)
     {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        jpeg_abort_decompress(cinfo);
         return -1;
     }
-    // if you do some ugly pointer math, remember to restore the original pointer or some random crashes will happen. This is why I do not like pointers!!
-    uint8_t *oldmem = *memptr;
-    *naxis = cinfo.num_components;
-    *w     = cinfo.output_width;
-    *h     = cinfo.output_height;
+    *naxis = cinfo->num_components;
+    *w     = cinfo->output_width;
+    *h     = cinfo->output_height;
 
     /* now actually read the jpeg into the raw buffer */
-    row_pointer[0] = (unsigned char *)malloc(cinfo.output_width * cinfo.num_components);
-    if (cinfo.num_components)
-    {
-        r_data = (unsigned char *)*memptr;
-        g_data = r_data + cinfo.output_width * cinfo.output_height;
-        b_data = r_data + 2 * cinfo.output_width * cinfo.output_height;
-    }
+    row_pointer[0] = (unsigned char *)malloc(cinfo->output_width * cinfo->num_components);
+    r_data    = *memptr;
+    g_data    = r_data + cinfo->output_width * cinfo->output_height;
+    b_data    = r_data + 2 * cinfo->output_width * cinfo->output_height;
+    mono_data = *memptr;
+
     /* read one scan line at a time */
-    for (unsigned int row = 0; row < cinfo.image_height; row++)
+    for (unsigned int row = 0; row < cinfo->image_height; row++)
     {
         unsigned char *ppm8 = row_pointer[0];
-        jpeg_read_scanlines(&cinfo, row_pointer, 1);
+        jpeg_read_scanlines(cinfo, row_pointer, 1);
 
-        if (cinfo.num_components == 3)
+        if (cinfo->num_components == 3)
         {
-            for (unsigned int i = 0; i < cinfo.output_width; i++)
+            for (unsigned int i = 0; i < cinfo->output_width; i++)
             {
                 *r_data++ = *ppm8++;
                 *g_data++ = *ppm8++;
@@ -284,25 +267,70 @@ int read_jpeg(const char *filename, uint8_t **memptr, size_t *memsize, int *naxi
         }
         else
         {
-            memcpy(*memptr, ppm8, cinfo.output_width);
-            *memptr += cinfo.output_width;
+            memcpy(mono_data, ppm8, cinfo->output_width);
+            mono_data += cinfo->output_width;
         }
     }
 
-    /* wrap up decompression, destroy objects, free pointers and close open files */
-    jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
+    /* wrap up decompression */
+    jpeg_finish_decompress(cinfo);
 
     if (row_pointer[0])
         free(row_pointer[0]);
-    if (infile)
-        fclose(infile);
-
-    *memptr = oldmem;
 
     return 0;
 }
 
+int read_jpeg(const char *filename, uint8_t **memptr, size_t *memsize, int *naxis, int *w, int *h)
+{
+    /* these are standard libjpeg structures for reading(decompression) */
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+
+    FILE *infile = fopen(filename, "rb");
+
+    if (!infile)
+    {
+        DEBUGFDEVICE(device, INDI::Logger::DBG_DEBUG, "Error opening jpeg file %s!", filename);
+        return -1;
+    }
+    /* here we set up the standard libjpeg error handler */
+    cinfo.err = jpeg_std_error(&jerr);
+    /* setup decompression process and source, then read JPEG header */
+    jpeg_create_decompress(&cinfo);
+    /* this makes the library read from infile */
+    jpeg_stdio_src(&cinfo, infile);
+
+    int rc = decompress_jpeg_planar(&cinfo, memptr, memsize, naxis, w, h);
+
+    /* destroy objects and close open files */
+    jpeg_destroy_decompress(&cinfo);
+    fclose(infile);
+
+    return rc;
+}
+
+int read_jpeg_planar_mem(const unsigned char *inBuffer, unsigned long inSize, uint8_t **memptr, size_t *memsize,
+                         int *naxis, int *w, int *h)
+{
+    /* these are standard libjpeg structures for reading(decompression) */
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+
+    /* here we set up the standard libjpeg error handler */
+    cinfo.err = jpeg_std_error(&jerr);
+    /* setup decompression process and source, then read JPEG header */
+    jpeg_create_decompress(&cinfo);
+    /* this makes the library read from the downloaded buffer */
+    jpeg_mem_src(&cinfo, const_cast<unsigned char *>(inBuffer), inSize);
+
+    int rc = decompress_jpeg_planar(&cinfo, memptr, memsize, naxis, w, h);
+
+    jpeg_destroy_decompress(&cinfo);
+
+    return rc;
+}
+
 int read_jpeg_mem(unsigned char *inBuffer, unsigned long inSize, uint8_t **memptr, size_t *memsize, int *naxis, int *w,
                   int *h)
 {
@@ -331,7 +359,7 @@ int read_jpeg_mem(unsigned char *inBuffer, unsigned long inSize, uint8_t **mempt
         *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
     if (*memptr == nullptr)
     {
-        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        DEBUGFDEVICE(device, INDI::Logger::DBG_ERROR, "%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
         return -1;
     }
 
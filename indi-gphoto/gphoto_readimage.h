@@ -4,9 +4,18 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rawingest.h>
+
+// w and h are always the full image size. If crop is given and fits in the image, only that window is
+// copied to memptr, otherwise crop is set to an empty window and the full image is copied.
 int read_libraw(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel,
-                char *bayer_pattern);
+                char *bayer_pattern, PixelKernels::RawWindow *crop = nullptr);
+int read_libraw_mem(const void *inBuffer, size_t inSize, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h,
+                    int *bitsperpixel, char *bayer_pattern, PixelKernels::RawWindow *crop = nullptr);
 int read_jpeg(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h);
+// Same output as read_jpeg (planar RGB), decoded from an in-memory JPEG
+int read_jpeg_planar_mem(const unsigned char *inBuffer, unsigned long inSize, uint8_t **memptr, size_t *memsize,
+                         int *naxis, int *w, int *h);
 int read_jpeg_mem(unsigned char *inBuffer, unsigned long inSize, uint8_t **memptr, size_t *memsize, int *naxis, int *w,
                   int *h);
 int read_jpeg_size(unsigned char *inBuffer, unsigned long inSize, int *w, int *h);
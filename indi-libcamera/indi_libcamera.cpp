@@ -40,8 +40,9 @@
 #include <fcntl.h>
 #include <signal.h>
 
-#include <libraw.h>
+#include <librawingest.h>
 #include <jpeglib.h>
+#include <libcamera/formats.h>
 
 
 #define CONTROL_TAB "Controls"
@@ -126,6 +127,9 @@ int INDILibCamera::getColorspaceFlags(std::string const &codec)
 /////////////////////////////////////////////////////////////////////////////
 void INDILibCamera::workerStreamVideo(const std::atomic_bool &isAboutToQuit, double framerate)
 {
+    // The video pipeline needs the camera for itself
+    closeStillSession();
+
     RPiCamEncoder app;
     auto options = app.GetOptions();
     configureVideoOptions(options, framerate);
@@ -222,41 +226,39 @@ void INDILibCamera::metadataReady(libcamera::ControlList &metadata)
 /////////////////////////////////////////////////////////////////////////////
 void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float duration)
 {
-    RPiCamINDIApp app;
+    // The camera stays open and configured between exposures, only started and stopped around each one
+    if (!openStillSession(duration))
+    {
+        PrimaryCCD.setExposureFailed();
+        return;
+    }
+
+    RPiCamINDIApp &app = *m_StillApp;
     auto options = app.GetOptions();
-    configureStillOptions(options, duration);
-    unsigned int still_flags = RPiCamApp::FLAG_STILL_RAW;
 
     try
     {
-        app.OpenCamera();
-        app.ConfigureStill(still_flags);
         app.StartCamera();
     }
     catch (std::exception &e)
     {
-        LOGF_ERROR("Error opening camera: %s", e.what());
+        LOGF_ERROR("Error starting camera: %s", e.what());
         PrimaryCCD.setExposureFailed();
-        app.StopCamera();
-        app.Teardown();
-        app.CloseCamera();
+        closeStillSession();
+        return;
     }
 
     RPiCamApp::Msg msg = app.Wait();
     if (msg.type != RPiCamApp::MsgType::RequestComplete)
     {
         PrimaryCCD.setExposureFailed();
-        app.StopCamera();
-        app.Teardown();
-        app.CloseCamera();
+        closeStillSession();
         LOGF_ERROR("Exposure failed: %d", msg.type);
         return;
     }
     else if (isAboutToQuit)
     {
         app.StopCamera();
-        app.Teardown();
-        app.CloseCamera();
         return;
     }
 
@@ -270,38 +272,51 @@ void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float
     try
     {
         char filename[MAXINDIFORMAT] {0};
+        char bayer_pattern[8] = {};
+        uint8_t * memptr = PrimaryCCD.getFrameBuffer();
+        size_t memsize = 0;
+        int naxis = 2, w = 0, h = 0, bpp = 8;
 
-        if (raw)
-        {
-            strncpy(filename, "/tmp/output.dng", MAXINDIFORMAT);
-            dng_save(mem, info, payload->metadata, filename, app.CameraId(), options);
-        }
-        else
+        // Subframes are cut out while copying the raw samples
+        PixelKernels::RawWindow crop;
+        crop.x      = PrimaryCCD.getSubX();
+        crop.y      = PrimaryCCD.getSubY();
+        crop.width  = PrimaryCCD.getSubW();
+        crop.height = PrimaryCCD.getSubH();
+
+        // Bayer data for FITS is unpacked straight from the request buffer. The DNG is only written
+        // when it is the requested output, or the sensor format is not one we can unpack.
+        bool inMemory = raw && EncodeFormatSP[FORMAT_FITS].getState() == ISS_ON &&
+                        processRAWStream(mem[0], info, &memptr, &memsize, &naxis, &w, &h, &bpp, bayer_pattern, &crop);
+
+        if (!raw)
         {
             strncpy(filename, "/tmp/output.jpg", MAXINDIFORMAT);
             jpeg_save(mem, info, payload->metadata, filename, app.CameraId(), options);
         }
+        else if (!inMemory)
+        {
+            strncpy(filename, "/tmp/output.dng", MAXINDIFORMAT);
+            dng_save(mem, info, payload->metadata, filename, app.CameraId(), options);
+        }
 
-        char bayer_pattern[8] = {};
-        uint8_t * memptr = PrimaryCCD.getFrameBuffer();
-        size_t memsize = 0;
-        int naxis = 2, w = 0, h = 0, bpp = 8;
+        // True once the raw reader already copied just the requested subframe
+        bool rawCropped = false;
 
         if (EncodeFormatSP[FORMAT_FITS].getState() == ISS_ON)
         {
             if (CaptureFormatSP.findOnSwitchIndex() == CAPTURE_DNG)
             {
-                if (!processRAW(filename, &memptr, &memsize, &naxis, &w, &h, &bpp, bayer_pattern))
+                if (!inMemory && !processRAW(filename, &memptr, &memsize, &naxis, &w, &h, &bpp, bayer_pattern, &crop))
                 {
                     LOG_ERROR("Exposure failed to parse raw image.");
                     PrimaryCCD.setExposureFailed();
                     app.StopCamera();
-                    app.Teardown();
-                    app.CloseCamera();
                     unlink(filename);
                     return;
                 }
 
+                rawCropped = crop.width > 0 && crop.height > 0;
                 SetCCDCapability(GetCCDCapability() | CCD_HAS_BAYER);
                 IUSaveText(&BayerT[2], bayer_pattern);
                 IDSetText(&BayerTP, nullptr);
@@ -313,13 +328,11 @@ void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float
                     LOG_ERROR("Exposure failed to parse jpeg.");
                     PrimaryCCD.setExposureFailed();
                     app.StopCamera();
-                    app.Teardown();
-                    app.CloseCamera();
                     unlink(filename);
                     return;
                 }
 
-                LOGF_DEBUG("read_jpeg: memsize (%d) naxis (%d) w (%d) h (%d) bpp (%d)", memsize, naxis, w, h, bpp);
+                LOGF_DEBUG("read_jpeg: memsize (%zu) naxis (%d) w (%d) h (%d) bpp (%d)", memsize, naxis, w, h, bpp);
 
                 SetCCDCapability(GetCCDCapability() & ~CCD_HAS_BAYER);
             }
@@ -349,10 +362,14 @@ void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float
 
                 if (naxis == 2)
                 {
-                    // JM 2020-08-29: Using memmove since regions are overlaping
-                    // as proposed by Camiel Severijns on INDI forums.
-                    for (int i = subY; i < subY + subH; i++)
-                        memmove(memptr + (i - subY) * lineW, memptr + (i * w + subX) * bpp / 8, lineW);
+                    // Raw images are already cropped by the reader
+                    if (!rawCropped)
+                    {
+                        // JM 2020-08-29: Using memmove since regions are overlaping
+                        // as proposed by Camiel Severijns on INDI forums.
+                        for (int i = subY; i < subY + subH; i++)
+                            memmove(memptr + (i - subY) * lineW, memptr + (i * w + subX) * bpp / 8, lineW);
+                    }
                 }
                 else
                 {
@@ -412,8 +429,6 @@ void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float
                 LOGF_ERROR("Error opening file %s: %s", filename, strerror(errno));
                 PrimaryCCD.setExposureFailed();
                 app.StopCamera();
-                app.Teardown();
-                app.CloseCamera();
                 close(fd);
                 return;
             }
@@ -438,8 +453,6 @@ void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float
                     LOGF_ERROR("Error reading file %s: %s", filename, strerror(errno));
                     PrimaryCCD.setExposureFailed();
                     app.StopCamera();
-                    app.Teardown();
-                    app.CloseCamera();
                     close(fd);
                     return;
                 }
@@ -471,8 +484,6 @@ void INDILibCamera::workerExposure(const std::atomic_bool &isAboutToQuit, float
     }
 
     app.StopCamera();
-    app.Teardown();
-    app.CloseCamera();
 }
 
 /*
@@ -653,6 +664,67 @@ void INDILibCamera::configureStillOptions(StillOptions *options, double duration
     options->height = PrimaryCCD.getSubH();
 }
 
+/////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////
+bool INDILibCamera::openStillSession(double duration)
+{
+    // Only the stream size and denoise mode need the camera to be configured again. Exposure,
+    // gain and the image adjustments are applied as controls each time the camera is started.
+    std::string configuration = std::to_string(PrimaryCCD.getSubW()) + "x" + std::to_string(PrimaryCCD.getSubH()) +
+                                " " + AdjustDenoiseModeSP.findOnSwitch()->getName();
+
+    if (m_StillApp && configuration == m_StillConfiguration)
+    {
+        configureStillOptions(m_StillApp->GetOptions(), duration);
+        return true;
+    }
+
+    closeStillSession();
+
+    m_StillApp.reset(new RPiCamINDIApp());
+    configureStillOptions(m_StillApp->GetOptions(), duration);
+
+    try
+    {
+        m_StillApp->OpenCamera();
+        m_StillApp->ConfigureStill(RPiCamApp::FLAG_STILL_RAW);
+    }
+    catch (std::exception &e)
+    {
+        LOGF_ERROR("Error opening camera: %s", e.what());
+        closeStillSession();
+        return false;
+    }
+
+    m_StillConfiguration = configuration;
+    LOGF_DEBUG("Still capture session configured (%s).", configuration.c_str());
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////
+void INDILibCamera::closeStillSession()
+{
+    if (!m_StillApp)
+        return;
+
+    try
+    {
+        m_StillApp->StopCamera();
+        m_StillApp->Teardown();
+        m_StillApp->CloseCamera();
+    }
+    catch (std::exception &e)
+    {
+        LOGF_WARN("Error closing camera: %s", e.what());
+    }
+
+    m_StillApp.reset();
+    m_StillConfiguration.clear();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 ///
 /////////////////////////////////////////////////////////////////////////////
@@ -720,6 +792,7 @@ bool INDILibCamera::Connect()
 bool INDILibCamera::Disconnect()
 {
     m_Worker.quit();
+    closeStillSession();
     return true;
 }
 
@@ -982,7 +1055,7 @@ bool INDILibCamera::SetCaptureFormat(uint8_t index)
 /////////////////////////////////////////////////////////////////////////////
 bool INDILibCamera::processRAW(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h,
                                int *bitsperpixel,
-                               char *bayer_pattern)
+                               char *bayer_pattern, PixelKernels::RawWindow *crop)
 {
     int ret = 0;
     // Creation of image processing object
@@ -996,65 +1069,7 @@ bool INDILibCamera::processRAW(const char *filename, uint8_t **memptr, size_t *m
         return false;
     }
 
-    // Let us unpack the image
-    if ((ret = RawProcessor.unpack()) != LIBRAW_SUCCESS)
-    {
-        LOGF_ERROR( "Cannot unpack %s: %s", filename, libraw_strerror(ret));
-        RawProcessor.recycle();
-        return false;
-    }
-
-    // Covert to image
-    if ((ret = RawProcessor.raw2image()) != LIBRAW_SUCCESS)
-    {
-        LOGF_ERROR("Cannot convert %s : %s", filename, libraw_strerror(ret));
-        RawProcessor.recycle();
-        return false;
-    }
-
-    *n_axis       = 2;
-    *w            = RawProcessor.imgdata.rawdata.sizes.width;
-    *h            = RawProcessor.imgdata.rawdata.sizes.height;
-    *bitsperpixel = 16;
-    // cdesc contains counter-clock wise e.g. RGBG CFA pattern while we want it sequential as RGGB
-    bayer_pattern[0] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(0, 0)];
-    bayer_pattern[1] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(0, 1)];
-    bayer_pattern[2] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(1, 0)];
-    bayer_pattern[3] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(1, 1)];
-    bayer_pattern[4] = '\0';
-
-    int first_visible_pixel = RawProcessor.imgdata.rawdata.sizes.raw_width * RawProcessor.imgdata.sizes.top_margin +
-                              RawProcessor.imgdata.sizes.left_margin;
-
-    LOGF_DEBUG("read_libraw: raw_width: %d top_margin %d left_margin %d first_visible_pixel %d",
-               RawProcessor.imgdata.rawdata.sizes.raw_width, RawProcessor.imgdata.sizes.top_margin,
-               RawProcessor.imgdata.sizes.left_margin, first_visible_pixel);
-
-    *memsize = RawProcessor.imgdata.rawdata.sizes.width * RawProcessor.imgdata.rawdata.sizes.height * sizeof(uint16_t);
-    *memptr  = static_cast<uint8_t *>(IDSharedBlobRealloc(*memptr, *memsize));
-    if (*memptr == nullptr)
-        *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
-    if (*memptr == nullptr)
-    {
-        LOGF_ERROR("%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
-        return false;
-    }
-
-    LOGF_DEBUG("read_libraw: rawdata.sizes.width: %d rawdata.sizes.height %d memsize %d bayer_pattern %s",
-               RawProcessor.imgdata.rawdata.sizes.width, RawProcessor.imgdata.rawdata.sizes.height, *memsize,
-               bayer_pattern);
-
-    uint16_t *image = reinterpret_cast<uint16_t *>(*memptr);
-    uint16_t *src   = RawProcessor.imgdata.rawdata.raw_image + first_visible_pixel;
-
-    for (int i = 0; i < RawProcessor.imgdata.rawdata.sizes.height; i++)
-    {
-        memcpy(image, src, RawProcessor.imgdata.rawdata.sizes.width * 2);
-        image += RawProcessor.imgdata.rawdata.sizes.width;
-        src += RawProcessor.imgdata.rawdata.sizes.raw_width;
-    }
-
-    return true;
+    return processRAWImage(RawProcessor, memptr, memsize, n_axis, w, h, bitsperpixel, bayer_pattern, crop);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1075,71 +1090,147 @@ bool INDILibCamera::processRAWMemory(unsigned char *inBuffer, unsigned long inSi
         return false;
     }
 
-    // Let us unpack the image
-    if ((ret = RawProcessor.unpack()) != LIBRAW_SUCCESS)
+    if (!processRAWImage(RawProcessor, memptr, memsize, n_axis, w, h, bitsperpixel, bayer_pattern, nullptr))
+        return false;
+
+    if (m_LiveVideoWidth <= 0)
     {
-        LOGF_ERROR( "Cannot unpack buffer %s", libraw_strerror(ret));
-        RawProcessor.recycle();
+        m_LiveVideoWidth = *w;
+        m_LiveVideoHeight = *h;
+        PrimaryCCD.setBin(1, 1);
+        PrimaryCCD.setFrame(0, 0, m_LiveVideoWidth, m_LiveVideoHeight);
+        Streamer->setSize(m_LiveVideoWidth, m_LiveVideoHeight);
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/// Unpack the Bayer samples of a raw stream buffer, or the crop window, into memptr.
+/// Returns false if the sensor format is not a plain or CSI-2 packed Bayer format.
+/////////////////////////////////////////////////////////////////////////////
+bool INDILibCamera::processRAWStream(const libcamera::Span<uint8_t> &mem, const StreamInfo &info, uint8_t **memptr,
+                                     size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel, char *bayer_pattern,
+                                     PixelKernels::RawWindow *crop)
+{
+    static const struct
+    {
+        libcamera::PixelFormat format;
+        PixelKernels::RawPacking packing;
+        const char *bayer;
+    } rawFormats[] =
+    {
+        { libcamera::formats::SRGGB10_CSI2P, PixelKernels::RAW_CSI2_10, "RGGB" },
+        { libcamera::formats::SGRBG10_CSI2P, PixelKernels::RAW_CSI2_10, "GRBG" },
+        { libcamera::formats::SBGGR10_CSI2P, PixelKernels::RAW_CSI2_10, "BGGR" },
+        { libcamera::formats::SGBRG10_CSI2P, PixelKernels::RAW_CSI2_10, "GBRG" },
+        { libcamera::formats::SRGGB12_CSI2P, PixelKernels::RAW_CSI2_12, "RGGB" },
+        { libcamera::formats::SGRBG12_CSI2P, PixelKernels::RAW_CSI2_12, "GRBG" },
+        { libcamera::formats::SBGGR12_CSI2P, PixelKernels::RAW_CSI2_12, "BGGR" },
+        { libcamera::formats::SGBRG12_CSI2P, PixelKernels::RAW_CSI2_12, "GBRG" },
+        { libcamera::formats::SRGGB10, PixelKernels::RAW_16BIT, "RGGB" },
+        { libcamera::formats::SGRBG10, PixelKernels::RAW_16BIT, "GRBG" },
+        { libcamera::formats::SBGGR10, PixelKernels::RAW_16BIT, "BGGR" },
+        { libcamera::formats::SGBRG10, PixelKernels::RAW_16BIT, "GBRG" },
+        { libcamera::formats::SRGGB12, PixelKernels::RAW_16BIT, "RGGB" },
+        { libcamera::formats::SGRBG12, PixelKernels::RAW_16BIT, "GRBG" },
+        { libcamera::formats::SBGGR12, PixelKernels::RAW_16BIT, "BGGR" },
+        { libcamera::formats::SGBRG12, PixelKernels::RAW_16BIT, "GBRG" },
+        { libcamera::formats::SRGGB16, PixelKernels::RAW_16BIT, "RGGB" },
+        { libcamera::formats::SGRBG16, PixelKernels::RAW_16BIT, "GRBG" },
+        { libcamera::formats::SBGGR16, PixelKernels::RAW_16BIT, "BGGR" },
+        { libcamera::formats::SGBRG16, PixelKernels::RAW_16BIT, "GBRG" },
+    };
+
+    auto rawFormat = std::find_if(std::begin(rawFormats), std::end(rawFormats), [&info](const auto &entry)
+    {
+        return entry.format == info.pixel_format;
+    });
+
+    if (rawFormat == std::end(rawFormats))
+    {
+        LOGF_DEBUG("Raw format %s is not unpacked in memory, using DNG.", info.pixel_format.toString().c_str());
         return false;
     }
 
-    // Covert to image
-    if ((ret = RawProcessor.raw2image()) != LIBRAW_SUCCESS)
+    if (mem.size() < static_cast<size_t>(info.stride) * info.height)
     {
-        LOGF_ERROR("Cannot convert %s", libraw_strerror(ret));
-        RawProcessor.recycle();
+        LOGF_ERROR("Raw buffer too small: %zu bytes for %ux%u stride %u.", mem.size(), info.width, info.height, info.stride);
         return false;
     }
 
+    PixelKernels::RawImage image;
+    image.data    = mem.data();
+    image.packing = rawFormat->packing;
+    image.pitch   = info.stride;
+    image.width   = info.width;
+    image.height  = info.height;
+
     *n_axis       = 2;
-    *w            = RawProcessor.imgdata.rawdata.sizes.width;
-    *h            = RawProcessor.imgdata.rawdata.sizes.height;
+    *w            = image.width;
+    *h            = image.height;
     *bitsperpixel = 16;
-    // cdesc contains counter-clock wise e.g. RGBG CFA pattern while we want it sequential as RGGB
-    bayer_pattern[0] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(0, 0)];
-    bayer_pattern[1] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(0, 1)];
-    bayer_pattern[2] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(1, 0)];
-    bayer_pattern[3] = RawProcessor.imgdata.idata.cdesc[RawProcessor.COLOR(1, 1)];
-    bayer_pattern[4] = '\0';
+    strncpy(bayer_pattern, rawFormat->bayer, 5);
 
-    if (m_LiveVideoWidth <= 0)
+    PixelKernels::RawWindow window = PixelKernels::fitRawWindow(image, crop);
+
+    *memsize = window.width * window.height * sizeof(uint16_t);
+    *memptr  = static_cast<uint8_t *>(IDSharedBlobRealloc(*memptr, *memsize));
+    if (*memptr == nullptr)
+        *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
+    if (*memptr == nullptr)
     {
-        m_LiveVideoWidth = *w;
-        m_LiveVideoHeight = *h;
-        PrimaryCCD.setBin(1, 1);
-        PrimaryCCD.setFrame(0, 0, m_LiveVideoWidth, m_LiveVideoHeight);
-        Streamer->setSize(m_LiveVideoWidth, m_LiveVideoHeight);
+        LOGF_ERROR("%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        return false;
+    }
+
+    LOGF_DEBUG("Raw stream %s: %dx%d stride %zu memsize %zu bayer_pattern %s", info.pixel_format.toString().c_str(),
+               image.width, image.height, image.pitch, *memsize, bayer_pattern);
+
+    return PixelKernels::ingestRaw(image, window, reinterpret_cast<uint16_t *>(*memptr));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/// Unpack an opened raw image and copy its bayered samples, or the crop window, into memptr.
+/////////////////////////////////////////////////////////////////////////////
+bool INDILibCamera::processRAWImage(LibRaw &RawProcessor, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h,
+                                    int *bitsperpixel, char *bayer_pattern, PixelKernels::RawWindow *crop)
+{
+    PixelKernels::RawImage image;
+    int ret = PixelKernels::unpackLibRaw(RawProcessor, &image, bayer_pattern);
+    if (ret != LIBRAW_SUCCESS)
+    {
+        LOGF_ERROR("Cannot unpack image %s", libraw_strerror(ret));
+        return false;
     }
 
-    int first_visible_pixel = RawProcessor.imgdata.rawdata.sizes.raw_width * RawProcessor.imgdata.sizes.top_margin +
-                              RawProcessor.imgdata.sizes.left_margin;
+    *n_axis       = 2;
+    *w            = image.width;
+    *h            = image.height;
+    *bitsperpixel = 16;
+
+    LOGF_DEBUG("read_libraw: raw_width: %d raw_pitch %zu top_margin %d left_margin %d",
+               RawProcessor.imgdata.rawdata.sizes.raw_width, image.pitch, image.top, image.left);
 
-    LOGF_DEBUG("read_libraw: raw_width: %d top_margin %d left_margin %d first_visible_pixel %d",
-               RawProcessor.imgdata.rawdata.sizes.raw_width, RawProcessor.imgdata.sizes.top_margin,
-               RawProcessor.imgdata.sizes.left_margin, first_visible_pixel);
+    PixelKernels::RawWindow window = PixelKernels::fitRawWindow(image, crop);
 
-    *memsize = RawProcessor.imgdata.rawdata.sizes.width * RawProcessor.imgdata.rawdata.sizes.height * sizeof(uint16_t);
+    *memsize = window.width * window.height * sizeof(uint16_t);
     *memptr  = static_cast<uint8_t *>(IDSharedBlobRealloc(*memptr, *memsize));
     if (*memptr == nullptr)
         *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
     if (*memptr == nullptr)
     {
-        LOGF_ERROR("%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        LOGF_ERROR("%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
         return false;
     }
 
-    LOGF_DEBUG("read_libraw: rawdata.sizes.width: %d rawdata.sizes.height %d memsize %d bayer_pattern %s",
-               RawProcessor.imgdata.rawdata.sizes.width, RawProcessor.imgdata.rawdata.sizes.height, *memsize,
-               bayer_pattern);
+    LOGF_DEBUG("read_libraw: rawdata.sizes.width: %d rawdata.sizes.height %d memsize %zu bayer_pattern %s",
+               image.width, image.height, *memsize, bayer_pattern);
 
-    uint16_t *image = reinterpret_cast<uint16_t *>(*memptr);
-    uint16_t *src   = RawProcessor.imgdata.rawdata.raw_image + first_visible_pixel;
-
-    for (int i = 0; i < RawProcessor.imgdata.rawdata.sizes.height; i++)
+    if (!PixelKernels::ingestRaw(image, window, reinterpret_cast<uint16_t *>(*memptr)))
     {
-        memcpy(image, src, RawProcessor.imgdata.rawdata.sizes.width * 2);
-        image += RawProcessor.imgdata.rawdata.sizes.width;
-        src += RawProcessor.imgdata.rawdata.sizes.raw_width;
+        LOG_ERROR("Cannot copy raw image: invalid geometry");
+        return false;
     }
 
     return true;
@@ -1183,7 +1274,7 @@ bool INDILibCamera::processJPEG(const char *filename, uint8_t **memptr, size_t *
         *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
     if (*memptr == nullptr)
     {
-        LOGF_ERROR("%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        LOGF_ERROR("%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
         return false;
     }
     // if you do some ugly pointer math, remember to restore the original pointer or some random crashes will happen. This is why I do not like pointers!!
@@ -1277,7 +1368,7 @@ int INDILibCamera::processJPEGMemory(unsigned char *inBuffer, unsigned long inSi
         *memptr = static_cast<uint8_t *>(IDSharedBlobAlloc(*memsize));
     if (*memptr == nullptr)
     {
-        LOGF_ERROR("%s: Failed to allocate %d bytes of memory!", __PRETTY_FUNCTION__, *memsize);
+        LOGF_ERROR("%s: Failed to allocate %zu bytes of memory!", __PRETTY_FUNCTION__, *memsize);
         return -1;
     }
 
@@ -32,6 +32,8 @@
 #include <indiccd.h>
 #include <inditimer.h>
 
+#include <rawingest.h>
+
 class RPiCamINDIApp : public RPiCamApp
 {
 public:
@@ -44,6 +46,7 @@ public:
 };
 
 class SingleWorker;
+class LibRaw;
 class INDILibCamera : public INDI::CCD
 {
 public:
@@ -95,6 +98,10 @@ protected:
     void initSwitch(INDI::PropertySwitch &switchSP, int n, const char **names);
 
     void configureStillOptions(StillOptions *options, double duration);
+
+    // Still capture session, kept open and configured across a sequence of exposures
+    bool openStillSession(double duration);
+    void closeStillSession();
     void configureVideoOptions(VideoOptions *options, double framerate);
 
 
@@ -108,7 +115,10 @@ protected:
         CAPTURE_JPG
     };
 
-    bool processRAW(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel, char *bayer_pattern);
+    // w and h are always the full image size. If crop is given and fits in the image, only that window is
+    // copied to memptr, otherwise crop is set to an empty window.
+    bool processRAW(const char *filename, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel, char *bayer_pattern,
+                    PixelKernels::RawWindow *crop = nullptr);
 
     bool processRAWMemory(unsigned char *inBuffer, unsigned long inSize, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel, char *bayer_pattern);
 
@@ -116,6 +126,12 @@ protected:
 
     int processJPEGMemory(unsigned char *inBuffer, unsigned long inSize, uint8_t **memptr, size_t *memsize, int *naxis, int *w, int *h);
 
+    bool processRAWStream(const libcamera::Span<uint8_t> &mem, const StreamInfo &info, uint8_t **memptr, size_t *memsize,
+                          int *n_axis, int *w, int *h, int *bitsperpixel, char *bayer_pattern, PixelKernels::RawWindow *crop);
+
+    bool processRAWImage(LibRaw &RawProcessor, uint8_t **memptr, size_t *memsize, int *n_axis, int *w, int *h, int *bitsperpixel,
+                         char *bayer_pattern, PixelKernels::RawWindow *crop);
+
     void shutdownVideo();
 
 private:
@@ -134,6 +150,9 @@ private:
     // std::unique_ptr<RPiCamApp> m_CameraApp;
     // std::unique_ptr<RPiCamEncoder> m_CameraEncoder;
 
+    std::unique_ptr<RPiCamINDIApp> m_StillApp;
+    std::string m_StillConfiguration;
+
     int m_LiveVideoWidth {-1}, m_LiveVideoHeight {-1};
     uint8_t m_CameraIndex;
     libcamera::ControlList m_ControlList;
@@ -24,6 +24,9 @@
 #include <indilogger.h>
 #include <memory>
 #include <deque>
+#include <chrono>
+#include <cstring>
+#include <fitsio.h>
 
 #define min(a, b)               \
     ({                          \
@@ -37,6 +40,9 @@
 #define MIN_FRAME_SIZE (512)
 #define MAX_FRAME_SIZE (SUBFRAME_SIZE * 16)
 #define SPECTRUM_SIZE  (256)
+#define STREAM_FIFO_SIZE (MAX_FRAME_SIZE * 4)
+#define RING_BLOCKS    (64)
+#define MAX_CONTINUUM_POINTS (65536)
 
 static class Loader
 {
@@ -100,6 +106,7 @@ bool LIMESDR::Connect()
 bool LIMESDR::Disconnect()
 {
     InIntegration = false;
+    stopStreaming();
     LMS_Close(lime_dev);
     setBufferSize(1);
     LOG_INFO("LIME-SDR Receiver disconnected successfully!");
@@ -142,6 +149,16 @@ bool LIMESDR::initProperties()
     IUFillBLOB(&TFitsB[4], "TRMT", "Transmit5", "");
     IUFillBLOBVector(&TFitsBP, TFitsB, 5, getDeviceName(), "LIME_TRMT", "Transmit Data", INTEGRATION_INFO_TAB, IP_WO, 60, IPS_IDLE);
 */
+    IUFillNumber(&SpectrumSettingsN[0], "SPECTRUM_SIZE", "FFT size", "%.0f", 16, 16384, 16, SPECTRUM_SIZE);
+    IUFillNumber(&SpectrumSettingsN[1], "SPECTROGRAM_ROWS", "Spectrogram rows", "%.0f", 0, 1024, 1, 0);
+    IUFillNumberVector(&SpectrumSettingsNP, SpectrumSettingsN, 2, getDeviceName(), "LIME_SPECTRUM_SETTINGS", "Spectrum",
+                       MAIN_CONTROL_TAB, IP_RW, 60, IPS_IDLE);
+
+    IUFillBLOB(&SpectrumB[0], "SPECTRUM", "Spectrum", "");
+    IUFillBLOB(&SpectrumB[1], "SPECTROGRAM", "Spectrogram", "");
+    IUFillBLOBVector(&SpectrumBP, SpectrumB, 2, getDeviceName(), "LIME_SPECTRUM", "Spectrum Data", MAIN_CONTROL_TAB, IP_RO, 60,
+                     IPS_IDLE);
+
     // Add Debug, Simulator, and Configuration controls
     addAuxControls();
 
@@ -164,6 +181,12 @@ bool LIMESDR::updateProperties()
         // Inital values
         setupParams(1000000, 1420000000, 10000, 10);
         //defineProperty(&TFitsBP);
+        defineProperty(&SpectrumSettingsNP);
+        defineProperty(&SpectrumBP);
+
+        // The stream runs as long as we are connected, an integration starts on the next block
+        if (!startStreaming())
+            LOG_ERROR("Failed to start the sample stream.");
 
         // Start the timer
         SetTimer(getCurrentPollingPeriod());
@@ -171,6 +194,8 @@ bool LIMESDR::updateProperties()
     else
     {
         //deleteProperty(TFitsBP.name);
+        deleteProperty(SpectrumSettingsNP.name);
+        deleteProperty(SpectrumBP.name);
     }
 
     return true;
@@ -181,24 +206,37 @@ bool LIMESDR::updateProperties()
 ***************************************************************************************/
 bool LIMESDR::StartIntegration(double duration)
 {
+    if (!streaming)
+    {
+        LOG_ERROR("The sample stream is not running.");
+        return false;
+    }
+
     IntegrationRequest = duration;
 
     // Since we have only have one Receiver with one chip, we set the exposure duration of the primary Receiver
     setIntegrationTime(duration);
-    b_read  = 0;
-    to_read = getSampleRate() * getIntegrationTime();
-
-    setBufferSize(to_read * sizeof(float));
+    size_t to_read = static_cast<size_t>(getSampleRate() * getIntegrationTime());
 
     if (to_read > 0)
     {
-        lime_stream.channel             = 0;
-        lime_stream.isTx                = false;
-        lime_stream.fifoSize            = to_read;
-        lime_stream.dataFmt             = lms_stream_t::LMS_FMT_F32;
-        lime_stream.throughputVsLatency = 0.5;
-        LMS_SetupStream(lime_dev, &lime_stream);
-        LMS_StartStream(&lime_stream);
+        // Largest power of two not above the requested size
+        size_t fftSize = 16;
+        while (fftSize * 2 <= static_cast<size_t>(SpectrumSettingsN[0].value))
+            fftSize *= 2;
+        {
+            std::lock_guard<std::mutex> lock(integratorMutex);
+            if (!integrator.begin(fftSize, to_read, MAX_CONTINUUM_POINTS, static_cast<size_t>(SpectrumSettingsN[1].value)))
+            {
+                LOG_ERROR("Failed to setup the integration.");
+                return false;
+            }
+            integrationReady = false;
+            droppedSamples = 0;
+            integrationSamples = to_read;
+            // Published last, the receiving thread reads it before the sample count
+            generation++;
+        }
         gettimeofday(&CapStart, nullptr);
         InIntegration = true;
         LOG_INFO("Integration started...");
@@ -209,18 +247,161 @@ bool LIMESDR::StartIntegration(double duration)
     return false;
 }
 
+/**************************************************************************************
+** Keep the stream running and reduce the samples while they arrive
+***************************************************************************************/
+bool LIMESDR::startStreaming()
+{
+    if (streaming)
+        return true;
+
+    memset(&lime_stream, 0, sizeof(lime_stream));
+    lime_stream.channel             = 0;
+    lime_stream.isTx                = false;
+    lime_stream.fifoSize            = STREAM_FIFO_SIZE;
+    lime_stream.dataFmt             = lms_stream_t::LMS_FMT_F32;
+    lime_stream.throughputVsLatency = 0.5;
+    if (LMS_SetupStream(lime_dev, &lime_stream) != 0)
+        return false;
+    if (LMS_StartStream(&lime_stream) != 0)
+    {
+        LMS_DestroyStream(lime_dev, &lime_stream);
+        return false;
+    }
+
+    ring.resize(RING_BLOCKS);
+    for (auto &block : ring)
+        block.iq.resize(SUBFRAME_SIZE * 2);
+    ringHead = 0;
+    ringTail = 0;
+
+    streaming = true;
+    receiveThread = std::thread(&LIMESDR::receiveSamples, this);
+    processThread = std::thread(&LIMESDR::processSamples, this);
+    return true;
+}
+
+void LIMESDR::stopStreaming()
+{
+    if (!streaming)
+        return;
+
+    streaming = false;
+    ringCond.notify_all();
+    receiveThread.join();
+    processThread.join();
+
+    std::lock_guard<std::mutex> lock(streamMutex);
+    LMS_StopStream(&lime_stream);
+    LMS_DestroyStream(lime_dev, &lime_stream);
+    ring.clear();
+}
+
+void LIMESDR::receiveSamples()
+{
+    // Received while the ring is full, then thrown away
+    Block overflow;
+    overflow.iq.resize(SUBFRAME_SIZE * 2);
+
+    uint32_t current = generation;
+    size_t assigned = 0, lost = 0;
+    bool finishing = false;
+
+    while (streaming)
+    {
+        uint32_t gen = generation.load(std::memory_order_acquire);
+        if (gen != current)
+        {
+            current   = gen;
+            assigned  = 0;
+            lost      = 0;
+            finishing = false;
+        }
+
+        size_t head = ringHead.load(std::memory_order_relaxed);
+        bool full = head - ringTail.load(std::memory_order_acquire) >= ring.size();
+        Block &block = full ? overflow : ring[head % ring.size()];
+
+        int n;
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            n = LMS_RecvStream(&lime_stream, block.iq.data(), SUBFRAME_SIZE, nullptr, 100);
+        }
+        if (n <= 0)
+            continue;
+
+        size_t target    = integrationSamples.load(std::memory_order_acquire);
+        block.count      = static_cast<size_t>(n);
+        block.integrate  = target > assigned ? min(block.count, target - assigned) : 0;
+        block.generation = current;
+        assigned += block.integrate;
+        if (block.integrate > 0 && assigned == target)
+            finishing = true;
+
+        if (full)
+        {
+            // The next block queued accounts for these and ends the integration if this one should have
+            lost += block.integrate;
+            droppedSamples += block.integrate;
+            continue;
+        }
+
+        block.lost = lost;
+        block.last = finishing;
+        lost       = 0;
+        finishing  = false;
+        ringHead.store(head + 1, std::memory_order_release);
+        ringCond.notify_one();
+    }
+}
+
+void LIMESDR::processSamples()
+{
+    while (streaming)
+    {
+        size_t tail = ringTail.load(std::memory_order_relaxed);
+        if (tail == ringHead.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> lock(ringMutex);
+            ringCond.wait_for(lock, std::chrono::milliseconds(100));
+            continue;
+        }
+
+        Block &block = ring[tail % ring.size()];
+        if (block.integrate > 0 || block.lost > 0 || block.last)
+        {
+            std::lock_guard<std::mutex> lock(integratorMutex);
+            if (block.generation == generation && !integrationReady)
+            {
+                if (block.lost > 0)
+                    integrator.skip(block.lost);
+                integrator.add(block.iq.data(), block.integrate);
+                if (block.last)
+                    integrationReady = true;
+            }
+        }
+        ringTail.store(tail + 1, std::memory_order_release);
+    }
+}
+
 /**************************************************************************************
 ** Client is updating capture settings
 ***************************************************************************************/
 void LIMESDR::setupParams(float sr, float freq, float bw, float gain)
 {
     setBPS(-32);
+    // The stream is paused while the chip is reconfigured
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (streaming)
+        LMS_StopStream(&lime_stream);
     int r = 0;
     r |= LMS_SetAntenna(lime_dev, LMS_CH_RX, 0, 0);
     r |= LMS_SetNormalizedGain(lime_dev, LMS_CH_RX, 0, gain);
     r |= LMS_SetLOFrequency(lime_dev, LMS_CH_RX, 0, freq);
     r |= LMS_SetSampleRate(lime_dev, sr, 0);
     r |= LMS_Calibrate(lime_dev, LMS_CH_RX, 0, bw, 0);
+    if (streaming)
+        r |= LMS_StartStream(&lime_stream);
 
     if (r != 0)
     {
@@ -245,9 +426,23 @@ bool LIMESDR::ISNewNumber(const char *dev, const char *name, double values[], ch
         }
         IDSetNumber(&ReceiverSettingsNP, nullptr);
     }
+    if (dev && !strcmp(dev, getDeviceName()) && !strcmp(name, SpectrumSettingsNP.name)) {
+        // Applies from the next integration
+        IUUpdateNumber(&SpectrumSettingsNP, values, names, n);
+        SpectrumSettingsNP.s = IPS_OK;
+        IDSetNumber(&SpectrumSettingsNP, nullptr);
+        return true;
+    }
     return processNumber(dev, name, values, names, n) & !r;
 }
 
+bool LIMESDR::saveConfigItems(FILE *fp)
+{
+    INDI::Receiver::saveConfigItems(fp);
+    IUSaveConfigNumber(fp, &SpectrumSettingsNP);
+    return true;
+}
+
 /**************************************************************************************
 ** Client is asking us to abort a capture
 ***************************************************************************************/
@@ -255,14 +450,11 @@ bool LIMESDR::AbortIntegration()
 {
     if (InIntegration)
     {
-        lms_stream_status_t status;
-        LMS_GetStreamStatus(&lime_stream, &status);
-        if (status.fifoFilledCount <= 0)
-        {
-            InIntegration = false;
-            LMS_StopStream(&lime_stream);
-            LMS_DestroyStream(lime_dev, &lime_stream);
-        }
+        // The stream keeps running, what was received so far is discarded
+        std::lock_guard<std::mutex> lock(integratorMutex);
+        InIntegration = false;
+        integrationSamples = 0;
+        generation++;
     }
     return true;
 }
@@ -298,20 +490,15 @@ void LIMESDR::TimerHit()
     if (InIntegration)
     {
         timeleft = CalcTimeLeft();
-        if (timeleft < 0.1)
+        if (integrationReady)
         {
-            /* We're done capturing */
-            LOG_INFO("Integration done, expecting data...");
-            lms_stream_status_t status;
-            LMS_GetStreamStatus(&lime_stream, &status);
-            if (status.active)
-            {
-                if (status.fifoFilledCount >= status.fifoSize)
-                {
-                    n_read = status.fifoFilledCount;
-                    grabData();
-                }
-            }
+            /* We're done capturing, the samples are already reduced */
+            grabData();
+            timeleft = 0.0;
+        }
+        else if (timeleft < 0.1)
+        {
+            // Waiting for the last samples in the stream fifo
             timeleft = 0.0;
         }
 
@@ -330,14 +517,75 @@ void LIMESDR::grabData()
 {
     if (InIntegration)
     {
-        continuum = getBuffer();
-        LOG_INFO("Downloading...");
-        LMS_RecvStream(&lime_stream, continuum, n_read, NULL, 1000);
-        LMS_StopStream(&lime_stream);
-        LMS_DestroyStream(lime_dev, &lime_stream);
-        InIntegration = false;
+        std::unique_lock<std::mutex> lock(integratorMutex);
+        integrator.finish();
+        if (droppedSamples > 0)
+            LOGF_WARN("%zu samples were lost, the processing could not keep up with the stream.", droppedSamples.load());
+
+        // The continuum goes out as the integration buffer, the spectra in their own BLOBs
+        const std::vector<float> &continuum = integrator.continuum();
+        setBufferSize(static_cast<int>(continuum.size() * sizeof(float)));
+        memcpy(getBuffer(), continuum.data(), continuum.size() * sizeof(float));
+
+        long naxes[2] = { static_cast<long>(integrator.fftSize()), static_cast<long>(integrator.spectrogramRows()) };
+        size_t memsize = 0;
+        SpectrumB[0].blob = createFITS(integrator.spectrum().data(), 1, naxes, &memsize);
+        SpectrumB[0].bloblen = SpectrumB[0].size = SpectrumB[0].blob != nullptr ? static_cast<int>(memsize) : 0;
+        memsize = 0;
+        SpectrumB[1].blob = integrator.spectrogramRows() > 0 ? createFITS(integrator.spectrogram().data(), 2, naxes, &memsize) : nullptr;
+        SpectrumB[1].bloblen = SpectrumB[1].size = SpectrumB[1].blob != nullptr ? static_cast<int>(memsize) : 0;
+        lock.unlock();
+
+        for (int i = 0; i < SpectrumBP.nbp; i++)
+            strncpy(SpectrumB[i].format, ".fits", MAXINDIBLOBFMT);
+        SpectrumBP.s = IPS_OK;
+        IDSetBLOB(&SpectrumBP, nullptr);
+        for (int i = 0; i < SpectrumBP.nbp; i++)
+        {
+            free(SpectrumB[i].blob);
+            SpectrumB[i].blob = nullptr;
+        }
 
+        InIntegration = false;
         LOG_INFO("Download complete.");
         IntegrationComplete();
     }
 }
+
+/**************************************************************************************
+** Float FITS image in memory, for the spectrum BLOBs
+***************************************************************************************/
+void *LIMESDR::createFITS(const float *data, int naxis, long *naxes, size_t *memsize)
+{
+    fitsfile *fptr = nullptr;
+    int status     = 0;
+    long nelements = 1;
+    for (int i = 0; i < naxis; i++)
+        nelements *= naxes[i];
+
+    *memsize     = 5760;
+    void *memptr = malloc(*memsize);
+    if (!memptr)
+    {
+        LOGF_ERROR("Error: failed to allocate memory: %lu", *memsize);
+        return nullptr;
+    }
+
+    char error_status[MAXINDINAME];
+    fits_create_memfile(&fptr, &memptr, memsize, 2880, realloc, &status);
+    if (!status)
+        fits_create_img(fptr, FLOAT_IMG, naxis, naxes, &status);
+    if (!status)
+        fits_write_img(fptr, TFLOAT, 1, nelements, const_cast<float *>(data), &status);
+    if (status)
+    {
+        fits_get_errstatus(status, error_status);
+        LOGF_ERROR("FITS Error: %s", error_status);
+        if (fptr != nullptr)
+            fits_close_file(fptr, &status);
+        free(memptr);
+        return nullptr;
+    }
+    fits_close_file(fptr, &status);
+    return memptr;
+}
@@ -21,6 +21,13 @@
 
 #include <lime/LimeSuite.h>
 #include "indireceiver.h"
+#include "limesdr_spectrum.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 enum Settings
 {
@@ -35,6 +42,7 @@ class LIMESDR : public INDI::Receiver
     LIMESDR(uint32_t index);
 
     bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+    bool saveConfigItems(FILE *fp) override;
 
   protected:
 	// General device functions
@@ -51,6 +59,13 @@ class LIMESDR : public INDI::Receiver
     void TimerHit() override;
 
     void grabData();
+    void *createFITS(const float *data, int naxis, long *naxes, size_t *memsize);
+
+    // Streaming
+    bool startStreaming();
+    void stopStreaming();
+    void receiveSamples();
+    void processSamples();
 
   private:
     lms_device_t *lime_dev = { nullptr };
@@ -58,19 +73,51 @@ class LIMESDR : public INDI::Receiver
 	float CalcTimeLeft();
     void setupParams(float sr, float freq, float bw, float gain);
     lms_stream_t lime_stream;
+
+    // Samples received from the stream, in blocks of SUBFRAME_SIZE.
+    // Only the receiving thread writes and only the processing thread reads.
+    struct Block
+    {
+        std::vector<float> iq;
+        size_t count { 0 };
+        size_t integrate { 0 };     // leading samples that belong to the integration
+        size_t lost { 0 };          // samples of the integration dropped before this block
+        uint32_t generation { 0 };
+        bool last { false };        // the integration ends with this block
+    };
+    std::vector<Block> ring;
+    std::atomic<size_t> ringHead { 0 };
+    std::atomic<size_t> ringTail { 0 };
+    std::mutex ringMutex;
+    std::condition_variable ringCond;
+
+    std::thread receiveThread;
+    std::thread processThread;
+    std::atomic<bool> streaming { false };
+    std::mutex streamMutex;         // held around every call on the stream
+
+    // Bumped on every start or abort, blocks of older integrations are ignored
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<size_t> integrationSamples { 0 };
+    std::atomic<bool> integrationReady { false };
+    std::atomic<size_t> droppedSamples { 0 };
+    SpectrumIntegrator integrator;
+    std::mutex integratorMutex;
+
 	// Are we exposing?
     bool InIntegration;
 	// Struct to keep timing
 	struct timeval CapStart;
-    int to_read;
-    int b_read;
-    int n_read;
     float IntegrationRequest;
-	uint8_t* continuum;
-    uint8_t *spectrum;
 
     uint32_t receiverIndex = { 0 };
 
     IBLOB TFitsB[5];
     IBLOBVectorProperty TFitsBP;
+
+    INumber SpectrumSettingsN[2];
+    INumberVectorProperty SpectrumSettingsNP;
+
+    IBLOB SpectrumB[2];
+    IBLOBVectorProperty SpectrumBP;
 };
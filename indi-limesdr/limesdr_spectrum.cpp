@@ -0,0 +1,178 @@
+/*
+    indi_limesdr_receiver - a software defined radio driver for INDI
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "limesdr_spectrum.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool SpectrumIntegrator::begin(size_t fftSize, size_t totalSamples, size_t continuumPoints, size_t spectrogramRows)
+{
+    if (fftSize < 2 || (fftSize & (fftSize - 1)) != 0 || totalSamples == 0 || continuumPoints == 0)
+        return false;
+
+    if (fftSize != mFFTSize)
+        setupFFT(fftSize);
+
+    mFrameFill = 0;
+    mSamples   = 0;
+    mFrames    = 0;
+    mSpectrumSum.assign(fftSize, 0.0);
+    mSpectrum.clear();
+
+    // Never less than a frame of samples per point
+    mPointSamples = std::max((totalSamples + continuumPoints - 1) / continuumPoints, fftSize);
+    size_t points = (totalSamples + mPointSamples - 1) / mPointSamples;
+    mContinuumSum.assign(points, 0.0);
+    mContinuumCount.assign(points, 0);
+    mContinuum.clear();
+
+    size_t frames = std::max(totalSamples / fftSize, static_cast<size_t>(1));
+    mRows      = std::min(spectrogramRows, frames);
+    mRowFrames = mRows > 0 ? (frames + mRows - 1) / mRows : 0;
+    mRows      = mRows > 0 ? (frames + mRowFrames - 1) / mRowFrames : 0;
+    mSpectrogramSum.assign(mRows * fftSize, 0.0);
+    mRowCount.assign(mRows, 0);
+    mSpectrogram.clear();
+
+    return true;
+}
+
+void SpectrumIntegrator::setupFFT(size_t size)
+{
+    mFFTSize = size;
+    mFrame.resize(size);
+
+    // Hann window
+    mWindow.resize(size);
+    for (size_t i = 0; i < size; i++)
+        mWindow[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / size));
+
+    mTwiddles.resize(size / 2);
+    for (size_t i = 0; i < size / 2; i++)
+        mTwiddles[i] = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * i / size));
+
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < size)
+        bits++;
+    mReverse.resize(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; b++)
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        mReverse[i] = r;
+    }
+}
+
+void SpectrumIntegrator::transform()
+{
+    // In place radix 2, the input is reordered first
+    for (size_t i = 0; i < mFFTSize; i++)
+        if (i < mReverse[i])
+            std::swap(mFrame[i], mFrame[mReverse[i]]);
+
+    for (size_t len = 2; len <= mFFTSize; len <<= 1)
+    {
+        size_t half = len / 2, step = mFFTSize / len;
+        for (size_t i = 0; i < mFFTSize; i += len)
+        {
+            for (size_t j = 0; j < half; j++)
+            {
+                std::complex<float> t = mFrame[i + j + half] * mTwiddles[j * step];
+                mFrame[i + j + half] = mFrame[i + j] - t;
+                mFrame[i + j] += t;
+            }
+        }
+    }
+
+    // Bins are stored with DC in the middle
+    size_t half = mFFTSize / 2;
+    size_t row = mRows > 0 ? std::min(mFrames / mRowFrames, mRows - 1) : 0;
+    double *rowSum = mRows > 0 ? &mSpectrogramSum[row * mFFTSize] : nullptr;
+    for (size_t i = 0; i < mFFTSize; i++)
+    {
+        double power = std::norm(mFrame[i]);
+        size_t bin = (i + half) % mFFTSize;
+        mSpectrumSum[bin] += power;
+        if (rowSum != nullptr)
+            rowSum[bin] += power;
+    }
+    if (mRows > 0)
+        mRowCount[row]++;
+    mFrames++;
+}
+
+void SpectrumIntegrator::add(const float *iq, size_t samples)
+{
+    while (samples > 0)
+    {
+        // Up to the end of the continuum point or of the frame, whichever comes first
+        size_t point = std::min(mSamples / mPointSamples, mContinuumSum.size() - 1);
+        size_t n = std::min(samples, std::min(mPointSamples - mSamples % mPointSamples, mFFTSize - mFrameFill));
+
+        double power = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            float re = iq[i * 2], im = iq[i * 2 + 1];
+            power += re * re + im * im;
+            mFrame[mFrameFill + i] = std::complex<float>(re * mWindow[mFrameFill + i], im * mWindow[mFrameFill + i]);
+        }
+        mContinuumSum[point] += power;
+        mContinuumCount[point] += n;
+
+        mFrameFill += n;
+        if (mFrameFill == mFFTSize)
+        {
+            transform();
+            mFrameFill = 0;
+        }
+
+        mSamples += n;
+        iq += n * 2;
+        samples -= n;
+    }
+}
+
+void SpectrumIntegrator::skip(size_t samples)
+{
+    // A frame with a gap in it would smear the spectrum, it is dropped
+    mFrameFill = 0;
+    mSamples += samples;
+}
+
+void SpectrumIntegrator::finish()
+{
+    mSpectrum.resize(mFFTSize);
+    double scale = mFrames > 0 ? 1.0 / (static_cast<double>(mFrames) * mFFTSize) : 0.0;
+    for (size_t i = 0; i < mFFTSize; i++)
+        mSpectrum[i] = static_cast<float>(mSpectrumSum[i] * scale);
+
+    mContinuum.resize(mContinuumSum.size());
+    for (size_t i = 0; i < mContinuumSum.size(); i++)
+        mContinuum[i] = mContinuumCount[i] > 0 ? static_cast<float>(mContinuumSum[i] / mContinuumCount[i]) : 0.0f;
+
+    mSpectrogram.resize(mSpectrogramSum.size());
+    for (size_t r = 0; r < mRows; r++)
+    {
+        double rowScale = mRowCount[r] > 0 ? 1.0 / (static_cast<double>(mRowCount[r]) * mFFTSize) : 0.0;
+        for (size_t i = 0; i < mFFTSize; i++)
+            mSpectrogram[r * mFFTSize + i] = static_cast<float>(mSpectrogramSum[r * mFFTSize + i] * rowScale);
+    }
+}
@@ -0,0 +1,114 @@
+/*
+    indi_limesdr_receiver - a software defined radio driver for INDI
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The SpectrumIntegrator class reduces an I/Q sample stream while it is received.
+ *
+ * Samples are windowed and transformed in frames of the FFT size, the power of each frame is
+ * added to the integrated spectrum and, optionally, to the current spectrogram row.
+ * The continuum is the mean sample power over fixed groups of samples. The size of every
+ * result only depends on the settings, not on the sample rate or the integration length.
+ */
+class SpectrumIntegrator
+{
+    public:
+        /**
+         * @brief Start a new integration.
+         * @param fftSize spectrum bins, a power of two
+         * @param totalSamples samples expected in the integration
+         * @param continuumPoints maximum continuum length
+         * @param spectrogramRows spectrogram rows, 0 for none
+         */
+        bool begin(size_t fftSize, size_t totalSamples, size_t continuumPoints, size_t spectrogramRows);
+
+        /** Add interleaved I/Q float samples */
+        void add(const float *iq, size_t samples);
+
+        /** Account for samples lost before the next add(), the continuum stays aligned in time */
+        void skip(size_t samples);
+
+        /** Average what was accumulated, the results are valid until the next begin() */
+        void finish();
+
+        size_t samples() const
+        {
+            return mSamples;
+        }
+
+        size_t fftSize() const
+        {
+            return mFFTSize;
+        }
+
+        /** Mean power per bin, DC in the middle */
+        const std::vector<float> &spectrum() const
+        {
+            return mSpectrum;
+        }
+
+        /** Mean sample power per group of samples */
+        const std::vector<float> &continuum() const
+        {
+            return mContinuum;
+        }
+
+        /** Row major rows x fftSize() spectra, empty if not requested */
+        const std::vector<float> &spectrogram() const
+        {
+            return mSpectrogram;
+        }
+
+        size_t spectrogramRows() const
+        {
+            return mRows;
+        }
+
+    private:
+        void setupFFT(size_t size);
+        void transform();
+
+        size_t mFFTSize {0};
+        std::vector<float> mWindow;
+        std::vector<std::complex<float>> mTwiddles;
+        std::vector<size_t> mReverse;
+        std::vector<std::complex<float>> mFrame;
+        size_t mFrameFill {0};
+
+        size_t mSamples {0};
+        size_t mFrames {0};
+        std::vector<double> mSpectrumSum;
+        std::vector<float> mSpectrum;
+
+        size_t mPointSamples {0};
+        std::vector<double> mContinuumSum;
+        std::vector<size_t> mContinuumCount;
+        std::vector<float> mContinuum;
+
+        size_t mRows {0};
+        size_t mRowFrames {0};
+        std::vector<double> mSpectrogramSum;
+        std::vector<size_t> mRowCount;
+        std::vector<float> mSpectrogram;
+};
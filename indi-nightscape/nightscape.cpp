@@ -172,14 +172,6 @@ bool NightscapeCCD::Connect()
     dn->setFbase("");
     dn->setNumExp(99999);
     dn->setImgWrite(false);
-    if (useD2xx == 0)
-    {
-        dn->setZeroReads(100);
-    }
-    if (useD2xx == 2)
-    {
-        //dn->setZeroReads(100);
-    }
     dn->startThread();
     st->startThread();
     // Let's set a timer that checks nighscape status every POLLMS milliseconds.
@@ -375,6 +367,7 @@ bool NightscapeCCD::StartExposure(float duration)
     dn->setImgSize(m->getRawImgSize(zonestart, zonelen, framediv));
     dn->setFrameYBinning(framediv);
     dn->setFrameXBinning(PrimaryCCD.getBinX());
+    dn->setFrameXWindow(PrimaryCCD.getSubX(), PrimaryCCD.getSubW());
     m->sendzone(zonestart, zonelen, framediv);
     INDI::CCDChip::CCD_FRAME ft = PrimaryCCD.getFrameType();
     if (ft == INDI::CCDChip::DARK_FRAME || ft == INDI::CCDChip::BIAS_FRAME) dark = true;
@@ -1,8 +1,71 @@
 #include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <memory>
 
 #include "nschannel-u.h"
 #include  "nsdebug.h"
 
+// Bulk transfers kept queued on the data channel while streaming a download
+#define STREAM_TRANSFERS 8
+#define STREAM_XFER_TIMEOUT 1000
+// No data at all after this many ms fails the download, the camera may still be reading out
+#define STREAM_START_TIMEOUT 20000
+// Once data flowed, this long without any ends the download
+#define STREAM_IDLE_TIMEOUT 1500
+
+struct ns_stream {
+	unsigned char * buf;
+	size_t n;
+	size_t total;
+	unsigned packet;
+	int pending;
+	int error;
+	bool stop;
+	struct timeval lastdata;
+	const std::function<bool(size_t)> * progress;
+};
+
+static long elapsed_ms(const struct timeval * since) {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - since->tv_sec) * 1000 + (now.tv_usec - since->tv_usec) / 1000;
+}
+
+static void LIBUSB_CALL stream_callback(struct libusb_transfer * xfer) {
+	struct ns_stream * st = (struct ns_stream *) xfer->user_data;
+	st->pending--;
+	if (st->stop || st->error) return;
+	// A timed out transfer may still carry data, the idle check decides when to give up
+	if (xfer->status != LIBUSB_TRANSFER_COMPLETED && xfer->status != LIBUSB_TRANSFER_TIMED_OUT) {
+		st->error = xfer->status;
+		return;
+	}
+	// Every packet starts with two modem status bytes
+	size_t got = 0;
+	for (int off = 0; off < xfer->actual_length && st->total < st->n; off += st->packet) {
+		int len = xfer->actual_length - off;
+		if (len > (int)st->packet) len = st->packet;
+		len -= 2;
+		if (len <= 0) continue;
+		if ((size_t)len > st->n - st->total) len = st->n - st->total;
+		memcpy(st->buf + st->total, xfer->buffer + off + 2, len);
+		st->total += len;
+		got += len;
+	}
+	if (got > 0) {
+		gettimeofday(&st->lastdata, NULL);
+		if (!(*st->progress)(st->total)) st->stop = true;
+	}
+	if (st->total >= st->n) st->stop = true;
+	if (st->stop) return;
+	if (libusb_submit_transfer(xfer) < 0) {
+		st->error = LIBUSB_TRANSFER_ERROR;
+		return;
+	}
+	st->pending++;
+}
+
 struct ftdi_context * NsChannelU::getDataChannel(void) {
 		return &data_channel;	
 }
@@ -265,6 +328,89 @@ int NsChannelU::readData(unsigned char *buf, size_t size) {
   }
 }
 
+int NsChannelU::streamData(unsigned char *buf, size_t n, const std::function<bool(size_t)> &progress) {
+	struct ftdi_context * ftdid = &data_channel;
+	unsigned chunksize = DEFAULT_CHUNK_SIZE;
+	ftdi_read_data_get_chunksize(ftdid, &chunksize);
+
+	struct ns_stream st;
+	memset(&st, 0, sizeof(st));
+	st.buf = buf;
+	st.n = n;
+	st.packet = ftdid->max_packet_size ? ftdid->max_packet_size : 512;
+	st.progress = &progress;
+
+	struct timeval start;
+	gettimeofday(&start, NULL);
+	st.lastdata = start;
+
+	// Data libftdi already buffered in an earlier read comes first
+	if (ftdid->readbuffer_remaining > 0 && n > 0) {
+		size_t len = ftdid->readbuffer_remaining;
+		if (len > n) len = n;
+		memcpy(buf, ftdid->readbuffer + ftdid->readbuffer_offset, len);
+		ftdid->readbuffer_offset += len;
+		ftdid->readbuffer_remaining -= len;
+		st.total = len;
+		if (!progress(st.total) || st.total >= n) return st.total;
+	}
+
+	std::unique_ptr<unsigned char[]> staging(new unsigned char[(size_t)chunksize * STREAM_TRANSFERS]);
+	struct libusb_transfer * xfers[STREAM_TRANSFERS] = { NULL };
+	for (int i = 0; i < STREAM_TRANSFERS && !st.error; i++) {
+		xfers[i] = libusb_alloc_transfer(0);
+		if (xfers[i] == NULL) {
+			st.error = LIBUSB_TRANSFER_ERROR;
+			break;
+		}
+		libusb_fill_bulk_transfer(xfers[i], ftdid->usb_dev, ftdid->out_ep, staging.get() + (size_t)i * chunksize,
+		                          chunksize, stream_callback, &st, STREAM_XFER_TIMEOUT);
+		if (libusb_submit_transfer(xfers[i]) < 0) {
+			st.error = LIBUSB_TRANSFER_ERROR;
+			break;
+		}
+		st.pending++;
+	}
+
+	bool cancelled = false;
+	while (st.pending > 0) {
+		if (!st.stop && !st.error) {
+			if (st.total == 0 && elapsed_ms(&start) > STREAM_START_TIMEOUT) {
+				DO_ERR("%s\n", "download: no data from camera");
+				st.stop = true;
+			} else if (st.total > 0 && elapsed_ms(&st.lastdata) > STREAM_IDLE_TIMEOUT) {
+				st.stop = true;
+			}
+		}
+		if ((st.stop || st.error) && !cancelled) {
+			for (int i = 0; i < STREAM_TRANSFERS; i++)
+				if (xfers[i]) libusb_cancel_transfer(xfers[i]);
+			cancelled = true;
+		}
+		struct timeval tv = { 0, 100000 };
+		int rc = libusb_handle_events_timeout_completed(ftdid->usb_ctx, &tv, NULL);
+		if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED) {
+			DO_ERR("unable to handle data events: %d (%s)\n", rc, libusb_error_name(rc));
+			st.error = LIBUSB_TRANSFER_ERROR;
+			break;
+		}
+	}
+
+	// Transfers libusb still owns, and their buffers, cannot be freed
+	if (st.pending == 0) {
+		for (int i = 0; i < STREAM_TRANSFERS; i++)
+			libusb_free_transfer(xfers[i]);
+	} else {
+		staging.release();
+	}
+	if (st.error) {
+		DO_ERR("unable to stream data: transfer status %d\n", st.error);
+		return -1;
+	}
+	DO_INFO("streamed %zu bytes in %ld ms\n", st.total, elapsed_ms(&start));
+	return st.total;
+}
+
 int NsChannelU::purgeData(void) {
   struct ftdi_context * ftdid = &data_channel;
 	int rc2;
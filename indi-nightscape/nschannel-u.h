@@ -26,6 +26,7 @@ class NsChannelU : public NsChannel {
 		int readCommand(unsigned char * buf, size_t n);
 		int writeCommand(const unsigned char * buf, size_t n);
 		int readData(unsigned char * buf, size_t n);
+		int streamData(unsigned char * buf, size_t n, const std::function<bool(size_t)> &progress);
 		int purgeData(void);
 		int setDataRts(void);
 		int resetcontrol (void);
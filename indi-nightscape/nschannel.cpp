@@ -1,7 +1,11 @@
 #include <stdio.h>
+#include <unistd.h>
 #include "nschannel.h"
 #include  "nsdebug.h"
 
+// Polls without data before a stream is considered finished
+#define STREAM_IDLE_POLLS 20
+
 int NsChannel::open() {
 	  int rc = 0;
 		if ((rc = scan()) < 0) return rc;
@@ -19,3 +23,27 @@ int NsChannel::close() {
 int NsChannel::getMaxXfer() {
 		return maxxfer;	
 }
+
+int NsChannel::streamData(unsigned char *buf, size_t n, const std::function<bool(size_t)> &progress) {
+		size_t total = 0;
+		int idle = 0;
+		int sleepage = 1000;
+		while (total < n) {
+			size_t len = n - total;
+			if (len > (size_t)getMaxXfer()) len = getMaxXfer();
+			int rc = readData(buf + total, len);
+			if (rc < 0) return -1;
+			if (rc == 0) {
+				if (++idle > STREAM_IDLE_POLLS) break;
+				usleep(sleepage);
+				sleepage *= 2;
+				if (sleepage > 100000) sleepage = 100000;
+				continue;
+			}
+			idle = 0;
+			sleepage = 1000;
+			total += rc;
+			if (!progress(total)) break;
+		}
+		return total;
+}
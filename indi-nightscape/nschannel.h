@@ -1,6 +1,7 @@
 #ifndef __NS_CHANNEL_H__
 #define __NS_CHANNEL_H__
 #include <stdlib.h>
+#include <functional>
 #include <libftdi1/ftdi.h>
 #define DEFAULT_OLD_CHUNK_SIZE  63448
 #define DEFAULT_CHUNK_SIZE 65536
@@ -25,6 +26,10 @@ class NsChannel {
 		virtual int readCommand(unsigned char * buf, size_t n) = 0;
 		virtual int writeCommand(const unsigned char * buf, size_t n) = 0;
 		virtual int readData(unsigned char * buf, size_t n)= 0;
+		// Read up to n bytes of image data, calling progress with the total so far after
+		// every block. Stops when n bytes arrived, data stopped or progress returns false.
+		// Returns the number of bytes read or -1.
+		virtual int streamData(unsigned char * buf, size_t n, const std::function<bool(size_t)> &progress);
 		virtual int purgeData(void)= 0;
 		virtual int setDataRts(void)= 0;
 		virtual int resetcontrol (void)= 0;
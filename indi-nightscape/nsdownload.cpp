@@ -17,6 +17,11 @@ void NsDownload::setFrameXBinning(int binning) {
 			ctx->imgp->xbinning = binning;	
 
 }
+void NsDownload::setFrameXWindow(int xstart, int xlen) {
+			ctx->imgp->xstart = xstart;
+			ctx->imgp->xlen = xlen;
+}
+
 void NsDownload::setImgSize(int siz) {
 	rd->imgsz = siz;
 }
@@ -93,7 +98,9 @@ void NsDownload::setImgWrite(bool w) {
 void NsDownload::freeBuf() {
 	if (!retrBuf) return;
 	if (retrBuf->buffer) free(retrBuf->buffer);
+	if (retrBuf->image) free(retrBuf->image);
 	retrBuf->buffer = NULL;
+	retrBuf->image = NULL;
 	retrBuf = NULL;
 }
 
@@ -103,9 +110,6 @@ void NsDownload::setInterrupted(){
 	go_download.notify_all();
 }
 
-void NsDownload::setZeroReads(int zeroes){
-	zero_reads = zeroes;
-}
  int NsDownload::getActWriteLines(){
 		 return writelines;	
 }
@@ -144,6 +148,7 @@ int NsDownload::downloader()
 				return (-1);
 			}
 			rd->nread += rc2;
+			cooklines(rd);
 			if (rc2 != cn->getMaxXfer()) {
 				DO_INFO("short! %d %d\n", rd->nblks, rc2);
 			}		
@@ -161,6 +166,7 @@ int NsDownload::downloader()
 				rb = rdd;
 				retrBuf = &rb;
 				rd->buffer = NULL;
+				rd->image = NULL;
 			}	
 			return download;		
 }
@@ -302,14 +308,51 @@ void NsDownload::writedownload(int pad, int cooked)
 
 
 
+static void setwindow(ns_readdata_t * r, int xstart, int xlen, int xbin)
+{
+	if (xbin < 1) xbin = 1;
+	if (xbin > 4) xbin = 4;
+	if (xstart < 0 || xstart >= KAF8300_ACTIVE_X) xstart = 0;
+	if (xlen <= 0 || xstart + xlen > KAF8300_ACTIVE_X) xlen = KAF8300_ACTIVE_X - xstart;
+	r->xstart = xstart;
+	r->xlen = xlen;
+	r->xbin = xbin;
+	r->lines = 0;
+}
+
+/*
+ * Cook the raw lines received since the last call: strip the postamble, crop to the
+ * window and average xbin pixels. Runs while the download is still in progress.
+ */
+void NsDownload::cooklines(ns_readdata_t * r)
+{
+	const int rawline = KAF8300_MAX_X*2;
+	const int xbin = r->xbin;
+	const int outw = r->xlen / xbin;
+	int avail = r->nread / rawline;
+
+	for (; r->lines < avail; r->lines++) {
+		const uint8_t * src = r->buffer + r->lines * rawline + (KAF8300_POSTAMBLE*2) + r->xstart*2;
+		uint8_t * dst = r->image + r->lines * outw * 2;
+		if (xbin == 1) {
+			memcpy(dst, src, outw * 2);
+			continue;
+		}
+		for (int x = 0; x < outw; x++) {
+			uint16_t px[4];
+			uint32_t pxsum = 0;
+			memcpy(px, src, xbin * 2);
+			for (int a = 0; a < xbin; a++)
+				pxsum += px[a];
+			uint16_t pxa = pxsum / xbin;
+			memcpy(dst + x * 2, &pxa, 2);
+			src += xbin * 2;
+		}
+	}
+}
+
 void NsDownload::copydownload(unsigned char *buf, int xstart, int xlen, int xbin, int pad, int cooked)
 {
-	unsigned char linebuf[KAF8300_MAX_X*2];
-	bool forwards = true;
-	bool rms = false;
-	int binning = xbin;
-	uint8_t * dbufp = buf;
-	uint8_t * bufp;
 	int nwrite = 0;
 	
 	if (retrBuf == NULL) {
@@ -324,65 +367,16 @@ void NsDownload::copydownload(unsigned char *buf, int xstart, int xlen, int xbin
 		} else {
 			nwrite = retrBuf->nread;
 		}
-		memcpy (dbufp, retrBuf->buffer, nwrite);
+		memcpy (buf, retrBuf->buffer, nwrite);
 	} else {
-		//int actlines = nwrite / (KAF8300_MAX_X*2);
-	  //int rem = nwrite % (KAF8300_MAX_X*2);
-	  nwrite = retrBuf->nread;
-		int nwriteleft = nwrite;
-		if (forwards) {
-			bufp = retrBuf->buffer;
-			//dbufp =  (dbufp +(KAF8300_ACTIVE_X*2*IMG_Y)) - (KAF8300_ACTIVE_X*2);
-		} else {
-			bufp = (retrBuf->buffer + nwrite) - (KAF8300_MAX_X*2);
-			dbufp =  (dbufp +(KAF8300_ACTIVE_X*2*IMG_MAX_Y)) - (KAF8300_ACTIVE_X*2);
+		// The lines were cooked during the download, unless the window changed since
+		if (xstart != retrBuf->xstart || xlen != retrBuf->xlen || xbin != retrBuf->xbin) {
+			DO_INFO("window changed, cooking %d lines again\n", retrBuf->lines);
+			setwindow(retrBuf, xstart, xlen, xbin);
 		}
-		writelines = 0;
-	  while (nwriteleft >= (KAF8300_MAX_X*2)) {
-	  //swab (bufp + (KAF8300_POSTAMBLE*2),  linebuf, KAF8300_ACTIVE_X*2 );
-	   //memcpy (dbufp, linebuf, KAF8300_ACTIVE_X*2);
-	    if (binning > 1) {
-	    	uint8_t * lbufp = bufp + (KAF8300_POSTAMBLE*2) + xstart*2;
-	    	int len = xlen * 2;
-	    	int linelen = 0;
-	    	while (len > 0) {
-	    		short px[4];
-	    		long long pxsq =0;
-	    		long pxav =0;
-	    		short pxa;
-	    		memcpy(px, lbufp,binning * 2);
-	    		for (int a = 0; a < binning; a++) {
-	    			pxav += px[a];
-	    			pxsq	+= px[a]*px[a];
-	    		}
-	    		pxav /= binning;
-	    		pxsq /= binning;
-	    		if(rms) {
-	    			pxa = round(sqrt((double)	pxsq));
-	    			
-	    		} else {
-	    			pxa = pxav;	
-	    		}
-	    		memcpy (linebuf + linelen, &pxa, 2);
-	    		linelen += 2;
-	    		lbufp += 2*binning;
-	    		len -= 2* binning;
-				}
-				memcpy (dbufp, linebuf, (xlen*2)/binning);
-
-	    } else {
-	  		memcpy (dbufp, bufp + (KAF8300_POSTAMBLE*2) + xstart*2, xlen * 2 ); //KAF8300_ACTIVE_X*2 );
-	  	}
-			if (forwards) { 
-				bufp +=  KAF8300_MAX_X*2;
-				dbufp +=(xlen*2)/binning;
-			} else {
-				bufp -=  KAF8300_MAX_X*2;
-				dbufp-=(xlen*2)/binning;
-			}
-			nwriteleft -= KAF8300_MAX_X*2;
-			writelines++;
-	  }
+		cooklines(retrBuf);
+		writelines = retrBuf->lines;
+		memcpy(buf, retrBuf->image, writelines * (retrBuf->xlen / retrBuf->xbin) * 2);
 	 DO_INFO( "wrote %d lines\n", writelines);
 	}	 
 }
@@ -407,22 +401,24 @@ int NsDownload::purgedownload()
 }
 
 
-int NsDownload::fulldownload() 
+int NsDownload::streamdownload()
 {
-		int rc2;
-		
-		rc2 = cn->readData(rd->buffer+rd->nread, rd->bufsiz - rd->nread);
+		int want = rd->bufsiz;
+		if (rd->imgsz > 0 && rd->imgsz < want) want = rd->imgsz;
+
+		int rc2 = cn->streamData(rd->buffer, want, [this](size_t total) {
+			rd->nread = total;
+			rd->nblks++;
+			cooklines(rd);
+			return !interrupted;
+		});
 		if (rc2 < 0 ) {
-			DO_ERR( "unable to read: %d\n", rc2);
+			DO_ERR( "unable to stream download: %d\n", rc2);
 			return (-1);
 		}
-		if (rc2 > 0) {
-			DO_INFO("read %d\n", rc2);
-		  rd->nread += rc2;
-		  rd->nblks += rc2/65536;
-		  DO_INFO("read %d tot %d\n", rc2, rd->nread);
-
-		}	
+		rd->nread = rc2;
+		cooklines(rd);
+		DO_INFO("read %d blks %d lines %d\n", rd->nread, rd->nblks, rd->lines);
 		return rc2;
 }
 
@@ -436,9 +432,15 @@ void NsDownload::initdownload()
 			rd->buffer = (unsigned char *)malloc(imgszmax);
 		}
 		memset(rd->buffer, 0, imgszmax);
+		if(!rd->image) {
+			rd->image = (unsigned char *)malloc((imgszmax / (KAF8300_MAX_X*2)) * KAF8300_ACTIVE_X*2);
+		}
 
 		rd->bufsiz = imgszmax;
 		rd->nblks = 0;	
+
+		// Window for cooking the lines as they arrive
+		setwindow(rd, ctx->imgp->xstart, ctx->imgp->xlen, ctx->imgp->xbinning);
 }
 
 
@@ -450,11 +452,6 @@ void NsDownload::initdownload()
 void NsDownload::trun()
 {
 
-	int maxxfer;
-  int zeroes = 0;
-	//struct ftdi_context * ftdid = cn->getDataChannel();
-	maxxfer = cn->getMaxXfer();
-
 	do  {
 		DO_INFO("%s\n", "initdownload");
 		std::unique_lock<std::mutex> ulock(mutx);
@@ -465,54 +462,32 @@ void NsDownload::trun()
 
 	
 		if (do_download && !in_download) {
-			//ftdi_usb_close(ftdid);
-			//maxxfer = opendownload(ftdid, ctx->dev);
 			in_download = 1;
 			ctx->imgseq++;
-			zeroes = 0;
 		}
-	  while (in_download && !interrupted) {
-	  	//int rc2= cn->setDataRts();;
-    	//if (rc2  < 0) {
-      //  		DO_ERR( "unable to set rts: %d\n", rc2);
-    	//}	
-    	int down = 0;
-	    if (zero_reads > 1) 
-	  		down = fulldownload();
-	  	else
-	  		down = downloader();
+	  if (in_download && !interrupted) {
+	  	// The lines are cooked while the data streams in, the image is ready with the last block
+	  	int down = streamdownload();
 	  	if (down < 0) {
 	  		DO_ERR( "unable to read download: %d\n", down);
-	  		do_download = 0;
-	  		in_download = 0;
-	  		continue;
-	  	}
-	  	if (rd->nread < rd->imgsz) {
-	  		if (down == 0 && rd->nread > 0) {
-    			zeroes++;
+	  	} else {
+	  		int pad = 0;
+	  		if (rd->nread != rd->imgsz) {
+	  			int actlines = rd->nread / (KAF8300_MAX_X*2);
+	  			int rem = rd->nread % (KAF8300_MAX_X*2);
+	  			DO_INFO( "siz %d read %d act lines %d rem %d\n",  rd->imgsz,rd->nread, actlines, rem);
+	  			if (rd->imgsz - rd->nread < KAF8300_MAX_X * 5) {
+	  				pad = 1;
+	  			}
 	  		}
-	  		if (zeroes < zero_reads) continue;
+	  		lastread = down;
+
+	  		rb = rdd;
+	  		retrBuf = &rb;
+	  		rd->buffer = NULL;
+	  		rd->image = NULL;
+	  		if(write_it) writedownload(pad, 0);
 	  	}
-	  	int pad = 0;
-	  	if (rd->nread != rd->imgsz) {
-	  		int actlines = rd->nread / (KAF8300_MAX_X*2);
-	  		int rem = rd->nread % (KAF8300_MAX_X*2);
-	  		DO_INFO( "siz %d read %d act lines %d rem %d\n",  rd->imgsz,rd->nread, actlines, rem);
-	  		if (rd->imgsz - rd->nread < KAF8300_MAX_X * 5) {
-	  			pad = 1;
-	  		}
-	    }	
-	    lastread = down;
-	    	   // IDLog("foop\n");
-
-	    if (zero_reads > 1) {
-	    	rb = rdd;
-	    	retrBuf = &rb;
-	    	rd->buffer = NULL;
-	    }
-	    //IDLog("retr %p buf %p \n", retrBuf, rb.buffer);
-	    if(write_it) writedownload(pad, 0);
-			
 	  	do_download = 0;
 	  	in_download = 0;
 	  }
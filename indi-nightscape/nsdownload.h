@@ -1,6 +1,7 @@
 #ifndef __NS_DOWNLOAD_H__
 #define __NS_DOWNLOAD_H__
 #include "nschannel.h"
+#include "kaf_constants.h"
 #include <stdio.h>
 #include <string.h>
 #include <pthread.h>
@@ -13,6 +14,12 @@ typedef struct ns_readdata {
 	unsigned char * buffer;
 	int nblks;
 	int imgsz;
+	// Lines cooked as they arrive: postamble stripped, cropped to the window and binned
+	unsigned char * image;
+	int lines;
+	int xstart;
+	int xlen;
+	int xbin;
 
 } ns_readdata_t;
 
@@ -24,6 +31,8 @@ struct img_params {
 	time_t expdate;	
 	int ybinning;
 	int xbinning;
+	int xstart;
+	int xlen;
 };
 
 struct download_params {
@@ -50,6 +59,9 @@ class NsDownload {
 
 			 //strcpy(ctx->fbase, "");
 			 rd->buffer = NULL;
+			 rd->image = NULL;
+			 ctx->imgp->xstart = 0;
+			 ctx->imgp->xlen = KAF8300_ACTIVE_X;
 				in_download = 0;
 		 		do_download = 0;
 		 		write_it = 0;
@@ -70,6 +82,9 @@ class NsDownload {
 
 			 //strcpy(ctx->fbase, "");
 			 rd->buffer = NULL;
+			 rd->image = NULL;
+			 ctx->imgp->xstart = 0;
+			 ctx->imgp->xlen = KAF8300_ACTIVE_X;
 		 		cn = chn;
 		 		in_download = 0;
 		 		do_download = 0;
@@ -79,6 +94,7 @@ class NsDownload {
 		 }
 		 void setFrameYBinning(int  binning);
 		 void setFrameXBinning(int  binning);
+		 void setFrameXWindow(int xstart, int xlen);
 
 		 void setSetTemp (float temp);
 		 void setActTemp(float temp);
@@ -105,11 +121,11 @@ class NsDownload {
 		void setInterrupted();
 		void copydownload(unsigned char *buf, int xstart, int xlen, int xbin, int pad, int cooked);
 		void writedownload(int pad, int cooked);
-		void setZeroReads(int zeroes);
 	private:
 
 	  void fitsheader(int x, int y, char * fbase, struct img_params * ip);
-		int fulldownload(); 
+		int streamdownload();
+		void cooklines(ns_readdata_t * r);
 		bool getDoDownload();
 		struct download_params dp;
 		struct img_params ip;
@@ -134,7 +150,6 @@ class NsDownload {
 		ns_readdata_t rb;
 
 		ns_readdata_t * retrBuf;
-		int zero_reads { 1 };
 		int writelines{0};
 };
 #endif
\ No newline at end of file
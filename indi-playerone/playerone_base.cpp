@@ -27,6 +27,8 @@
 
 #include "config.h"
 
+#include <pixelkernels.h>
+
 #include <stream/streammanager.h>
 #include <indielapsedtimer.h>
 
@@ -100,8 +102,7 @@ void POABase::workerStreamVideo(const std::atomic_bool &isAbortToQuit)
         }
 
         if (mCurrentVideoFormat == POA_RGB24)
-            for (uint32_t i = 0; i < totalBytes; i += 3)
-                std::swap(targetFrame[i], targetFrame[i + 2]);
+            PixelKernels::swapRB(targetFrame, totalBytes / 3, 3);
 
         Streamer->newFrame(targetFrame, totalBytes);
     }
@@ -590,6 +591,8 @@ bool POABase::Disconnect()
         POACloseCamera(mCameraInfo.cameraID);
     }
 
+    mStagingBuffer.release();
+
     LOG_INFO("Camera is offline.");
 
 
@@ -1237,12 +1240,18 @@ int POABase::grabImage(float duration)
 
     if (type == POA_RGB24)
     {
-        buffer = static_cast<uint8_t *>(malloc(nTotalBytes));
+        // Kept across exposures, only reallocated when the frame size changes
+        buffer = mStagingBuffer.get(nTotalBytes);
         if (buffer == nullptr)
         {
-            LOGF_ERROR("%s: %d malloc failed (RGB 24).", getDeviceName());
+            LOGF_ERROR("Failed to allocate RGB 24 staging buffer (%zu bytes).", nTotalBytes);
             return -1;
         }
+
+        const PixelKernels::StagingBuffer::Stats &stats = mStagingBuffer.stats();
+        LOGF_DEBUG("RGB 24 staging buffer: %zu bytes%s, %llu allocation(s), %llu reuse(s).",
+                   stats.capacity, stats.hugePages ? " (huge pages)" : "",
+                   static_cast<unsigned long long>(stats.allocations), static_cast<unsigned long long>(stats.reuses));
     }
 
     ret = POAGetImageData(mCameraInfo.cameraID, buffer, nTotalBytes, -1);
@@ -1252,28 +1261,14 @@ int POABase::grabImage(float duration)
             "Failed to get data after exposure (%dx%d #%d channels) (%s).",
             subW, subH, nChannels, Helpers::toString(ret)
         );
-        if (type == POA_RGB24)
-            free(buffer);
         return -1;
     }
 
     if (type == POA_RGB24)
     {
-        uint8_t *dstR = image;
-        uint8_t *dstG = image + subW * subH;
-        uint8_t *dstB = image + subW * subH * 2;
-
-        const uint8_t *src = buffer;
-        const uint8_t *end = buffer + subW * subH * 3;
-
-        while (src != end)
-        {
-            *dstB++ = *src++;
-            *dstG++ = *src++;
-            *dstR++ = *src++;
-        }
-
-        free(buffer);
+        // BGR24 from the SDK into R, G and B planes
+        uint8_t *planes[3] = { image + subW * subH * 2, image + subW * subH, image };
+        PixelKernels::deinterleave(buffer, planes, subW * subH, 3);
     }
     guard.unlock();
 
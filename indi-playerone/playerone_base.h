@@ -30,6 +30,7 @@
 #include <vector>
 
 #include <indiccd.h>
+#include <stagingbuffer.h>
 #include <inditimer.h>
 
 class SingleWorker;
@@ -172,4 +173,7 @@ class POABase : public INDI::CCD
         uint8_t mExposureRetry {0};
         POAImgFormat                      mCurrentVideoFormat;
         std::vector<POAConfigAttributes>  mControlCaps;
+
+        /** BGR frames are read here before being split into planes */
+        PixelKernels::StagingBuffer       mStagingBuffer;
 };
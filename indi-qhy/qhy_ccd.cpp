@@ -23,6 +23,8 @@
 #include "qhy_ccd.h"
 #include "config.h"
 #include <stream/streammanager.h>
+#include <sharedblob.h>
+#include <indielapsedtimer.h>
 
 #include <libnova/julian_day.h>
 #include <algorithm>
@@ -202,6 +204,12 @@ bool QHYCCD::initProperties()
     IUFillNumberVector(&USBBufferNP, USBBufferN, 1, getDeviceName(), "USB_BUFFER", "USB Buffer", MAIN_CONTROL_TAB,
                        IP_RW, 60, IPS_IDLE);
 
+    // Pipelined capture
+    IUFillSwitch(&PipelineS[INDI_ENABLED], "INDI_ENABLED", "On", ISS_OFF);
+    IUFillSwitch(&PipelineS[INDI_DISABLED], "INDI_DISABLED", "Off", ISS_ON);
+    IUFillSwitchVector(&PipelineSP, PipelineS, 2, getDeviceName(), "CCD_PIPELINE", "Pipeline", OPTIONS_TAB,
+                       IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
+
     // Humidity
     IUFillNumber(&HumidityN[0], "HUMIDITY", "%", "%.2f", -100, 1000, 0.1, 0);
     IUFillNumberVector(&HumidityNP, HumidityN, 1, getDeviceName(), "CCD_HUMIDITY", "Humidity", MAIN_CONTROL_TAB,
@@ -370,6 +378,7 @@ void QHYCCD::ISGetProperties(const char *dev)
             defineProperty(&USBTrafficNP);
 
         defineProperty(&USBBufferNP);
+        defineProperty(&PipelineSP);
 
         defineProperty(&SDKVersionTP);
 
@@ -595,6 +604,7 @@ bool QHYCCD::updateProperties()
         }
 
         defineProperty(&USBBufferNP);
+        defineProperty(&PipelineSP);
 
         defineProperty(&SDKVersionTP);
 
@@ -676,6 +686,7 @@ bool QHYCCD::updateProperties()
             deleteProperty(USBTrafficNP.name);
 
         deleteProperty(USBBufferNP.name);
+        deleteProperty(PipelineSP.name);
 
         deleteProperty(SDKVersionTP.name);
 
@@ -1135,6 +1146,10 @@ bool QHYCCD::Connect()
         }
         pthread_mutex_unlock(&condMutex);
 
+        m_PackagingTerminate = false;
+        m_PackagingPending = false;
+        m_PackagingThread = std::thread(&QHYCCD::packagingThreadEntry, this);
+
         SetTimer(getCurrentPollingPeriod());
 
         return true;
@@ -1150,12 +1165,24 @@ bool QHYCCD::Disconnect()
     ImageState  tState;
     LOGF_DEBUG("Closing %s...", m_Name);
 
+    m_StreamRunning = false;
     pthread_mutex_lock(&condMutex);
     tState = m_ThreadState;
     m_ThreadRequest = StateTerminate;
     pthread_cond_signal(&cv);
     pthread_mutex_unlock(&condMutex);
     pthread_join(m_ImagingThread, nullptr);
+
+    if (m_PackagingThread.joinable())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_PackagingMutex);
+            m_PackagingTerminate = true;
+        }
+        m_PackagingCV.notify_all();
+        m_PackagingThread.join();
+    }
+    releaseBackBuffer();
     //tState = StateNone;
     if (isSimulation() == false)
     {
@@ -1517,23 +1544,38 @@ double QHYCCD::calcTimeLeft()
 /* Downloads the image from the CCD. */
 int QHYCCD::grabImage()
 {
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    // In pipelined mode the frame is read into the back buffer without holding the frame buffer lock,
+    // so readout of this frame overlaps with packaging and upload of the previous one.
+    const bool pipelined = PipelineS[INDI_ENABLED].s == ISS_ON;
+    uint8_t *target = nullptr;
+
+    std::unique_lock<std::mutex> guard(ccdBufferLock, std::defer_lock);
+    if (pipelined)
+        target = getBackBuffer();
+
+    if (target == nullptr)
+    {
+        // Reading straight into the front buffer, the packaging thread may still be sending the previous frame from it
+        waitForPackaging();
+        guard.lock();
+        target = PrimaryCCD.getFrameBuffer();
+    }
+
     if (isSimulation())
     {
-        uint8_t *image = PrimaryCCD.getFrameBuffer();
         int width      = PrimaryCCD.getSubW() / PrimaryCCD.getBinX() * PrimaryCCD.getBPP() / 8;
         int height     = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
 
         for (int i = 0; i < height; i++)
             for (int j = 0; j < width; j++)
-                image[i * width + j] = rand() % 255;
+                target[i * width + j] = rand() % 255;
     }
     else
     {
         uint32_t ret, w, h, bpp, channels;
 
         LOG_DEBUG("GetQHYCCDSingleFrame Blocking read call.");
-        ret = GetQHYCCDSingleFrame(m_CameraHandle, &w, &h, &bpp, &channels, PrimaryCCD.getFrameBuffer());
+        ret = GetQHYCCDSingleFrame(m_CameraHandle, &w, &h, &bpp, &channels, target);
         LOG_DEBUG("GetQHYCCDSingleFrame Blocking read call complete.");
 
         if (ret != QHYCCD_SUCCESS)
@@ -1543,6 +1585,15 @@ int QHYCCD::grabImage()
             return -1;
         }
     }
+
+    if (!guard.owns_lock())
+    {
+        // Previous frame must be out of the front buffer before the two are swapped.
+        waitForPackaging();
+        guard.lock();
+        m_BackBuffer = PrimaryCCD.getFrameBuffer();
+        PrimaryCCD.setFrameBuffer(target);
+    }
     guard.unlock();
 
     // Perform software binning if necessary
@@ -1555,13 +1606,106 @@ int QHYCCD::grabImage()
         LOG_DEBUG("Download complete.");
 
     if (HasGPS && GPSControlS[INDI_ENABLED].s == ISS_ON)
-        decodeGPSHeader();
+        decodeGPSHeader(PrimaryCCD.getFrameBuffer());
 
-    ExposureComplete(&PrimaryCCD);
+    if (pipelined)
+        queuePackaging();
+    else
+        ExposureComplete(&PrimaryCCD);
 
     return 0;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+/// Back buffer of the pipelined capture, sized after the current frame buffer.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+uint8_t *QHYCCD::getBackBuffer()
+{
+    uint32_t size = PrimaryCCD.getFrameBufferSize();
+    if (size == 0)
+        return nullptr;
+
+    if (m_BackBuffer == nullptr || m_BackBufferSize != size)
+    {
+        uint8_t *buffer = static_cast<uint8_t *>(IDSharedBlobRealloc(m_BackBuffer, size));
+        if (buffer == nullptr)
+        {
+            IDSharedBlobFree(m_BackBuffer);
+            buffer = static_cast<uint8_t *>(IDSharedBlobAlloc(size));
+        }
+
+        m_BackBuffer = buffer;
+        m_BackBufferSize = (buffer == nullptr) ? 0 : size;
+        if (buffer == nullptr)
+            LOGF_ERROR("Failed to allocate %u bytes for pipelined capture, falling back to direct readout.", size);
+    }
+
+    return m_BackBuffer;
+}
+
+void QHYCCD::releaseBackBuffer()
+{
+    if (m_BackBuffer != nullptr)
+        IDSharedBlobFree(m_BackBuffer);
+    m_BackBuffer = nullptr;
+    m_BackBufferSize = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+/// Packaging thread runs ExposureComplete (FITS encoding, compression and upload) of the front
+/// buffer while the imaging thread is already reading out the next frame.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+void QHYCCD::packagingThreadEntry()
+{
+    std::unique_lock<std::mutex> lock(m_PackagingMutex);
+    while (true)
+    {
+        m_PackagingCV.wait(lock, [this]
+        {
+            return m_PackagingPending || m_PackagingTerminate;
+        });
+
+        if (m_PackagingTerminate)
+            break;
+
+        lock.unlock();
+        INDI::ElapsedTimer timer;
+        ExposureComplete(&PrimaryCCD);
+        LOGF_DEBUG("Frame packaged in %lld ms.", static_cast<long long>(timer.elapsed()));
+        lock.lock();
+
+        m_PackagingPending = false;
+        m_PackagingCV.notify_all();
+    }
+
+    m_PackagingPending = false;
+    m_PackagingCV.notify_all();
+}
+
+void QHYCCD::queuePackaging()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_PackagingMutex);
+        // Without the packaging thread (e.g. not connected yet), package inline.
+        if (m_PackagingThread.joinable() && !m_PackagingTerminate)
+        {
+            m_PackagingPending = true;
+            m_PackagingCV.notify_all();
+            return;
+        }
+    }
+    ExposureComplete(&PrimaryCCD);
+}
+
+void QHYCCD::waitForPackaging()
+{
+    std::unique_lock<std::mutex> lock(m_PackagingMutex);
+    m_PackagingCV.wait(lock, [this]
+    {
+        return !m_PackagingPending;
+    });
+}
+
 void QHYCCD::TimerHit()
 {
     if (isConnected() == false)
@@ -1753,6 +1897,22 @@ bool QHYCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, cha
             return true;
         }
 
+        //////////////////////////////////////////////////////////////////////
+        /// Pipelined Capture
+        //////////////////////////////////////////////////////////////////////
+        else if (!strcmp(PipelineSP.name, name))
+        {
+            IUUpdateSwitch(&PipelineSP, states, names, n);
+            PipelineSP.s = IPS_OK;
+            if (PipelineS[INDI_ENABLED].s == ISS_ON)
+                LOG_INFO("Pipelined capture is enabled. Frames are read out while the previous frame is uploaded.");
+            else
+                LOG_INFO("Pipelined capture is disabled.");
+            saveConfig(true, PipelineSP.name);
+            IDSetSwitch(&PipelineSP, nullptr);
+            return true;
+        }
+
         //////////////////////////////////////////////////////////////////////
         /// GPS Header
         //////////////////////////////////////////////////////////////////////
@@ -2365,6 +2525,7 @@ bool QHYCCD::saveConfigItems(FILE *fp)
     }
 
     IUSaveConfigNumber(fp, &USBBufferNP);
+    IUSaveConfigSwitch(fp, &PipelineSP);
 
     return true;
 }
@@ -2483,6 +2644,7 @@ bool QHYCCD::StartStreaming()
     LOGF_INFO("Starting video streaming with exposure %.f seconds (%.f FPS), w=%d h=%d", m_ExposureRequest,
               Streamer->getTargetFPS(), subW, subH);
     BeginQHYCCDLive(m_CameraHandle);
+    m_StreamRunning = true;
     pthread_mutex_lock(&condMutex);
     m_ThreadRequest = StateStream;
     pthread_cond_signal(&cv);
@@ -2493,6 +2655,7 @@ bool QHYCCD::StartStreaming()
 
 bool QHYCCD::StopStreaming()
 {
+    m_StreamRunning = false;
     pthread_mutex_lock(&condMutex);
     m_ThreadRequest = StateAbort;
     pthread_cond_signal(&cv);
@@ -2580,43 +2743,68 @@ void *QHYCCD::imagingThreadEntry()
 
 void QHYCCD::streamVideo()
 {
+    if (!m_LiveQueue.allocate(PrimaryCCD.getFrameBufferSize()))
+    {
+        LOGF_ERROR("Failed to allocate %u bytes for the video frame queue.", PrimaryCCD.getFrameBufferSize());
+        m_ThreadRequest = StateIdle;
+        return;
+    }
+
+    // The camera is read here without any lock, the sender thread hands the frames to the streamer.
+    pthread_mutex_unlock(&condMutex);
+    std::thread sender(&QHYCCD::streamSenderThreadEntry, this);
+
+    const bool gpsTimestamps = HasGPS && GPSControlS[INDI_ENABLED].s == ISS_ON;
     uint32_t ret = 0, w, h, bpp, channels;
-    //uint32_t t_start = time(NULL), frames = 0;
-    while (m_ThreadRequest == StateStream)
+    while (m_StreamRunning)
     {
-        pthread_mutex_unlock(&condMutex);
-        uint32_t retries = 0;
-        std::unique_lock<std::mutex> guard(ccdBufferLock);
-        uint8_t *buffer = PrimaryCCD.getFrameBuffer();
-        while (retries++ < 10)
-        {
+        QHYFrameQueue::Frame &frame = m_LiveQueue.writeSlot();
 
-            ret = GetQHYCCDLiveFrame(m_CameraHandle, &w, &h, &bpp, &channels, buffer);
-            if (ret == QHYCCD_ERROR)
-                usleep(1000);
-            else
-                break;
-        }
-        guard.unlock();
-        if (ret == QHYCCD_SUCCESS)
+        ret = GetQHYCCDLiveFrame(m_CameraHandle, &w, &h, &bpp, &channels, frame.data);
+        if (ret != QHYCCD_SUCCESS)
         {
-            uint64_t timestamp = 0;
-            if (HasGPS && GPSControlS[INDI_ENABLED].s == ISS_ON)
-            {
-                decodeGPSHeader();
-                timestamp = (uint64_t)GPSHeader.start_sec * 1e6;
-                timestamp += GPSHeader.start_us + QHY_SER_US_EPOCH;
-            }
+            // No new frame yet
+            usleep(500);
+            continue;
+        }
+
+        frame.bytes = w * h * bpp / 8 * channels;
+        frame.timestamp = gpsTimestamps ? decodeGPSTimestamp(frame.data) : 0;
+        m_LiveQueue.push();
+    }
+
+    sender.join();
+    if (m_LiveQueue.dropped() > 0)
+        LOGF_DEBUG("Video frame queue dropped %llu frames.", static_cast<unsigned long long>(m_LiveQueue.dropped()));
+    m_LiveQueue.release();
+
+    pthread_mutex_lock(&condMutex);
+}
 
-            Streamer->newFrame(buffer, w * h * bpp / 8 * channels, timestamp);
+void QHYCCD::streamSenderThreadEntry()
+{
+    INDI::ElapsedTimer gpsRefresh;
+    bool gpsPending = true;
 
-            //DEBUG
-            //if(!frames)
-            //    LOGF_DEBUG("Receiving frames ...");
-            //if(!(++frames % 30))
-            //    LOGF_DEBUG("Frames received: %d (%.1f fps)", frames, 1.0 * frames / (time(NULL) - t_start));
+    while (m_StreamRunning)
+    {
+        const QHYFrameQueue::Frame *frame = m_LiveQueue.readSlot();
+        if (frame == nullptr)
+        {
+            usleep(500);
+            continue;
         }
-        pthread_mutex_lock(&condMutex);
+
+        // Full header decoding with the text properties is only refreshed about once a second
+        if (HasGPS && GPSControlS[INDI_ENABLED].s == ISS_ON && (gpsPending || gpsRefresh.elapsed() >= GPS_REFRESH_MS))
+        {
+            decodeGPSHeader(frame->data);
+            gpsRefresh.start();
+            gpsPending = false;
+        }
+
+        Streamer->newFrame(frame->data, frame->bytes, frame->timestamp);
+        m_LiveQueue.pop();
     }
 }
 
@@ -2829,12 +3017,20 @@ void QHYCCD::setLEDStartPosNP(const INumberVectorProperty &value)
     GPSLEDStartPosNP = value;
 }
 
-void QHYCCD::decodeGPSHeader()
+uint64_t QHYCCD::decodeGPSTimestamp(const uint8_t *header)
+{
+    uint32_t start_sec = header[18] << 24 | header[19] << 16 | header[20] << 8 | header[21];
+    // 10Mhz ticks
+    uint32_t start_ticks = header[22] << 16 | header[23] << 8 | header[24];
+    return static_cast<uint64_t>(start_sec) * 1000000 + start_ticks / 10 + QHY_SER_US_EPOCH;
+}
+
+void QHYCCD::decodeGPSHeader(const uint8_t *header)
 {
     char ts[64] = {0}, iso8601[64] = {0}, data[64] = {0};
 
     uint8_t gpsarray[64] = {0};
-    memcpy(gpsarray, PrimaryCCD.getFrameBuffer(), 64);
+    memcpy(gpsarray, header, 64);
 
     // Sequence Number
     GPSHeader.seqNumber = gpsarray[0] << 24 | gpsarray[1] << 16 | gpsarray[2] << 8 | gpsarray[3];
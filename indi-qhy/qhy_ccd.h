@@ -24,9 +24,14 @@
 #include <qhyccd.h>
 #include <indiccd.h>
 #include <indifilterinterface.h>
+#include "qhy_framequeue.h"
 #include <unistd.h>
 #include <functional>
 #include <pthread.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #define DEVICE struct usb_device *
 
@@ -176,6 +181,10 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         INumber USBBufferN[1];
         INumberVectorProperty USBBufferNP;
 
+        // Pipelined capture: read out into a back buffer while the previous frame is uploaded
+        ISwitch PipelineS[2];
+        ISwitchVectorProperty PipelineSP;
+
         // Humidity Readout
         INumber HumidityN[1];
         INumberVectorProperty HumidityNP;
@@ -389,10 +398,23 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         static void *imagingHelper(void *context);
         void *imagingThreadEntry();
         void streamVideo();
+        // Passes live frames from the queue to the streamer
+        void streamSenderThreadEntry();
         void getExposure();
         void exposureSetRequest(ImageState request);
         int grabImage();
 
+        /////////////////////////////////////////////////////////////////////////////
+        /// Pipelined Capture
+        /////////////////////////////////////////////////////////////////////////////
+        // Back buffer of the ping-pong pair, the front one is PrimaryCCD's frame buffer
+        uint8_t *getBackBuffer();
+        void releaseBackBuffer();
+        // FITS packaging and upload of the front buffer on the packaging thread
+        void packagingThreadEntry();
+        void queuePackaging();
+        void waitForPackaging();
+
         /////////////////////////////////////////////////////////////////////////////
         /// Cooling
         /////////////////////////////////////////////////////////////////////////////
@@ -414,8 +436,10 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         bool isQHY5PIIC();
         // Call when max filter count is known
         bool updateFilterProperties();
-        // Decode GPS Header
-        void decodeGPSHeader();
+        // Decode GPS Header and update the GPS data properties
+        void decodeGPSHeader(const uint8_t *header);
+        // SER timestamp of the frame start from the raw GPS header, cheap enough to run on every frame
+        static uint64_t decodeGPSTimestamp(const uint8_t *header);
         /**
          * @brief JStoJD Convert Julian Second to Julian Date
          * @param JS Julian Second
@@ -489,6 +513,18 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         pthread_cond_t cv         = PTHREAD_COND_INITIALIZER;
         pthread_mutex_t condMutex = PTHREAD_MUTEX_INITIALIZER;
 
+        uint8_t *m_BackBuffer {nullptr};
+        uint32_t m_BackBufferSize {0};
+        std::thread m_PackagingThread;
+        std::mutex m_PackagingMutex;
+        std::condition_variable m_PackagingCV;
+        bool m_PackagingPending {false};
+        bool m_PackagingTerminate {false};
+
+        // Live frames read by the imaging thread, sent to the streamer by the sender thread
+        QHYFrameQueue m_LiveQueue {8};
+        std::atomic_bool m_StreamRunning {false};
+
         void logQHYMessages(const std::string &message);
         std::function<void(const std::string &)> m_QHYLogCallback;
 
@@ -498,4 +534,5 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         static constexpr const char * GPS_CONTROL_TAB = "GPS Control";
         static constexpr const char * GPS_DATA_TAB = "GPS Data";
         static constexpr uint64_t QHY_SER_US_EPOCH = 62948880000000000; // offset to SER epoch January 1, 1 AD
+        static constexpr uint32_t GPS_REFRESH_MS = 1000; // GPS data properties refresh period while streaming
 };
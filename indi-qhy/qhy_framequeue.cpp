@@ -0,0 +1,110 @@
+/*
+ QHY INDI Driver
+
+ Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qhy_framequeue.h"
+
+#include <cstdlib>
+#include <unistd.h>
+
+QHYFrameQueue::QHYFrameQueue(size_t depth)
+    : mSlots((depth < 1 ? 1 : depth) + 1)
+{ }
+
+QHYFrameQueue::~QHYFrameQueue()
+{
+    release();
+}
+
+bool QHYFrameQueue::allocate(size_t frameSize)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0)
+        pageSize = 4096;
+
+    mHead.store(0, std::memory_order_relaxed);
+    mTail.store(0, std::memory_order_relaxed);
+    mDropped.store(0, std::memory_order_relaxed);
+
+    for (auto &slot : mSlots)
+    {
+        if (frameSize != mFrameSize || slot.data == nullptr)
+        {
+            free(slot.data);
+            slot.data = nullptr;
+            if (posix_memalign(reinterpret_cast<void **>(&slot.data), pageSize, frameSize) != 0)
+            {
+                slot.data = nullptr;
+                mFrameSize = 0;
+                return false;
+            }
+        }
+        slot.bytes = 0;
+        slot.timestamp = 0;
+    }
+
+    mFrameSize = frameSize;
+    return true;
+}
+
+void QHYFrameQueue::release()
+{
+    for (auto &slot : mSlots)
+    {
+        free(slot.data);
+        slot.data = nullptr;
+        slot.bytes = 0;
+    }
+    mFrameSize = 0;
+}
+
+QHYFrameQueue::Frame &QHYFrameQueue::writeSlot()
+{
+    return mSlots[mTail.load(std::memory_order_relaxed)];
+}
+
+bool QHYFrameQueue::push()
+{
+    size_t tail = mTail.load(std::memory_order_relaxed);
+    size_t next = (tail + 1) % mSlots.size();
+
+    if (next == mHead.load(std::memory_order_acquire))
+    {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    mTail.store(next, std::memory_order_release);
+    return true;
+}
+
+const QHYFrameQueue::Frame *QHYFrameQueue::readSlot() const
+{
+    size_t head = mHead.load(std::memory_order_relaxed);
+    if (head == mTail.load(std::memory_order_acquire))
+        return nullptr;
+
+    return &mSlots[head];
+}
+
+void QHYFrameQueue::pop()
+{
+    size_t head = mHead.load(std::memory_order_relaxed);
+    mHead.store((head + 1) % mSlots.size(), std::memory_order_release);
+}
@@ -0,0 +1,90 @@
+/*
+ QHY INDI Driver
+
+ Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The QHYFrameQueue class is a lock-free single producer, single consumer queue of
+ * preallocated live frames, each carrying its own timestamp.
+ *
+ * The producer always has a slot to read the next frame into. If the consumer falls behind
+ * and the queue is full, push() discards the new frame and the slot is reused for the next one.
+ */
+class QHYFrameQueue
+{
+    public:
+        struct Frame
+        {
+            uint8_t *data {nullptr};
+            size_t bytes {0};
+            uint64_t timestamp {0};     // SER timestamp, 0 lets the streamer stamp the frame
+        };
+
+    public:
+        /** @param depth number of frames that can be queued */
+        explicit QHYFrameQueue(size_t depth);
+        ~QHYFrameQueue();
+
+        QHYFrameQueue(const QHYFrameQueue &) = delete;
+        QHYFrameQueue &operator=(const QHYFrameQueue &) = delete;
+
+        /** Allocate all slots to hold frameSize bytes and empty the queue. Not thread safe. */
+        bool allocate(size_t frameSize);
+
+        /** Free all slots. Not thread safe. */
+        void release();
+
+        size_t frameSize() const
+        {
+            return mFrameSize;
+        }
+
+        /** Producer: slot to read the next frame into, never nullptr once allocated. */
+        Frame &writeSlot();
+
+        /** Producer: publish the write slot. Returns false if the queue was full and the frame was dropped. */
+        bool push();
+
+        /** Consumer: oldest queued frame, nullptr if the queue is empty. */
+        const Frame *readSlot() const;
+
+        /** Consumer: release the frame returned by readSlot. */
+        void pop();
+
+        /** Number of frames dropped since allocate() */
+        uint64_t dropped() const
+        {
+            return mDropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::vector<Frame> mSlots;
+        size_t mFrameSize {0};
+
+        // One slot is always left unused so that the slot at mTail is owned by the producer.
+        alignas(64) std::atomic<size_t> mHead {0};   // written by the consumer
+        alignas(64) std::atomic<size_t> mTail {0};   // written by the producer
+        std::atomic<uint64_t> mDropped {0};
+};
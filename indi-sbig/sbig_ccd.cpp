@@ -52,6 +52,7 @@
 #define MAX_DEVICES         20   /* Max device cameraCount */
 #define MAX_THREAD_RETRIES  3
 #define MAX_THREAD_WAIT     300000
+#define READOUT_BLOCK_LINES 64   /* Lines read before the tracking chip can be serviced */
 
 static class Loader
 {
@@ -278,6 +279,36 @@ int SBIGCCD::CloseDevice()
 
 SBIGCCD::SBIGCCD() : FilterInterface(this)
 {
+    SBIGScheduler::Driver driver;
+    driver.startReadout = [this](const SBIGScheduler::Readout & readout)
+    {
+        StartReadoutParams srp;
+        srp.ccd         = readout.ccd;
+        srp.readoutMode = readout.readoutMode;
+        srp.left        = readout.left;
+        srp.top         = readout.top;
+        srp.width       = readout.width;
+        srp.height      = readout.height;
+        return StartReadout(&srp);
+    };
+    driver.readoutLine = [this](const SBIGScheduler::Readout & readout, uint16_t *line)
+    {
+        ReadoutLineParams rlp;
+        rlp.ccd         = readout.ccd;
+        rlp.readoutMode = readout.readoutMode;
+        rlp.pixelStart  = readout.left;
+        rlp.pixelLength = readout.width;
+        return ReadoutLine(&rlp, line, false);
+    };
+    driver.endReadout = [this](const SBIGScheduler::Readout & readout)
+    {
+        EndReadoutParams erp;
+        erp.ccd = readout.ccd;
+        return EndReadout(&erp);
+    };
+    m_Scheduler.reset(new SBIGScheduler(sbigLock, driver));
+    m_Scheduler->setBlockLines(READOUT_BLOCK_LINES);
+
     InitVars();
     int res = OpenDriver();
     if (res != CE_NO_ERROR)
@@ -306,6 +337,7 @@ SBIGCCD::SBIGCCD() : FilterInterface(this)
 
 SBIGCCD::~SBIGCCD()
 {
+    m_Scheduler->stop();
     CloseDevice();
     CloseDriver();
 }
@@ -902,6 +934,7 @@ bool SBIGCCD::Disconnect()
 {
     if (!isConnected())
         return true;
+    m_Scheduler->stop();
     m_useExternalTrackingCCD = false;
     m_hasGuideHead           = false;
 #ifdef ASYNC_READOUT
@@ -950,6 +983,7 @@ bool SBIGCCD::setupParams()
     x_1 = y_1 = 0;
     x_2       = wCcd;
     y_2       = hCcd;
+    m_Scheduler->wait();
     SetCCDParams(x_2 - x_1, y_2 - y_1, bit_depth, x_pixel_size, y_pixel_size);
 
     if (HasGuideHead())
@@ -1100,7 +1134,7 @@ int SBIGCCD::StartExposure(INDI::CCDChip *targetChip, double duration)
 
     for (int i = 0; i < MAX_THREAD_RETRIES; i++)
     {
-        std::unique_lock<std::mutex> guard(sbigLock);
+        SBIGScheduler::Lock guard = m_Scheduler->lock();
         res = StartExposure(&sep);
         guard.unlock();
         if (res == CE_NO_ERROR)
@@ -1186,7 +1220,7 @@ int SBIGCCD::AbortExposure(INDI::CCDChip *targetChip)
     }
     EndExposureParams eep;
     eep.ccd = ccd;
-    std::unique_lock<std::mutex> guard(sbigLock);
+    SBIGScheduler::Lock guard = m_Scheduler->lock();
     int res = EndExposure(&eep);
     guard.unlock();
     return res;
@@ -1196,6 +1230,8 @@ bool SBIGCCD::AbortExposure()
 {
     int res = CE_NO_ERROR;
     LOG_DEBUG("Aborting primary camera exposure...");
+    m_Scheduler->cancel();
+    m_Scheduler->wait();
     for (int i = 0; i < MAX_THREAD_RETRIES; i++)
     {
         res = AbortExposure(&PrimaryCCD);
@@ -1240,6 +1276,8 @@ bool SBIGCCD::AbortGuideExposure()
 
 bool SBIGCCD::UpdateCCDFrameType(INDI::CCDChip::CCD_FRAME fType)
 {
+    // A queued readout is packaged with the frame type in place when it completes
+    m_Scheduler->wait();
     INDI::CCDChip::CCD_FRAME imageFrameType = PrimaryCCD.getFrameType();
     if (fType != imageFrameType)
     {
@@ -1291,6 +1329,8 @@ bool SBIGCCD::updateFrameProperties(INDI::CCDChip *targetChip)
 bool SBIGCCD::UpdateCCDFrame(int x, int y, int w, int h)
 {
     LOGF_DEBUG("The final main camera image area is (%ld, %ld), (%ld, %ld)", x, y, w, h);
+    // The frame buffer may be in use by a readout
+    m_Scheduler->wait();
     PrimaryCCD.setFrame(x, y, w, h);
     int nbuf = (w * h * PrimaryCCD.getBPP() / 8) + 512;
     PrimaryCCD.setFrameBufferSize(nbuf);
@@ -1310,6 +1350,8 @@ bool SBIGCCD::UpdateGuiderFrame(int x, int y, int w, int h)
 
 bool SBIGCCD::UpdateCCDBin(int binx, int biny)
 {
+    // A queued readout must be packaged with the binning and frame it was taken with
+    m_Scheduler->wait();
     // only basic sanity checks; if the camera really supports the requested binning
     // mode is checked in getBinningMode
     if (binx > 255 || biny > 255)
@@ -1445,8 +1487,6 @@ void *SBIGCCD::grabCCD()
 
 bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
 {
-    uint16_t left   = targetChip->getSubX() / targetChip->getBinX();
-    uint16_t top    = targetChip->getSubY() / targetChip->getBinX();
     uint16_t width  = targetChip->getSubW() / targetChip->getBinX();
     uint16_t height = targetChip->getSubH() / targetChip->getBinY();
 
@@ -1465,11 +1505,10 @@ bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
     }
     else
     {
-        uint16_t *buffer = reinterpret_cast<uint16_t *>(targetChip->getFrameBuffer());
-        int res                = 0;
+        int res = 0;
         for (int i = 0; i < MAX_THREAD_RETRIES; i++)
         {
-            res = readoutCCD(left, top, width, height, buffer, targetChip);
+            res = readoutCCD(targetChip);
             if (res == CE_NO_ERROR)
                 break;
             LOGF_DEBUG("Readout error, retrying...", res);
@@ -1521,7 +1560,7 @@ void SBIGCCD::TimerHit()
             LOG_DEBUG("Primay camera exposure done, downloading image...");
             targetChip->setExposureLeft(0);
             InExposure = false;
-            if (grabImage(targetChip) == false)
+            if (queueImagingReadout() == false)
                 targetChip->setExposureFailed();
         }
         else
@@ -2269,6 +2308,8 @@ int SBIGCCD::SBIGUnivDrvCommand(PAR_COMMAND command, void *params, void *results
     {
         return CE_NO_ERROR;
     }
+    // The imaging readout may be sending commands from its thread
+    SBIGScheduler::Lock guard = m_Scheduler->lock();
     // Make sure we have a valid handle to the driver.
     if (GetDriverHandle() == INVALID_HANDLE_VALUE)
     {
@@ -2520,7 +2561,7 @@ void SBIGCCD::updateTemperature()
     bool enabled;
     double ccdTemp, setpointTemp, percentTE, power;
 
-    std::unique_lock<std::mutex> guard(sbigLock);
+    SBIGScheduler::Lock guard = m_Scheduler->lock();
     int res = QueryTemperatureStatus(enabled, ccdTemp, setpointTemp, percentTE);
     guard.unlock();
 
@@ -2610,7 +2651,7 @@ bool SBIGCCD::isExposureDone(INDI::CCDChip *targetChip)
 
     // Query command status:
     qcsp.command = CC_START_EXPOSURE2;
-    std::unique_lock<std::mutex> guard(sbigLock);
+    SBIGScheduler::Lock guard = m_Scheduler->lock();
     int res = QueryCommandStatus(&qcsp, &qcsr);
     if (res != CE_NO_ERROR)
     {
@@ -2641,58 +2682,93 @@ bool SBIGCCD::isExposureDone(INDI::CCDChip *targetChip)
 
 //==========================================================================
 
-int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t height,
-                        uint16_t *buffer, INDI::CCDChip *targetChip)
+int SBIGCCD::getReadout(INDI::CCDChip *targetChip, SBIGScheduler::Readout &readout)
 {
-    int h, ccd, binning, res;
+    int binning, res;
+    if ((res = getBinningMode(targetChip, binning)) != CE_NO_ERROR)
+    {
+        return res;
+    }
     if (targetChip == &PrimaryCCD)
     {
-        ccd = CCD_IMAGING;
+        readout.ccd = CCD_IMAGING;
     }
     else
     {
-        ccd = m_useExternalTrackingCCD ? CCD_EXT_TRACKING : CCD_TRACKING;
+        readout.ccd = m_useExternalTrackingCCD ? CCD_EXT_TRACKING : CCD_TRACKING;
     }
-    if ((res = getBinningMode(targetChip, binning)) != CE_NO_ERROR)
+    readout.readoutMode = binning;
+    readout.left        = targetChip->getSubX() / targetChip->getBinX();
+    readout.top         = targetChip->getSubY() / targetChip->getBinY();
+    readout.width       = targetChip->getSubW() / targetChip->getBinX();
+    readout.height      = targetChip->getSubH() / targetChip->getBinY();
+    readout.buffer      = reinterpret_cast<uint16_t *>(targetChip->getFrameBuffer());
+    return CE_NO_ERROR;
+}
+
+void SBIGCCD::logReadout(INDI::CCDChip *targetChip, const SBIGScheduler::Readout &readout,
+                         const SBIGScheduler::Timing &timing)
+{
+    LOGF_DEBUG("%s readout %dx%d: queued %.3fs, start %.3fs, %d blocks %.3fs (%.0f lines/s), end %.3fs, "
+               "%d commands interleaved %.3fs, %d retries, total %.3fs",
+               (targetChip == &PrimaryCCD) ? "Primary" : "Guide", readout.width, readout.height, timing.queued,
+               timing.start, timing.blocks, timing.lines, timing.lines > 0 ? readout.height / timing.lines : 0.0,
+               timing.end, timing.interleaved, timing.yielded, timing.retries, timing.total);
+}
+
+int SBIGCCD::readoutCCD(INDI::CCDChip *targetChip)
+{
+    SBIGScheduler::Readout readout;
+    SBIGScheduler::Timing timing;
+    int res = getReadout(targetChip, readout);
+    if (res != CE_NO_ERROR)
     {
         return res;
     }
-    StartReadoutParams srp;
-    srp.ccd         = ccd;
-    srp.readoutMode = binning;
-    srp.left        = left;
-    srp.top         = top;
-    srp.width       = width;
-    srp.height      = height;
-    std::unique_lock<std::mutex> guard(sbigLock);
-    res = StartReadout(&srp);
-    if (res != CE_NO_ERROR)
+    if ((res = m_Scheduler->run(readout, timing)) != CE_NO_ERROR)
     {
-        LOGF_ERROR("%s readoutCCD - StartReadout error! (%s)",
+        LOGF_ERROR("%s readoutCCD error! (%s)",
                    (targetChip == &PrimaryCCD) ? "Primary" : "Guide", GetErrorString(res));
-        guard.unlock();
         return res;
     }
-    ReadoutLineParams rlp;
-    rlp.ccd         = ccd;
-    rlp.readoutMode = binning;
-    rlp.pixelStart  = left;
-    rlp.pixelLength = width;
-    for (h = 0; h < height; h++)
+    logReadout(targetChip, readout, timing);
+    return res;
+}
+
+bool SBIGCCD::queueImagingReadout()
+{
+    if (isSimulation())
     {
-        ReadoutLine(&rlp, buffer + (h * width), false);
+        return grabImage(&PrimaryCCD);
     }
-    EndReadoutParams erp;
-    erp.ccd = ccd;
-    if ((res = EndReadout(&erp)) != CE_NO_ERROR)
+
+    SBIGScheduler::Readout readout;
+    if (getReadout(&PrimaryCCD, readout) != CE_NO_ERROR)
     {
-        LOGF_ERROR("%s readoutCCD - EndReadout error! (%s)",
-                   (targetChip == &PrimaryCCD) ? "Primary" : "Guide", GetErrorString(res));
-        guard.unlock();
-        return res;
+        return false;
     }
-    guard.unlock();
-    return res;
+
+    // Read in the background so the guide head keeps being serviced
+    LOG_DEBUG("Primary camera readout in progress...");
+    m_Scheduler->submit(readout, MAX_THREAD_RETRIES - 1, MAX_THREAD_WAIT,
+                        [this, readout](int res, const SBIGScheduler::Timing & timing)
+    {
+        if (res == SBIGScheduler::CANCELLED)
+        {
+            LOG_DEBUG("Primary camera readout cancelled");
+            return;
+        }
+        if (res != CE_NO_ERROR)
+        {
+            LOGF_ERROR("Primary camera readout error (%s)", GetErrorString(res));
+            PrimaryCCD.setExposureFailed();
+            return;
+        }
+        logReadout(&PrimaryCCD, readout, timing);
+        LOG_DEBUG("Primary camera readout complete");
+        ExposureComplete(&PrimaryCCD);
+    });
+    return true;
 }
 
 //==========================================================================
@@ -30,6 +30,8 @@
 #include <indiccd.h>
 #include <indifilterinterface.h>
 
+#include "sbig_scheduler.h"
+
 #ifdef __APPLE__
 #include <libusb-1.0/libusb.h>
 #include <libsbig/sbigudrv.h>
@@ -37,6 +39,7 @@
 #include <sbigudrv.h>
 #endif
 
+#include <memory>
 #include <string>
 
 #define DEVICE struct usb_device *
@@ -276,7 +279,9 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         /////////////////////////////////////////////////////////////////////////////
         /// Threading Variables
         /////////////////////////////////////////////////////////////////////////////
-        std::mutex sbigLock;
+        SBIGScheduler::Mutex sbigLock;
+        // Imaging chip readouts in the background, every driver command goes through it
+        std::unique_ptr<SBIGScheduler> m_Scheduler;
 
         /////////////////////////////////////////////////////////////////////////////
         /// Exposure Variables
@@ -407,8 +412,10 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         int getBinningMode(INDI::CCDChip *targetChip, int &binning);
         int getFrameType(INDI::CCDChip *targetChip, INDI::CCDChip::CCD_FRAME *frameType);
         int getShutterMode(INDI::CCDChip *targetChip, int &shutter);
-        int readoutCCD(unsigned short left, unsigned short top, unsigned short width, unsigned short height,
-                       unsigned short *buffer, INDI::CCDChip *targetChip);
+        int readoutCCD(INDI::CCDChip *targetChip);
+        int getReadout(INDI::CCDChip *targetChip, SBIGScheduler::Readout &readout);
+        void logReadout(INDI::CCDChip *targetChip, const SBIGScheduler::Readout &readout,
+                        const SBIGScheduler::Timing &timing);
 
         /////////////////////////////////////////////////////////////////////////////
         /// Filter Wheel Functions
@@ -434,6 +441,7 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         /// Utility Functions
         /////////////////////////////////////////////////////////////////////////////
         bool grabImage(INDI::CCDChip *targetChip);
+        bool queueImagingReadout();
         bool setupParams();
         // SBIG's software interface to the Universal Driver Library function:
         int SBIGUnivDrvCommand(PAR_COMMAND, void *, void *);
@@ -0,0 +1,228 @@
+/*
+    Driver type: SBIG CCD Camera INDI Driver
+
+    Readout scheduler, imaging chip downloads interleaved with the other
+    operations on the camera.
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja AT ikarustech DOT com)
+
+    This library is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+    or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+    License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this library; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+
+ */
+
+#include "sbig_scheduler.h"
+
+#include <algorithm>
+
+// Scheduler whose worker is the current thread
+static thread_local const SBIGScheduler *currentWorker = nullptr;
+
+static double seconds(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+SBIGScheduler::SBIGScheduler(Mutex &lock, Driver driver) : mLock(lock), mDriver(driver)
+{
+}
+
+SBIGScheduler::~SBIGScheduler()
+{
+    stop();
+}
+
+SBIGScheduler::Lock SBIGScheduler::lock()
+{
+    // The worker already holds the lock while it reads
+    if (currentWorker == this)
+        return Lock(mLock);
+
+    mWaiting++;
+    Lock guard(mLock);
+    mServed++;
+
+    if (--mWaiting == 0)
+    {
+        // The lock of the waiting list makes sure the worker is waiting or has not checked yet
+        std::lock_guard<std::mutex> waiting(mWaitingLock);
+        mWaitingDone.notify_all();
+    }
+    return guard;
+}
+
+void SBIGScheduler::yield(Lock &guard, Timing &timing)
+{
+    if (mWaiting == 0)
+        return;
+
+    Clock::time_point start = Clock::now();
+    int served = mServed;
+
+    guard.unlock();
+    {
+        std::unique_lock<std::mutex> waiting(mWaitingLock);
+        mWaitingDone.wait(waiting, [this] { return mWaiting == 0; });
+    }
+    guard.lock();
+
+    timing.interleaved += mServed - served;
+    timing.yielded += seconds(Clock::now() - start);
+}
+
+int SBIGScheduler::read(const Readout &readout, Timing &timing, Lock &guard, const Job *job)
+{
+    Clock::time_point t = Clock::now();
+    int res = mDriver.startReadout(readout);
+    timing.start += seconds(Clock::now() - t);
+    if (res != 0)
+        return res;
+
+    uint16_t *line = readout.buffer;
+    for (int row = 0; row < readout.height && res == 0;)
+    {
+        int block = std::min<int>(mBlockLines, readout.height - row);
+
+        t = Clock::now();
+        for (int end = row + block; row < end && res == 0; row++, line += readout.width)
+            res = mDriver.readoutLine(readout, line);
+        timing.lines += seconds(Clock::now() - t);
+        timing.blocks++;
+
+        if (job != nullptr && res == 0 && row < readout.height)
+        {
+            yield(guard, timing);
+            if (cancelled(*job))
+                res = CANCELLED;
+        }
+    }
+
+    // Always end the readout, the chip is left in a known state
+    t = Clock::now();
+    int end = mDriver.endReadout(readout);
+    timing.end += seconds(Clock::now() - t);
+
+    return res != 0 ? res : end;
+}
+
+int SBIGScheduler::run(const Readout &readout, Timing &timing)
+{
+    Clock::time_point start = Clock::now();
+    Lock guard = lock();
+    timing.queued += seconds(Clock::now() - start);
+
+    int res = read(readout, timing, guard, nullptr);
+    timing.total += seconds(Clock::now() - start);
+    return res;
+}
+
+void SBIGScheduler::submit(const Readout &readout, int retries, int retryWait, Completion done)
+{
+    Job job;
+    job.readout   = readout;
+    job.retries   = retries;
+    job.retryWait = retryWait;
+    job.done      = done;
+    job.queued    = Clock::now();
+
+    std::lock_guard<std::mutex> queue(mQueueLock);
+    if (!mRunning)
+    {
+        mRunning  = true;
+        mStopping = false;
+        mWorker   = std::thread(&SBIGScheduler::worker, this);
+    }
+    job.generation = mGeneration;
+    mQueue.push_back(job);
+    mQueueChanged.notify_all();
+}
+
+void SBIGScheduler::worker()
+{
+    currentWorker = this;
+
+    std::unique_lock<std::mutex> queue(mQueueLock);
+    for (;;)
+    {
+        mQueueChanged.wait(queue, [this] { return mStopping || !mQueue.empty(); });
+        if (mQueue.empty())
+            break;
+
+        Job &job = mQueue.front();
+        queue.unlock();
+
+        Timing timing;
+        int res = CANCELLED;
+        for (int attempt = 0; attempt <= job.retries && !cancelled(job); attempt++)
+        {
+            if (attempt > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(job.retryWait));
+                timing.retries++;
+            }
+
+            Lock guard(mLock);
+            if (attempt == 0)
+                timing.queued = seconds(Clock::now() - job.queued);
+
+            res = read(job.readout, timing, guard, &job);
+            if (res == 0 || res == CANCELLED)
+                break;
+        }
+        if (cancelled(job))
+            res = CANCELLED;
+        timing.total = seconds(Clock::now() - job.queued);
+
+        if (job.done)
+            job.done(res, timing);
+
+        queue.lock();
+        mQueue.pop_front();
+        mQueueChanged.notify_all();
+    }
+}
+
+void SBIGScheduler::cancel()
+{
+    mGeneration++;
+}
+
+void SBIGScheduler::wait()
+{
+    std::unique_lock<std::mutex> queue(mQueueLock);
+    mQueueChanged.wait(queue, [this] { return mQueue.empty(); });
+}
+
+bool SBIGScheduler::busy()
+{
+    std::lock_guard<std::mutex> queue(mQueueLock);
+    return !mQueue.empty();
+}
+
+void SBIGScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> queue(mQueueLock);
+        if (!mRunning)
+            return;
+        mGeneration++;
+        mStopping = true;
+        mQueueChanged.notify_all();
+    }
+
+    mWorker.join();
+
+    std::lock_guard<std::mutex> queue(mQueueLock);
+    mRunning = false;
+}
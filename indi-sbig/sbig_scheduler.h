@@ -0,0 +1,169 @@
+/*
+    Driver type: SBIG CCD Camera INDI Driver
+
+    Readout scheduler, imaging chip downloads interleaved with the other
+    operations on the camera.
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja AT ikarustech DOT com)
+
+    This library is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+    or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+    License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this library; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief The SBIGScheduler class serializes the commands sent to the SBIG universal driver.
+ *
+ * Every command is sent with the driver lock held. Readouts are done in blocks of lines
+ * written straight to the frame buffer, the lock is held for a whole block. Imaging chip
+ * readouts run in a worker thread and give the lock away between blocks to the callers of
+ * lock(), so the tracking chip can be exposed, polled and read out while the imaging chip
+ * downloads. A readout is never interrupted inside a block.
+ *
+ * The lock is recursive, a caller of lock() may send several commands that lock it again.
+ */
+class SBIGScheduler
+{
+    public:
+        // Recursive, the driver commands lock it again
+        typedef std::recursive_mutex Mutex;
+        typedef std::unique_lock<Mutex> Lock;
+
+        /** Returned by a readout stopped by cancel() */
+        static const int CANCELLED = -1;
+
+        struct Readout
+        {
+            int ccd {0};
+            int readoutMode {0};
+            uint16_t left {0};
+            uint16_t top {0};
+            uint16_t width {0};
+            uint16_t height {0};
+            uint16_t *buffer {nullptr};     // width x height pixels
+        };
+
+        /** Seconds spent in each phase of a readout */
+        struct Timing
+        {
+            double queued {0};              // waiting for the worker and the lock
+            double start {0};               // CC_START_READOUT
+            double lines {0};               // CC_READOUT_LINE
+            double end {0};                 // CC_END_READOUT
+            double yielded {0};             // lock given away between blocks
+            double total {0};
+            int blocks {0};
+            int interleaved {0};            // commands sent between the blocks
+            int retries {0};
+        };
+
+        /** Driver commands, called with the lock held. They return the driver error code, 0 on success. */
+        struct Driver
+        {
+            std::function<int(const Readout &)> startReadout;
+            std::function<int(const Readout &, uint16_t *line)> readoutLine;
+            std::function<int(const Readout &)> endReadout;
+        };
+
+        typedef std::function<void(int result, const Timing &timing)> Completion;
+
+        SBIGScheduler(Mutex &lock, Driver driver);
+        ~SBIGScheduler();
+
+        SBIGScheduler(const SBIGScheduler &) = delete;
+        SBIGScheduler &operator=(const SBIGScheduler &) = delete;
+
+        /** Lines read while the lock is held */
+        void setBlockLines(int lines)
+        {
+            mBlockLines = lines > 0 ? lines : 1;
+        }
+
+        /** Take the driver lock, ahead of the imaging readout if one is in progress */
+        Lock lock();
+
+        /** Read out a chip in the calling thread, the lock is held from start to end */
+        int run(const Readout &readout, Timing &timing);
+
+        /**
+         * @brief Queue an imaging readout, read in the worker thread.
+         * @param retries times the readout is restarted after a driver error
+         * @param retryWait microseconds between two attempts
+         * @param done called from the worker thread when the readout ends
+         */
+        void submit(const Readout &readout, int retries, int retryWait, Completion done);
+
+        /** Stop the queued and running readouts, the running one at the end of its current block */
+        void cancel();
+
+        /** Wait for the queued readouts */
+        void wait();
+
+        bool busy();
+
+        /** Cancel the readouts and stop the worker */
+        void stop();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Job
+        {
+            Readout readout;
+            int retries {0};
+            int retryWait {0};
+            Completion done;
+            Clock::time_point queued;
+            unsigned int generation {0};
+        };
+
+        // Interleaved and cancellable when read for a job
+        int read(const Readout &readout, Timing &timing, Lock &guard, const Job *job);
+        bool cancelled(const Job &job) const
+        {
+            return job.generation != mGeneration;
+        }
+        void yield(Lock &guard, Timing &timing);
+        void worker();
+
+        Mutex &mLock;
+        Driver mDriver;
+        std::atomic<int> mBlockLines {64};
+
+        // Callers of lock() waiting for the driver, and the ones served, the worker thread is not counted
+        std::atomic<int> mWaiting {0};
+        std::atomic<int> mServed {0};
+        std::mutex mWaitingLock;
+        std::condition_variable mWaitingDone;
+
+        std::mutex mQueueLock;
+        std::condition_variable mQueueChanged;
+        std::deque<Job> mQueue;
+        bool mRunning {false};
+        bool mStopping {false};
+        // Jobs queued before the last cancel() are cancelled
+        std::atomic<unsigned int> mGeneration {0};
+        std::thread mWorker;
+};
@@ -335,8 +335,14 @@ INDIStarbookTen::fetchStartupInfo() {
 bool
 INDIStarbookTen::ReadScopeStatus() {
     try {
-        auto stat = retry<StarbookTen::MountStatus>(2, &StarbookTen::getStatus, starbook);
-        bool isTracking = retry<bool>(2, &StarbookTen::isTracking, starbook);
+        // One status cycle, the getters below read its replies
+        unsigned int fields = StarbookTen::STATUS_MOUNT | StarbookTen::STATUS_TRACKING | StarbookTen::STATUS_PIERSIDE;
+        if (isPropGuidingRA || isPropGuidingDE)
+            fields |= StarbookTen::STATUS_GUIDING;
+        retry<bool>(2, &StarbookTen::refresh, starbook, fields);
+
+        auto stat = starbook->getStatus();
+        bool isTracking = starbook->isTracking();
 
         updateStarbookState(stat);
 
@@ -364,11 +370,11 @@ INDIStarbookTen::ReadScopeStatus() {
 
         NewRaDec(stat.ra, stat.dec);
 
-        auto ps = retry<StarbookTen::PierSide>(2, &StarbookTen::getPierSide, starbook);
+        auto ps = starbook->getPierSide();
         setPierSide((ps == StarbookTen::PIERSIDE_EAST) ? INDI::Telescope::PIER_EAST : INDI::Telescope::PIER_WEST);
 
         if (isPropGuidingRA || isPropGuidingDE) {
-            auto gs = retry<std::tuple<bool,bool> >(2, &StarbookTen::getGuidingRaDec, starbook);
+            auto gs = starbook->getGuidingRaDec();
             LOGF_DEBUG("Prop guiding status: RA=%d, DEC=%d", !!(std::get<0>(gs)), !!(std::get<1>(gs)));
             if (isPropGuidingRA && !std::get<0>(gs)) {
                 LOG_DEBUG("Prop guiding in RA finished");
@@ -1,8 +1,85 @@
-#include <regex>
 #include <cmath>
+#include <cstring>
 #include <stdio.h>
+#include <stdlib.h>
 #include "starbook_ten.h"
 
+namespace {
+
+/*
+ * The firmware replies with key=value pairs in an HTML comment, e.g.
+ * <!--RA=1.5&DEC=-2.0&GOTO=0&STATE=SCOPE-->. The scanners below read them in
+ * place, they return false on a missing key or a malformed value.
+ */
+const char *
+findValue(const std::string& body, const char *key) {
+    size_t len = strlen(key);
+
+    for (size_t pos = body.find(key); pos != std::string::npos; pos = body.find(key, pos + 1)) {
+        bool start = (pos == 0) || strchr("&-?> \t\r\n", body[pos - 1]) != nullptr;
+
+        if (start && body.compare(pos + len, 1, "=") == 0)
+            return body.c_str() + pos + len + 1;
+    }
+
+    return nullptr;
+}
+
+bool
+scanInt(const char *&p, long& value) {
+    char *end;
+    value = strtol(p, &end, 10);
+    if (end == p)
+        return false;
+    p = end;
+    return true;
+}
+
+bool
+scanDouble(const char *&p, double& value) {
+    char *end;
+    value = strtod(p, &end);
+    if (end == p)
+        return false;
+    p = end;
+    return true;
+}
+
+bool
+scanChar(const char *&p, char c) {
+    if (*p != c)
+        return false;
+    p++;
+    return true;
+}
+
+bool
+scanInt(const std::string& body, const char *key, long& value) {
+    const char *p = findValue(body, key);
+    return p && scanInt(p, value);
+}
+
+/* Sign and degrees+minutes, e.g. E139+44 */
+bool
+scanDms(const std::string& body, const char *key, char negative, ln_dms& dms) {
+    const char *p = findValue(body, key);
+    long deg, min;
+
+    if (!p || (*p != negative && *p != (negative == 'W' ? 'E' : 'N')))
+        return false;
+
+    dms.neg = (*p++ == negative) ? 1 : 0;
+    if (!scanInt(p, deg) || !scanChar(p, '+') || !scanInt(p, min))
+        return false;
+
+    dms.degrees = deg;
+    dms.minutes = min;
+    dms.seconds = 0;
+    return true;
+}
+
+}
+
 StarbookTen::StarbookTen(httplib::Client *http) : http(http) {
     setHttpClient(http);
 }
@@ -43,11 +120,141 @@ StarbookTen::setHttpClient(httplib::Client *http) {
 
     this->http = http;
     destroyClient = false;
+
+    invalidate();
+}
+
+
+void
+StarbookTen::invalidate(unsigned int fields) {
+    statusValid &= ~fields;
+}
+
+
+void
+StarbookTen::setMaxStatusAge(double seconds) {
+    maxStatusAge = seconds;
+}
+
+
+std::string
+StarbookTen::get(const char *path) {
+    auto res = http->Get(path);
+
+    if (!res || res->status != 200) {
+        throw std::runtime_error("HTTP get failed");
+    }
+
+    return std::move(res->body);
+}
+
+
+bool
+StarbookTen::refresh(unsigned int fields) {
+    static const char *paths[STATUS_FIELDS] = {
+        "/getstatus2", "/gettrackstatus", "/get_pierside", "/getguidestatus", "/getplace"
+    };
+
+    // Back to back on the kept alive connection, each reply is parsed as it comes in
+    for (int i = 0; i < STATUS_FIELDS; i++) {
+        if (!(fields & (1u << i)))
+            continue;
+
+        statusValid &= ~(1u << i);
+        parseStatus(i, get(paths[i]));
+        statusValid |= 1u << i;
+        statusTime[i] = Clock::now();
+    }
+
+    return true;
+}
+
+
+void
+StarbookTen::need(unsigned int fields) {
+    unsigned int stale = 0;
+    Clock::time_point now = Clock::now();
+
+    for (int i = 0; i < STATUS_FIELDS; i++) {
+        if ((fields & (1u << i)) &&
+            (!(statusValid & (1u << i)) ||
+             std::chrono::duration<double>(now - statusTime[i]).count() > maxStatusAge))
+            stale |= 1u << i;
+    }
+
+    if (stale)
+        refresh(stale);
+}
+
+
+void
+StarbookTen::parseStatus(int field, const std::string& body) {
+    long l[4];
+
+    switch (1 << field) {
+    case STATUS_MOUNT: {
+        const char *state = findValue(body, "STATE");
+        const char *ra = findValue(body, "RA"), *dec = findValue(body, "DEC");
+
+        if (!state || !ra || !dec || !scanDouble(ra, mountStatus.ra) || !scanDouble(dec, mountStatus.dec) ||
+            !scanInt(body, "GOTO", l[0])) {
+            throw std::runtime_error("Could not get status");
+        }
+
+        size_t len = strspn(state, "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        mountStatus.goto_busy = (l[0] != 0);
+        mountStatus.state =
+            (len == 4 && !strncmp(state, "USER", 4))  ? STATE_USER  :
+            (len == 5 && !strncmp(state, "CHART", 5)) ? STATE_CHART :
+            (len == 5 && !strncmp(state, "SCOPE", 5)) ? STATE_SCOPE : STATE_INIT;
+        break;
+    }
+
+    case STATUS_TRACKING:
+        // TRACK=2 seems to be used during gotos, but since we can already figure
+        // gotos out from the getstatus2 call, there's no need to handle it here.
+        if (!scanInt(body, "TRACK", l[0]) || l[0] < 0 || l[0] > 2) {
+            throw std::runtime_error("Could not get track status");
+        }
+        tracking = (l[0] == 1);
+        break;
+
+    case STATUS_PIERSIDE:
+        if (!scanInt(body, "PIERSIDE", l[0]) || (l[0] != 0 && l[0] != 1)) {
+            throw std::runtime_error("Could not get pier side");
+        }
+        pierSide = static_cast<PierSide>(l[0]);
+        break;
+
+    case STATUS_GUIDING:
+        if (!scanInt(body, "RA+", l[0]) || !scanInt(body, "RA-", l[1]) ||
+            !scanInt(body, "DEC+", l[2]) || !scanInt(body, "DEC-", l[3])) {
+            throw std::runtime_error("Could not get guide status");
+        }
+        guiding = std::tuple<bool,bool>(l[0] == 1 || l[1] == 1, l[2] == 1 || l[3] == 1);
+        break;
+
+    case STATUS_PLACE: {
+        ln_dms lon_dms, lat_dms;
+
+        if (!scanDms(body, "longitude", 'W', lon_dms) || !scanDms(body, "latitude", 'S', lat_dms) ||
+            !scanInt(body, "timezone", l[0])) {
+            throw std::runtime_error("Could not get lat/long");
+        }
+        place.lat = ln_dms_to_deg(&lat_dms);
+        place.lon = ln_dms_to_deg(&lon_dms);
+        place.gmtoff = l[0] * 3600;
+        break;
+    }
+    }
 }
 
 
 bool
 StarbookTen::sendBasicCmd(const char *cmd) {
+    // Commands change what the status endpoints report
+    invalidate();
+
     auto res = http->Get(cmd);
 
     if (!res || res->status != 200) {
@@ -64,19 +271,11 @@ StarbookTen::sendBasicCmd(const char *cmd) {
 
 std::tuple<int,int>
 StarbookTen::getFirmwareVersion() {
-    auto res = http->Get("/version");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    std::regex r(R"(<!--VERSION=([0-9]+)\.([0-9]+)-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        int vmaj = std::stoi(sm[1]);
-        int vmin = std::stoi(sm[2]);
+    std::string body = get("/version");
+    const char *p = findValue(body, "VERSION");
+    long vmaj, vmin;
 
+    if (p && scanInt(p, vmaj) && scanChar(p, '.') && scanInt(p, vmin)) {
         return std::tuple<int,int>(vmaj, vmin);
     } else {
         throw std::runtime_error("Could not get version");
@@ -86,20 +285,9 @@ StarbookTen::getFirmwareVersion() {
 
 StarbookTen::PierSide
 StarbookTen::getPierSide() {
-    auto res = http->Get("/get_pierside");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    std::regex r(R"(PIERSIDE=([01]))");
-    std::smatch sm;
+    need(STATUS_PIERSIDE);
 
-    if (std::regex_search(res->body, sm, r)) {
-        return static_cast<StarbookTen::PierSide>(std::stoi(sm[1]));
-    } else {
-        throw std::runtime_error("Could not get pier side");
-    }
+    return pierSide;
 }
 
 
@@ -107,17 +295,11 @@ StarbookTen::PierSide
 StarbookTen::getNewPierSide(double ra, double dec) {
     std::stringstream cmd_ss;
     cmd_ss << "/calc_sideofpier?ra=" << ra << "&dec=" << dec;
-    auto res = http->Get(cmd_ss.str().c_str());
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
+    std::string body = get(cmd_ss.str().c_str());
+    long ps;
 
-    std::regex r(R"(PIERSIDE=([01]))");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        return static_cast<StarbookTen::PierSide>(std::stoi(sm[1]));
+    if (scanInt(body, "PIERSIDE", ps) && (ps == 0 || ps == 1)) {
+        return static_cast<StarbookTen::PierSide>(ps);
     } else {
         throw std::runtime_error("Could not get new pier side");
     }
@@ -136,40 +318,25 @@ ln_zonedate
 StarbookTen::getDateTime() {
     ln_zonedate zdt;
 
-    auto res = http->Get("/gettime");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    std::regex r(R"(TIME=(\d{4})\+(\d{1,2})\+(\d{1,2})\+(\d{1,2})\+(\d{1,2})\+(\d{1,2}))");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        zdt.years = std::stoi(sm[1]);
-        zdt.months = std::stoi(sm[2]);
-        zdt.days = std::stoi(sm[3]);
-        zdt.hours = std::stoi(sm[4]);
-        zdt.minutes = std::stoi(sm[5]);
-        zdt.seconds = std::stoi(sm[6]);
-    } else {
-        throw std::runtime_error("Could not get time");
-    }
-
-    res = http->Get("/getplace");
+    std::string body = get("/gettime");
+    const char *p = findValue(body, "TIME");
+    long t[6];
 
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
+    for (int i = 0; i < 6; i++) {
+        if (!p || (i > 0 && !scanChar(p, '+')) || !scanInt(p, t[i])) {
+            throw std::runtime_error("Could not get time");
+        }
     }
 
-    std::regex rtz(R"(<!--.*timezone=([+-]?\d+)-->)");
-    std::smatch smtz;
+    zdt.years = t[0];
+    zdt.months = t[1];
+    zdt.days = t[2];
+    zdt.hours = t[3];
+    zdt.minutes = t[4];
+    zdt.seconds = t[5];
 
-    if (std::regex_search(res->body, smtz, rtz)) {
-        zdt.gmtoff = std::stoi(smtz[1])*3600;
-    } else {
-        throw std::runtime_error("Could not get timezone");
-    }
+    need(STATUS_PLACE);
+    zdt.gmtoff = place.gmtoff;
 
     return zdt;
 }
@@ -219,48 +386,19 @@ StarbookTen::setLatLonTz(double lat, double lon, long utc_off_secs) {
 
 std::tuple<double,double>
 StarbookTen::getLatLon() {
-    auto res = http->Get("/getplace");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
+    need(STATUS_PLACE);
 
-    std::regex r(R"(<!--longitude=([EW])(\d+)\+(\d+)&latitude=([NS])(\d+)\+(\d+)&.*-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        ln_dms lon_dms, lat_dms;
-
-        lon_dms.neg = (sm[1].compare("W") == 0) ? 1 : 0;
-        lon_dms.degrees = std::stoi(sm[2]);
-        lon_dms.minutes = std::stoi(sm[3]);
-        lon_dms.seconds = 0;
-
-        lat_dms.neg = (sm[4].compare("S") == 0) ? 1 : 0;
-        lat_dms.degrees = std::stoi(sm[5]);
-        lat_dms.minutes = std::stoi(sm[6]);
-        lat_dms.seconds = 0;
-
-        return std::tuple<double,double>(ln_dms_to_deg(&lat_dms), ln_dms_to_deg(&lon_dms));
-    } else {
-        throw std::runtime_error("Could not get lat/long");
-    }
+    return std::tuple<double,double>(place.lat, place.lon);
 }
 
 
 StarbookTen::CoordType
 StarbookTen::getCoordType() {
-    auto res = http->Get("/getradectype");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    std::regex r(R"((J2000|NOW))");
-    std::smatch sm;
+    std::string body = get("/getradectype");
+    size_t j2000 = body.find("J2000"), now = body.find("NOW");
 
-    if (std::regex_search(res->body, sm, r)) {
-        return (sm[1].compare("J2000") == 0) ? COORD_TYPE_J2000 : COORD_TYPE_NOW;
+    if (j2000 != std::string::npos || now != std::string::npos) {
+        return (j2000 < now) ? COORD_TYPE_J2000 : COORD_TYPE_NOW;
     } else {
         throw std::runtime_error("Could not get coordinate type");
     }
@@ -275,70 +413,25 @@ StarbookTen::setCoordType(CoordType ct) {
 
 StarbookTen::MountStatus
 StarbookTen::getStatus() {
-    auto res = http->Get("/getstatus2");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    std::regex r(R"(<!--RA=(\-?\d+\.\d+)&DEC=(\-?\d+\.\d+)&GOTO=([01])&STATE=([A-Z]+)-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        MountStatus stat;
+    need(STATUS_MOUNT);
 
-        stat.ra = std::stod(sm[1]);
-        stat.dec = std::stod(sm[2]);
-        stat.goto_busy = !(sm[3].compare("0") == 0);
-        stat.state =
-            (sm[4].compare("USER") == 0)  ? STATE_USER  :
-            (sm[4].compare("CHART") == 0) ? STATE_CHART :
-            (sm[4].compare("SCOPE") == 0) ? STATE_SCOPE : STATE_INIT;
-
-        return stat;
-    } else {
-        throw std::runtime_error("Could not get status");
-    }
+    return mountStatus;
 }
 
+
 bool
 StarbookTen::isTracking() {
-    auto res = http->Get("/gettrackstatus");
-
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    // TRACK=2 seems to be used during gotos, but since we can already figure
-    // gotos out from the getstatus2 call, there's no need to handle it here.
-    std::regex r(R"(<!--TRACK=([012])-->)");
-    std::smatch sm;
+    need(STATUS_TRACKING);
 
-    if (std::regex_search(res->body, sm, r)) {
-        return !(sm[1].compare("1"));
-    } else {
-        throw std::runtime_error("Could not get track status");
-    }
+    return tracking;
 }
 
 
 std::tuple<bool,bool>
 StarbookTen::getGuidingRaDec() {
-    auto res = http->Get("/getguidestatus");
+    need(STATUS_GUIDING);
 
-    if (!res || res->status != 200) {
-        throw std::runtime_error("HTTP get failed");
-    }
-
-    std::regex r(R"(<!--RA\+=([01])&RA\-=([01])&DEC\+=([01])&DEC\-=([01])-->)");
-    std::smatch sm;
-
-    if (std::regex_search(res->body, sm, r)) {
-        return std::tuple<bool,bool>((!(sm[1].compare("1")) || !(sm[2].compare("1"))),
-                                     (!(sm[3].compare("1")) || !(sm[4].compare("1"))));
-    } else {
-        throw std::runtime_error("Could not get guide status");
-    }
+    return guiding;
 }
 
 
@@ -1,12 +1,14 @@
 #ifndef _STARBOOK_TEN_H_
 #define _STARBOOK_TEN_H_
 
+#include <chrono>
 #include <string>
 #include <libnova/julian_day.h>
 #include <libnova/utility.h>
 #include "httplib.h"
 
 #define STARBOOK_TEN_DEFAULT_PULSE_RATE 288
+#define STARBOOK_TEN_STATUS_MAX_AGE     0.5 /* Seconds a cached status reply is used for */
 
 class StarbookTen {
 private:
@@ -52,6 +54,16 @@ public:
         State  state;
     };
 
+    /* Status endpoints, fetched together by refresh() */
+    enum StatusField {
+        STATUS_MOUNT    = 1 << 0, /* /getstatus2 */
+        STATUS_TRACKING = 1 << 1, /* /gettrackstatus */
+        STATUS_PIERSIDE = 1 << 2, /* /get_pierside */
+        STATUS_GUIDING  = 1 << 3, /* /getguidestatus */
+        STATUS_PLACE    = 1 << 4, /* /getplace */
+        STATUS_ALL      = (1 << 5) - 1
+    };
+
     static const double slewRates[];
 
     StarbookTen(httplib::Client *http);
@@ -62,6 +74,11 @@ public:
 
     void setHttpClient(httplib::Client *http);
 
+    /* Fetch the status fields in one cycle, the getters then read them from the cache */
+    bool refresh(unsigned int fields);
+    void invalidate(unsigned int fields = STATUS_ALL);
+    void setMaxStatusAge(double seconds);
+
     std::tuple<int,int> getFirmwareVersion();
 
     PierSide getPierSide();
@@ -100,6 +117,31 @@ public:
     bool goTo(double ra, double dec);
 
     bool move(Axis axis, double rate);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Place {
+        double lat;
+        double lon;
+        long   gmtoff;
+    };
+
+    static const int STATUS_FIELDS = 5;
+
+    std::string get(const char *path);
+    void parseStatus(int field, const std::string& body);
+    void need(unsigned int fields);
+
+    MountStatus mountStatus;
+    bool tracking;
+    PierSide pierSide;
+    std::tuple<bool,bool> guiding;
+    Place place;
+
+    unsigned int statusValid = 0;
+    Clock::time_point statusTime[STATUS_FIELDS];
+    double maxStatusAge = STARBOOK_TEN_STATUS_MAX_AGE;
 };
 
 #endif /* _STARBOOK_TEN_H_ */
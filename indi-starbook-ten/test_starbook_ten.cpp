@@ -0,0 +1,186 @@
+/*
+    Status engine tests against a local HTTP fake of the StarBook Ten firmware
+*/
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "starbook_ten.h"
+
+class FakeStarbook {
+public:
+    FakeStarbook() {
+        replies["/getstatus2"]     = "<html><!--RA=5.58&DEC=-5.39&GOTO=0&STATE=SCOPE--></html>";
+        replies["/gettrackstatus"] = "<html><!--TRACK=1--></html>";
+        replies["/get_pierside"]   = "<html><!--PIERSIDE=1--></html>";
+        replies["/getguidestatus"] = "<html><!--RA+=0&RA-=1&DEC+=0&DEC-=0--></html>";
+        replies["/getplace"]       = "<html><!--longitude=W71+30&latitude=S33+15&timezone=-4--></html>";
+        replies["/gettime"]        = "<html><!--TIME=2021+3+14+21+5+9--></html>";
+        replies["/version"]        = "<html><!--VERSION=2.7--></html>";
+        replies["/getradectype"]   = "<html><!--TYPE=J2000--></html>";
+        replies["/gotoradec"]      = "<html><!--OK--></html>";
+
+        server.Get(R"(/\w+)", [this](const httplib::Request& req, httplib::Response& res) {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests[req.path]++;
+            ports.insert(req.remote_port);
+
+            auto reply = replies.find(req.path);
+            if (reply == replies.end()) {
+                res.status = 404;
+            } else {
+                res.set_content(reply->second, "text/html");
+            }
+        });
+
+        port = server.bind_to_any_port("127.0.0.1");
+        thread = std::thread([this]() { server.listen_after_bind(); });
+        while (!server.is_running())
+            std::this_thread::yield();
+    }
+
+    ~FakeStarbook() {
+        server.stop();
+        thread.join();
+    }
+
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port);
+    }
+
+    int count(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests[path];
+    }
+
+    int total() {
+        std::lock_guard<std::mutex> lock(mutex);
+        int n = 0;
+        for (auto& r : requests)
+            n += r.second;
+        return n;
+    }
+
+    // Client ports seen, one per connection
+    size_t connections() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ports.size();
+    }
+
+    void reply(const std::string& path, const std::string& body) {
+        std::lock_guard<std::mutex> lock(mutex);
+        replies[path] = body;
+    }
+
+private:
+    httplib::Server server;
+    std::thread thread;
+    int port;
+
+    std::mutex mutex;
+    std::map<std::string, std::string> replies;
+    std::map<std::string, int> requests;
+    std::set<int> ports;
+};
+
+
+TEST(StarbookTen, StatusCycleFeedsGetters) {
+    FakeStarbook fake;
+    StarbookTen starbook(fake.url().c_str());
+
+    ASSERT_TRUE(starbook.refresh(StarbookTen::STATUS_ALL));
+    EXPECT_EQ(fake.total(), 5);
+
+    auto stat = starbook.getStatus();
+    EXPECT_DOUBLE_EQ(stat.ra, 5.58);
+    EXPECT_DOUBLE_EQ(stat.dec, -5.39);
+    EXPECT_FALSE(stat.goto_busy);
+    EXPECT_EQ(stat.state, StarbookTen::STATE_SCOPE);
+
+    EXPECT_TRUE(starbook.isTracking());
+    EXPECT_EQ(starbook.getPierSide(), StarbookTen::PIERSIDE_EAST);
+
+    auto gs = starbook.getGuidingRaDec();
+    EXPECT_TRUE(std::get<0>(gs));
+    EXPECT_FALSE(std::get<1>(gs));
+
+    auto loc = starbook.getLatLon();
+    EXPECT_DOUBLE_EQ(std::get<0>(loc), -33.25);
+    EXPECT_DOUBLE_EQ(std::get<1>(loc), -71.5);
+
+    // Everything above came from the cache, on a single connection
+    EXPECT_EQ(fake.total(), 5);
+    EXPECT_EQ(fake.connections(), 1u);
+}
+
+TEST(StarbookTen, PlaceIsSharedByTimeAndLocation) {
+    FakeStarbook fake;
+    StarbookTen starbook(fake.url().c_str());
+
+    ln_zonedate zdt = starbook.getDateTime();
+    EXPECT_EQ(zdt.years, 2021);
+    EXPECT_EQ(zdt.months, 3);
+    EXPECT_EQ(zdt.days, 14);
+    EXPECT_EQ(zdt.hours, 21);
+    EXPECT_EQ(zdt.minutes, 5);
+    EXPECT_EQ(zdt.seconds, 9);
+    EXPECT_EQ(zdt.gmtoff, -4 * 3600);
+
+    starbook.getLatLon();
+    EXPECT_EQ(fake.count("/getplace"), 1);
+
+    auto ver = starbook.getFirmwareVersion();
+    EXPECT_EQ(std::get<0>(ver), 2);
+    EXPECT_EQ(std::get<1>(ver), 7);
+    EXPECT_EQ(starbook.getCoordType(), StarbookTen::COORD_TYPE_J2000);
+}
+
+TEST(StarbookTen, CacheExpiresAndCommandsInvalidate) {
+    FakeStarbook fake;
+    StarbookTen starbook(fake.url().c_str());
+
+    starbook.getStatus();
+    starbook.getStatus();
+    EXPECT_EQ(fake.count("/getstatus2"), 1);
+
+    fake.reply("/getstatus2", "<html><!--RA=1.00&DEC=2.00&GOTO=1&STATE=SCOPE--></html>");
+    starbook.goTo(1.0, 2.0);
+    auto stat = starbook.getStatus();
+    EXPECT_EQ(fake.count("/getstatus2"), 2);
+    EXPECT_TRUE(stat.goto_busy);
+    EXPECT_DOUBLE_EQ(stat.ra, 1.0);
+
+    starbook.setMaxStatusAge(0);
+    starbook.getStatus();
+    EXPECT_EQ(fake.count("/getstatus2"), 3);
+}
+
+TEST(StarbookTen, MalformedReplyIsNotCached) {
+    FakeStarbook fake;
+    StarbookTen starbook(fake.url().c_str());
+
+    fake.reply("/gettrackstatus", "<html><!--TRACK=x--></html>");
+    EXPECT_THROW(starbook.refresh(StarbookTen::STATUS_MOUNT | StarbookTen::STATUS_TRACKING), std::runtime_error);
+    EXPECT_THROW(starbook.isTracking(), std::runtime_error);
+
+    fake.reply("/gettrackstatus", "<html><!--TRACK=0--></html>");
+    EXPECT_FALSE(starbook.isTracking());
+
+    // The mount status of the failed cycle is kept
+    starbook.getStatus();
+    EXPECT_EQ(fake.count("/getstatus2"), 1);
+
+    fake.reply("/getstatus2", "<html><!--RA=1.0&GOTO=0&STATE=USER--></html>");
+    starbook.invalidate();
+    EXPECT_THROW(starbook.getStatus(), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
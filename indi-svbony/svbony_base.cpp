@@ -26,6 +26,8 @@
 
 #include "config.h"
 
+#include <pixelkernels.h>
+
 #include <stream/streammanager.h>
 #include <indielapsedtimer.h>
 
@@ -141,8 +143,7 @@ void SVBONYBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
             if (Helpers::isRGB(mCurrentVideoFormat))
             {
                 int nChannels = Helpers::getNChannels(mCurrentVideoFormat);
-                for (uint32_t i = 0; i < totalBytes; i += nChannels)
-                    std::swap(targetFrame[i], targetFrame[i + 2]); // swap R and B channel.
+                PixelKernels::swapRB(targetFrame, totalBytes / nChannels, nChannels);
             }
 
             Streamer->newFrame(targetFrame, totalBytes);
@@ -296,37 +297,15 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
                 case SVB_SUCCESS:
                     if (Helpers::isRGB(type))
                     {
-                        uint8_t *dstR = image;
-                        uint8_t *dstG = image + subW * subH;
-                        uint8_t *dstB = image + subW * subH * 2;
-
-                        const uint8_t *src = buffer;
-
-                        /*
-                            To optimize execution speed, RGB32 and RGB24 are discriminated outside of while loop.
-                        */
-                        if (type == SVB_IMG_RGB32)
-                        {
-                            const uint8_t *end = buffer + subW * subH * 4;
-                            uint8_t *dstA = image + subW * subH * 3; // Alpha channel destination address
-                            while (src != end)
-                            {
-                                *dstB++ = *src++;
-                                *dstG++ = *src++;
-                                *dstR++ = *src++;
-                                *dstA++ = *src++;
-                            }
-                        }
-                        else
+                        // BGR24 or BGRA32 into R, G, B (and A) planes
+                        uint8_t *planes[4] =
                         {
-                            const uint8_t *end = buffer + subW * subH * 3;
-                            while (src != end)
-                            {
-                                *dstB++ = *src++;
-                                *dstG++ = *src++;
-                                *dstR++ = *src++;
-                            }
-                        }
+                            image + subW * subH * 2,
+                            image + subW * subH,
+                            image,
+                            image + subW * subH * 3
+                        };
+                        PixelKernels::deinterleave(buffer, planes, subW * subH, type == SVB_IMG_RGB32 ? 4 : 3);
                         free(buffer);
                     }
                     guard.unlock();
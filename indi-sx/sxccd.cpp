@@ -88,7 +88,6 @@ SXCCD::SXCCD(DEVICE device, const char *name)
     this->device          = device;
     handle                = nullptr;
     model                 = 0;
-    oddBuf                = nullptr;
     evenBuf               = nullptr;
     GuideStatus           = 0;
     TemperatureRequest    = 0;
@@ -327,16 +326,7 @@ void SXCCD::SetupParms()
         nbuf *= 2;
     //nbuf += 512;
     PrimaryCCD.setFrameBufferSize(nbuf);
-    if (isInterlaced)
-    {
-        if (evenBuf != nullptr)
-            delete evenBuf;
-        if (oddBuf != nullptr)
-            delete oddBuf;
-        evenBuf      = new char[nbuf / 2];
-        oddBuf       = new char[nbuf / 2];
-    }
-    else if (isICX453)
+    if (isICX453)
     {
         if (evenBuf != nullptr)
             delete evenBuf;
@@ -475,9 +465,9 @@ void SXCCD::ExposureTimerHit()
             int subH          = PrimaryCCD.getSubH();
             int binX          = PrimaryCCD.getBinX();
             int binY          = PrimaryCCD.getBinY();
-            int subWW         = subW * 2;
             bool isICX453     = sxIsICX453(model);
             uint8_t *buf      = PrimaryCCD.getFrameBuffer();
+            double rate       = 0;
             int size;
             if (isInterlaced && binY > 1)
                 size = subW * subH / 2 / binX / (binY / 2);
@@ -493,7 +483,7 @@ void SXCCD::ExposureTimerHit()
                     rc = sxLatchPixels(handle, CCD_EXP_FLAGS_FIELD_BOTH, 0, subX, subY / binY, subW, subH / 2, binX,
                                        binY / 2);
                     if (rc)
-                        rc = sxReadPixels(handle, buf, size * 2);
+                        rc = sxReadPixels(handle, buf, size * 2, &rate);
                 }
                 else
                 {
@@ -502,24 +492,17 @@ void SXCCD::ExposureTimerHit()
                     struct timeval tv;
                     gettimeofday(&tv, nullptr);
                     long startTime = tv.tv_sec * 1000000 + tv.tv_usec;
+                    // Each field is read straight into every other frame row, the even field into rows 1, 3, 5...
+                    int rowBytes = subW / binX * 2;
                     if (rc)
-                        rc = sxReadPixels(handle, evenBuf, size);
+                        rc = sxReadPixelRows(handle, buf + rowBytes, rowBytes, subH / 2, rowBytes * 2, &rate);
                     gettimeofday(&tv, nullptr);
                     wipeDelay = tv.tv_sec * 1000000 + tv.tv_usec - startTime;
                     if (rc)
                         rc = sxLatchPixels(handle, CCD_EXP_FLAGS_FIELD_ODD | CCD_EXP_FLAGS_SPARE2, 0, subX, subY / 2,
                                            subW, subH / 2, binX, 1);
                     if (rc)
-                        rc = sxReadPixels(handle, oddBuf, size);
-                    if (rc)
-                    {
-                        for (int i = 0, j = 0; i < subH; i += 2, j++)
-                        {
-                            memcpy(buf + i * subWW, oddBuf + (j * subWW), subWW);
-                            memcpy(buf + ((i + 1) * subWW), evenBuf + (j * subWW), subWW);
-                        }
-                        //            deinterlace((unsigned short *)buf, subW, subH);
-                    }
+                        rc = sxReadPixelRows(handle, buf, rowBytes, subH / 2, rowBytes * 2, &rate);
                 }
             }
             else if (isICX453)
@@ -529,7 +512,7 @@ void SXCCD::ExposureTimerHit()
                 {
                     if (binX == 1 && binY == 1)
                     {
-                        rc = sxReadPixels(handle, evenBuf, size * 2);
+                        rc = sxReadPixels(handle, evenBuf, size * 2, &rate);
                         if (rc)
                         {
                             uint16_t *buf16 = reinterpret_cast<uint16_t *>(buf);
@@ -563,7 +546,7 @@ void SXCCD::ExposureTimerHit()
                     }
                     else
                     {
-                        rc = sxReadPixels(handle, buf, size * 2);
+                        rc = sxReadPixels(handle, buf, size * 2, &rate);
                     }
                 }
             }
@@ -571,8 +554,10 @@ void SXCCD::ExposureTimerHit()
             {
                 rc = sxLatchPixels(handle, CCD_EXP_FLAGS_FIELD_BOTH, 0, subX, subY, subW, subH, binX, binY);
                 if (rc)
-                    rc = sxReadPixels(handle, buf, size * 2);
+                    rc = sxReadPixels(handle, buf, size * 2, &rate);
             }
+            if (rc)
+                LOGF_DEBUG("Readout rate %.1f MB/s", rate);
             DidLatch   = false;
             InExposure = false;
             PrimaryCCD.setExposureLeft(ExposureTimeLeft = 0);
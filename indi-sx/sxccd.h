@@ -47,7 +47,7 @@ class SXCCD : public INDI::CCD
         HANDLE handle;
         unsigned short model;
         char name[32];
-        char *evenBuf, *oddBuf;
+        char *evenBuf;
         long wipeDelay;
         ISwitch CoolerS[2];
         ISwitchVectorProperty CoolerSP;
@@ -39,11 +39,13 @@
 
 #include <indidevapi.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include <unistd.h>
 
 #include <config-usb.h>
@@ -117,12 +119,14 @@
 #define BULK_COMMAND_TIMEOUT 2000
 #define BULK_DATA_TIMEOUT    40000 //Older SXV-M25C takes 14s unbinned
 
+// Readout keeps ASYNC_TRANSFERS bulk transfers queued so the host controller never idles
+// between them. The size must be a multiple of the 512 byte high speed packet size.
 #ifdef __arm__
-#define CHUNK_SIZE (4 * 1024 * 1024)
-//#warning "ARM mode, 4MB CHUNK_SIZE"
+#define ASYNC_TRANSFERS     4
+#define ASYNC_TRANSFER_SIZE (128 * 1024)
 #else
-#define CHUNK_SIZE (16*1024*1024)
-//#warning "Intel mode, 16MB CHUNK_SIZE"
+#define ASYNC_TRANSFERS     8
+#define ASYNC_TRANSFER_SIZE (256 * 1024)
 #endif
 
 #if 1
@@ -734,25 +738,191 @@ int sxExposePixelsGated(HANDLE sxHandle, unsigned short flags, unsigned short ca
     return rc >= 0;
 }
 
-int sxReadPixels(HANDLE sxHandle, void *pixels, unsigned long count)
+/*
+ * State of an asynchronous readout. The camera sends the pixels as one bulk stream that is
+ * split into transfers of ASYNC_TRANSFER_SIZE bytes. When the rows are contiguous the
+ * transfers land directly in the destination, otherwise each transfer reads into its own
+ * staging buffer and the callback copies it to the destination rows.
+ */
+struct ReadState
 {
-    int transferred;
-    unsigned long read = 0;
-    int rc             = 0;
-    while (read < count && rc >= 0)
+    HANDLE handle;
+    unsigned char *pixels;      // first destination row
+    unsigned long rowBytes;
+    unsigned long stride;       // distance between destination rows
+    unsigned long count;        // bytes expected
+    unsigned long submitted;    // bytes requested so far
+    unsigned long received;     // bytes delivered so far
+    int pending;                // transfers in flight
+    int error;                  // first libusb error, 0 if none
+    bool direct;
+};
+
+static int transferError(enum libusb_transfer_status status)
+{
+    switch (status)
+    {
+        case LIBUSB_TRANSFER_TIMED_OUT:
+            return LIBUSB_ERROR_TIMEOUT;
+        case LIBUSB_TRANSFER_STALL:
+            return LIBUSB_ERROR_PIPE;
+        case LIBUSB_TRANSFER_NO_DEVICE:
+            return LIBUSB_ERROR_NO_DEVICE;
+        case LIBUSB_TRANSFER_OVERFLOW:
+            return LIBUSB_ERROR_OVERFLOW;
+        case LIBUSB_TRANSFER_CANCELLED:
+            return LIBUSB_ERROR_INTERRUPTED;
+        default:
+            return LIBUSB_ERROR_IO;
+    }
+}
+
+static void scatterRows(ReadState *state, const unsigned char *data, unsigned long length)
+{
+    unsigned long offset = state->received;
+    while (length > 0)
+    {
+        unsigned long row    = offset / state->rowBytes;
+        unsigned long column = offset % state->rowBytes;
+        unsigned long size   = std::min(length, state->rowBytes - column);
+        memcpy(state->pixels + row * state->stride + column, data, size);
+        data += size;
+        offset += size;
+        length -= size;
+    }
+}
+
+static void LIBUSB_CALL readPixelsCallback(struct libusb_transfer *transfer);
+
+static int submitRead(ReadState *state, struct libusb_transfer *transfer, unsigned char *staging)
+{
+    int length = std::min<unsigned long>(ASYNC_TRANSFER_SIZE, state->count - state->submitted);
+    unsigned char *buffer = state->direct ? state->pixels + state->submitted : staging;
+    libusb_fill_bulk_transfer(transfer, state->handle, BULK_IN, buffer, length, readPixelsCallback, state,
+                              BULK_DATA_TIMEOUT);
+    int rc = libusb_submit_transfer(transfer);
+    if (rc < 0)
+        return rc;
+    state->submitted += length;
+    state->pending++;
+    return 0;
+}
+
+static void LIBUSB_CALL readPixelsCallback(struct libusb_transfer *transfer)
+{
+    ReadState *state = static_cast<ReadState *>(transfer->user_data);
+    state->pending--;
+    if (state->error)
+        return;
+    if (transfer->status != LIBUSB_TRANSFER_COMPLETED)
+    {
+        state->error = transferError(transfer->status);
+        return;
+    }
+
+    // Transfers complete in the order they were queued, so the data belongs at the received
+    // offset. After a short transfer it is below the offset the transfer was queued for.
+    unsigned long length = transfer->actual_length;
+    if (state->direct)
+    {
+        if (transfer->buffer != state->pixels + state->received)
+            memmove(state->pixels + state->received, transfer->buffer, length);
+    }
+    else
+        scatterRows(state, transfer->buffer, length);
+    state->received += length;
+
+    if (state->submitted < state->count)
     {
-        int size = count - read;
-        if (size > CHUNK_SIZE)
-            size = CHUNK_SIZE;
-        rc = libusb_bulk_transfer(sxHandle, BULK_IN, (unsigned char *)pixels + read, size, &transferred,
-                                  BULK_DATA_TIMEOUT);
-        DEBUG(log(true, "sxReadPixels: libusb_control_transfer -> %s\n", rc < 0 ? libusb_error_name(rc) : "OK"));
-        if (transferred >= 0)
+        int rc = submitRead(state, transfer, transfer->buffer);
+        if (rc < 0)
+            state->error = rc;
+    }
+}
+
+int sxReadPixelRows(HANDLE sxHandle, void *pixels, unsigned long rowBytes, unsigned long rows, unsigned long stride,
+                    double *rate)
+{
+    ReadState state = {};
+    state.handle    = sxHandle;
+    state.pixels    = static_cast<unsigned char *>(pixels);
+    state.rowBytes  = rowBytes;
+    state.stride    = stride;
+    state.count     = rowBytes * rows;
+    state.direct    = (rows == 1 || stride == rowBytes);
+    if (state.count == 0)
+        return 1;
+
+    int transfers = std::min<unsigned long>(ASYNC_TRANSFERS, (state.count + ASYNC_TRANSFER_SIZE - 1) / ASYNC_TRANSFER_SIZE);
+    struct libusb_transfer *transfer[ASYNC_TRANSFERS] = {};
+    std::unique_ptr<unsigned char[]> staging;
+    if (!state.direct)
+        staging.reset(new unsigned char[transfers * ASYNC_TRANSFER_SIZE]);
+
+    for (int i = 0; i < transfers; i++)
+    {
+        transfer[i] = libusb_alloc_transfer(0);
+        if (transfer[i] == nullptr)
+            state.error = LIBUSB_ERROR_NO_MEM;
+    }
+
+    struct timeval start, end;
+    gettimeofday(&start, nullptr);
+
+    while (!state.error && (state.pending > 0 || state.received < state.count))
+    {
+        // Queue all transfers, initially and when short transfers left the stream incomplete
+        if (state.pending == 0)
         {
-            read += transferred;
+            state.submitted = state.received;
+            for (int i = 0; i < transfers && !state.error && state.submitted < state.count; i++)
+            {
+                int rc = submitRead(&state, transfer[i], state.direct ? nullptr : staging.get() + i * ASYNC_TRANSFER_SIZE);
+                if (rc < 0)
+                    state.error = rc;
+            }
         }
+
+        struct timeval timeout = { 1, 0 };
+        int rc = libusb_handle_events_timeout_completed(ctx, &timeout, nullptr);
+        if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED)
+            state.error = rc;
     }
-    return rc >= 0;
+
+    if (state.pending > 0)
+    {
+        for (int i = 0; i < transfers; i++)
+            libusb_cancel_transfer(transfer[i]);
+        while (state.pending > 0)
+        {
+            struct timeval timeout = { 1, 0 };
+            int rc = libusb_handle_events_timeout_completed(ctx, &timeout, nullptr);
+            if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED)
+                break;
+        }
+    }
+
+    gettimeofday(&end, nullptr);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+    double mbps    = seconds > 0 ? state.received / seconds / (1024 * 1024) : 0;
+    if (rate != nullptr)
+        *rate = mbps;
+
+    // Transfers still owned by libusb cannot be freed, leak them rather than crash
+    if (state.pending == 0)
+    {
+        for (int i = 0; i < transfers; i++)
+            libusb_free_transfer(transfer[i]);
+    }
+
+    DEBUG(log(true, "sxReadPixelRows: %lu of %lu bytes in %.3fs, %.1f MB/s -> %s\n", state.received, state.count, seconds,
+              mbps, state.error ? libusb_error_name(state.error) : "OK"));
+    return state.error == 0;
+}
+
+int sxReadPixels(HANDLE sxHandle, void *pixels, unsigned long count, double *rate)
+{
+    return sxReadPixelRows(sxHandle, pixels, count, 1, count, rate);
 }
 
 int sxSetSTAR2000(HANDLE sxHandle, char star2k)
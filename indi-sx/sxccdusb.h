@@ -159,7 +159,11 @@ int sxExposePixels(HANDLE sxHandle, unsigned short flags, unsigned short camInde
 int sxExposePixelsGated(HANDLE sxHandle, unsigned short flags, unsigned short camIndex, unsigned short xoffset,
                         unsigned short yoffset, unsigned short width, unsigned short height, unsigned short xbin,
                         unsigned short ybin, unsigned long msec);
-int sxReadPixels(HANDLE sxHandle, void *pixels, unsigned long count);
+/* Read count bytes of pixels. If rate is given it is set to the achieved MB/s. */
+int sxReadPixels(HANDLE sxHandle, void *pixels, unsigned long count, double *rate = nullptr);
+/* Read rows of rowBytes each, storing row i at pixels + i * stride, e.g. one field into every other frame row. */
+int sxReadPixelRows(HANDLE sxHandle, void *pixels, unsigned long rowBytes, unsigned long rows, unsigned long stride,
+                    double *rate = nullptr);
 int sxSetShutter(HANDLE sxHandle, unsigned short state);
 int sxSetTimer(HANDLE sxHandle, unsigned long msec);
 unsigned long sxGetTimer(HANDLE sxHandle);
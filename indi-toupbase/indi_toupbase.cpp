@@ -21,8 +21,11 @@
 
 #include "indi_toupbase.h"
 #include "config.h"
+#include <pixelkernels.h>
 #include <stream/streammanager.h>
+#include <sharedblob.h>
 #include <unistd.h>
+#include <sys/time.h>
 #include <deque>
 
 #define BITDEPTH_FLAG       (CP(FLAG_RAW10) | CP(FLAG_RAW12) | CP(FLAG_RAW14) | CP(FLAG_RAW16))
@@ -492,12 +495,7 @@ bool ToupBase::Disconnect()
 
     FP(Close(m_Handle));
 
-    if (m_rgbBuffer)
-    {
-        free(m_rgbBuffer);
-        m_rgbBuffer = nullptr;
-    }
-    m_rgbBufferSize = 0;
+    releaseFramePool();
 
     return true;
 }
@@ -1284,6 +1282,7 @@ bool ToupBase::StartStreaming()
         return false;
     }
     m_CurrentTriggerMode = TRIGGER_VIDEO;
+    m_TimestampSynced = false;
 
     return true;
 }
@@ -1841,13 +1840,63 @@ void ToupBase::eventCB(unsigned event, void* pCtx)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ///
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-uint8_t* ToupBase::getRgbBuffer()
+ToupBase::FrameSlot *ToupBase::acquireFrameSlot(uint32_t size)
+{
+    FrameSlot *slot = &m_FramePool[m_FramePoolNext];
+    m_FramePoolNext = (m_FramePoolNext + 1) % FRAME_POOL_SLOTS;
+
+    if (slot->data == nullptr || slot->size < size)
+    {
+        uint8_t *data = static_cast<uint8_t *>(IDSharedBlobRealloc(slot->data, size));
+        if (data == nullptr)
+        {
+            IDSharedBlobFree(slot->data);
+            data = static_cast<uint8_t *>(IDSharedBlobAlloc(size));
+        }
+        slot->data = data;
+        slot->size = data ? size : 0;
+        if (data == nullptr)
+            return nullptr;
+    }
+
+    return slot;
+}
+
+void ToupBase::releaseFramePool()
 {
-    if (m_rgbBuffer && (m_rgbBufferSize == PrimaryCCD.getXRes() * PrimaryCCD.getYRes() * 3))
-        return m_rgbBuffer;
-    m_rgbBufferSize = PrimaryCCD.getXRes() * PrimaryCCD.getYRes() * 3;
-    m_rgbBuffer = static_cast<uint8_t*>(realloc(m_rgbBuffer, m_rgbBufferSize));
-    return m_rgbBuffer;
+    for (auto &slot : m_FramePool)
+    {
+        if (slot.data)
+            IDSharedBlobFree(slot.data);
+        slot.data = nullptr;
+        slot.size = 0;
+    }
+    m_FramePoolNext = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// The camera clock is anchored to the host clock on the first streamed frame, later frames keep
+/// the exact spacing reported by the camera.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t ToupBase::serTimestamp(uint64_t cameraTimestamp)
+{
+    // Microseconds from January 1, 1 AD to the Unix epoch
+    static constexpr int64_t SER_UNIX_US_EPOCH = 62135596800000000LL;
+
+    // Not supported by the camera, let the streamer stamp the frame
+    if (cameraTimestamp == 0)
+        return 0;
+
+    if (m_TimestampSynced == false)
+    {
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        int64_t now = static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec + SER_UNIX_US_EPOCH;
+        m_TimestampOffset = now - static_cast<int64_t>(cameraTimestamp);
+        m_TimestampSynced = true;
+    }
+
+    return static_cast<uint64_t>(static_cast<int64_t>(cameraTimestamp) + m_TimestampOffset);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1870,11 +1919,22 @@ void ToupBase::eventCallBack(unsigned event)
         case CP(EVENT_IMAGE):
         {
             int captureBits = m_BitsPerPixel == 8 ? 8 : m_maxBitDepth;
+            const uint32_t frameSize = PrimaryCCD.getFrameBufferSize();
             if (Streamer->isStreaming() || Streamer->isRecording())
             {
-                HRESULT rc = FP(PullImageWithRowPitchV2(m_Handle, PrimaryCCD.getFrameBuffer(), captureBits * m_Channels, -1, nullptr));
+                XP(FrameInfoV2) info;
+                memset(&info, 0, sizeof(XP(FrameInfoV2)));
+
+                FrameSlot *slot = acquireFrameSlot(frameSize);
+                if (slot == nullptr)
+                {
+                    LOGF_ERROR("Failed to allocate %u bytes for the frame pool.", frameSize);
+                    break;
+                }
+
+                HRESULT rc = FP(PullImageWithRowPitchV2(m_Handle, slot->data, captureBits * m_Channels, -1, &info));
                 if (SUCCEEDED(rc))
-                    Streamer->newFrame(PrimaryCCD.getFrameBuffer(), PrimaryCCD.getFrameBufferSize());
+                    Streamer->newFrame(slot->data, frameSize, serTimestamp(info.timestamp));
             }
             else if (InExposure)
             {
@@ -1884,11 +1944,15 @@ void ToupBase::eventCallBack(unsigned event)
                 XP(FrameInfoV2) info;
                 memset(&info, 0, sizeof(XP(FrameInfoV2)));
 
-                uint8_t *buffer = PrimaryCCD.getFrameBuffer();
-                if (m_MonoCamera == false && (0 == m_CurrentVideoFormat))
-                    buffer = getRgbBuffer();
+                FrameSlot *slot = acquireFrameSlot(frameSize);
+                if (slot == nullptr)
+                {
+                    LOGF_ERROR("Failed to allocate %u bytes for the frame pool.", frameSize);
+                    PrimaryCCD.setExposureFailed();
+                    break;
+                }
 
-                HRESULT rc = FP(PullImageWithRowPitchV2(m_Handle, buffer, captureBits * m_Channels, -1, &info));
+                HRESULT rc = FP(PullImageWithRowPitchV2(m_Handle, slot->data, captureBits * m_Channels, -1, &info));
                 if (FAILED(rc))
                 {
                     LOGF_ERROR("Failed to pull image. %s", errorCodes(rc).c_str());
@@ -1896,25 +1960,26 @@ void ToupBase::eventCallBack(unsigned event)
                 }
                 else
                 {
+                    std::unique_lock<std::mutex> guard(ccdBufferLock);
                     if (m_MonoCamera == false && (0 == m_CurrentVideoFormat))
                     {
                         uint8_t *image  = PrimaryCCD.getFrameBuffer();
                         uint32_t width  = PrimaryCCD.getSubW() / PrimaryCCD.getBinX() * (PrimaryCCD.getBPP() / 8);
                         uint32_t height = PrimaryCCD.getSubH() / PrimaryCCD.getBinY() * (PrimaryCCD.getBPP() / 8);
 
-                        uint8_t *subR = image;
-                        uint8_t *subG = image + width * height;
-                        uint8_t *subB = image + width * height * 2;
-                        int size      = width * height * 3 - 3;
-
                         // RGB to three sepearate R-frame, G-frame, and B-frame for color FITS
-                        for (int i = 0; i <= size; i += 3)
-                        {
-                            *subR++ = buffer[i];
-                            *subG++ = buffer[i + 1];
-                            *subB++ = buffer[i + 2];
-                        }
+                        uint8_t *planes[3] = { image, image + width * height, image + width * height * 2 };
+                        PixelKernels::deinterleave(slot->data, planes, width * height, 3);
+                    }
+                    else
+                    {
+                        // Hand the pulled frame over by pointer, the previous frame buffer becomes a pool slot
+                        uint8_t *previous = PrimaryCCD.getFrameBuffer();
+                        PrimaryCCD.setFrameBuffer(slot->data);
+                        slot->data = previous;
+                        slot->size = frameSize;
                     }
+                    guard.unlock();
 
                     LOGF_DEBUG("Image received. Width: %d, Height: %d, flag: %d, timestamp: %ld", info.width, info.height, info.flag,
                                info.timestamp);
@@ -295,10 +295,27 @@ class ToupBase : public INDI::CCD
         uint8_t m_BitsPerPixel { 8 };
         uint8_t m_maxBitDepth { 8 };
         uint8_t m_Channels { 1 };
-        
-        uint8_t *getRgbBuffer();
-        uint8_t *m_rgbBuffer { nullptr };
-        int32_t m_rgbBufferSize { 0 };
+
+        /////////////////////////////////////////////////////////////////////////////
+        /// Frame Pool
+        /////////////////////////////////////////////////////////////////////////////
+        // The SDK callback pulls every frame into a pool slot, never into the frame buffer being encoded.
+        // Slots are shared blobs so a finished exposure can be swapped into PrimaryCCD by pointer.
+        struct FrameSlot
+        {
+            uint8_t *data { nullptr };
+            uint32_t size { 0 };
+        };
+        static constexpr int FRAME_POOL_SLOTS = 3;
+        FrameSlot m_FramePool[FRAME_POOL_SLOTS];
+        int m_FramePoolNext { 0 };
+        FrameSlot *acquireFrameSlot(uint32_t size);
+        void releaseFramePool();
+
+        // Convert FrameInfoV2.timestamp (camera clock, microseconds) to a SER timestamp
+        uint64_t serTimestamp(uint64_t cameraTimestamp);
+        int64_t m_TimestampOffset { 0 };
+        bool m_TimestampSynced { false };
 
         int m_ConfigResolutionIndex {-1};
 };
@@ -193,8 +193,8 @@ indi_webcam::indi_webcam()
     frameRate = 30;
     videoSize = "640x480";
     webcamStacking = false;
-    averaging = false;
     outputFormat = "8 bit RGB";
+    streamFormat = "Converted";
 
     protocol = "HTTP";
     IPAddress = "xxx.xxx.x.xxx";
@@ -520,15 +520,25 @@ bool indi_webcam::initProperties()
     CaptureFormat rgb = {"INDI_RGB", "RGB", 8, true};
     addCaptureFormat(rgb);
 
-    RapidStacking = new ISwitch[3];
+    RapidStacking = new ISwitch[5];
     IUFillSwitch(&RapidStacking[0], "Integration", "Integration", ISS_OFF);
     IUFillSwitch(&RapidStacking[1], "Average", "Average", ISS_OFF);
-    IUFillSwitch(&RapidStacking[2], "Off", "Off", ISS_ON);
+    IUFillSwitch(&RapidStacking[2], "Sigma Clip", "Sigma Clip", ISS_OFF);
+    IUFillSwitch(&RapidStacking[3], "Median", "Median", ISS_OFF);
+    IUFillSwitch(&RapidStacking[4], "Off", "Off", ISS_ON);
 
-    IUFillSwitchVector(&RapidStackingSelection, RapidStacking, 3, getDeviceName(), "RAPID_STACKING_OPTION", "Rapid Stacking",
+    IUFillSwitchVector(&RapidStackingSelection, RapidStacking, 5, getDeviceName(), "RAPID_STACKING_OPTION", "Rapid Stacking",
                        MAIN_CONTROL_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
     defineProperty(&RapidStackingSelection);
 
+    //Sigma Clip and Median combine groups of this many frames
+    IUFillNumber(&StackingOptionsT[0], "GROUP_SIZE", "Group Size", "%.0f", WebcamStacker::MIN_GROUP_SIZE,
+                 WebcamStacker::MAX_GROUP_SIZE, 1, 8);
+    IUFillNumber(&StackingOptionsT[1], "SIGMA", "Sigma", "%.1f", 1, 5, 0.1, 2.5);
+    IUFillNumberVector(&StackingOptionsTP, StackingOptionsT, NARRAY(StackingOptionsT), getDeviceName(), "RAPID_STACKING_SETTINGS",
+                     "Stacking", OPTIONS_TAB, IP_RW, 0, IPS_IDLE);
+    defineProperty(&StackingOptionsTP);
+
     OutputFormats = new ISwitch[3];
     IUFillSwitch(&OutputFormats[0], "16 bit Grayscale", "16 bit Grayscale", ISS_OFF);
     IUFillSwitch(&OutputFormats[1], "16 bit RGB", "16 bit RGB", ISS_OFF);
@@ -538,6 +548,17 @@ bool indi_webcam::initProperties()
                        MAIN_CONTROL_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
     defineProperty(&OutputFormatSelection);
 
+    //How frames are sent to the streamer. Converted uses the output format above,
+    //JPEG passes MJPEG packets through untouched, Luma sends the Y plane of the frame as 8 bit mono.
+    StreamFormats = new ISwitch[3];
+    IUFillSwitch(&StreamFormats[0], "Converted", "Converted", ISS_ON);
+    IUFillSwitch(&StreamFormats[1], "JPEG Passthrough", "JPEG Passthrough", ISS_OFF);
+    IUFillSwitch(&StreamFormats[2], "Native Luma", "Native Luma", ISS_OFF);
+
+    IUFillSwitchVector(&StreamFormatSelection, StreamFormats, 3, getDeviceName(), "STREAM_FORMAT_OPTION", "Stream Format",
+                       MAIN_CONTROL_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    defineProperty(&StreamFormatSelection);
+
     IUFillNumber(&TimeoutOptionsT[0], "FFMPEG_TIMEOUT", "FFMPEG", "%.0f", 0 , 100000000, 1, ffmpegTimeout);
     IUFillNumber(&TimeoutOptionsT[1], "BUFFER_TIMEOUT", "Buffer", "%.0f", 0 , 10000000, 1, bufferTimeout);
     IUFillNumberVector(&TimeoutOptionsTP, TimeoutOptionsT, NARRAY(TimeoutOptionsT), getDeviceName(), "TIMEOUT_OPTIONS",
@@ -667,7 +688,9 @@ bool indi_webcam::initProperties()
     SetCCDCapability(cap);
 
     loadConfig(true, RapidStackingSelection.name);
+    loadConfig(true, StackingOptionsTP.name);
     loadConfig(true, OutputFormatSelection.name);
+    loadConfig(true, StreamFormatSelection.name);
     loadConfig(true, PixelSizeTP.name);
     loadConfig(true, InputOptionsTP.name);
     loadConfig(true, TimeoutOptionsTP.name);
@@ -897,6 +920,16 @@ bool indi_webcam::ISNewNumber (const char *dev, const char *name, double values[
         return true;
     }
 
+    if (!strcmp(name, StackingOptionsTP.name) )
+    {
+        IUUpdateNumber(&StackingOptionsTP, values, names, n);
+        stacker.setGroupSize(IUFindNumber( &StackingOptionsTP, "GROUP_SIZE" )->value);
+        stacker.setSigma(IUFindNumber( &StackingOptionsTP, "SIGMA" )->value);
+        IDSetNumber (&StackingOptionsTP, nullptr);
+        StackingOptionsTP.s = IPS_OK;
+        return true;
+    }
+
     if (!strcmp(name, TimeoutOptionsTP.name) )
     {
         IUUpdateNumber(&TimeoutOptionsTP, values, names, n);
@@ -1039,21 +1072,17 @@ bool indi_webcam::ISNewSwitch (const char *dev, const char *name, ISState *state
         ISwitch *sp = IUFindOnSwitch(&RapidStackingSelection);
         if (sp)
         {
+            webcamStacking = true;
             if(!strcmp(sp->name, "Integration"))
-            {
-                webcamStacking = true;
-                averaging = false;
-            }
-            if(!strcmp(sp->name, "Average"))
-            {
-                webcamStacking = true;
-                averaging = true;
-            }
-            if(!strcmp(sp->name, "Off"))
-            {
+                stackingMode = WebcamStacker::STACK_INTEGRATE;
+            else if(!strcmp(sp->name, "Average"))
+                stackingMode = WebcamStacker::STACK_AVERAGE;
+            else if(!strcmp(sp->name, "Sigma Clip"))
+                stackingMode = WebcamStacker::STACK_SIGMA_CLIP;
+            else if(!strcmp(sp->name, "Median"))
+                stackingMode = WebcamStacker::STACK_MEDIAN;
+            else
                 webcamStacking = false;
-                averaging = false;
-            }
             RapidStackingSelection.s = IPS_OK;
             IDSetSwitch(&RapidStackingSelection, nullptr);
             return true;
@@ -1075,6 +1104,27 @@ bool indi_webcam::ISNewSwitch (const char *dev, const char *name, ISState *state
         return false;
     }
 
+    if (!strcmp(svp->name, StreamFormatSelection.name))
+    {
+        if (is_streaming)
+        {
+            LOG_WARN("Stop streaming before changing the stream format.");
+            StreamFormatSelection.s = IPS_ALERT;
+            IDSetSwitch(&StreamFormatSelection, nullptr);
+            return true;
+        }
+        IUUpdateSwitch(&StreamFormatSelection, states, names, n);
+        ISwitch *sp = IUFindOnSwitch(&StreamFormatSelection);
+        if (sp)
+        {
+            streamFormat = sp->name;
+            StreamFormatSelection.s = IPS_OK;
+            IDSetSwitch(&StreamFormatSelection, nullptr);
+            return true;
+        }
+        return false;
+    }
+
     if (!strcmp(svp->name, PixelSizeSelection.name))
     {
         IUUpdateSwitch(&PixelSizeSelection, states, names, n);
@@ -1233,13 +1283,8 @@ bool indi_webcam::StartExposure(float duration)
         return false;
     }
 
-    //This resets the stack buffer
-    if(webcamStacking)
-    {
-        if(stackBuffer)
-            free(stackBuffer);
-        stackBuffer = nullptr;
-    }
+    //This resets the stack, it is sized on the first frame
+    stacker.release();
 
     //This sets up the output format for the exposure
     if(outputFormat == "16 bit RGB")
@@ -1299,8 +1344,7 @@ bool indi_webcam::StartExposure(float duration)
 
 bool indi_webcam::AbortExposure()
 {
-    if(stackBuffer)
-        free(stackBuffer);
+    stacker.release();
     InExposure = false;
     return true;
 }
@@ -1390,95 +1434,26 @@ bool indi_webcam::grabImage()
 //This adds each image to the running stack
 bool indi_webcam::addToStack()
 {
-    if(!stackBuffer)
-    {
-        stackBuffer = (float *)malloc(numBytes * sizeof(float_t));
-        numberOfFramesInStack = 0;
-    }
-
-    int w = pCodecCtx->width  * ((PrimaryCCD.getNAxis() == 3) ? 3 : 1);
-    int h = pCodecCtx->height;
-
-    for (int i = 0; i < w * h; i++)
+    if(!stacker.isActive())
     {
-        int x = i % w;
-        int y = i / w;
-        if(x >= 0 && y >= 0 && x < w && y < h)
+        size_t samples = pCodecCtx->width * pCodecCtx->height * ((PrimaryCCD.getNAxis() == 3) ? 3 : 1);
+        if(!stacker.begin(stackingMode, samples, PrimaryCCD.getBPP()))
         {
-            if(numberOfFramesInStack == 0)
-                stackBuffer[i] = getImageDataFloatValue(x, y);
-            else
-                stackBuffer[i] += getImageDataFloatValue(x, y);
+            LOGF_ERROR("Unable to stack %d bit frames.", PrimaryCCD.getBPP());
+            return false;
         }
     }
-    numberOfFramesInStack++;
-    return true;
-}
 
-//This gets the pixel value at an x, y position in the image
-float indi_webcam::getImageDataFloatValue(int x, int y)
-{
-    int w = pCodecCtx->width  * ((PrimaryCCD.getNAxis() == 3) ? 3 : 1);
-    uint8_t *primaryBuffer = PrimaryCCD.getFrameBuffer();
-    if(PrimaryCCD.getBPP() == 8)
-        return (float) primaryBuffer[y * w + x];
-    else if(PrimaryCCD.getBPP() == 16)
-    {
-        uint16_t *newBuffer = reinterpret_cast<uint16_t *>(primaryBuffer);
-        return (float) newBuffer[y * w + x];
-    }
-    else
-        return 0;
-}
-//This sets the pixel value at an x, y position in the image
-void indi_webcam::setImageDataValueFromFloat(int x, int y, float value, bool roundAnswer)
-{
-    uint8_t *primaryBuffer = PrimaryCCD.getFrameBuffer();
-    int w = pCodecCtx->width * ((PrimaryCCD.getNAxis() == 3) ? 3 : 1);
-    if(!stackBuffer)
-        return;
-    if(PrimaryCCD.getBPP() == 8)
-    {
-        int max = std::numeric_limits<uint8_t>::max();
-        if (value > max)
-            value = max;
-        if(roundAnswer)
-            primaryBuffer[y * w + x] = round(value);
-        else
-            primaryBuffer[y * w + x] = value;
-    }
-    else if(PrimaryCCD.getBPP() == 16)
-    {
-        int max = std::numeric_limits<uint16_t>::max();
-        if (value > max)
-            value = max;
-        uint16_t *newBuffer = reinterpret_cast<uint16_t *>(primaryBuffer);
-        if(roundAnswer)
-            newBuffer[y * w + x] = round(value);
-        else
-            newBuffer[y * w + x] = value;
-    }
+    stacker.add(PrimaryCCD.getFrameBuffer());
+    return true;
 }
 
 //This will take the final image stack and copy it back to the primary buffer for final download.
 void indi_webcam::copyFinalStackToPrimaryFrameBuffer()
 {
-    int w = pCodecCtx->width  * ((PrimaryCCD.getNAxis() == 3) ? 3 : 1);
-    int h = pCodecCtx->height;
-    for (int i = 0; i < w * h; i++)
-    {
-        int x = i % w;
-        int y = i / w;
-        if(x >= 0 && y >= 0 && x < w && y < h)
-        {
-            if(averaging)
-                setImageDataValueFromFloat(x, y, round(stackBuffer[i] / numberOfFramesInStack), true);
-            else //Integrating
-                setImageDataValueFromFloat(x, y, round(stackBuffer[i]), true);
-        }
-    }
-
-    LOGF_INFO("Final Image is a stack of %u exposures.", numberOfFramesInStack);
+    if(stacker.finish(PrimaryCCD.getFrameBuffer()))
+        LOGF_INFO("Final Image is a stack of %u exposures.", stacker.frames());
+    stacker.release();
 }
 
 //This will crop the image to a subframe if desired.
@@ -1616,11 +1591,10 @@ void indi_webcam::run_capture()
     //This sets up the output format for the exposures
     if(outputFormat == "16 bit RGB")
     {
-        LOG_INFO("Note, RGB 16 bit not supported in video stream using 8 Bit RGB instead.");
-        out_pix_fmt = AV_PIX_FMT_RGB24;
-        PrimaryCCD.setBPP(8);
+        out_pix_fmt = AV_PIX_FMT_RGB48LE;
+        PrimaryCCD.setBPP(16);
         PrimaryCCD.setNAxis(3);
-        Streamer->setPixelFormat(INDI_RGB);
+        Streamer->setPixelFormat(INDI_RGB, 16);
     }
     else if(outputFormat == "8 bit RGB")
     {
@@ -1631,15 +1605,32 @@ void indi_webcam::run_capture()
     }
     else if(outputFormat == "16 bit Grayscale")
     {
-        LOG_INFO("Note, 16 bit Grayscale not supported in video stream using 8 Bit Grayscale instead.");
-        out_pix_fmt = AV_PIX_FMT_GRAY8;
-        PrimaryCCD.setBPP(8);
+        out_pix_fmt = AV_PIX_FMT_GRAY16LE;
+        PrimaryCCD.setBPP(16);
         PrimaryCCD.setNAxis(2);
-        Streamer->setPixelFormat(INDI_MONO);
+        Streamer->setPixelFormat(INDI_MONO, 16);
     }
     else
         return;
 
+    bool passJPEG = (streamFormat == "JPEG Passthrough");
+    bool passLuma = (streamFormat == "Native Luma");
+    if(passJPEG && pCodecCtx->codec_id != AV_CODEC_ID_MJPEG)
+    {
+        LOGF_WARN("JPEG passthrough needs an MJPEG source, this one sends %s. Converting frames instead.",
+                  avcodec_get_name(pCodecCtx->codec_id));
+        passJPEG = false;
+    }
+
+    if(passJPEG)
+        Streamer->setPixelFormat(INDI_JPG);
+    else if(passLuma)
+    {
+        PrimaryCCD.setBPP(8);
+        PrimaryCCD.setNAxis(2);
+        Streamer->setPixelFormat(INDI_MONO);
+    }
+
     if(!setupStreaming())
         return;
 
@@ -1662,21 +1653,114 @@ void indi_webcam::run_capture()
     }
     */
 
-    while (is_capturing && is_streaming)
+    if(passJPEG)
+        streamJPEGPackets();
+    else
     {
+        while (is_capturing && is_streaming)
+        {
+            bool ok = passLuma ? streamLumaFrame() : getStreamFrame();
+            if(ok && !passLuma)
+                Streamer->newFrame(pFrameOUT->data[0], numBytes);
+            else if(!ok)
+            {
+                is_capturing = false;
+                is_streaming = false;
+            }
+        }
+    }
 
-        if(getStreamFrame())
-            Streamer->newFrame(pFrameOUT->data[0], numBytes);
-        else
+    freeMemory();
+    lumaBuffer = std::vector<uint8_t>();
+
+    DEBUG(INDI::Logger::DBG_SESSION, "Capture thread releasing device.");
+}
+
+//MJPEG packets from the camera already are JPEG images, so they go to the streamer without decoding
+void indi_webcam::streamJPEGPackets()
+{
+    AVPacket packet;
+    while (is_capturing && is_streaming)
+    {
+        if(!readVideoPacket(&packet))
         {
             is_capturing = false;
             is_streaming = false;
+            break;
         }
+        Streamer->newFrame(packet.data, packet.size);
+        av_packet_unref(&packet);
     }
+}
 
-    freeMemory();
+//Decodes a frame and sends its luminance as 8 bit mono, no swscale conversion.
+//Planar YUV and gray frames already hold the luma in their first plane, packed YUYV/UYVY is picked apart.
+bool indi_webcam::streamLumaFrame()
+{
+    AVPacket packet;
+    if(!readVideoPacket(&packet))
+        return false;
 
-    DEBUG(INDI::Logger::DBG_SESSION, "Capture thread releasing device.");
+    int ret = avcodec_send_packet(pCodecCtx, &packet);
+    av_packet_unref(&packet);
+    if(ret < 0)
+        return false;
+
+    ret = avcodec_receive_frame(pCodecCtx, pFrame);
+    if(ret == AVERROR(EAGAIN))
+        return true;
+    if(ret < 0)
+        return false;
+
+    int w = pFrame->width;
+    int h = pFrame->height;
+    const uint8_t *src = pFrame->data[0];
+    int step = 1;
+    switch(pFrame->format)
+    {
+        case AV_PIX_FMT_YUYV422:
+            step = 2;
+            break;
+        case AV_PIX_FMT_UYVY422:
+            step = 2;
+            src += 1;
+            break;
+        case AV_PIX_FMT_GRAY8:
+        case AV_PIX_FMT_NV12:
+        case AV_PIX_FMT_NV21:
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P:
+        case AV_PIX_FMT_YUV422P:
+        case AV_PIX_FMT_YUVJ422P:
+        case AV_PIX_FMT_YUV444P:
+        case AV_PIX_FMT_YUVJ444P:
+            break;
+        default:
+            LOGF_ERROR("Native luma is not available for %s frames, select the converted stream format.",
+                       av_get_pix_fmt_name(static_cast<AVPixelFormat>(pFrame->format)));
+            return false;
+    }
+
+    //Tightly packed luma plane goes straight to the streamer
+    if(step == 1 && pFrame->linesize[0] == w)
+    {
+        Streamer->newFrame(src, w * h);
+        return true;
+    }
+
+    lumaBuffer.resize(w * h);
+    uint8_t *dst = lumaBuffer.data();
+    for(int y = 0; y < h; y++, dst += w)
+    {
+        const uint8_t *row = src + y * pFrame->linesize[0];
+        if(step == 1)
+            memcpy(dst, row, w);
+        else
+            for(int x = 0; x < w; x++)
+                dst[x] = row[x * 2];
+    }
+    Streamer->newFrame(lumaBuffer.data(), w * h);
+    return true;
 }
 
 //This converts an image from INDI_RGB to FITS_RGB so the FITSViewer can read it.
@@ -1740,11 +1824,7 @@ bool indi_webcam::setupStreaming()
                           pCodecCtx->width, pCodecCtx->height, 1);
 
     // initialize SWS context for software scaling
-    sws_ctx = sws_getContext( pCodecCtx->width, pCodecCtx->height,
-                              pCodecCtx->pix_fmt, pCodecCtx->width, pCodecCtx->height,
-                              out_pix_fmt, SWS_BILINEAR, nullptr, nullptr, nullptr
-                            );
-    if(sws_ctx == nullptr)
+    if(!createScaleContext())
         return false;
 
     updateVideoAdjustments();
@@ -1769,17 +1849,45 @@ void indi_webcam::updateVideoAdjustments()
 
 //This gets one image from the camera.
 //It is used for both the streaming and exposing algorithms
-bool indi_webcam::getStreamFrame()
+//This creates the pixel format conversion context, sliced over several threads where libswscale supports it
+bool indi_webcam::createScaleContext()
 {
-    AVPacket packet;
-    //If at first you don't succees to get a frame, try again.
-    int ret = -1;
-    while(ret < 0)
+    sws_ctx = sws_alloc_context();
+    if(sws_ctx == nullptr)
+        return false;
+
+    av_opt_set_int(sws_ctx, "srcw", pCodecCtx->width, 0);
+    av_opt_set_int(sws_ctx, "srch", pCodecCtx->height, 0);
+    av_opt_set_int(sws_ctx, "src_format", pCodecCtx->pix_fmt, 0);
+    av_opt_set_int(sws_ctx, "dstw", pCodecCtx->width, 0);
+    av_opt_set_int(sws_ctx, "dsth", pCodecCtx->height, 0);
+    av_opt_set_int(sws_ctx, "dst_format", out_pix_fmt, 0);
+    av_opt_set_int(sws_ctx, "sws_flags", SWS_BILINEAR, 0);
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT(6, 1, 100)
+    // 0 lets libswscale use one slice thread per core
+    av_opt_set_int(sws_ctx, "threads", 0, 0);
+#endif
+
+    if(sws_init_context(sws_ctx, nullptr, nullptr) < 0)
+    {
+        sws_freeContext(sws_ctx);
+        sws_ctx = nullptr;
+        return false;
+    }
+    return true;
+}
+
+//This reads the next packet of the video stream, retrying and reconnecting the source if needed.
+bool indi_webcam::readVideoPacket(AVPacket *packet)
+{
+    while(true)
     {
+        //If at first you don't succees to get a frame, try again.
+        int ret = -1;
         int tries = 0;
         while(tries < 10) //Try a maximum of 10 times before trying to reconnect the source
         {
-            ret = av_read_frame(pFormatCtx, &packet);
+            ret = av_read_frame(pFormatCtx, packet);
             if(ret == 0)
                 break;
             else
@@ -1810,44 +1918,55 @@ bool indi_webcam::getStreamFrame()
             else
             {
                 DEBUG(INDI::Logger::DBG_SESSION, "Device did not reconnect after 10 tries.");
-                av_packet_unref(&packet);
                 return false;
             }
+            continue;
         }
+
+        if(packet->stream_index == videoStream)
+            return true;
+
+        //Audio or other streams of the source are skipped
+        av_packet_unref(packet);
     }
-    if(packet.stream_index == videoStream)
+}
+
+bool indi_webcam::getStreamFrame()
+{
+    AVPacket packet;
+    if(!readVideoPacket(&packet))
+        return false;
+
+    int ret;
+    ret = avcodec_send_packet(pCodecCtx, &packet);
+    char errbuff[200];
+    av_make_error_string(errbuff, 200, ret);
+    if (ret < 0)
     {
-        int ret;
-        ret = avcodec_send_packet(pCodecCtx, &packet);
-        char errbuff[200];
-        av_make_error_string(errbuff, 200, ret);
-        if (ret < 0)
+        DEBUGF(INDI::Logger::DBG_SESSION, "Error sending a packet for decoding:%s", errbuff);
+        av_packet_unref(&packet);
+        return false;
+    }
+    while (ret >= 0)
+    {
+        ret = avcodec_receive_frame(pCodecCtx, pFrame);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+            continue;
+        else if (ret < 0)
         {
-            DEBUGF(INDI::Logger::DBG_SESSION, "Error sending a packet for decoding:%s", errbuff);
+            DEBUG(INDI::Logger::DBG_SESSION, "Error during decoding");
             av_packet_unref(&packet);
             return false;
         }
-        while (ret >= 0)
-        {
-            ret = avcodec_receive_frame(pCodecCtx, pFrame);
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
-                continue;
-            else if (ret < 0)
-            {
-                DEBUG(INDI::Logger::DBG_SESSION, "Error during decoding");
-                av_packet_unref(&packet);
-                return false;
-            }
-            // We have a frame at that point
-            // Convert the image from its native format to our output format
-            sws_scale(sws_ctx, (uint8_t const * const *)pFrame->data,
-                      pFrame->linesize, 0, pCodecCtx->height,
-                      pFrameOUT->data, pFrameOUT->linesize);
-            av_packet_unref(&packet);
-            return true;
-        }
-
+        // We have a frame at that point
+        // Convert the image from its native format to our output format
+        sws_scale(sws_ctx, (uint8_t const * const *)pFrame->data,
+                  pFrame->linesize, 0, pCodecCtx->height,
+                  pFrameOUT->data, pFrameOUT->linesize);
+        av_packet_unref(&packet);
+        return true;
     }
+    av_packet_unref(&packet);
     return false;
 }
 
@@ -1911,7 +2030,9 @@ bool indi_webcam::saveConfigItems(FILE *fp)
     INDI::CCD::saveConfigItems(fp);
     IUSaveConfigSwitch(fp, &CaptureDeviceSelection);
     IUSaveConfigSwitch(fp, &RapidStackingSelection);
+    IUSaveConfigNumber(fp, &StackingOptionsTP);
     IUSaveConfigSwitch(fp, &OutputFormatSelection);
+    IUSaveConfigSwitch(fp, &StreamFormatSelection);
     IUSaveConfigSwitch(fp, &OnlineProtocolSelection);
     IUSaveConfigNumber(fp, &PixelSizeTP);
     IUSaveConfigText(fp, &InputOptionsTP);
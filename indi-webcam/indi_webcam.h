@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <indiccd.h>
 #include <stream/streammanager.h>
+#include "webcam_stacker.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +36,7 @@ extern "C" {
 #include <libavdevice/avdevice.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/opt.h>
 #include <libswscale/swscale.h>
 #include <libavutil/version.h>
 
@@ -117,15 +119,10 @@ private:
     bool webcamStacking = false;
     bool gotAnImageAlready = false;
     bool loadingSettings = false;
-    bool averaging = false;
-    float *stackBuffer = nullptr;
-    int numberOfFramesInStack = 0;
+    WebcamStacker::Mode stackingMode = WebcamStacker::STACK_AVERAGE;
+    WebcamStacker stacker;
     bool addToStack();
     void copyFinalStackToPrimaryFrameBuffer();
-    void setImageDataValueFromFloat(int x, int y, float value, bool roundAnswer);
-    void setRGBImageDataValueFromFloat(int x, int y, int channel, float value, bool roundAnswer);
-    float getImageDataFloatValue(int x, int y);
-    float getRGBImageDataFloatValue(int x, int y, int channel);
 
     //These are our device capture settings
     bool use16Bit = true;
@@ -135,6 +132,7 @@ private:
     std::string videoSize = "";
     std::string inputPixelFormat = "";
     std::string outputFormat = "";
+    std::string streamFormat = "";
     //These are our online device capture settings
     std::string protocol = "";
     std::string IPAddress = "";
@@ -176,6 +174,8 @@ private:
     ISwitchVectorProperty RapidStackingSelection;
     ISwitch *OutputFormats = nullptr;
     ISwitchVectorProperty OutputFormatSelection;
+    ISwitch *StreamFormats = nullptr;
+    ISwitchVectorProperty StreamFormatSelection;
     ISwitch *PixelSizes = nullptr;
     ISwitchVectorProperty PixelSizeSelection;
 
@@ -185,6 +185,8 @@ private:
     INumberVectorProperty PixelSizeTP;
     INumber VideoAdjustmentsT[3] {};
     INumberVectorProperty VideoAdjustmentsTP;
+    INumber StackingOptionsT[2] {};
+    INumberVectorProperty StackingOptionsTP;
 
 
     //Webcam setup, release, and frame capture
@@ -192,6 +194,13 @@ private:
     bool setupStreaming();
     void freeMemory();
     bool getStreamFrame();
+    bool readVideoPacket(AVPacket *packet);
+    bool createScaleContext();
+
+    //Streaming without conversion
+    void streamJPEGPackets();
+    bool streamLumaFrame();
+    std::vector<uint8_t> lumaBuffer;
 
     //Related to streaming
     std::thread capture_thread;
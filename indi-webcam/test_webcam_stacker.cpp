@@ -0,0 +1,137 @@
+/*
+INDI Webcam CCD Driver
+
+Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+This driver is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include "webcam_stacker.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+// Adds one frame per value, every sample of a frame set to that value, and returns the stacked frame
+template <typename T>
+static std::vector<T> stack(WebcamStacker &stacker, WebcamStacker::Mode mode, size_t samples,
+                            const std::vector<T> &values)
+{
+    std::vector<T> out(samples, 0);
+    EXPECT_TRUE(stacker.begin(mode, samples, sizeof(T) * 8));
+    for (T value : values)
+    {
+        std::vector<T> frame(samples, value);
+        stacker.add(reinterpret_cast<const uint8_t *>(frame.data()));
+    }
+    EXPECT_EQ(stacker.frames(), values.size());
+    EXPECT_TRUE(stacker.finish(reinterpret_cast<uint8_t *>(out.data())));
+    return out;
+}
+
+TEST(WebcamStacker, IntegrateSaturates)
+{
+    WebcamStacker stacker;
+    auto out = stack<uint8_t>(stacker, WebcamStacker::STACK_INTEGRATE, 16, { 100, 100, 100 });
+    EXPECT_EQ(out[0], 255);
+    EXPECT_EQ(out[15], 255);
+}
+
+TEST(WebcamStacker, AverageRounds)
+{
+    WebcamStacker stacker;
+    auto out = stack<uint16_t>(stacker, WebcamStacker::STACK_AVERAGE, 16, { 1000, 1001 });
+    EXPECT_EQ(out[0], 1001);
+}
+
+TEST(WebcamStacker, MedianRejectsOutlier)
+{
+    WebcamStacker stacker;
+    stacker.setGroupSize(3);
+    auto out = stack<uint8_t>(stacker, WebcamStacker::STACK_MEDIAN, 16, { 10, 200, 12 });
+    EXPECT_EQ(out[0], 12);
+}
+
+TEST(WebcamStacker, MedianEvenGroup)
+{
+    WebcamStacker stacker;
+    stacker.setGroupSize(4);
+    auto out = stack<uint16_t>(stacker, WebcamStacker::STACK_MEDIAN, 16, { 100, 65535, 0, 103 });
+    EXPECT_EQ(out[0], 102);
+}
+
+TEST(WebcamStacker, PartialGroupIsWeighted)
+{
+    // A full group of 3 reduces to 20 and counts 3 times, the partial group of 1 counts once
+    WebcamStacker stacker;
+    stacker.setGroupSize(3);
+    auto out = stack<uint8_t>(stacker, WebcamStacker::STACK_MEDIAN, 16, { 10, 20, 30, 50 });
+    EXPECT_EQ(out[0], 28);
+}
+
+TEST(WebcamStacker, SigmaClipRejectsOutlier)
+{
+    WebcamStacker stacker;
+    stacker.setGroupSize(5);
+    stacker.setSigma(1.5);
+    auto out = stack<uint16_t>(stacker, WebcamStacker::STACK_SIGMA_CLIP, 16, { 1000, 1002, 998, 1000, 60000 });
+    EXPECT_EQ(out[0], 1000);
+
+    // All values are within 2.5 sigma, the clipped mean is the plain mean
+    stacker.setSigma(2.5);
+    out = stack<uint16_t>(stacker, WebcamStacker::STACK_SIGMA_CLIP, 16, { 1000, 1002, 998, 1000, 60000 });
+    EXPECT_EQ(out[0], 12800);
+}
+
+TEST(WebcamStacker, SigmaClipSmallNoiseOnHighSignal)
+{
+    // Variance of about 41 on a mean of 60003, the 60020 sample is 2.6 sigma out
+    WebcamStacker stacker;
+    stacker.setGroupSize(8);
+    stacker.setSigma(2);
+    auto out = stack<uint16_t>(stacker, WebcamStacker::STACK_SIGMA_CLIP, 16,
+    { 60000, 60002, 60000, 60002, 60000, 60002, 60000, 60020 });
+    EXPECT_EQ(out[0], 60001);
+}
+
+TEST(WebcamStacker, SigmaClipFlatGroup)
+{
+    WebcamStacker stacker;
+    stacker.setGroupSize(3);
+    auto out = stack<uint8_t>(stacker, WebcamStacker::STACK_SIGMA_CLIP, 16, { 42, 42, 42 });
+    EXPECT_EQ(out[0], 42);
+}
+
+TEST(WebcamStacker, LargeFrameIsSplitAcrossThreads)
+{
+    const size_t samples = 1024 * 1024 + 3;
+    WebcamStacker stacker;
+    stacker.setGroupSize(3);
+    auto out = stack<uint16_t>(stacker, WebcamStacker::STACK_MEDIAN, samples, { 500, 9000, 510 });
+    EXPECT_EQ(out[0], 510);
+    EXPECT_EQ(out[samples / 2], 510);
+    EXPECT_EQ(out[samples - 1], 510);
+}
+
+TEST(WebcamStacker, RejectsBadDepth)
+{
+    WebcamStacker stacker;
+    EXPECT_FALSE(stacker.begin(WebcamStacker::STACK_AVERAGE, 16, 12));
+    EXPECT_FALSE(stacker.begin(WebcamStacker::STACK_AVERAGE, 0, 8));
+
+    std::vector<uint8_t> out(16);
+    EXPECT_FALSE(stacker.finish(out.data()));
+}
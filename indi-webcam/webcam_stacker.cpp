@@ -0,0 +1,259 @@
+/*
+INDI Webcam CCD Driver
+
+Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+This driver is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include "webcam_stacker.h"
+
+#include <pixelkernels.h>
+#include <workerpool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// Blocks are a multiple of this many samples so the vector loops have no tails in between
+static const size_t BLOCK_ALIGN = 64;
+
+WebcamStacker::WebcamStacker()
+{
+    // Started once and reused for every frame
+    mPool = &PixelKernels::WorkerPool::shared();
+}
+
+bool WebcamStacker::begin(Mode mode, size_t samples, int bpp)
+{
+    if (samples == 0 || (bpp != 8 && bpp != 16))
+        return false;
+
+    mMode = mode;
+    mBytes = bpp / 8;
+    mFrames = 0;
+    mGroupFrames = 0;
+    mGroupSize = mRequestedGroupSize;
+
+    // The accumulators for the other depth are dropped, the ones in use are only zeroed
+    if (mBytes == 1)
+    {
+        mAcc64 = std::vector<uint64_t>();
+        mAcc32.assign(samples, 0);
+    }
+    else
+    {
+        mAcc32 = std::vector<uint32_t>();
+        mAcc64.assign(samples, 0);
+    }
+
+    if (isGrouped())
+    {
+        mGroup.resize(samples * mBytes * mGroupSize);
+        mReduced.resize(samples * mBytes);
+    }
+    else
+    {
+        mGroup = std::vector<uint8_t>();
+        mReduced = std::vector<uint8_t>();
+    }
+
+    mSamples = samples;
+    return true;
+}
+
+void WebcamStacker::release()
+{
+    mAcc32 = std::vector<uint32_t>();
+    mAcc64 = std::vector<uint64_t>();
+    mGroup = std::vector<uint8_t>();
+    mReduced = std::vector<uint8_t>();
+    mSamples = 0;
+    mFrames = 0;
+    mGroupFrames = 0;
+}
+
+void WebcamStacker::setGroupSize(int frames)
+{
+    // Takes effect on the next begin()
+    mRequestedGroupSize = std::max(MIN_GROUP_SIZE, std::min(frames, MAX_GROUP_SIZE));
+}
+
+void WebcamStacker::parallelFor(const std::function<void(size_t, size_t)> &fn) const
+{
+    mPool->parallelFor(mSamples, mBytes, BLOCK_ALIGN, fn);
+}
+
+template <typename T, typename A>
+static void accumulateWeighted(const T *src, A *acc, size_t samples, uint32_t weight)
+{
+    for (size_t i = 0; i < samples; i++)
+        acc[i] += static_cast<A>(src[i]) * weight;
+}
+
+void WebcamStacker::accumulate(const uint8_t *frame, uint32_t weight)
+{
+    parallelFor([&](size_t from, size_t to)
+    {
+        if (mBytes == 1)
+        {
+            if (weight == 1)
+                PixelKernels::accumulate(frame + from, mAcc32.data() + from, to - from);
+            else
+                accumulateWeighted(frame + from, mAcc32.data() + from, to - from, weight);
+        }
+        else
+        {
+            const uint16_t *samples = reinterpret_cast<const uint16_t *>(frame);
+            if (weight == 1)
+                PixelKernels::accumulate(samples + from, mAcc64.data() + from, to - from);
+            else
+                accumulateWeighted(samples + from, mAcc64.data() + from, to - from, weight);
+        }
+    });
+}
+
+void WebcamStacker::add(const uint8_t *frame)
+{
+    if (!isActive())
+        return;
+
+    if (isGrouped())
+    {
+        memcpy(mGroup.data() + mGroupFrames * mSamples * mBytes, frame, mSamples * mBytes);
+        if (++mGroupFrames == mGroupSize)
+            reduceGroup();
+    }
+    else
+        accumulate(frame, 1);
+
+    mFrames++;
+}
+
+template <typename T>
+void WebcamStacker::reduceBlock(size_t from, size_t to)
+{
+    const T *group = reinterpret_cast<const T *>(mGroup.data());
+    T *reduced = reinterpret_cast<T *>(mReduced.data());
+    const int n = mGroupFrames;
+    const double sigma2 = mSigma * mSigma;
+    T values[MAX_GROUP_SIZE];
+
+    for (size_t i = from; i < to; i++)
+    {
+        for (int f = 0; f < n; f++)
+            values[f] = group[f * mSamples + i];
+
+        if (mMode == STACK_MEDIAN)
+        {
+            std::nth_element(values, values + n / 2, values + n);
+            T upper = values[n / 2];
+            if (n % 2)
+                reduced[i] = upper;
+            else
+            {
+                T lower = *std::max_element(values, values + n / 2);
+                reduced[i] = static_cast<T>((static_cast<uint32_t>(lower) + upper + 1) / 2);
+            }
+            continue;
+        }
+
+        // Sigma clipping: mean of the values within mSigma standard deviations of the group mean
+        uint64_t sum = 0, sumSquares = 0;
+        for (int f = 0; f < n; f++)
+        {
+            sum += values[f];
+            sumSquares += static_cast<uint64_t>(values[f]) * values[f];
+        }
+
+        // Work with n times the deviations, so mean and variance stay exact integers:
+        // (n * v - sum)^2 <= sigma^2 * (n * sumSquares - sum^2)
+        // The squares are below 2^53 for 16 bit samples, the comparison is exact in double.
+        const double spread = static_cast<double>(n * sumSquares - sum * sum);
+        const double limit = sigma2 * spread;
+
+        uint64_t kept = 0;
+        int count = 0;
+        for (int f = 0; f < n; f++)
+        {
+            double deviation = static_cast<double>(static_cast<int64_t>(n * values[f]) - static_cast<int64_t>(sum));
+            if (deviation * deviation <= limit)
+            {
+                kept += values[f];
+                count++;
+            }
+        }
+
+        reduced[i] = (count > 0) ? static_cast<T>((kept + count / 2) / count) : static_cast<T>((sum + n / 2) / n);
+    }
+}
+
+void WebcamStacker::reduceGroup()
+{
+    if (mGroupFrames == 0)
+        return;
+
+    parallelFor([this](size_t from, size_t to)
+    {
+        if (mBytes == 1)
+            reduceBlock<uint8_t>(from, to);
+        else
+            reduceBlock<uint16_t>(from, to);
+    });
+
+    // The reduced frame stands for all frames of its group
+    accumulate(mReduced.data(), mGroupFrames);
+    mGroupFrames = 0;
+}
+
+template <typename T, typename A>
+void WebcamStacker::finishBlock(const A *acc, T *out, size_t from, size_t to) const
+{
+    const A maxValue = std::numeric_limits<T>::max();
+
+    if (mMode == STACK_INTEGRATE)
+    {
+        for (size_t i = from; i < to; i++)
+            out[i] = static_cast<T>(std::min(acc[i], maxValue));
+        return;
+    }
+
+    // Rounded average, the division by a constant is turned into a multiplication
+    const double scale = 1.0 / mFrames;
+    for (size_t i = from; i < to; i++)
+        out[i] = static_cast<T>(std::min(static_cast<A>(acc[i] * scale + 0.5), maxValue));
+}
+
+bool WebcamStacker::finish(uint8_t *out)
+{
+    if (!isActive() || mFrames == 0)
+        return false;
+
+    // Partial last group
+    if (isGrouped())
+        reduceGroup();
+
+    parallelFor([&](size_t from, size_t to)
+    {
+        if (mBytes == 1)
+            finishBlock(mAcc32.data(), out, from, to);
+        else
+            finishBlock(mAcc64.data(), reinterpret_cast<uint16_t *>(out), from, to);
+    });
+
+    return true;
+}
@@ -0,0 +1,133 @@
+/*
+INDI Webcam CCD Driver
+
+Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+This driver is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace PixelKernels
+{
+class WorkerPool;
+}
+
+/**
+ * @brief The WebcamStacker class adds up webcam frames for rapid stacking.
+ *
+ * Frames are summed in the integer domain: 8 bit samples into 32 bit accumulators,
+ * 16 bit samples into 64 bit accumulators. Integration and averaging add every frame
+ * directly. Sigma clipping and median keep a group of frames and reduce each complete
+ * group to one frame before it is added, so outliers such as hot pixels, satellites or
+ * compression artifacts are rejected with bounded memory.
+ *
+ * Large frames are split into blocks of samples processed on the shared pixel kernels worker pool.
+ */
+class WebcamStacker
+{
+    public:
+        enum Mode
+        {
+            STACK_INTEGRATE,
+            STACK_AVERAGE,
+            STACK_SIGMA_CLIP,
+            STACK_MEDIAN
+        };
+
+        static constexpr int MIN_GROUP_SIZE = 3;
+        static constexpr int MAX_GROUP_SIZE = 25;
+
+    public:
+        WebcamStacker();
+
+        /**
+         * @brief Start a new stack, allocating the accumulators.
+         * @param mode how the frames are combined
+         * @param samples number of samples per frame, i.e. pixels times channels
+         * @param bpp 8 or 16 bits per sample
+         */
+        bool begin(Mode mode, size_t samples, int bpp);
+
+        /** Add a frame of samples with the bpp given to begin() */
+        void add(const uint8_t *frame);
+
+        /** Write the final image, same layout as the frames. Returns false if nothing was stacked. */
+        bool finish(uint8_t *out);
+
+        /** Free all the memory */
+        void release();
+
+        /** Frames added since begin() */
+        uint32_t frames() const
+        {
+            return mFrames;
+        }
+
+        bool isActive() const
+        {
+            return mSamples > 0;
+        }
+
+        /** Frames per group for sigma clipping and median, clamped to [MIN_GROUP_SIZE, MAX_GROUP_SIZE] */
+        void setGroupSize(int frames);
+
+        /** Rejection threshold in standard deviations for sigma clipping */
+        void setSigma(double sigma)
+        {
+            mSigma = sigma;
+        }
+
+    private:
+        bool isGrouped() const
+        {
+            return mMode == STACK_SIGMA_CLIP || mMode == STACK_MEDIAN;
+        }
+
+        /** Add frame to the accumulators, scaled by weight (frames a group stands for) */
+        void accumulate(const uint8_t *frame, uint32_t weight);
+
+        /** Reduce the frames of the current group into mReduced and accumulate it */
+        void reduceGroup();
+        template <typename T> void reduceBlock(size_t from, size_t to);
+
+        template <typename T, typename A> void finishBlock(const A *acc, T *out, size_t from, size_t to) const;
+
+        /** Call fn(from, to) over [0, mSamples) split across the worker pool */
+        void parallelFor(const std::function<void(size_t, size_t)> &fn) const;
+
+        Mode mMode { STACK_AVERAGE };
+        size_t mSamples { 0 };
+        int mBytes { 1 };
+        uint32_t mFrames { 0 };
+
+        PixelKernels::WorkerPool *mPool { nullptr };
+
+        std::vector<uint32_t> mAcc32;
+        std::vector<uint64_t> mAcc64;
+
+        int mGroupSize { 8 };
+        int mRequestedGroupSize { 8 };
+        int mGroupFrames { 0 };
+        double mSigma { 2.5 };
+        std::vector<uint8_t> mGroup;
+        std::vector<uint8_t> mReduced;
+};
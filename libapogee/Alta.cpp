@@ -478,6 +478,24 @@ Apg::Status Alta::GetImagingStatus()
 //////////////////////////// 
 // GET  IMAGE 
 void Alta::GetImage( std::vector<uint16_t> & out )
+{
+    uint16_t r=0, c = 0;
+    ExposureAndGetImgRC( r, c );
+    const int32_t dataLen = r*GetImageZ();
+    const int32_t numCols = GetRoiNumCols();
+
+    if( dataLen*numCols != apgHelper::SizeT2Int32( out.size() ) )
+    {
+        out.clear();
+        out.resize( dataLen*numCols );
+    }
+
+    GetImage( out.data(), numCols );
+}
+
+//////////////////////////// 
+// GET  IMAGE 
+void Alta::GetImage( uint16_t * out, const size_t pitch )
 {
 #ifdef DEBUGGING_CAMERA
     apgHelper::DebugMsg( "Alta::GetImage -> BEGINNING" );
@@ -526,10 +544,12 @@ void Alta::GetImage( std::vector<uint16_t> & out )
     const int32_t dataLen = r*z;
     const int32_t numCols = GetRoiNumCols();  
 
-    if( dataLen*numCols != apgHelper::SizeT2Int32( out.size() ) )
+    if( pitch < static_cast<size_t>( numCols ) )
     {
-        out.clear();
-        out.resize( dataLen*numCols );
+        std::stringstream msg;
+        msg << "Invalid image pitch " << pitch << " for " << numCols << " columns";
+        apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+            __LINE__, Apg::ErrorType_InvalidUsage );
     }
 
     try
@@ -545,7 +565,7 @@ void Alta::GetImage( std::vector<uint16_t> & out )
         ApgLogger::Instance().Write(ApgLogger::LEVEL_RELEASE,"error",
         apgHelper::mkMsg( m_fileName, msg, __LINE__) );
 
-        FixImgFromCamera( datafromCam, out, dataLen, numCols );
+        FixImgFromCamera( datafromCam, out, pitch, dataLen, numCols );
         throw;
     }
     
@@ -580,7 +600,7 @@ void Alta::GetImage( std::vector<uint16_t> & out )
 #endif
 
     // removing the AD garbage pixels at the beginning of every row
-    FixImgFromCamera( datafromCam, out, dataLen, numCols );
+    FixImgFromCamera( datafromCam, out, pitch, dataLen, numCols );
   
     ApgLogger::Instance().Write(ApgLogger::LEVEL_DEBUG,"info","Get Image Completed.");
 
@@ -955,11 +975,11 @@ Apg::FanMode Alta::GetFanMode()
 //////////////////////////// 
 //      FIX      IMG        FROM          CAMERA
 void Alta::FixImgFromCamera( const std::vector<uint16_t> & data,
-                              std::vector<uint16_t> & out,  const int32_t rows, 
+                              uint16_t * out, const size_t pitch,  const int32_t rows, 
                               const int32_t cols )
 {
     const int32_t offset = m_CcdAcqSettings->GetPixelShift();
-    ImgFix::SingleOuputCopy( data, out, rows, cols, offset );
+    ImgFix::SingleOuputCopy( data.data(), out, pitch, rows, cols, offset );
 }
 
 //////////////////////////// 
@@ -40,6 +40,7 @@ class DLL_EXPORT Alta : public ApogeeCam
         Apg::Status GetImagingStatus();
       
         void GetImage( std::vector<uint16_t> & out );
+        void GetImage( uint16_t * out, size_t pitch );
 
         void StopExposure( bool Digitize );
 
@@ -206,7 +207,7 @@ class DLL_EXPORT Alta : public ApogeeCam
             const std::string & DeviceAddr);
 
         void FixImgFromCamera( const std::vector<uint16_t> & data,
-            std::vector<uint16_t> & out,  int32_t rows, int32_t cols);
+            uint16_t * out, size_t pitch, int32_t rows, int32_t cols);
 
     private:
         
@@ -16,10 +16,13 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 #include "ICamIo.h" 
 #include "IAltaSerialPortIo.h" 
 
+class CLibCurlWrap;
+
 class AltaEthernetIo : public ICamIo, public IAltaSerialPortIo
 { 
     public: 
@@ -85,6 +88,9 @@ class AltaEthernetIo : public ICamIo, public IAltaSerialPortIo
         const std::string m_fileName;
         std::vector<uint16_t> m_StatusRegs;
 
+        // One handle for the whole session, its connection is reused
+        std::shared_ptr<CLibCurlWrap> m_libcurl;
+
         //disabling the copy ctor and assignment operator
         //generated by the compiler - don't want them
         //Effective C++ Item 6
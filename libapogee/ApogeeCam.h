@@ -1166,6 +1166,17 @@ class DLL_EXPORT ApogeeCam
          */
         virtual void GetImage( std::vector<uint16_t> & out ) = 0;
 
+        /*! 
+         * Downloads the image data from the camera straight into a caller 
+         * owned buffer, without an intermediate vector.  The buffer receives
+         * the same rows as GetImage( std::vector<uint16_t> & out ).
+         * \param [out] out Buffer that will recieve the image data
+         * \param [in] pitch Distance between the start of two rows in pixels,
+         * at least GetRoiNumCols()
+         * \exception std::runtime_error
+         */
+        virtual void GetImage( uint16_t * out, size_t pitch ) = 0;
+
         /*! 
          * This method halts an in progress exposure. If this method is called 
          * and there is no exposure in progress a std::runtime_error exception is thrown.
@@ -1284,7 +1295,7 @@ class DLL_EXPORT ApogeeCam
         virtual uint16_t GetImageZ() = 0;
         virtual uint16_t GetIlluminationMask() = 0;
         virtual void FixImgFromCamera( const std::vector<uint16_t> & data,
-            std::vector<uint16_t> & out,  int32_t rows, int32_t cols) = 0;
+            uint16_t * out, size_t pitch, int32_t rows, int32_t cols) = 0;
                 
 //this code removes vc++ compiler warning C4251
 //from http://www.unknownroad.com/rtfm/VisualStudio/warningC4251.html
@@ -316,6 +316,24 @@ Apg::Status CamGen2Base::GetImagingStatus()
 //////////////////////////// 
 // GET  IMAGE 
 void CamGen2Base::GetImage( std::vector<uint16_t> & out )
+{
+    uint16_t r=0, c = 0;
+    ExposureAndGetImgRC( r, c );
+    const int32_t dataLen = r*GetImageZ();
+    const int32_t numCols = GetRoiNumCols();
+
+    if( dataLen*numCols != apgHelper::SizeT2Int32( out.size() ) )
+    {
+        out.clear();
+        out.resize( dataLen*numCols );
+    }
+
+    GetImage( out.data(), numCols );
+}
+
+//////////////////////////// 
+// GET  IMAGE 
+void CamGen2Base::GetImage( uint16_t * out, const size_t pitch )
 {
 #ifdef DEBUGGING_CAMERA
     apgHelper::DebugMsg( "CamGen2Base::GetImage -> BEGIN" );
@@ -356,10 +374,12 @@ void CamGen2Base::GetImage( std::vector<uint16_t> & out )
     const int32_t dataLen = r*z;
     const int32_t numCols = GetRoiNumCols();
     
-    if( dataLen*numCols != apgHelper::SizeT2Int32( out.size() ) )
+    if( pitch < static_cast<size_t>( numCols ) )
     {
-        out.clear();
-        out.resize( dataLen*numCols );
+        std::stringstream msg;
+        msg << "Invalid image pitch " << pitch << " for " << numCols << " columns";
+        apgHelper::throwRuntimeException( m_fileName, msg.str(), 
+            __LINE__, Apg::ErrorType_InvalidUsage );
     }
 
     try
@@ -374,7 +394,7 @@ void CamGen2Base::GetImage( std::vector<uint16_t> & out )
         ApgLogger::Instance().Write(ApgLogger::LEVEL_RELEASE,"error",
         apgHelper::mkMsg( m_fileName, msg, __LINE__) );
 
-        FixImgFromCamera( datafromCam, out, dataLen, numCols );
+        FixImgFromCamera( datafromCam, out, pitch, dataLen, numCols );
         throw;
     }
         
@@ -401,7 +421,7 @@ void CamGen2Base::GetImage( std::vector<uint16_t> & out )
     }
     
     // at a minimum removing the AD garbage pixels at the beginning of every row
-    FixImgFromCamera( datafromCam, out, dataLen, numCols );
+    FixImgFromCamera( datafromCam, out, pitch, dataLen, numCols );
 
    ApgLogger::Instance().Write(ApgLogger::LEVEL_DEBUG,"info","Get Image Completed.");
 
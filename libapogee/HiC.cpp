@@ -108,7 +108,8 @@ void HiC::Get4kby4kImage( std::vector<uint16_t> & out )
         ApgLogger::Instance().Write(ApgLogger::LEVEL_RELEASE,"error",
         apgHelper::mkMsg( m_fileName, msg, __LINE__) );
 
-        FixImgFromCamera( datafromCam, out, dataLen, numCols );
+        out.resize( dataLen*numCols );
+        FixImgFromCamera( datafromCam, out.data(), numCols, dataLen, numCols );
         throw;
     }
         
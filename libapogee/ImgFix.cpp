@@ -11,41 +11,270 @@
 
 #include "ImgFix.h" 
 #include <algorithm>
+#include <system_error>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // below this many pixels per thread a frame is reassembled
+    // on the calling thread, spawning costs more than it saves
+    const size_t MIN_PIXELS_PER_THREAD = 512*1024;
+    const unsigned int MAX_THREADS = 8;
+
+    //////////////////////////// 
+    //      FOR      EACH      ROW      BLOCK
+    // calls block( begin, end ) over [0, count) items, in parallel
+    // when there is enough work
+    template<typename Block>
+    void ForEachRowBlock( const int32_t count, const size_t pixelsPerItem, Block block )
+    {
+        if( count <= 0 )
+        {
+            return;
+        }
+
+        const size_t pixels = static_cast<size_t>( count ) * pixelsPerItem;
+        unsigned int threads = std::max( 1u, std::thread::hardware_concurrency() );
+        threads = static_cast<unsigned int>( std::min<size_t>( 
+            std::min( threads, MAX_THREADS ), pixels / MIN_PIXELS_PER_THREAD ) );
+
+        if( threads < 2 )
+        {
+            block( 0, count );
+            return;
+        }
+
+        const int32_t step = ( count + threads - 1 ) / threads;
+        std::vector<std::thread> workers;
+        int32_t begin = step;
+
+        try
+        {
+            for( ; begin < count; begin += step )
+            {
+                workers.push_back( std::thread( block, begin, std::min( count, begin + step ) ) );
+            }
+        }
+        catch( std::system_error & )
+        {
+            // out of threads, what was not handed out runs here
+        }
+
+        block( 0, std::min( count, step ) );
+        for( ; begin < count; begin += step )
+        {
+            block( begin, std::min( count, begin + step ) );
+        }
+
+        for( std::vector<std::thread>::iterator iter = workers.begin(); iter != workers.end(); ++iter )
+        {
+            iter->join();
+        }
+    }
+
+#if defined(__SSE2__)
+    inline __m128i Reverse( const __m128i v )
+    {
+        const __m128i halves = _mm_shufflehi_epi16( 
+            _mm_shufflelo_epi16( v, _MM_SHUFFLE(0, 1, 2, 3) ), _MM_SHUFFLE(0, 1, 2, 3) );
+        return _mm_shuffle_epi32( halves, _MM_SHUFFLE(1, 0, 3, 2) );
+    }
+#endif
+
+    //////////////////////////// 
+    //      DUAL       ROW
+    // even samples fill the right half from the right edge,
+    // odd samples the left half from the left edge
+    void DualRow( const uint16_t * in, uint16_t * out, const int32_t cols )
+    {
+        const int32_t HALF_COLS = cols / 2;
+        //account for the odd no op col
+        const int32_t oddAdjust = ( cols % 2 ) ? 1 : 0;
+        uint16_t * right = out + cols - 1 - oddAdjust;
+
+        int32_t c = 0;
+#if defined(__SSE2__)
+        for( ; c + 8 <= HALF_COLS; c += 8 )
+        {
+            const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i *>( in + 2*c ) );
+            const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i *>( in + 2*c + 8 ) );
+            // sign extending keeps the 16 bit patterns through the saturating pack
+            const __m128i even = _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( a, 16 ), 16 ),
+                _mm_srai_epi32( _mm_slli_epi32( b, 16 ), 16 ) );
+            const __m128i odd = _mm_packs_epi32( _mm_srai_epi32( a, 16 ), _mm_srai_epi32( b, 16 ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( out + c ), odd );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( right - c - 7 ), Reverse( even ) );
+        }
+#endif
+        for( ; c < HALF_COLS; ++c )
+        {
+            right[-c] = in[2*c];
+            out[c] = in[2*c+1];
+        }
+
+        if( oddAdjust )
+        {
+            out[cols-1] = 0;
+        }
+    }
+
+    //////////////////////////// 
+    //      QUAD       ROWS
+    // each group of four samples is one pixel of every quadrant,
+    // upper left, upper right, lower right then lower left
+    void QuadRows( const uint16_t * in, uint16_t * top, uint16_t * bottom, const int32_t cols )
+    {
+        const int32_t HALF_COLS = cols / 2;
+        uint16_t * topRight = top + cols - 1;
+        uint16_t * bottomRight = bottom + cols - 1;
+
+        int32_t c = 0;
+#if defined(__SSE2__)
+        for( ; c + 8 <= HALF_COLS; c += 8 )
+        {
+            const __m128i * src = reinterpret_cast<const __m128i *>( in + 4*c );
+            const __m128i v0 = _mm_loadu_si128( src );
+            const __m128i v1 = _mm_loadu_si128( src + 1 );
+            const __m128i v2 = _mm_loadu_si128( src + 2 );
+            const __m128i v3 = _mm_loadu_si128( src + 3 );
+
+            // 4x8 transpose in two rounds of unpacking
+            const __m128i t0 = _mm_unpacklo_epi16( v0, v1 );
+            const __m128i t1 = _mm_unpackhi_epi16( v0, v1 );
+            const __m128i t2 = _mm_unpacklo_epi16( v2, v3 );
+            const __m128i t3 = _mm_unpackhi_epi16( v2, v3 );
+            const __m128i u0 = _mm_unpacklo_epi16( t0, t1 );
+            const __m128i u1 = _mm_unpackhi_epi16( t0, t1 );
+            const __m128i u2 = _mm_unpacklo_epi16( t2, t3 );
+            const __m128i u3 = _mm_unpackhi_epi16( t2, t3 );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( top + c ), _mm_unpacklo_epi64( u0, u2 ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( topRight - c - 7 ), 
+                Reverse( _mm_unpackhi_epi64( u0, u2 ) ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( bottomRight - c - 7 ), 
+                Reverse( _mm_unpacklo_epi64( u1, u3 ) ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i *>( bottom + c ), _mm_unpackhi_epi64( u1, u3 ) );
+        }
+#endif
+        for( ; c < HALF_COLS; ++c )
+        {
+            top[c] = in[4*c];
+            topRight[-c] = in[4*c+1];
+            bottomRight[-c] = in[4*c+2];
+            bottom[c] = in[4*c+3];
+        }
+
+        if( cols % 2 )
+        {
+            top[HALF_COLS] = 0;
+            bottom[HALF_COLS] = 0;
+        }
+    }
+}
 
 //////////////////////////// 
 //      SINGLE       OUPUT       ERASE
 void ImgFix::SingleOuputErase( std::vector<uint16_t> & data, const int32_t rows,  
         const int32_t numImgCols,  const int32_t numLatencyPixels )
 {
-        for(int32_t r = 0, i=numLatencyPixels; r < rows; i += numImgCols, ++r)
+    // same result as erasing numLatencyPixels after the first numLatencyPixels 
+    // of every row, compacted in a single pass instead of shifting the
+    // remainder of the buffer once per row
+    if( rows <= 0 || numLatencyPixels <= 0 )
+    {
+        return;
+    }
+
+    const size_t actNumCols = numImgCols + numLatencyPixels;
+    std::vector<uint16_t>::iterator write = data.begin() + numLatencyPixels;
+
+    for( int32_t r = 0; r < rows; ++r )
+    {
+        const size_t from = numLatencyPixels*2 + r*actNumCols;
+        if( from >= data.size() )
         {
-            std::vector<uint16_t>::iterator start = data.begin()+i;
-            std::vector<uint16_t>::iterator end = start+numLatencyPixels;
-            data.erase( start, end );
+            break;
         }
+
+        const size_t len = std::min<size_t>( numImgCols, data.size() - from );
+        write = std::copy( data.begin() + from, data.begin() + from + len, write );
+    }
+
+    const size_t tail = numLatencyPixels + rows*actNumCols;
+    if( tail < data.size() )
+    {
+        write = std::copy( data.begin() + tail, data.end(), write );
+    }
+
+    data.erase( write, data.end() );
+}
+
+//////////////////////////// 
+//      SINGLE       OUPUT       COPY
+void ImgFix::SingleOuputCopy( const uint16_t * data, uint16_t * out, const size_t pitch,
+    const int32_t rows, const int32_t numImgCols, const int32_t numLatencyPixels )
+{
+    const size_t actNumCols = numImgCols + numLatencyPixels;
+
+    ForEachRowBlock( rows, numImgCols, [=]( const int32_t begin, const int32_t end )
+    {
+        for( int32_t r = begin; r < end; ++r )
+        {
+            const uint16_t * start = data + numLatencyPixels + r*actNumCols;
+            std::copy( start, start + numImgCols, out + r*pitch );
+        }
+    } );
 }
 
-    
 //////////////////////////// 
 //      SINGLE       OUPUT       COPY
 void ImgFix::SingleOuputCopy( const std::vector<uint16_t> & data, 
       std::vector<uint16_t> & out, const int32_t rows,  const int32_t numImgCols,  
       const int32_t numLatencyPixels )
 {
-
     // in testing found that this function is much faster than the erase function
-    const int32_t actNumCols = numImgCols + numLatencyPixels;
+    SingleOuputCopy( data.data(), out.data(), numImgCols, rows, numImgCols, numLatencyPixels );
+}
+
+//////////////////////////// 
+//      QUAD      OUPUT       COPY
+void ImgFix::QuadOuputCopy( const uint16_t * data, uint16_t * out, const size_t pitch,
+    const int32_t rows, const int32_t cols, const int32_t numLatencyPixels )
+{
+    // the camera sends runs of numGood pixels, each one followed by numBad
+    // latency pixels, output pixel k is the k-th good pixel
+    const size_t numGood = ( cols / 2 ) * 4;
+    const size_t numBad = numLatencyPixels*2;
 
-    for(int32_t r = 0, actColsOffset=numLatencyPixels, outColsOffset=0; r < rows;
-		    actColsOffset += actNumCols, outColsOffset += numImgCols, ++r)
+    if( 0 == numGood )
     {
-        std::vector<uint16_t>::const_iterator start = data.begin()+actColsOffset;
-        std::vector<uint16_t>::const_iterator end = start + numImgCols;
-        std::vector<uint16_t>::iterator outStart = out.begin() + outColsOffset;
-        std::copy( start, end, outStart );
+        return;
     }
-}
 
+    ForEachRowBlock( rows, cols, [=]( const int32_t begin, const int32_t end )
+    {
+        for( int32_t r = begin; r < end; ++r )
+        {
+            uint16_t * outRow = out + r*pitch;
+            size_t k = static_cast<size_t>( r )*cols;
+            size_t left = cols;
+
+            while( left > 0 )
+            {
+                const size_t within = k % numGood;
+                const size_t len = std::min( left, numGood - within );
+                const uint16_t * start = data + numBad + ( k / numGood )*( numGood + numBad ) + within;
+                outRow = std::copy( start, start + len, outRow );
+                k += len;
+                left -= len;
+            }
+        }
+    } );
+}
 
 //////////////////////////// 
 //      QUAD      OUPUT       COPY
@@ -53,26 +282,33 @@ void ImgFix::QuadOuputCopy( const std::vector<uint16_t> & data,
       std::vector<uint16_t> & out, const int32_t rows,  const int32_t cols,  
       const int32_t numLatencyPixels, const int32_t outputBuffOffset )
 {
-    int32_t numGood =  ( cols / 2 ) * 4;
-    int32_t numBad = numLatencyPixels*2;
+    QuadOuputCopy( data.data(), out.data() + outputBuffOffset, cols, rows, cols, numLatencyPixels );
+}
 
-    int32_t down = rows*cols;
-    
-    int32_t goodStart = 0;
-    int32_t badStart = numLatencyPixels*2;
+//////////////////////////// 
+//      QUAD       OUPUT       FIX
+void ImgFix::QuadOuputFix( const uint16_t * data, uint16_t * out, const size_t pitch,
+    const int32_t rows, const int32_t cols, const int32_t numLatencyPixels )
+{
+    const int32_t HALF_COLS = cols / 2;
+    const int32_t HALF_ROWS = rows / 2;
 
-    while( down > 0 )
-    {
-         int32_t len = std::min<int32_t>( down, numGood );
+    // one row from the top half and its mirror from the bottom half
+    // per HALF_COLS*4 pixels, each followed by the latency pixels
+    const size_t pairLen = HALF_COLS*4 + numLatencyPixels*2;
 
-        std::vector<uint16_t>::const_iterator start = data.begin()+badStart;
-        std::vector<uint16_t>::const_iterator end = start + len;
-        std::vector<uint16_t>::iterator outStart = out.begin() + outputBuffOffset + goodStart;
-        std::copy( start, end, outStart );
+    ForEachRowBlock( HALF_ROWS, cols*2, [=]( const int32_t begin, const int32_t end )
+    {
+        for( int32_t r = begin; r < end; ++r )
+        {
+            QuadRows( data + numLatencyPixels*2 + r*pairLen, out + r*pitch, 
+                out + ( rows - ( r + 1 ) )*pitch, cols );
+        }
+    } );
 
-         goodStart += len;
-         badStart += (len + numBad);
-         down -= len;
+    if( rows % 2 )
+    {
+        std::fill( out + HALF_ROWS*pitch, out + HALF_ROWS*pitch + cols, 0 );
     }
 }
 
@@ -83,39 +319,23 @@ void ImgFix::QuadOuputFix( const std::vector<uint16_t> & data,
                                              const int32_t rows,  const int32_t cols,
                                              const int32_t numLatencyPixels)
 {
-    const int32_t HALF_COLS = cols / 2;
-    const int32_t HALF_ROWS = rows / 2;
-    
-    int32_t index = numLatencyPixels*2;
-  
-    for( int32_t r=0; r < HALF_ROWS; ++r )
-    {
-        int32_t topOffset = cols*r;
-        int32_t bottomOffset = (cols*(rows-(r+1)));
-
-        for( int32_t c=0; c < HALF_COLS; ++c)
-        {
-            int32_t ul = topOffset + c;
-            out[ul] = data[index];
-
-            int32_t ur =  topOffset + (cols-(c+1) );
-            ++index;
-            out[ur] = data[index];
-            
-            int32_t lr = bottomOffset + (cols-(c+1) );
-            ++index;
-            out[lr] = data[index];
+    QuadOuputFix( data.data(), out.data(), cols, rows, cols, numLatencyPixels );
+}
 
-            int32_t ll = bottomOffset+c;
-            ++index;
-            out[ll] = data[index];
+//////////////////////////// 
+//      DUAL       OUPUT       FIX
+void ImgFix::DualOuputFix( const uint16_t * data, uint16_t * out, const size_t pitch,
+    const int32_t rows, const int32_t cols, const int32_t numLatencyPixels )
+{
+    const size_t rowLen = ( cols / 2 )*2 + numLatencyPixels;
 
-            ++index;
+    ForEachRowBlock( rows, cols, [=]( const int32_t begin, const int32_t end )
+    {
+        for( int32_t r = begin; r < end; ++r )
+        {
+            DualRow( data + numLatencyPixels + r*rowLen, out + r*pitch, cols );
         }
-
-        //skip the latency pixels
-        index += numLatencyPixels*2;
-    }
+    } );
 }
 
 //////////////////////////// 
@@ -125,33 +345,5 @@ void ImgFix::DualOuputFix( const std::vector<uint16_t> & data,
                                              const int32_t rows,  const int32_t cols,
                                              const int32_t numLatencyPixels)
 {
-   
-    const int32_t HALF_COLS = cols / 2;
-
-     //account for the odd no op col
-    const int32_t oddAdjust = ( cols % 2 ) ? 1 : 0;
-    const int32_t START_UR_COL = cols;
-
-    int32_t index = numLatencyPixels;
-  
-    for( int32_t r=0; r < rows; ++r )
-    {
-        int32_t topOffset = cols*r;
-
-        for( int32_t c=0; c < HALF_COLS; ++c)
-        {
-            // skip odd col if need with oddAdjust
-            int32_t ur =  topOffset + (START_UR_COL-(c+1) ) - oddAdjust;
-            out[ur] = data[index];
-
-           int32_t ul = topOffset + c;
-            ++index;
-            out[ul] = data[index];
-            
-            ++index;
-        }
-
-        //skip the latency pixels
-        index += numLatencyPixels;
-    }
+    DualOuputFix( data.data(), out.data(), cols, rows, cols, numLatencyPixels );
 }
@@ -14,10 +14,27 @@
 #define IMGFIX_INCLUDE_H__ 
 
 #include <vector>
+#include <cstddef>
 #include "stdint.h"
 
 namespace ImgFix 
 { 
+    // The pointer versions write rows of cols pixels, pitch pixels apart, 
+    // into a caller owned buffer.  Large frames are split in blocks of rows
+    // that are reassembled in parallel.
+
+    void SingleOuputCopy( const uint16_t * data, uint16_t * out, size_t pitch,
+        int32_t rows, int32_t numImgCols, int32_t numLatencyPixels );
+
+    void QuadOuputCopy( const uint16_t * data, uint16_t * out, size_t pitch,
+        int32_t rows, int32_t cols, int32_t numLatencyPixels );
+
+    void QuadOuputFix( const uint16_t * data, uint16_t * out, size_t pitch,
+        int32_t rows, int32_t cols, int32_t numLatencyPixels );
+
+    void DualOuputFix( const uint16_t * data, uint16_t * out, size_t pitch,
+        int32_t rows, int32_t cols, int32_t numLatencyPixels );
+
     void SingleOuputErase( std::vector<uint16_t> & data, int32_t rows,  
         int32_t numImgCols,  int32_t numLatencyPixels );
 
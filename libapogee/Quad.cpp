@@ -201,7 +201,7 @@ void Quad::VerifyCamId()
 //////////////////////////// 
 //      FIX      IMG        FROM          CAMERA
 void Quad::FixImgFromCamera( const std::vector<uint16_t> & data,
-                                            std::vector<uint16_t> & out,  const int32_t rows, 
+                                            uint16_t * out, const size_t pitch,  const int32_t rows, 
                                             const int32_t cols)
 {
     int32_t offset = 0; 
@@ -210,7 +210,7 @@ void Quad::FixImgFromCamera( const std::vector<uint16_t> & data,
     {
         case 1:
             offset = m_CcdAcqSettings->GetPixelShift();
-            ImgFix::SingleOuputCopy( data, out, rows, cols, offset );
+            ImgFix::SingleOuputCopy( data.data(), out, pitch, rows, cols, offset );
         break;
 
         case 4:
@@ -220,11 +220,11 @@ void Quad::FixImgFromCamera( const std::vector<uint16_t> & data,
             offset = c - cols;
             if( m_DoPixelReorder )
             {
-                ImgFix::QuadOuputFix( data, out, rows, cols, offset );
+                ImgFix::QuadOuputFix( data.data(), out, pitch, rows, cols, offset );
             }
             else
             {
-                ImgFix::QuadOuputCopy( data, out, rows, cols, offset );
+                ImgFix::QuadOuputCopy( data.data(), out, pitch, rows, cols, offset );
             }
         }
         break;
@@ -0,0 +1,320 @@
+/*!
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this file,
+* You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+* \file alta_ethernet_bench.cpp
+* \brief Alta ethernet image download benchmark against a loopback camera
+*
+* Serves synthetic frames from a local HTTP stub that answers like the Alta
+* ethernet interface, then times the downloads:
+*
+*     alta_ethernet_bench [-w width] [-h height] [-n frames]
+*
+* "per frame" is the former download path, a new connection and a string per
+* frame then a second pass to build the words.  "session" is
+* AltaEthernetIo::GetImageData on its persistent connection.
+*/
+
+#include "AltaEthernetIo.h"
+#include "libCurlWrap.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds( Clock::time_point start )
+{
+    return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+static uint16_t pixel( size_t i )
+{
+    return static_cast<uint16_t>( i * 2654435761u >> 7 );
+}
+
+////////////////////////////
+// LOOPBACK     CAMERA
+// Minimal HTTP/1.1 server with keep alive, one thread per connection
+class LoopbackCamera
+{
+    public:
+        LoopbackCamera( size_t pixels ) : m_fd( -1 ), m_port( 0 ), m_running( false ), m_connections( 0 )
+        {
+            // The camera sends big endian words
+            m_frame.resize( pixels * 2 );
+            for( size_t i = 0; i < pixels; ++i )
+            {
+                m_frame[2*i]   = static_cast<char>( pixel(i) >> 8 );
+                m_frame[2*i+1] = static_cast<char>( pixel(i) & 0xFF );
+            }
+        }
+
+        ~LoopbackCamera()
+        {
+            Stop();
+        }
+
+        void Start()
+        {
+            m_fd = socket( AF_INET, SOCK_STREAM, 0 );
+            int one = 1;
+            setsockopt( m_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one) );
+
+            sockaddr_in addr;
+            memset( &addr, 0, sizeof(addr) );
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+            socklen_t len = sizeof(addr);
+            if( bind( m_fd, reinterpret_cast<sockaddr *>( &addr ), len ) != 0 ||
+                listen( m_fd, 8 ) != 0 ||
+                getsockname( m_fd, reinterpret_cast<sockaddr *>( &addr ), &len ) != 0 )
+            {
+                throw std::runtime_error( "cannot listen on the loopback interface" );
+            }
+            m_port = ntohs( addr.sin_port );
+
+            m_running = true;
+            m_acceptThread = std::thread( &LoopbackCamera::Accept, this );
+        }
+
+        void Stop()
+        {
+            if( !m_running )
+            {
+                return;
+            }
+            m_running = false;
+            shutdown( m_fd, SHUT_RDWR );
+            close( m_fd );
+            m_acceptThread.join();
+
+            std::lock_guard<std::mutex> lock( m_mutex );
+            for( size_t i = 0; i < m_clients.size(); ++i )
+            {
+                shutdown( m_clients[i].first, SHUT_RDWR );
+                m_clients[i].second.join();
+                close( m_clients[i].first );
+            }
+            m_clients.clear();
+        }
+
+        std::string Url() const
+        {
+            return "http://127.0.0.1:" + std::to_string( m_port );
+        }
+
+        int Connections() const
+        {
+            return m_connections;
+        }
+
+    private:
+        void Accept()
+        {
+            while( m_running )
+            {
+                int client = accept( m_fd, nullptr, nullptr );
+                if( client < 0 )
+                {
+                    continue;
+                }
+                ++m_connections;
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_clients.push_back( std::make_pair( client, std::thread( &LoopbackCamera::Serve, this, client ) ) );
+            }
+        }
+
+        void Serve( int client )
+        {
+            std::string request;
+            char buffer[4096];
+
+            for( ;; )
+            {
+                size_t end = request.find( "\r\n\r\n" );
+                if( end == std::string::npos )
+                {
+                    ssize_t n = recv( client, buffer, sizeof(buffer), 0 );
+                    if( n <= 0 )
+                    {
+                        return;
+                    }
+                    request.append( buffer, static_cast<size_t>( n ) );
+                    continue;
+                }
+
+                // GET <path> HTTP/1.1
+                size_t from = request.find( ' ' ) + 1;
+                std::string path = request.substr( from, request.find( ' ', from ) - from );
+                request.erase( 0, end + 4 );
+
+                const char * body = "";
+                size_t size = 0;
+                std::string text;
+                if( path == "/UE/image.bin" )
+                {
+                    body = m_frame.data();
+                    size = m_frame.size();
+                }
+                else
+                {
+                    // Enough for the session and register requests
+                    text = path.compare( 0, 8, "/SESSION" ) == 0 ? "SessionId=1" : "0x0000=0x0000";
+                    body = text.c_str();
+                    size = text.size();
+                }
+
+                std::string header = "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " +
+                    std::to_string( size ) + "\r\n\r\n";
+                if( !Send( client, header.data(), header.size() ) || !Send( client, body, size ) )
+                {
+                    return;
+                }
+            }
+        }
+
+        static bool Send( int client, const char * data, size_t size )
+        {
+            while( size > 0 )
+            {
+                ssize_t n = send( client, data, size, MSG_NOSIGNAL );
+                if( n <= 0 )
+                {
+                    return false;
+                }
+                data += n;
+                size -= static_cast<size_t>( n );
+            }
+            return true;
+        }
+
+        int m_fd;
+        uint16_t m_port;
+        std::atomic<bool> m_running;
+        std::atomic<int> m_connections;
+        std::vector<char> m_frame;
+        std::thread m_acceptThread;
+        std::mutex m_mutex;
+        std::vector< std::pair<int, std::thread> > m_clients;
+};
+
+////////////////////////////
+// PER     FRAME     DOWNLOAD
+// What GetImageData did before it kept its connection
+static void PerFrameDownload( const std::string & url, std::vector<uint16_t> & ImageData )
+{
+    CLibCurlWrap theCurl;
+    std::string result;
+    theCurl.HttpGet( url + "/UE/image.bin", result );
+
+    if( result.size() != ImageData.size() * sizeof(uint16_t) )
+    {
+        throw std::runtime_error( "short frame" );
+    }
+
+    int32_t i = 0;
+    for( std::string::iterator strIter = result.begin(); strIter != result.end(); strIter += 2, ++i )
+    {
+        uint8_t a = (*strIter);
+        uint8_t b = *(strIter + 1);
+        ImageData.at(i) = static_cast<uint16_t>( (a << 8) | b );
+    }
+}
+
+static bool Verify( const std::vector<uint16_t> & ImageData )
+{
+    for( size_t i = 0; i < ImageData.size(); ++i )
+    {
+        if( ImageData[i] != pixel(i) )
+        {
+            fprintf( stderr, "pixel %zu is %u, expected %u\n", i, ImageData[i], pixel(i) );
+            return false;
+        }
+    }
+    return true;
+}
+
+int main( int argc, char * argv[] )
+{
+    size_t width = 4096, height = 4096;
+    int frames = 10;
+
+    for( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if( !strcmp( argv[i], "-w" ) )
+            width = strtoul( argv[i+1], nullptr, 10 );
+        else if( !strcmp( argv[i], "-h" ) )
+            height = strtoul( argv[i+1], nullptr, 10 );
+        else if( !strcmp( argv[i], "-n" ) )
+            frames = atoi( argv[i+1] );
+    }
+    if( width == 0 || height == 0 || frames <= 0 || (argc - 1) % 2 )
+    {
+        fprintf( stderr, "Usage: %s [-w width] [-h height] [-n frames]\n", argv[0] );
+        return 1;
+    }
+
+    try
+    {
+        LoopbackCamera camera( width * height );
+        camera.Start();
+
+        std::vector<uint16_t> image( width * height );
+        const double bytes = static_cast<double>( image.size() * sizeof(uint16_t) ) * frames;
+
+        printf( "%zux%zu frames, %.1f MB each, %d frames\n", width, height, image.size() * 2 / 1e6, frames );
+        printf( "%-12s %10s %10s %12s\n", "path", "ms/frame", "MB/s", "connections" );
+
+        int connections = camera.Connections();
+        Clock::time_point start = Clock::now();
+        for( int i = 0; i < frames; ++i )
+        {
+            PerFrameDownload( camera.Url(), image );
+        }
+        double elapsed = seconds( start );
+        if( !Verify( image ) )
+        {
+            return 1;
+        }
+        printf( "%-12s %10.1f %10.0f %12d\n", "per frame", elapsed * 1000.0 / frames, bytes / elapsed / 1e6,
+            camera.Connections() - connections );
+
+        AltaEthernetIo io( camera.Url() );
+        connections = camera.Connections();
+        std::fill( image.begin(), image.end(), 0 );
+        start = Clock::now();
+        for( int i = 0; i < frames; ++i )
+        {
+            io.GetImageData( image );
+        }
+        elapsed = seconds( start );
+        if( !Verify( image ) )
+        {
+            return 1;
+        }
+        printf( "%-12s %10.1f %10.0f %12d\n", "session", elapsed * 1000.0 / frames, bytes / elapsed / 1e6,
+            camera.Connections() - connections );
+    }
+    catch( std::exception & err )
+    {
+        fprintf( stderr, "%s\n", err.what() );
+        return 1;
+    }
+
+    return 0;
+}
@@ -11,16 +11,13 @@
 
 #include "libCurlWrap.h" 
 #include <stdexcept>
+#include <cstring>
+#include <algorithm>
 
 #include "apgHelper.h" 
 
-//////////////////////////// 
-// Write any errors in here  
-static char errorBuffer[CURL_ERROR_SIZE];  
-
 //////////////////////////// 
 // VECT WRITER
-static std::vector<uint8_t> bufferVect;  
 static int32_t vectWriter(uint8_t *data, size_t size, size_t nmemb,  
                   std::vector<uint8_t> &bufferVect) 
 {
@@ -32,7 +29,6 @@ static int32_t vectWriter(uint8_t *data, size_t size, size_t nmemb,
 //////////////////////////// 
 // STR WRITER
 // This is the writer call back function used by curl  
-static std::string bufferStr; 
 static int32_t strWriter(char *data, size_t size, size_t nmemb,  
                   std::string &bufferStr) 
 {
@@ -44,11 +40,77 @@ static int32_t strWriter(char *data, size_t size, size_t nmemb,
     return apgHelper::SizeT2Int32( numBytes );
 }
 
+//////////////////////////// 
+// BUFFER WRITER
+// Places each chunk at its offset in the destination, so nothing is
+// accumulated or copied again once the transfer is done
+namespace
+{
+    struct BufferWriterData
+    {
+        uint8_t * dest;
+        size_t destSize;
+        size_t received;
+        bool swap;
+    };
+}
+
+static size_t bufferWriter(char *data, size_t size, size_t nmemb,
+                  void * userp)
+{
+    BufferWriterData * writer = static_cast<BufferWriterData *>( userp );
+    const uint8_t * src = reinterpret_cast<const uint8_t *>( data );
+    const size_t numBytes = size * nmemb;
+
+    size_t offset = writer->received;
+    writer->received += numBytes;
+    if( offset >= writer->destSize )
+    {
+        return numBytes;
+    }
+    size_t count = std::min( numBytes, writer->destSize - offset );
+
+    if( !writer->swap )
+    {
+        memcpy( writer->dest + offset, src, count );
+        return numBytes;
+    }
+
+    // Byte k of the stream goes to k^1, chunks may split a word
+    if( offset & 1 )
+    {
+        writer->dest[offset - 1] = *src++;
+        ++offset;
+        --count;
+    }
+
+    uint8_t * dst = writer->dest + offset;
+    const size_t words = count / 2;
+    for( size_t i = 0; i < words; ++i )
+    {
+        dst[2*i]   = src[2*i+1];
+        dst[2*i+1] = src[2*i];
+    }
+
+    if( (count & 1) && offset + 2*words + 1 < writer->destSize )
+    {
+        dst[2*words + 1] = src[2*words];
+    }
+
+    return numBytes;
+}
+
 //////////////////////////// 
 // LOCAL     NAMESPACE
 namespace
 {
     const long OPERATION_TIMEOUT = (60*1);  //60 seconds * the number of minutes
+
+    bool IsLittleEndian()
+    {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const uint8_t *>( &probe ) == 1;
+    }
 }
 
 //////////////////////////// 
@@ -58,12 +120,17 @@ CLibCurlWrap::CLibCurlWrap() : m_curlHandle( 0 ),
 { 
     m_curlHandle = curl_easy_init();
 	m_timeout = OPERATION_TIMEOUT;
+    m_errorBuffer[0] = 0;
     if( !m_curlHandle )
     {
         std::string errStr("curl_easy_init failed");
          apgHelper::throwRuntimeException( m_fileName, 
              errStr, __LINE__, Apg::ErrorType_Connection );
     }
+
+    // The handle keeps its connection open between requests,
+    // keep alive probes stop idle links from being dropped
+    curl_easy_setopt(m_curlHandle, CURLOPT_TCP_KEEPALIVE, 1L);
 } 
 
 //////////////////////////// 
@@ -93,6 +160,29 @@ void CLibCurlWrap::HttpGet(const std::string & url,
     ExecuteVect( result );
 }
 
+//////////////////////////// 
+// HTTP GET 
+size_t CLibCurlWrap::HttpGet(const std::string & url,
+            uint8_t * dest, size_t destSize, bool BigEndian16)
+{
+    BufferWriterData writer;
+    writer.dest = dest;
+    writer.destSize = destSize;
+    writer.received = 0;
+    writer.swap = BigEndian16 && IsLittleEndian();
+
+    curl_easy_setopt(m_curlHandle, CURLOPT_ERRORBUFFER, m_errorBuffer);
+    curl_easy_setopt(m_curlHandle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, bufferWriter);
+    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, &writer);
+    curl_easy_setopt(m_curlHandle, CURLOPT_TIMEOUT, m_timeout);
+
+    Perform();
+
+    return writer.received;
+}
+
 //////////////////////////// 
 // HTTP POST 
 void CLibCurlWrap::HttpPost(const std::string & url,
@@ -123,10 +213,11 @@ void CLibCurlWrap::HttpPost(const std::string & url,
 void CLibCurlWrap::CurlSetupStrWrite(const std::string & url)
 {
      // Now set up all of the curl options  
-    curl_easy_setopt(m_curlHandle, CURLOPT_ERRORBUFFER, errorBuffer);  
+    curl_easy_setopt(m_curlHandle, CURLOPT_ERRORBUFFER, m_errorBuffer);  
     curl_easy_setopt(m_curlHandle, CURLOPT_URL, url.c_str());  
+    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPGET, 1L);
     curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, strWriter);  
-    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, &bufferStr); 
+    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, &m_bufferStr); 
     curl_easy_setopt(m_curlHandle, CURLOPT_TIMEOUT, m_timeout);
     
 }
@@ -136,8 +227,9 @@ void CLibCurlWrap::CurlSetupStrWrite(const std::string & url)
 void CLibCurlWrap::CurlSetupVectWrite(const std::string & url, const std::vector<uint8_t> & result)
 {
      // Now set up all of the curl options  
-    curl_easy_setopt(m_curlHandle, CURLOPT_ERRORBUFFER, errorBuffer);  
+    curl_easy_setopt(m_curlHandle, CURLOPT_ERRORBUFFER, m_errorBuffer);  
     curl_easy_setopt(m_curlHandle, CURLOPT_URL, url.c_str());  
+    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPGET, 1L);
     curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, vectWriter);  
     curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, &result); 
     curl_easy_setopt(m_curlHandle, CURLOPT_TIMEOUT, m_timeout);
@@ -148,20 +240,12 @@ void CLibCurlWrap::CurlSetupVectWrite(const std::string & url, const std::vector
 std::string CLibCurlWrap::ExecuteStr()
 {
     //clear out the string
-    bufferStr.clear();
+    m_bufferStr.clear();
 
     //perform the transfer
-    const CURLcode result = curl_easy_perform(m_curlHandle);
-
-    if( CURLE_OK != result )
-    {
-        std::string curlError( errorBuffer );
-
-        apgHelper::throwRuntimeException( m_fileName, curlError, 
-            __LINE__, Apg::ErrorType_Critical );
-    }
+    Perform();
 
-    return bufferStr;
+    return m_bufferStr;
 }
 
 //////////////////////////// 
@@ -172,16 +256,24 @@ void CLibCurlWrap::ExecuteVect( std::vector<uint8_t> & result )
     result.resize(0);
 
 	//perform the transfer
+    Perform();
+}
+
+//////////////////////////// 
+// PERFORM
+void CLibCurlWrap::Perform()
+{
+    m_errorBuffer[0] = 0;
+
     const CURLcode returnCode = curl_easy_perform(m_curlHandle);
 
     if( CURLE_OK != returnCode )
     {
-        std::string curlError( errorBuffer );
+        std::string curlError( m_errorBuffer[0] ? m_errorBuffer : curl_easy_strerror( returnCode ) );
 
         apgHelper::throwRuntimeException( m_fileName, curlError, 
             __LINE__, Apg::ErrorType_Critical );
     }
-
 }
 
 //////////////////////////// 
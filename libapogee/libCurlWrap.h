@@ -30,6 +30,13 @@ class CLibCurlWrap
         void HttpGet(const std::string & url,
             std::vector<uint8_t> & result);
 
+        // Streams the response straight into dest as it arrives, bytes
+        // past destSize are dropped.  With BigEndian16 set the data is
+        // taken as big endian 16 bit words and stored in host order.
+        // Returns the number of bytes in the response.
+        size_t HttpGet(const std::string & url,
+            uint8_t * dest, size_t destSize, bool BigEndian16);
+
         void HttpPost(const std::string & url,
             const std::string & postFields, 
             std::string & result);
@@ -51,7 +58,11 @@ class CLibCurlWrap
         void CurlSetupVectWrite(const std::string & url, const std::vector<uint8_t> & result);
         void ExecuteVect(std::vector<uint8_t> & result);
 
+        void Perform();
+
         CURL * m_curlHandle;
+        std::string m_bufferStr;
+        char m_errorBuffer[CURL_ERROR_SIZE];
         const std::string m_fileName;
 
         //disable the copy ctor and assignment operator
@@ -528,6 +528,30 @@ long fli_camera_parport_grab_row(flidev_t dev, void *buff, size_t width)
   return 0;
 }
 
+long fli_camera_parport_grab_frame(flidev_t dev, void *buff, size_t size, size_t *grabbed)
+{
+  flicamdata_t *cam = DEVICE->device_data;
+  size_t rowsize = cam->grabrowwidth * sizeof(unsigned short);
+  long r = 0;
+
+  *grabbed = 0;
+
+  if (size < cam->grabrowcount * rowsize)
+  {
+    debug(FLIDEBUG_FAIL, "Buffer not large enough to receive frame.");
+    return -ENOMEM;
+  }
+
+  /* The port moves a pixel at a time, rows are as good as anything */
+  while ((r == 0) && (cam->grabrowcount > 0))
+  {
+    r = fli_camera_parport_grab_row(dev, (unsigned char *) buff + *grabbed, cam->grabrowwidth);
+    *grabbed += rowsize;
+  }
+
+  return r;
+}
+
 long fli_camera_parport_expose_frame(flidev_t dev)
 {
   flicamdata_t *cam;
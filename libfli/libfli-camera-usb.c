@@ -55,6 +55,12 @@
 #include <string.h>
 #include <math.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "libfli-libfli.h"
 #include "libfli-debug.h"
 #include "libfli-mem.h"
@@ -63,6 +69,10 @@
 #include "libfli-usb.h"
 #include "indimacros.h"
 
+#ifndef usb_bulkqueue
+#define usb_bulkqueue usb_bulktransfer
+#endif
+
 double dconvert(void *buf)
 {
   unsigned char *fnum = (unsigned char *) buf;
@@ -1730,6 +1740,147 @@ long fli_camera_usb_grab_row(flidev_t dev, void *buff, size_t width)
 	return 0;
 }
 
+/* ProLine words are big endian on the wire, swapped in place */
+static void fli_camera_usb_swab16(unsigned short *buf, size_t count)
+{
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i v = _mm_loadu_si128((__m128i *) (buf + i));
+		_mm_storeu_si128((__m128i *) (buf + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+	}
+#elif defined(__ARM_NEON)
+	for (; i + 8 <= count; i += 8)
+	{
+		vst1q_u16(buf + i, vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(vld1q_u16(buf + i)))));
+	}
+#endif
+
+	for (; i < count; i++)
+		buf[i] = ((buf[i] << 8) & 0xff00) | ((buf[i] >> 8) & 0x00ff);
+}
+
+/* Reads what is left of a ProLine image to *dest, as host words */
+static long fli_camera_usb_download(flidev_t dev, unsigned short **dest)
+{
+	flicamdata_t *cam = DEVICE->device_data;
+	long r = 0;
+
+	while (cam->bytesleft > 0)
+	{
+		long rlen = (long) cam->bytesleft;
+
+		r = usb_bulkqueue(dev, 0x82, *dest, &rlen);
+
+		if (rlen == 0x03) /* This is a special case, the camera is telling us there
+											 * is no more data, something went wrong */
+		{
+			debug(FLIDEBUG_FAIL, "Camera aborted the image download.");
+			cam->bytesleft = 0;
+			return -EIO;
+		}
+
+		fli_camera_usb_swab16(*dest, rlen / 2);
+		*dest += rlen / 2;
+		cam->bytesleft -= rlen;
+
+		if ((r != 0) || (rlen == 0))
+		{
+			debug(FLIDEBUG_FAIL, "Read failed, %d bytes left.", cam->bytesleft);
+			return (r != 0) ? r : -EIO;
+		}
+	}
+
+	return 0;
+}
+
+long fli_camera_usb_grab_frame(flidev_t dev, void *buff, size_t size, size_t *grabbed)
+{
+	flicamdata_t *cam = DEVICE->device_data;
+	size_t rowsize = cam->grabrowwidth * sizeof(unsigned short);
+	long rows, r = 0;
+
+	*grabbed = 0;
+
+	switch (DEVICE->devinfo.devid)
+	{
+		/* MaxCam and IMG cameras count the rows down */
+		case FLIUSB_CAM_ID:
+			rows = cam->grabrowcount;
+			break;
+
+		case FLIUSB_PROLINE_ID:
+			rows = cam->grabrowcount - cam->grabrowindex;
+			break;
+
+		default:
+			return -EINVAL;
+	}
+
+	if (rows <= 0)
+		return 0;
+
+	if (size < rows * rowsize)
+	{
+		debug(FLIDEBUG_FAIL, "Buffer not large enough to receive frame.");
+		return -ENOMEM;
+	}
+
+	if ((DEVICE->devinfo.devid == FLIUSB_PROLINE_ID) && (cam->tdirate == 0))
+	{
+		unsigned short *dest;
+		int direct;
+
+		/* A single output reads out in image order, the download is the image */
+		direct = (cam->bottom_height == 0) && (cam->right_width == 0) &&
+			(cam->top_offset <= cam->bottom_offset) && (cam->left_offset <= cam->right_offset) &&
+			(cam->left_width == cam->grabrowwidth) && (cam->grabrowindex == 0) &&
+			(cam->ibuf_wr_idx == cam->ibuf) && (cam->bytesleft == rows * rowsize);
+
+#ifdef BADCOLUMN
+		direct = 0;
+#endif
+
+		if (direct)
+		{
+			dest = (unsigned short *) buff;
+			r = fli_camera_usb_download(dev, &dest);
+			*grabbed = (dest - (unsigned short *) buff) * sizeof(unsigned short);
+			cam->grabrowindex = cam->grabrowcount;
+
+			return r;
+		}
+
+		/* Top and bottom halves come interleaved, the whole image has to be
+		 * in memory before the rows are put back together */
+		if ((cam->ibuf == NULL) ||
+			((cam->ibuf_wr_idx - cam->ibuf) * sizeof(unsigned short) + cam->bytesleft > cam->ibuf_siz))
+		{
+			debug(FLIDEBUG_FAIL, "Image buffer not large enough to receive frame.");
+			return -ENOMEM;
+		}
+
+		dest = cam->ibuf_wr_idx;
+		r = fli_camera_usb_download(dev, &dest);
+		cam->ibuf_wr_idx = dest;
+
+		if (r != 0)
+			return r;
+	}
+
+	/* Rows are now in memory for the ProLine, the MaxCam reads batches of rows */
+	while ((r == 0) && (rows > 0))
+	{
+		r = fli_camera_usb_grab_row(dev, (unsigned char *) buff + *grabbed, cam->grabrowwidth);
+		*grabbed += rowsize;
+		rows--;
+	}
+
+	return r;
+}
+
 long fli_camera_usb_stop_video_mode(flidev_t dev)
 {
   flicamdata_t *cam = DEVICE->device_data;
@@ -188,6 +188,9 @@ static long fli_freelist(char **names)
 /* This is for FLI INTERNAL USE ONLY */
 #ifdef _WIN32
 long usb_bulktransfer(flidev_t dev, int ep, void *buf, long *len);
+#elif defined(__FLI_USB_REPLAY__)
+long replay_bulktransfer(flidev_t dev, int ep, void *buf, long *len);
+#define usb_bulktransfer replay_bulktransfer
 #elif defined(__APPLE__) && !defined(__LIBUSB__)
 long mac_bulktransfer(flidev_t dev, int ep, void *buf, long *len);
 #define usb_bulktransfer mac_bulktransfer
@@ -225,14 +228,44 @@ LIBFLIAPI FLIUsbBulkIO(flidev_t dev, int ep, void *buf, long *len)
 	return usb_bulktransfer(dev, ep, buf, len);
 }
 
+/**
+   Grab the rest of an image.  This function downloads the rows of the
+   image from camera \texttt{dev} that have not been grabbed yet and
+   places them one after the other in the buffer pointed to by
+   \texttt{buff}.  Each row is as wide as the image area divided by the
+   horizontal bin factor.  On USB cameras the image is read with several
+   transfers in flight and converted in place, which is much faster than
+   grabbing the rows one by one.
+
+   @param dev Camera whose image to grab.
+
+   @param buff Pointer to where the image will be placed.
+
+   @param buffsize Size of \texttt{buff} in bytes.
+
+   @param bytesgrabbed Number of bytes placed in \texttt{buff}, may be
+   NULL.
+
+   @return Zero on success.
+   @return Non-zero on failure.
+
+   @see FLIGrabRow
+   @see FLIExposeFrame
+*/
 LIBFLIAPI FLIGrabFrame(flidev_t dev, void* buff,
 		       size_t buffsize, size_t* bytesgrabbed)
 {
-  INDI_UNUSED(dev);
-  INDI_UNUSED(buff);
-  INDI_UNUSED(buffsize);
-  INDI_UNUSED(bytesgrabbed);
-	return -EINVAL;
+  size_t grabbed = 0;
+  long r;
+
+  CHKDEVICE(dev);
+
+  r = DEVICE->fli_command(dev, FLI_GRAB_FRAME, 3, buff, &buffsize, &grabbed);
+
+  if (bytesgrabbed != NULL)
+    *bytesgrabbed = grabbed;
+
+  return r;
 }
 
 /**
@@ -1913,4 +1946,4 @@ LIBFLIAPI FLIWriteUserEEPROM(flidev_t dev, long loc, long address, long length,
 	r = DEVICE->fli_command(dev, FLI_WRITE_EEPROM, 4, &loc, &address, &length, wbuf);
 
 	return r;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+/*
+    Frame download tests against USB captures served by the replay backend
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "libfli.h"
+
+#define PROLINE_ID 0x0a
+
+// Builds a capture of a ProLine exposure, see unix/libfli-usb-capture.h
+class ProLineCapture
+{
+    public:
+        ProLineCapture(int width, int height) : width(width), height(height)
+        {
+            put("FLIUSBCAP1", 10);
+            uint8_t device[] = { 'D', PROLINE_ID, 0x00, 0x00, 0x02 };
+            put(device, sizeof(device));
+
+            // Hardware revision, serial number, camera info length
+            read(0x81, { 0x01, 0x00, 0x00, 0x2a, 0x00, 0x20 });
+
+            // Camera info, little endian: array size, visible size, visible offset, pixel sizes
+            std::vector<uint8_t> info(32, 0);
+            le16(info, 0, width);
+            le16(info, 2, height);
+            le16(info, 4, width);
+            le16(info, 6, height);
+            read(0x81, info);
+
+            std::vector<uint8_t> strings(64, 0);
+            snprintf(reinterpret_cast<char *>(&strings[0]), 32, "Replay");
+            snprintf(reinterpret_cast<char *>(&strings[32]), 32, "ProLine Replay");
+            read(0x81, strings);
+        }
+
+        // Readout geometry returned by the expose command
+        void expose(int topHeight, int topOffset, int bottomHeight, int bottomOffset,
+                    int leftWidth, int leftOffset, int rightWidth, int rightOffset)
+        {
+            std::vector<uint8_t> reply(64, 0);
+            le16(reply, 0, topHeight);
+            le16(reply, 2, topOffset);
+            le16(reply, 4, bottomOffset);
+            le16(reply, 11, leftWidth);
+            le16(reply, 13, leftOffset);
+            le16(reply, 15, rightWidth);
+            le16(reply, 17, rightOffset);
+            le16(reply, 44, bottomHeight);
+            read(0x81, reply);
+        }
+
+        // Big endian words on the image endpoint, split in uneven transfers
+        void image(const std::vector<uint16_t> &words, size_t chunk)
+        {
+            std::vector<uint8_t> data;
+            for (uint16_t w : words)
+            {
+                data.push_back(w >> 8);
+                data.push_back(w & 0xff);
+            }
+            for (size_t i = 0; i < data.size(); i += chunk)
+                read(0x82, std::vector<uint8_t>(data.begin() + i, data.begin() + std::min(data.size(), i + chunk)));
+        }
+
+        std::string save(const char *name) const
+        {
+            std::string path = std::string(P_tmpdir) + "/" + name + "-" + std::to_string(getpid()) + ".cap";
+            FILE *f = fopen(path.c_str(), "wb");
+            fwrite(bytes.data(), 1, bytes.size(), f);
+            fclose(f);
+            return path;
+        }
+
+        int width, height;
+
+    private:
+        void put(const void *data, size_t len)
+        {
+            const uint8_t *p = static_cast<const uint8_t *>(data);
+            bytes.insert(bytes.end(), p, p + len);
+        }
+
+        void read(int ep, const std::vector<uint8_t> &data)
+        {
+            uint32_t len = data.size();
+            uint8_t header[] = { 'R', static_cast<uint8_t>(ep), static_cast<uint8_t>(len), static_cast<uint8_t>(len >> 8),
+                                 static_cast<uint8_t>(len >> 16), static_cast<uint8_t>(len >> 24) };
+            put(header, sizeof(header));
+            put(data.data(), data.size());
+        }
+
+        static void le16(std::vector<uint8_t> &buf, size_t i, int value)
+        {
+            buf[i] = value & 0xff;
+            buf[i + 1] = (value >> 8) & 0xff;
+        }
+
+        std::vector<uint8_t> bytes;
+};
+
+static std::vector<uint16_t> sequence(size_t count)
+{
+    std::vector<uint16_t> words(count);
+    for (size_t i = 0; i < count; i++)
+        words[i] = static_cast<uint16_t>(i * 2654435761u >> 9);
+    return words;
+}
+
+// Exposes the frame in the capture, grabs the first rows one at a time then the rest as a frame
+static std::vector<uint16_t> download(const std::string &path, int width, int height, int rows, long *result)
+{
+    flidev_t dev;
+    std::vector<uint16_t> image(width * height, 0);
+
+    *result = FLIOpen(&dev, const_cast<char *>(path.c_str()), FLIDOMAIN_USB | FLIDEVICE_CAMERA);
+    if (*result != 0)
+        return image;
+
+    if ((*result = FLIExposeFrame(dev)) == 0)
+    {
+        for (int i = 0; i < rows && *result == 0; i++)
+            *result = FLIGrabRow(dev, &image[i * width], width);
+
+        if (rows < height && *result == 0)
+        {
+            size_t grabbed = 0;
+            *result = FLIGrabFrame(dev, &image[rows * width], (height - rows) * width * sizeof(uint16_t), &grabbed);
+            if (*result == 0 && grabbed != (height - rows) * width * sizeof(uint16_t))
+                *result = -1;
+        }
+    }
+
+    FLIClose(dev);
+    return image;
+}
+
+TEST(FLIReplay, SingleOutputFrame)
+{
+    const int width = 300, height = 200;
+    ProLineCapture capture(width, height);
+    std::vector<uint16_t> words = sequence(width * height);
+
+    capture.expose(height, 0, 0, height, width, 0, 0, width);
+    capture.image(words, 12345);
+    std::string path = capture.save("fli-single");
+
+    long result;
+    std::vector<uint16_t> frame = download(path, width, height, 0, &result);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(frame, words);
+
+    std::vector<uint16_t> rows = download(path, width, height, height, &result);
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(rows, words);
+
+    unlink(path.c_str());
+}
+
+TEST(FLIReplay, FourOutputFrameMatchesRows)
+{
+    const int width = 64, height = 40;
+    ProLineCapture capture(width, height);
+    std::vector<uint16_t> words = sequence(width * height);
+
+    // Top and bottom halves interleaved, each row read from both ends
+    capture.expose(height / 2, 0, height / 2, 0, width / 2, 0, width / 2, 0);
+    capture.image(words, 1000);
+    std::string path = capture.save("fli-quad");
+
+    long result;
+    std::vector<uint16_t> rows = download(path, width, height, height, &result);
+    ASSERT_EQ(result, 0);
+
+    // The same pixels, reordered
+    std::vector<uint16_t> a = rows, b = words;
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    EXPECT_EQ(a, b);
+    EXPECT_NE(rows, words);
+
+    EXPECT_EQ(download(path, width, height, 0, &result), rows);
+    EXPECT_EQ(result, 0);
+
+    EXPECT_EQ(download(path, width, height, 7, &result), rows);
+    EXPECT_EQ(result, 0);
+
+    unlink(path.c_str());
+}
+
+TEST(FLIReplay, ShortCaptureFails)
+{
+    const int width = 128, height = 16;
+    ProLineCapture capture(width, height);
+    std::vector<uint16_t> words = sequence(width * (height - 2));
+
+    capture.expose(height, 0, 0, height, width, 0, 0, width);
+    capture.image(words, 4096);
+    std::string path = capture.save("fli-short");
+
+    long result;
+    download(path, width, height, 0, &result);
+    EXPECT_NE(result, 0);
+
+    unlink(path.c_str());
+}
+
+TEST(FLIReplay, SmallBufferIsRejected)
+{
+    const int width = 32, height = 8;
+    ProLineCapture capture(width, height);
+
+    capture.expose(height, 0, 0, height, width, 0, 0, width);
+    capture.image(sequence(width * height), 512);
+    std::string path = capture.save("fli-small");
+
+    flidev_t dev;
+    ASSERT_EQ(FLIOpen(&dev, const_cast<char *>(path.c_str()), FLIDOMAIN_USB | FLIDEVICE_CAMERA), 0);
+    ASSERT_EQ(FLIExposeFrame(dev), 0);
+
+    std::vector<uint16_t> image(width * height);
+    size_t grabbed = 1;
+    EXPECT_EQ(FLIGrabFrame(dev, image.data(), (image.size() - 1) * sizeof(uint16_t), &grabbed), -ENOMEM);
+    EXPECT_EQ(grabbed, 0u);
+
+    FLIClose(dev);
+    unlink(path.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -121,6 +121,7 @@
 typedef struct {
   int fd;
   void *han;
+  void *capture;
 } fli_unixio_t;
 
 typedef struct {
@@ -0,0 +1,81 @@
+/*
+    FLI USB capture
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libfli-libfli.h"
+#include "libfli-debug.h"
+#include "libfli-usb-capture.h"
+
+/* One device at a time, two devices in the same file could not be replayed */
+static FILE *capturing = NULL;
+
+static void fli_usb_capture_u16(FILE *capture, unsigned int value)
+{
+  fputc(value & 0xff, capture);
+  fputc((value >> 8) & 0xff, capture);
+}
+
+FILE *fli_usb_capture_open(unsigned short devid, unsigned short fwrev)
+{
+  const char *path = getenv(FLIUSB_CAPTURE_ENV);
+
+  if ((path == NULL) || (path[0] == '\0') || (capturing != NULL))
+    return NULL;
+
+  if ((capturing = fopen(path, "wb")) == NULL)
+  {
+    debug(FLIDEBUG_WARN, "Could not open USB capture %s", path);
+    return NULL;
+  }
+
+  debug(FLIDEBUG_INFO, "Capturing USB traffic to %s", path);
+
+  fwrite(FLIUSB_CAPTURE_MAGIC, 1, strlen(FLIUSB_CAPTURE_MAGIC), capturing);
+  fputc(FLIUSB_CAPTURE_DEVICE, capturing);
+  fli_usb_capture_u16(capturing, devid);
+  fli_usb_capture_u16(capturing, fwrev);
+
+  return capturing;
+}
+
+void fli_usb_capture_close(FILE *capture)
+{
+  if (capture == NULL)
+    return;
+
+  fclose(capture);
+  if (capture == capturing)
+    capturing = NULL;
+}
+
+void fli_usb_capture_record(FILE *capture, int type, int ep, const void *buf, long len)
+{
+  if ((capture == NULL) || (len <= 0))
+    return;
+
+  fputc(type, capture);
+  fputc(ep & 0xff, capture);
+  fli_usb_capture_u16(capture, (unsigned long) len & 0xffff);
+  fli_usb_capture_u16(capture, ((unsigned long) len >> 16) & 0xffff);
+  fwrite(buf, 1, len, capture);
+}
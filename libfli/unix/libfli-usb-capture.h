@@ -0,0 +1,52 @@
+/*
+    FLI USB capture
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+  USB captures record the traffic of one device so it can be replayed
+  without the hardware by the replay backend (unix/replay).  Capturing is
+  enabled by setting FLI_USB_CAPTURE to the path of the file to write,
+  the last device connected while no other one is being captured is
+  recorded.
+
+  The file starts with FLIUSB_CAPTURE_MAGIC, then records, all integers
+  little endian:
+
+    'D' u16 device id, u16 firmware revision
+    'W' u8 endpoint, u32 length, data written
+    'R' u8 endpoint, u32 length, data read
+*/
+
+#ifndef _LIBFLI_USB_CAPTURE_H_
+#define _LIBFLI_USB_CAPTURE_H_
+
+#include <stdio.h>
+
+#define FLIUSB_CAPTURE_MAGIC "FLIUSBCAP1"
+#define FLIUSB_CAPTURE_ENV "FLI_USB_CAPTURE"
+
+#define FLIUSB_CAPTURE_DEVICE 'D'
+#define FLIUSB_CAPTURE_WRITE 'W'
+#define FLIUSB_CAPTURE_READ 'R'
+
+FILE *fli_usb_capture_open(unsigned short devid, unsigned short fwrev);
+void fli_usb_capture_close(FILE *capture);
+void fli_usb_capture_record(FILE *capture, int type, int ep, const void *buf, long len);
+
+#endif /* _LIBFLI_USB_CAPTURE_H_ */
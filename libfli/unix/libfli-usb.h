@@ -44,7 +44,17 @@
 #ifndef _LIBFLI_USB_H_
 #define _LIBFLI_USB_H_
 
-#if defined(__linux__) && !defined(__LIBUSB__)
+#if defined(__FLI_USB_REPLAY__)
+
+#define unix_bulkwrite	replay_bulkwrite
+#define unix_bulkread	replay_bulkread
+#define unix_usb_connect replay_usb_connect
+#define unix_usb_disconnect	replay_usb_disconnect
+#define unix_bulktransfer	replay_bulktransfer
+#define unix_bulkqueue	replay_bulkqueue
+#define unix_usb_list replay_list
+
+#elif defined(__linux__) && !defined(__LIBUSB__)
 
 #define unix_bulkwrite  linux_bulkwrite
 #define unix_bulkread linux_bulkread
@@ -60,6 +70,7 @@
 #define unix_usb_connect libusb_usb_connect
 #define unix_usb_disconnect	libusb_usb_disconnect
 #define unix_bulktransfer	libusb_bulktransfer
+#define unix_bulkqueue	libusb_bulkqueue
 #define unix_usb_list libusb_list
 
 #elif defined(__FreeBSD__) || defined(__NetBSD__)
@@ -86,6 +97,7 @@
 #define unix_usb_connect libusb_usb_connect
 #define unix_usb_disconnect	libusb_usb_disconnect
 #define unix_bulktransfer	libusb_bulktransfer
+#define unix_bulkqueue	libusb_bulkqueue
 #define unix_usb_list libusb_list
 
 #else
@@ -100,6 +112,12 @@ long unix_usb_disconnect(flidev_t dev, fli_unixio_t *io);
 long unix_bulktransfer(flidev_t dev, int ep, void *buf, long *len);
 long unix_usb_list(char *pattern, flidomain_t domain,char ***names);
 
+/* Large reads with several transfers in flight, where the backend can queue them */
+#ifdef unix_bulkqueue
+long unix_bulkqueue(flidev_t dev, int ep, void *buf, long *len);
+#define usb_bulkqueue unix_bulkqueue
+#endif
+
 #if defined(__APPLE__) && !defined(__LIBUSB__)
 #define usb_bulktransfer mac_bulktransfer
 #else
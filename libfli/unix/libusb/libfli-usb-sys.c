@@ -51,10 +51,14 @@
 #include "libfli-sys.h"
 #include "libfli-mem.h"
 #include "libfli-usb.h"
+#include "libfli-usb-capture.h"
 #include "indimacros.h"
 
 #define FLIUSB_MIN_TIMEOUT (5000)
 
+/* Transfers kept in flight by libusb_bulkqueue() */
+#define FLIUSB_QUEUE_DEPTH (8)
+
 libusb_device_handle * libusb_fli_find_handle(struct libusb_context *usb_ctx, char *name);
 
 long libusb_usb_connect(flidev_t dev, fli_unixio_t *io, char *name)
@@ -170,6 +174,8 @@ long libusb_usb_connect(flidev_t dev, fli_unixio_t *io, char *name)
       return -ENODEV;
   }
 
+  io->capture = fli_usb_capture_open(DEVICE->devinfo.devid, DEVICE->devinfo.fwrev);
+
 #ifdef CLEAR_HALT
   /* Clear the halt/stall condition for all endpoints in this configuration */
   {
@@ -265,6 +271,9 @@ long libusb_bulktransfer(flidev_t dev, int ep, void *buf, long *len)
     err = -errno;
   *len -= remaining;
 
+  fli_usb_capture_record(io->capture, (ep & LIBUSB_ENDPOINT_IN) ? FLIUSB_CAPTURE_READ : FLIUSB_CAPTURE_WRITE,
+    ep, buf, *len);
+
 #ifdef _DEBUG
 
   if ((ep & 0xf0) != 0) {
@@ -284,6 +293,118 @@ long libusb_bulktransfer(flidev_t dev, int ep, void *buf, long *len)
   return err;
 }
 
+static void LIBUSB_CALL libusb_bulkqueue_done(struct libusb_transfer *transfer)
+{
+  *((int *) transfer->user_data) = 1;
+}
+
+/* Reads *len bytes with up to FLIUSB_QUEUE_DEPTH transfers in flight, so the
+ * device never waits for the next request.  The transfers complete in order,
+ * a short one ends the read and the ones behind it are cancelled. */
+long libusb_bulkqueue(flidev_t dev, int ep, void *buf, long *len)
+{
+  fli_unixio_t *io;
+  struct libusb_transfer *transfers[FLIUSB_QUEUE_DEPTH];
+  int completed[FLIUSB_QUEUE_DEPTH];
+  unsigned int timeout;
+  long submitted = 0, received = 0;
+  int head = 0, inflight = 0, stop = 0, i, r;
+  long err = 0;
+
+  io = DEVICE->io_data;
+  timeout = (DEVICE->io_timeout < FLIUSB_MIN_TIMEOUT)?FLIUSB_MIN_TIMEOUT:DEVICE->io_timeout;
+
+  memset(transfers, 0, sizeof(transfers));
+  for (i = 0; i < FLIUSB_QUEUE_DEPTH; i++)
+  {
+    if ((transfers[i] = libusb_alloc_transfer(0)) == NULL)
+    {
+      err = -ENOMEM;
+      goto done;
+    }
+  }
+
+  do
+  {
+    /* Keep the queue full */
+    while ((stop == 0) && (inflight < FLIUSB_QUEUE_DEPTH) && (submitted < *len))
+    {
+      int slot = (head + inflight) % FLIUSB_QUEUE_DEPTH;
+      int count = MIN(*len - submitted, USB_READ_SIZ_MAX);
+
+      completed[slot] = 0;
+      libusb_fill_bulk_transfer(transfers[slot], io->han, ep,
+        (unsigned char *) buf + submitted, count, libusb_bulkqueue_done, &completed[slot], timeout);
+
+      if ((r = libusb_submit_transfer(transfers[slot])) != 0)
+      {
+        debug(FLIDEBUG_WARN, "LibUSB Error: %s", libusb_error_name(r));
+        err = -EIO;
+        stop = 1;
+        break;
+      }
+
+      submitted += count;
+      inflight++;
+    }
+
+    if (inflight == 0)
+      break;
+
+    while (completed[head] == 0)
+    {
+      if ((r = libusb_handle_events_completed(NULL, &completed[head])) != 0)
+      {
+        debug(FLIDEBUG_WARN, "LibUSB Error: %s", libusb_error_name(r));
+        if (r != LIBUSB_ERROR_INTERRUPTED)
+        {
+          err = -EIO;
+          stop = 1;
+          for (i = 0; i < inflight; i++)
+            libusb_cancel_transfer(transfers[(head + i) % FLIUSB_QUEUE_DEPTH]);
+        }
+      }
+    }
+
+    if (stop == 0)
+    {
+      struct libusb_transfer *transfer = transfers[head];
+
+      if (transfer->status == LIBUSB_TRANSFER_COMPLETED)
+        received += transfer->actual_length;
+      else
+      {
+        debug(FLIDEBUG_WARN, "LibUSB transfer status: %d", transfer->status);
+        err = -EIO;
+      }
+
+      if ((transfer->status != LIBUSB_TRANSFER_COMPLETED) || (transfer->actual_length < transfer->length))
+      {
+        stop = 1;
+        for (i = 1; i < inflight; i++)
+          libusb_cancel_transfer(transfers[(head + i) % FLIUSB_QUEUE_DEPTH]);
+      }
+    }
+
+    head = (head + 1) % FLIUSB_QUEUE_DEPTH;
+    inflight--;
+  } while ((inflight > 0) || ((stop == 0) && (submitted < *len)));
+
+ done:
+
+  for (i = 0; i < FLIUSB_QUEUE_DEPTH; i++)
+  {
+    if (transfers[i] != NULL)
+      libusb_free_transfer(transfers[i]);
+  }
+
+  *len = received;
+
+  fli_usb_capture_record(io->capture, FLIUSB_CAPTURE_READ, ep, buf, received);
+
+  return err;
+}
+
 long libusb_bulkwrite(flidev_t dev, void *buf, long *wlen)
 {
   int ep;
@@ -340,6 +461,9 @@ long libusb_usb_disconnect(flidev_t dev,  fli_unixio_t *io)
 	
   debug(FLIDEBUG_INFO, "Disconnecting");
 
+  fli_usb_capture_close(io->capture);
+  io->capture = NULL;
+
   if (io->han != NULL)
   {
 		libusb_release_interface(io->han, 0);
@@ -0,0 +1,298 @@
+/*
+    FLI USB replay backend
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+  Replay backend: serves a device from a capture written with
+  FLI_USB_CAPTURE (see libfli-usb-capture.h) instead of the USB bus.  The
+  device name given to FLIOpen() is the path of the capture, FLIList()
+  returns the capture named by FLI_USB_REPLAY.
+
+  Every endpoint replays its own stream.  Reads are served from the
+  concatenated data read on that endpoint, regardless of how the reads
+  were split when capturing, so a frame captured row by row can be
+  replayed as a whole and the other way around.  Writes are compared with
+  the capture and only logged when they differ.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "libfli-libfli.h"
+#include "libfli-debug.h"
+#include "libfli-sys.h"
+#include "libfli-mem.h"
+#include "libfli-usb.h"
+#include "libfli-usb-capture.h"
+#include "indimacros.h"
+
+#define FLIUSB_REPLAY_ENV "FLI_USB_REPLAY"
+#define FLIUSB_REPLAY_ENDPOINTS (256)
+
+typedef struct {
+  int type;
+  int ep;
+  long len;
+  unsigned char *data;
+} replay_record_t;
+
+typedef struct {
+  unsigned char *file;
+  replay_record_t *records;
+  long count;
+
+  /* Next record and offset in it, per endpoint */
+  long record[FLIUSB_REPLAY_ENDPOINTS];
+  long offset[FLIUSB_REPLAY_ENDPOINTS];
+} replay_t;
+
+static unsigned long replay_u16(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static long replay_load(replay_t *replay, const char *path, unsigned short *devid, unsigned short *fwrev)
+{
+  FILE *f;
+  long size, pos, magic = strlen(FLIUSB_CAPTURE_MAGIC);
+  int device = 0;
+
+  if ((f = fopen(path, "rb")) == NULL)
+  {
+    debug(FLIDEBUG_FAIL, "Could not open USB capture %s", path);
+    return -ENODEV;
+  }
+
+  fseek(f, 0, SEEK_END);
+  size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  if ((size < magic) || ((replay->file = xmalloc(size)) == NULL) ||
+    (fread(replay->file, 1, size, f) != (size_t) size) ||
+    (memcmp(replay->file, FLIUSB_CAPTURE_MAGIC, magic) != 0))
+  {
+    debug(FLIDEBUG_FAIL, "%s is not a USB capture", path);
+    fclose(f);
+    return -ENODEV;
+  }
+  fclose(f);
+
+  /* Records are not larger than their header */
+  if ((replay->records = xcalloc(size / 6 + 1, sizeof(replay_record_t))) == NULL)
+    return -ENOMEM;
+
+  pos = magic;
+  while (pos < size)
+  {
+    const unsigned char *p = replay->file + pos;
+
+    if ((p[0] == FLIUSB_CAPTURE_DEVICE) && (pos + 5 <= size))
+    {
+      *devid = replay_u16(p + 1);
+      *fwrev = replay_u16(p + 3);
+      device = 1;
+      pos += 5;
+    }
+    else if (((p[0] == FLIUSB_CAPTURE_WRITE) || (p[0] == FLIUSB_CAPTURE_READ)) && (pos + 6 <= size))
+    {
+      replay_record_t *record = &replay->records[replay->count++];
+
+      record->type = p[0];
+      record->ep = p[1];
+      record->len = replay_u16(p + 2) | (replay_u16(p + 4) << 16);
+      record->data = replay->file + pos + 6;
+      pos += 6 + record->len;
+
+      if (pos > size)
+      {
+        debug(FLIDEBUG_WARN, "USB capture is truncated");
+        record->len -= pos - size;
+      }
+    }
+    else
+    {
+      debug(FLIDEBUG_FAIL, "Bad record at offset %ld of the USB capture", pos);
+      return -EIO;
+    }
+  }
+
+  return device ? 0 : -ENODEV;
+}
+
+static void replay_free(replay_t *replay)
+{
+  if (replay == NULL)
+    return;
+
+  if (replay->records != NULL)
+    xfree(replay->records);
+  if (replay->file != NULL)
+    xfree(replay->file);
+  xfree(replay);
+}
+
+/* Next record of a type on an endpoint, from the current one */
+static replay_record_t *replay_next(replay_t *replay, int type, int ep)
+{
+  long *i = &replay->record[ep & 0xff];
+
+  for (; *i < replay->count; (*i)++, replay->offset[ep & 0xff] = 0)
+  {
+    replay_record_t *record = &replay->records[*i];
+
+    if ((record->type == type) && (record->ep == ep) && (replay->offset[ep & 0xff] < record->len))
+      return record;
+  }
+
+  return NULL;
+}
+
+long replay_usb_connect(flidev_t dev, fli_unixio_t *io, char *name)
+{
+  replay_t *replay;
+  unsigned short devid = 0, fwrev = 0;
+  long r;
+
+  if ((replay = xcalloc(1, sizeof(replay_t))) == NULL)
+    return -ENOMEM;
+
+  if ((r = replay_load(replay, name, &devid, &fwrev)) != 0)
+  {
+    replay_free(replay);
+    return r;
+  }
+
+  switch (devid)
+  {
+    /* These are valid product IDs */
+  case FLIUSB_CAM_ID:
+  case FLIUSB_FOCUSER_ID:
+  case FLIUSB_FILTER_ID:
+  case FLIUSB_PROLINE_ID:
+    break;
+
+  default:
+    replay_free(replay);
+    return -ENODEV;
+  }
+
+  DEVICE->devinfo.devid = devid;
+  DEVICE->devinfo.fwrev = fwrev;
+
+  debug(FLIDEBUG_INFO, "Replaying %ld USB transfers from %s", replay->count, name);
+
+  io->han = replay;
+  return 0;
+}
+
+long replay_usb_disconnect(flidev_t dev, fli_unixio_t *io)
+{
+  INDI_UNUSED(dev);
+
+  replay_free(io->han);
+  io->han = NULL;
+
+  return 0;
+}
+
+long replay_bulktransfer(flidev_t dev, int ep, void *buf, long *len)
+{
+  fli_unixio_t *io = DEVICE->io_data;
+  replay_t *replay = io->han;
+  replay_record_t *record;
+  long done = 0;
+
+  if (replay == NULL)
+    return -ENODEV;
+
+  if ((ep & 0x80) == 0)
+  {
+    if ((record = replay_next(replay, FLIUSB_CAPTURE_WRITE, ep)) == NULL)
+    {
+      debug(FLIDEBUG_WARN, "Write on endpoint %02x past the end of the capture", ep);
+      return 0;
+    }
+
+    if ((record->len != *len) || (memcmp(record->data, buf, *len) != 0))
+      debug(FLIDEBUG_WARN, "Write on endpoint %02x differs from the capture", ep);
+
+    replay->record[ep]++;
+    replay->offset[ep] = 0;
+    return 0;
+  }
+
+  while ((done < *len) && ((record = replay_next(replay, FLIUSB_CAPTURE_READ, ep)) != NULL))
+  {
+    long n = MIN(*len - done, record->len - replay->offset[ep]);
+
+    memcpy((unsigned char *) buf + done, record->data + replay->offset[ep], n);
+    replay->offset[ep] += n;
+    done += n;
+  }
+
+  if (done < *len)
+  {
+    debug(FLIDEBUG_FAIL, "Read on endpoint %02x past the end of the capture", ep);
+    *len = done;
+    return -EIO;
+  }
+
+  return 0;
+}
+
+long replay_bulkqueue(flidev_t dev, int ep, void *buf, long *len)
+{
+  return replay_bulktransfer(dev, ep, buf, len);
+}
+
+long replay_bulkwrite(flidev_t dev, void *buf, long *wlen)
+{
+  return replay_bulktransfer(dev, (DEVICE->devinfo.devid == FLIUSB_PROLINE_ID) ? 0x01 : 0x02, buf, wlen);
+}
+
+long replay_bulkread(flidev_t dev, void *buf, long *rlen)
+{
+  return replay_bulktransfer(dev, (DEVICE->devinfo.devid == FLIUSB_PROLINE_ID) ? 0x81 : 0x82, buf, rlen);
+}
+
+long replay_list(char *pattern, flidomain_t domain, char ***names)
+{
+  INDI_UNUSED(pattern);
+  INDI_UNUSED(domain);
+  const char *path = getenv(FLIUSB_REPLAY_ENV);
+  char **list;
+
+  if ((list = xcalloc(2, sizeof(char *))) == NULL)
+    return -ENOMEM;
+
+  if ((path != NULL) && (path[0] != '\0'))
+  {
+    if ((list[0] = xmalloc(strlen(path) + strlen(";USB replay") + 1)) == NULL)
+    {
+      xfree(list);
+      return -ENOMEM;
+    }
+    sprintf(list[0], "%s;USB replay", path);
+  }
+
+  *names = list;
+  return 0;
+}
@@ -0,0 +1,78 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include "rawingest.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+// the older libraw uses auto_ptr
+#include <libraw.h>
+#pragma GCC diagnostic pop
+
+/**
+ * LibRaw side of the raw ingest, header only so that indipixelkernels does not link LibRaw.
+ * Only included by the drivers that already depend on it.
+ */
+namespace PixelKernels
+{
+
+/**
+ * @brief Unpack an opened LibRaw image and describe its bayered samples for ingestRaw.
+ *
+ * The samples are taken from raw_image directly, raw2image is not needed.
+ * On failure the processor is recycled.
+ * @param processor LibRaw processor after open_file() or open_buffer()
+ * @param image receives the raw_image geometry
+ * @param bayer_pattern receives the CFA pattern in reading order, e.g. "RGGB", 5 bytes
+ * @return LIBRAW_SUCCESS, the error of unpack(), or LIBRAW_FILE_UNSUPPORTED if there is no bayered raw_image
+ */
+inline int unpackLibRaw(LibRaw &processor, RawImage *image, char *bayer_pattern)
+{
+    int ret = processor.unpack();
+    if (ret == LIBRAW_SUCCESS && processor.imgdata.rawdata.raw_image == nullptr)
+        ret = LIBRAW_FILE_UNSUPPORTED;
+    if (ret != LIBRAW_SUCCESS)
+    {
+        processor.recycle();
+        return ret;
+    }
+
+    const libraw_image_sizes_t &sizes = processor.imgdata.rawdata.sizes;
+    image->data    = processor.imgdata.rawdata.raw_image;
+    image->packing = RAW_16BIT;
+    image->pitch   = sizes.raw_pitch;
+    image->width   = sizes.width;
+    image->height  = sizes.height;
+    image->left    = sizes.left_margin;
+    image->top     = sizes.top_margin;
+
+    // cdesc contains counter-clock wise e.g. RGBG CFA pattern while we want it sequential as RGGB
+    bayer_pattern[0] = processor.imgdata.idata.cdesc[processor.COLOR(0, 0)];
+    bayer_pattern[1] = processor.imgdata.idata.cdesc[processor.COLOR(0, 1)];
+    bayer_pattern[2] = processor.imgdata.idata.cdesc[processor.COLOR(1, 0)];
+    bayer_pattern[3] = processor.imgdata.idata.cdesc[processor.COLOR(1, 1)];
+    bayer_pattern[4] = '\0';
+
+    return LIBRAW_SUCCESS;
+}
+
+}
@@ -0,0 +1,618 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "pixelkernels.h"
+
+#include <atomic>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PIXELKERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXELKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace PixelKernels
+{
+
+namespace
+{
+
+struct KernelTable
+{
+    Kernel kernel;
+    void (*swapRB3)(uint8_t *data, size_t pixels);
+    void (*swapRB4)(uint8_t *data, size_t pixels);
+    void (*deinterleave3)(const uint8_t *src, uint8_t *const planes[], size_t pixels);
+    void (*deinterleave4)(const uint8_t *src, uint8_t *const planes[], size_t pixels);
+    void (*accumulate8)(const uint8_t *src, uint32_t *acc, size_t samples);
+    void (*accumulate16)(const uint16_t *src, uint64_t *acc, size_t samples);
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Scalar
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template <int N>
+void swapRBScalar(uint8_t *data, size_t pixels)
+{
+    uint8_t *end = data + pixels * N;
+    for (; data != end; data += N)
+        std::swap(data[0], data[2]);
+}
+
+template <int N>
+void deinterleaveScalar(const uint8_t *src, uint8_t *const planes[], size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++, src += N)
+        for (int c = 0; c < N; c++)
+            planes[c][i] = src[c];
+}
+
+template <typename S, typename A>
+void accumulateScalar(const S *src, A *acc, size_t samples)
+{
+    for (size_t i = 0; i < samples; i++)
+        acc[i] += src[i];
+}
+
+const KernelTable scalarTable =
+{
+    KERNEL_SCALAR,
+    swapRBScalar<3>,
+    swapRBScalar<4>,
+    deinterleaveScalar<3>,
+    deinterleaveScalar<4>,
+    accumulateScalar<uint8_t, uint32_t>,
+    accumulateScalar<uint16_t, uint64_t>
+};
+
+#ifdef PIXELKERNELS_X86
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// SSSE3 / AVX2
+///
+/// A block of N pixels-worth of 16 byte vectors is permuted with byte shuffles: every output
+/// vector is the OR of one shuffle per input vector, with lanes not taken from that input set to 0x80.
+/// AVX2 runs the same tables on two blocks at once, one per 128 bit lane.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+template <int N>
+struct ShuffleMasks
+{
+    alignas(16) uint8_t mask[N][N][16];     // [output vector][input vector][byte]
+};
+
+/** out[k] = in[source(k)] over the N * 16 bytes of a block */
+template <int N, typename Source>
+ShuffleMasks<N> makeMasks(Source source)
+{
+    ShuffleMasks<N> m;
+    for (int o = 0; o < N; o++)
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < 16; j++)
+            {
+                int from = source(o * 16 + j);
+                m.mask[o][i][j] = (from / 16 == i) ? static_cast<uint8_t>(from % 16) : 0x80;
+            }
+    return m;
+}
+
+// Swapping R and B of 3 byte pixels crosses vector boundaries, 4 byte pixels stay within a vector.
+const ShuffleMasks<3> swap3Masks = makeMasks<3>([](int k)
+{
+    return k - k % 3 + 2 - k % 3;
+});
+
+const ShuffleMasks<1> swap4Masks = makeMasks<1>([](int k)
+{
+    return (k % 4 == 1 || k % 4 == 3) ? k : k - k % 4 + 2 - k % 4;
+});
+
+// Output vector p holds byte p of 16 consecutive pixels.
+const ShuffleMasks<3> planar3Masks = makeMasks<3>([](int k)
+{
+    return (k % 16) * 3 + k / 16;
+});
+
+const ShuffleMasks<4> planar4Masks = makeMasks<4>([](int k)
+{
+    return (k % 16) * 4 + k / 16;
+});
+
+template <int V> const ShuffleMasks<V> &swapMasks();
+template <> const ShuffleMasks<3> &swapMasks<3>()
+{
+    return swap3Masks;
+}
+template <> const ShuffleMasks<1> &swapMasks<1>()
+{
+    return swap4Masks;
+}
+
+template <int N> const ShuffleMasks<N> &planarMasks();
+template <> const ShuffleMasks<3> &planarMasks<3>()
+{
+    return planar3Masks;
+}
+template <> const ShuffleMasks<4> &planarMasks<4>()
+{
+    return planar4Masks;
+}
+
+template <int N>
+__attribute__((target("ssse3")))
+inline void loadMasks(const ShuffleMasks<N> &masks, __m128i m[N][N])
+{
+    for (int o = 0; o < N; o++)
+        for (int i = 0; i < N; i++)
+            m[o][i] = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.mask[o][i]));
+}
+
+template <int N>
+__attribute__((target("ssse3")))
+inline void shuffleBlock(const __m128i in[N], __m128i out[N], const __m128i m[N][N])
+{
+    for (int o = 0; o < N; o++)
+    {
+        __m128i r = _mm_shuffle_epi8(in[0], m[o][0]);
+        for (int i = 1; i < N; i++)
+            r = _mm_or_si128(r, _mm_shuffle_epi8(in[i], m[o][i]));
+        out[o] = r;
+    }
+}
+
+template <int N, int V>
+__attribute__((target("ssse3")))
+void swapRBSSSE3(uint8_t *data, size_t pixels)
+{
+    __m128i m[V][V];
+    loadMasks<V>(swapMasks<V>(), m);
+
+    const size_t blockPixels = 16 * V / N;
+    size_t i = 0;
+    for (; i + blockPixels <= pixels; i += blockPixels, data += 16 * V)
+    {
+        __m128i in[V], out[V];
+        for (int v = 0; v < V; v++)
+            in[v] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * v));
+        shuffleBlock<V>(in, out, m);
+        for (int v = 0; v < V; v++)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + 16 * v), out[v]);
+    }
+    swapRBScalar<N>(data, pixels - i);
+}
+
+template <int N>
+__attribute__((target("ssse3")))
+void deinterleaveSSSE3(const uint8_t *src, uint8_t *const planes[], size_t pixels)
+{
+    __m128i m[N][N];
+    loadMasks<N>(planarMasks<N>(), m);
+
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16, src += 16 * N)
+    {
+        __m128i in[N], out[N];
+        for (int v = 0; v < N; v++)
+            in[v] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16 * v));
+        shuffleBlock<N>(in, out, m);
+        for (int c = 0; c < N; c++)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(planes[c] + i), out[c]);
+    }
+
+    uint8_t *tail[N];
+    for (int c = 0; c < N; c++)
+        tail[c] = planes[c] + i;
+    deinterleaveScalar<N>(src, tail, pixels - i);
+}
+
+/** Widen with zero unpacks, 16 bytes at a time into four accumulator vectors */
+__attribute__((target("ssse3")))
+void accumulate8SSSE3(const uint8_t *src, uint32_t *acc, size_t samples)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i *a = reinterpret_cast<__m128i *>(acc + i);
+        _mm_storeu_si128(a + 0, _mm_add_epi32(_mm_loadu_si128(a + 0), _mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2), _mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+    accumulateScalar(src + i, acc + i, samples - i);
+}
+
+__attribute__((target("ssse3")))
+void accumulate16SSSE3(const uint16_t *src, uint64_t *acc, size_t samples)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i lo = _mm_unpacklo_epi16(v, zero);
+        __m128i hi = _mm_unpackhi_epi16(v, zero);
+        __m128i *a = reinterpret_cast<__m128i *>(acc + i);
+        _mm_storeu_si128(a + 0, _mm_add_epi64(_mm_loadu_si128(a + 0), _mm_unpacklo_epi32(lo, zero)));
+        _mm_storeu_si128(a + 1, _mm_add_epi64(_mm_loadu_si128(a + 1), _mm_unpackhi_epi32(lo, zero)));
+        _mm_storeu_si128(a + 2, _mm_add_epi64(_mm_loadu_si128(a + 2), _mm_unpacklo_epi32(hi, zero)));
+        _mm_storeu_si128(a + 3, _mm_add_epi64(_mm_loadu_si128(a + 3), _mm_unpackhi_epi32(hi, zero)));
+    }
+    accumulateScalar(src + i, acc + i, samples - i);
+}
+
+const KernelTable ssse3Table =
+{
+    KERNEL_SSSE3,
+    swapRBSSSE3<3, 3>,
+    swapRBSSSE3<4, 1>,
+    deinterleaveSSSE3<3>,
+    deinterleaveSSSE3<4>,
+    accumulate8SSSE3,
+    accumulate16SSSE3
+};
+
+template <int N>
+__attribute__((target("avx2")))
+inline void loadMasks256(const ShuffleMasks<N> &masks, __m256i m[N][N])
+{
+    for (int o = 0; o < N; o++)
+        for (int i = 0; i < N; i++)
+            m[o][i] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(masks.mask[o][i])));
+}
+
+template <int N>
+__attribute__((target("avx2")))
+inline void shuffleBlock256(const __m256i in[N], __m256i out[N], const __m256i m[N][N])
+{
+    for (int o = 0; o < N; o++)
+    {
+        __m256i r = _mm256_shuffle_epi8(in[0], m[o][0]);
+        for (int i = 1; i < N; i++)
+            r = _mm256_or_si256(r, _mm256_shuffle_epi8(in[i], m[o][i]));
+        out[o] = r;
+    }
+}
+
+/** Load vector v of two consecutive blocks, first block in the low lane */
+__attribute__((target("avx2")))
+inline __m256i loadPair(const uint8_t *block0, const uint8_t *block1)
+{
+    return _mm256_inserti128_si256(
+               _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block0))),
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(block1)), 1);
+}
+
+template <int N, int V>
+__attribute__((target("avx2")))
+void swapRBAVX2(uint8_t *data, size_t pixels)
+{
+    __m256i m[V][V];
+    loadMasks256<V>(swapMasks<V>(), m);
+
+    const size_t blockPixels = 16 * V / N;
+    size_t i = 0;
+    for (; i + 2 * blockPixels <= pixels; i += 2 * blockPixels, data += 32 * V)
+    {
+        __m256i in[V], out[V];
+        for (int v = 0; v < V; v++)
+            in[v] = loadPair(data + 16 * v, data + 16 * (V + v));
+        shuffleBlock256<V>(in, out, m);
+        for (int v = 0; v < V; v++)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + 16 * v), _mm256_castsi256_si128(out[v]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + 16 * (V + v)), _mm256_extracti128_si256(out[v], 1));
+        }
+    }
+    swapRBSSSE3<N, V>(data, pixels - i);
+}
+
+template <int N>
+__attribute__((target("avx2")))
+void deinterleaveAVX2(const uint8_t *src, uint8_t *const planes[], size_t pixels)
+{
+    __m256i m[N][N];
+    loadMasks256<N>(planarMasks<N>(), m);
+
+    size_t i = 0;
+    for (; i + 32 <= pixels; i += 32, src += 32 * N)
+    {
+        __m256i in[N], out[N];
+        for (int v = 0; v < N; v++)
+            in[v] = loadPair(src + 16 * v, src + 16 * (N + v));
+        shuffleBlock256<N>(in, out, m);
+        for (int c = 0; c < N; c++)
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(planes[c] + i), out[c]);
+    }
+
+    uint8_t *tail[N];
+    for (int c = 0; c < N; c++)
+        tail[c] = planes[c] + i;
+    deinterleaveSSSE3<N>(src, tail, pixels - i);
+}
+
+__attribute__((target("avx2")))
+void accumulate8AVX2(const uint8_t *src, uint32_t *acc, size_t samples)
+{
+    size_t i = 0;
+    for (; i + 32 <= samples; i += 32)
+    {
+        __m256i *a = reinterpret_cast<__m256i *>(acc + i);
+        for (int k = 0; k < 4; k++)
+        {
+            __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i + 8 * k)));
+            _mm256_storeu_si256(a + k, _mm256_add_epi32(_mm256_loadu_si256(a + k), v));
+        }
+    }
+    accumulate8SSSE3(src + i, acc + i, samples - i);
+}
+
+__attribute__((target("avx2")))
+void accumulate16AVX2(const uint16_t *src, uint64_t *acc, size_t samples)
+{
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16)
+    {
+        __m256i *a = reinterpret_cast<__m256i *>(acc + i);
+        for (int k = 0; k < 4; k++)
+        {
+            __m256i v = _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i + 4 * k)));
+            _mm256_storeu_si256(a + k, _mm256_add_epi64(_mm256_loadu_si256(a + k), v));
+        }
+    }
+    accumulate16SSSE3(src + i, acc + i, samples - i);
+}
+
+const KernelTable avx2Table =
+{
+    KERNEL_AVX2,
+    swapRBAVX2<3, 3>,
+    swapRBAVX2<4, 1>,
+    deinterleaveAVX2<3>,
+    deinterleaveAVX2<4>,
+    accumulate8AVX2,
+    accumulate16AVX2
+};
+#endif
+
+#ifdef PIXELKERNELS_NEON
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// NEON, structure loads do the (de)interleaving for us
+////////////////////////////////////////////////////////////////////////////////////////////////////
+void swapRB3NEON(uint8_t *data, size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16, data += 48)
+    {
+        uint8x16x3_t v = vld3q_u8(data);
+        uint8x16_t t = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = t;
+        vst3q_u8(data, v);
+    }
+    swapRBScalar<3>(data, pixels - i);
+}
+
+void swapRB4NEON(uint8_t *data, size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16, data += 64)
+    {
+        uint8x16x4_t v = vld4q_u8(data);
+        uint8x16_t t = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = t;
+        vst4q_u8(data, v);
+    }
+    swapRBScalar<4>(data, pixels - i);
+}
+
+void deinterleave3NEON(const uint8_t *src, uint8_t *const planes[], size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16, src += 48)
+    {
+        uint8x16x3_t v = vld3q_u8(src);
+        vst1q_u8(planes[0] + i, v.val[0]);
+        vst1q_u8(planes[1] + i, v.val[1]);
+        vst1q_u8(planes[2] + i, v.val[2]);
+    }
+
+    uint8_t *tail[3] = { planes[0] + i, planes[1] + i, planes[2] + i };
+    deinterleaveScalar<3>(src, tail, pixels - i);
+}
+
+void deinterleave4NEON(const uint8_t *src, uint8_t *const planes[], size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16, src += 64)
+    {
+        uint8x16x4_t v = vld4q_u8(src);
+        vst1q_u8(planes[0] + i, v.val[0]);
+        vst1q_u8(planes[1] + i, v.val[1]);
+        vst1q_u8(planes[2] + i, v.val[2]);
+        vst1q_u8(planes[3] + i, v.val[3]);
+    }
+
+    uint8_t *tail[4] = { planes[0] + i, planes[1] + i, planes[2] + i, planes[3] + i };
+    deinterleaveScalar<4>(src, tail, pixels - i);
+}
+
+void accumulate8NEON(const uint8_t *src, uint32_t *acc, size_t samples)
+{
+    size_t i = 0;
+    for (; i + 16 <= samples; i += 16)
+    {
+        uint8x16_t v  = vld1q_u8(src + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        uint32_t *a = acc + i;
+        vst1q_u32(a + 0,  vaddw_u16(vld1q_u32(a + 0),  vget_low_u16(lo)));
+        vst1q_u32(a + 4,  vaddw_u16(vld1q_u32(a + 4),  vget_high_u16(lo)));
+        vst1q_u32(a + 8,  vaddw_u16(vld1q_u32(a + 8),  vget_low_u16(hi)));
+        vst1q_u32(a + 12, vaddw_u16(vld1q_u32(a + 12), vget_high_u16(hi)));
+    }
+    accumulateScalar(src + i, acc + i, samples - i);
+}
+
+void accumulate16NEON(const uint16_t *src, uint64_t *acc, size_t samples)
+{
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8)
+    {
+        uint16x8_t v  = vld1q_u16(src + i);
+        uint32x4_t lo = vmovl_u16(vget_low_u16(v));
+        uint32x4_t hi = vmovl_u16(vget_high_u16(v));
+        uint64_t *a = acc + i;
+        vst1q_u64(a + 0, vaddw_u32(vld1q_u64(a + 0), vget_low_u32(lo)));
+        vst1q_u64(a + 2, vaddw_u32(vld1q_u64(a + 2), vget_high_u32(lo)));
+        vst1q_u64(a + 4, vaddw_u32(vld1q_u64(a + 4), vget_low_u32(hi)));
+        vst1q_u64(a + 6, vaddw_u32(vld1q_u64(a + 6), vget_high_u32(hi)));
+    }
+    accumulateScalar(src + i, acc + i, samples - i);
+}
+
+const KernelTable neonTable =
+{
+    KERNEL_NEON,
+    swapRB3NEON,
+    swapRB4NEON,
+    deinterleave3NEON,
+    deinterleave4NEON,
+    accumulate8NEON,
+    accumulate16NEON
+};
+#endif
+
+const KernelTable *tableFor(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef PIXELKERNELS_X86
+        case KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") ? &avx2Table : nullptr;
+        case KERNEL_SSSE3:
+            return __builtin_cpu_supports("ssse3") ? &ssse3Table : nullptr;
+#endif
+#ifdef PIXELKERNELS_NEON
+        case KERNEL_NEON:
+            return &neonTable;
+#endif
+        case KERNEL_SCALAR:
+            return &scalarTable;
+        default:
+            return nullptr;
+    }
+}
+
+const KernelTable *bestTable()
+{
+    for (Kernel kernel : { KERNEL_AVX2, KERNEL_NEON, KERNEL_SSSE3 })
+    {
+        const KernelTable *table = tableFor(kernel);
+        if (table != nullptr)
+            return table;
+    }
+    return &scalarTable;
+}
+
+std::atomic<const KernelTable *> currentTable { nullptr };
+
+const KernelTable *table()
+{
+    const KernelTable *t = currentTable.load(std::memory_order_acquire);
+    if (t == nullptr)
+    {
+        t = bestTable();
+        currentTable.store(t, std::memory_order_release);
+    }
+    return t;
+}
+
+}
+
+void swapRB(uint8_t *data, size_t pixels, int channels)
+{
+    if (channels == 4)
+        table()->swapRB4(data, pixels);
+    else if (channels == 3)
+        table()->swapRB3(data, pixels);
+}
+
+void deinterleave(const uint8_t *src, uint8_t *const planes[], size_t pixels, int channels)
+{
+    if (channels == 4)
+        table()->deinterleave4(src, planes, pixels);
+    else if (channels == 3)
+        table()->deinterleave3(src, planes, pixels);
+}
+
+void accumulate(const uint8_t *src, uint32_t *acc, size_t samples)
+{
+    table()->accumulate8(src, acc, samples);
+}
+
+void accumulate(const uint16_t *src, uint64_t *acc, size_t samples)
+{
+    table()->accumulate16(src, acc, samples);
+}
+
+Kernel selected()
+{
+    return table()->kernel;
+}
+
+bool isSupported(Kernel kernel)
+{
+    return tableFor(kernel) != nullptr;
+}
+
+bool select(Kernel kernel)
+{
+    const KernelTable *t = tableFor(kernel);
+    if (t == nullptr)
+        return false;
+
+    currentTable.store(t, std::memory_order_release);
+    return true;
+}
+
+const char *toString(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case KERNEL_SSSE3:
+            return "SSSE3";
+        case KERNEL_AVX2:
+            return "AVX2";
+        case KERNEL_NEON:
+            return "NEON";
+        default:
+            return "Scalar";
+    }
+}
+
+}
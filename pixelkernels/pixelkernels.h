@@ -0,0 +1,82 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Colour frame helpers shared by the camera drivers.
+ *
+ * The fastest implementation supported by the running CPU is picked on first use:
+ * AVX2 or SSSE3 on x86, NEON on ARM, plain C++ otherwise.
+ */
+namespace PixelKernels
+{
+
+enum Kernel
+{
+    KERNEL_SCALAR,
+    KERNEL_SSSE3,
+    KERNEL_AVX2,
+    KERNEL_NEON
+};
+
+/**
+ * @brief Swap the first and third byte of every pixel in place (BGR24 <-> RGB24, BGRA32 <-> RGBA32).
+ * @param data interleaved pixels
+ * @param pixels number of pixels
+ * @param channels 3 or 4 bytes per pixel
+ */
+void swapRB(uint8_t *data, size_t pixels, int channels);
+
+/**
+ * @brief Split 8-bit interleaved pixels into separate planes.
+ * @param src interleaved pixels
+ * @param planes destination plane for each source byte of a pixel, e.g. {B, G, R} for BGR24 input
+ * @param pixels number of pixels
+ * @param channels 3 or 4 bytes per pixel, planes must hold as many pointers
+ */
+void deinterleave(const uint8_t *src, uint8_t *const planes[], size_t pixels, int channels);
+
+/**
+ * @brief Add 8-bit samples to 32-bit accumulators, acc[i] += src[i].
+ * @param src samples
+ * @param acc accumulators, one per sample
+ * @param samples number of samples
+ */
+void accumulate(const uint8_t *src, uint32_t *acc, size_t samples);
+
+/** @brief Add 16-bit samples to 64-bit accumulators, acc[i] += src[i]. */
+void accumulate(const uint16_t *src, uint64_t *acc, size_t samples);
+
+/** @return the kernel set currently in use */
+Kernel selected();
+
+/** @return true if the kernel set can run on this CPU */
+bool isSupported(Kernel kernel);
+
+/** @brief Force a kernel set, mainly for benchmarks and tests. Returns false if unsupported. */
+bool select(Kernel kernel);
+
+const char *toString(Kernel kernel);
+
+}
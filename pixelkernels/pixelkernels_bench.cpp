@@ -0,0 +1,105 @@
+/*
+    Pixel Kernels benchmark
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+    Times every supported kernel set on a synthetic colour frame:
+
+        pixelkernels_bench [megapixels] [iterations]
+*/
+
+#include "pixelkernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace PixelKernels;
+
+static double run(const char *name, int iterations, size_t bytes, void (*kernel)(void *), void *context)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        kernel(context);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double ms = seconds * 1000.0 / iterations;
+    printf("  %-16s %8.2f ms/frame %10.1f MB/s\n", name, ms, bytes * iterations / seconds / 1e6);
+    return ms;
+}
+
+struct Frame
+{
+    std::vector<uint8_t> interleaved;
+    std::vector<uint8_t> planar;
+    size_t pixels;
+    int channels;
+};
+
+int main(int argc, char *argv[])
+{
+    double megapixels = argc > 1 ? atof(argv[1]) : 26.0;
+    int iterations    = argc > 2 ? atoi(argv[2]) : 20;
+
+    if (megapixels <= 0 || iterations <= 0)
+    {
+        fprintf(stderr, "Usage: %s [megapixels] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    Frame frame;
+    frame.pixels = static_cast<size_t>(megapixels * 1e6);
+
+    for (int channels : { 3, 4 })
+    {
+        frame.channels = channels;
+        frame.interleaved.resize(frame.pixels * channels);
+        frame.planar.resize(frame.pixels * channels);
+        for (size_t i = 0; i < frame.interleaved.size(); i++)
+            frame.interleaved[i] = static_cast<uint8_t>(i * 7);
+
+        printf("%.1f MP, %d channels\n", megapixels, channels);
+
+        for (Kernel kernel : { KERNEL_SCALAR, KERNEL_SSSE3, KERNEL_AVX2, KERNEL_NEON })
+        {
+            if (!select(kernel))
+                continue;
+
+            printf(" %s\n", toString(kernel));
+
+            run("swapRB", iterations, frame.interleaved.size(), [](void *context)
+            {
+                Frame *f = static_cast<Frame *>(context);
+                swapRB(f->interleaved.data(), f->pixels, f->channels);
+            }, &frame);
+
+            run("deinterleave", iterations, frame.interleaved.size(), [](void *context)
+            {
+                Frame *f = static_cast<Frame *>(context);
+                uint8_t *planes[4];
+                for (int c = 0; c < f->channels; c++)
+                    planes[c] = f->planar.data() + c * f->pixels;
+                deinterleave(f->interleaved.data(), planes, f->pixels, f->channels);
+            }, &frame);
+        }
+    }
+
+    return 0;
+}
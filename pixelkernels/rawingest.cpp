@@ -0,0 +1,130 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "rawingest.h"
+#include "workerpool.h"
+
+#include <cstring>
+
+namespace PixelKernels
+{
+
+// Unpack a row of CSI-2 packed samples starting at sample x
+static void unpackCSI2_10(const uint8_t *row, int x, int width, uint16_t *out, int shift)
+{
+    for (int i = 0; i < width; i++, x++)
+    {
+        const uint8_t *group = row + (x / 4) * 5;
+        int n = x % 4;
+        out[i] = static_cast<uint16_t>(((group[n] << 2) | ((group[4] >> (2 * n)) & 0x03)) << shift);
+    }
+}
+
+static void unpackCSI2_12(const uint8_t *row, int x, int width, uint16_t *out, int shift)
+{
+    for (int i = 0; i < width; i++, x++)
+    {
+        const uint8_t *group = row + (x / 2) * 3;
+        int n = x % 2;
+        out[i] = static_cast<uint16_t>(((group[n] << 4) | ((group[2] >> (4 * n)) & 0x0F)) << shift);
+    }
+}
+
+static void copyRows(const RawImage &image, const RawWindow &window, uint16_t *dst, int shift, int from, int to)
+{
+    const uint8_t *base = static_cast<const uint8_t *>(image.data);
+    const size_t rowBytes = window.width * sizeof(uint16_t);
+    const int x = image.left + window.x;
+
+    for (int row = from; row < to; row++)
+    {
+        const uint8_t *line = base + (image.top + window.y + row) * image.pitch;
+        uint16_t *out = dst + static_cast<size_t>(row) * window.width;
+
+        switch (image.packing)
+        {
+            case RAW_CSI2_10:
+                unpackCSI2_10(line, x, window.width, out, shift);
+                break;
+
+            case RAW_CSI2_12:
+                unpackCSI2_12(line, x, window.width, out, shift);
+                break;
+
+            case RAW_16BIT:
+            {
+                const uint16_t *src = reinterpret_cast<const uint16_t *>(line) + x;
+                if (shift == 0)
+                    memcpy(out, src, rowBytes);
+                else
+                {
+                    for (int i = 0; i < window.width; i++)
+                        out[i] = static_cast<uint16_t>(src[i] << shift);
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool ingestRaw(const RawImage &image, const RawWindow &window, uint16_t *dst, int shift, unsigned threads)
+{
+    if (image.data == nullptr || dst == nullptr || shift < 0 || shift > 15)
+        return false;
+
+    if (window.x < 0 || window.y < 0 || window.width <= 0 || window.height <= 0 ||
+            window.x + window.width > image.width || window.y + window.height > image.height)
+        return false;
+
+    // Contiguous bands of rows on the shared pool
+    WorkerPool::shared().parallelFor(window.height, window.width * sizeof(uint16_t), 1, [&](size_t from, size_t to)
+    {
+        copyRows(image, window, dst, shift, static_cast<int>(from), static_cast<int>(to));
+    }, threads);
+
+    return true;
+}
+
+bool ingestRaw(const RawImage &image, uint16_t *dst, int shift, unsigned threads)
+{
+    RawWindow window;
+    window.width = image.width;
+    window.height = image.height;
+    return ingestRaw(image, window, dst, shift, threads);
+}
+
+RawWindow fitRawWindow(const RawImage &image, RawWindow *crop)
+{
+    RawWindow window;
+    window.width  = image.width;
+    window.height = image.height;
+    if (crop == nullptr)
+        return window;
+
+    // Only crop when the window fits, the caller then gets the full frame
+    if (crop->x >= 0 && crop->y >= 0 && crop->width > 0 && crop->height > 0 &&
+            crop->x + crop->width <= image.width && crop->y + crop->height <= image.height)
+        window = *crop;
+    else
+        crop->width = crop->height = 0;
+    return window;
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Raw sensor ingest shared by the DSLR style drivers (gphoto, libcamera).
+ *
+ * The drivers let LibRaw unpack the file, then copy the bayered samples out of
+ * LibRaw's raw_image straight into the INDI frame buffer with these helpers.
+ * LibRaw itself stays a dependency of the drivers only, its side is in librawingest.h.
+ */
+namespace PixelKernels
+{
+
+/** How the samples of a raw image are stored in memory. */
+enum RawPacking
+{
+    RAW_16BIT,              // one little endian uint16_t per sample, as LibRaw or unpacked sensor formats
+    RAW_CSI2_10,            // MIPI CSI-2 packed 10 bit: 4 samples in 5 bytes, low bits in the last byte
+    RAW_CSI2_12             // MIPI CSI-2 packed 12 bit: 2 samples in 3 bytes, low bits in the last byte
+};
+
+/** A raw image as unpacked by LibRaw, or as delivered by the sensor, including the masked borders. */
+struct RawImage
+{
+    const void *data {nullptr};
+    RawPacking packing {RAW_16BIT};
+    size_t pitch {0};       // bytes from one row to the next, rawdata.sizes.raw_pitch or the stream stride
+    int width {0};          // visible area, rawdata.sizes.width / height
+    int height {0};
+    int left {0};           // first visible column and row, sizes.left_margin / top_margin
+    int top {0};
+};
+
+/** A rectangle in visible image coordinates. */
+struct RawWindow
+{
+    int x {0};
+    int y {0};
+    int width {0};
+    int height {0};
+};
+
+/**
+ * @brief Copy a window of the visible area into a 16 bit frame, unpacking CSI-2 packed samples.
+ * @param image raw image
+ * @param window area to copy, in visible image coordinates
+ * @param dst destination, window.width * window.height samples
+ * @param shift left shift applied to every sample, e.g. 2 to scale 14 bit data to 16 bits, 0 to copy as is
+ * @param threads number of threads to split the rows across, 0 picks one per core
+ * @return false if the window does not fit in the visible area
+ */
+bool ingestRaw(const RawImage &image, const RawWindow &window, uint16_t *dst, int shift = 0, unsigned threads = 0);
+
+/** @brief Copy the whole visible area, see ingestRaw above. */
+bool ingestRaw(const RawImage &image, uint16_t *dst, int shift = 0, unsigned threads = 0);
+
+/**
+ * @brief The window to copy for a requested crop.
+ * @param image raw image
+ * @param crop requested window, nullptr for the whole visible area. Set to an empty window if it does not fit.
+ * @return crop if it fits in the visible area, the whole visible area otherwise
+ */
+RawWindow fitRawWindow(const RawImage &image, RawWindow *crop);
+
+}
@@ -0,0 +1,101 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "stagingbuffer.h"
+
+#include <sys/mman.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+namespace PixelKernels
+{
+
+// Below this size huge pages are not worth it
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+StagingBuffer::~StagingBuffer()
+{
+    release();
+}
+
+uint8_t *StagingBuffer::get(size_t size)
+{
+    if (mData != nullptr && size <= mStats.capacity && size >= mStats.capacity / 2)
+    {
+        mStats.reuses++;
+        return mData;
+    }
+
+    release();
+
+    if (size == 0)
+        return nullptr;
+
+    void *data = MAP_FAILED;
+    bool hugePages = false;
+
+#ifdef MAP_HUGETLB
+    // Explicit huge pages, only succeeds if the administrator reserved some (vm.nr_hugepages)
+    if (size >= HUGE_PAGE_SIZE)
+    {
+        mMappedSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        data = mmap(nullptr, mMappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugePages = (data != MAP_FAILED);
+    }
+#endif
+
+    if (data == MAP_FAILED)
+    {
+        mMappedSize = size;
+        data = mmap(nullptr, mMappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+        {
+            mMappedSize = 0;
+            return nullptr;
+        }
+
+#ifdef MADV_HUGEPAGE
+        // Transparent huge pages, if enabled in madvise mode
+        if (size >= HUGE_PAGE_SIZE)
+            hugePages = (madvise(data, mMappedSize, MADV_HUGEPAGE) == 0);
+#endif
+    }
+
+    mData = static_cast<uint8_t *>(data);
+    mStats.capacity = size;
+    mStats.hugePages = hugePages;
+    mStats.allocations++;
+    return mData;
+}
+
+void StagingBuffer::release()
+{
+    if (mData != nullptr)
+        munmap(mData, mMappedSize);
+
+    mData = nullptr;
+    mMappedSize = 0;
+    mStats.capacity = 0;
+    mStats.hugePages = false;
+}
+
+}
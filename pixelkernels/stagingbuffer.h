@@ -0,0 +1,71 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PixelKernels
+{
+
+/**
+ * @brief The StagingBuffer class keeps a frame sized scratch buffer alive across exposures.
+ *
+ * The memory is only reallocated when the requested size grows, or shrinks to less than half
+ * of the current capacity, i.e. when the ROI, binning or format changes. Large buffers are
+ * backed by huge pages when the system has them reserved, transparent huge pages otherwise.
+ */
+class StagingBuffer
+{
+    public:
+        struct Stats
+        {
+            uint64_t allocations {0};
+            uint64_t reuses {0};
+            size_t capacity {0};
+            bool hugePages {false};
+        };
+
+    public:
+        StagingBuffer() = default;
+        ~StagingBuffer();
+
+        StagingBuffer(const StagingBuffer &) = delete;
+        StagingBuffer &operator=(const StagingBuffer &) = delete;
+
+        /** @return a buffer of at least size bytes, or nullptr if the allocation failed */
+        uint8_t *get(size_t size);
+
+        /** Give the memory back to the system */
+        void release();
+
+        const Stats &stats() const
+        {
+            return mStats;
+        }
+
+    private:
+        uint8_t *mData {nullptr};
+        size_t mMappedSize {0};
+        Stats mStats;
+};
+
+}
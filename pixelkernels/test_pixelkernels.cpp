@@ -0,0 +1,308 @@
+/*
+    Pixel Kernels tests
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "pixelkernels.h"
+#include "rawingest.h"
+#include "stagingbuffer.h"
+#include "workerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+using namespace PixelKernels;
+
+static const Kernel kernels[] = { KERNEL_SCALAR, KERNEL_SSSE3, KERNEL_AVX2, KERNEL_NEON };
+
+// Odd sizes make sure the scalar tail after the vector loop is exercised
+static const size_t sizes[] = { 0, 1, 15, 16, 17, 31, 32, 33, 100, 1027 };
+
+static std::vector<uint8_t> pattern(size_t bytes)
+{
+    std::vector<uint8_t> data(bytes);
+    for (size_t i = 0; i < bytes; i++)
+        data[i] = static_cast<uint8_t>(i * 13 + 5);
+    return data;
+}
+
+TEST(PixelKernels, SwapRB)
+{
+    for (Kernel kernel : kernels)
+    {
+        if (!select(kernel))
+            continue;
+
+        for (int channels : { 3, 4 })
+            for (size_t pixels : sizes)
+            {
+                std::vector<uint8_t> source = pattern(pixels * channels);
+                std::vector<uint8_t> data = source;
+                swapRB(data.data(), pixels, channels);
+
+                for (size_t i = 0; i < pixels; i++)
+                    for (int c = 0; c < channels; c++)
+                    {
+                        int from = (c == 0) ? 2 : (c == 2) ? 0 : c;
+                        ASSERT_EQ(data[i * channels + c], source[i * channels + from])
+                                << toString(kernel) << " channels " << channels << " pixels " << pixels << " at " << i;
+                    }
+            }
+    }
+}
+
+TEST(PixelKernels, Deinterleave)
+{
+    for (Kernel kernel : kernels)
+    {
+        if (!select(kernel))
+            continue;
+
+        for (int channels : { 3, 4 })
+            for (size_t pixels : sizes)
+            {
+                std::vector<uint8_t> source = pattern(pixels * channels);
+                std::vector<uint8_t> planar(pixels * channels + 1, 0xAA);
+                uint8_t *planes[4];
+                // Reverse plane order, as the drivers do for BGR input
+                for (int c = 0; c < channels; c++)
+                    planes[c] = planar.data() + (channels - 1 - c) * pixels;
+
+                deinterleave(source.data(), planes, pixels, channels);
+
+                for (size_t i = 0; i < pixels; i++)
+                    for (int c = 0; c < channels; c++)
+                        ASSERT_EQ(planes[c][i], source[i * channels + c])
+                                << toString(kernel) << " channels " << channels << " pixels " << pixels << " at " << i;
+
+                // Nothing written past the last plane
+                ASSERT_EQ(planar.back(), 0xAA);
+            }
+    }
+}
+
+TEST(PixelKernels, Accumulate)
+{
+    for (Kernel kernel : kernels)
+    {
+        if (!select(kernel))
+            continue;
+
+        for (size_t samples : sizes)
+        {
+            std::vector<uint8_t> source = pattern(samples * 2);
+            std::vector<uint32_t> acc8(samples + 1, 1000);
+            std::vector<uint64_t> acc16(samples + 1, 1ULL << 40);
+            const uint16_t *source16 = reinterpret_cast<const uint16_t *>(source.data());
+
+            accumulate(source.data(), acc8.data(), samples);
+            accumulate(source.data(), acc8.data(), samples);
+            accumulate(source16, acc16.data(), samples);
+
+            for (size_t i = 0; i < samples; i++)
+            {
+                ASSERT_EQ(acc8[i], 1000U + 2 * source[i]) << toString(kernel) << " samples " << samples << " at " << i;
+                ASSERT_EQ(acc16[i], (1ULL << 40) + source16[i]) << toString(kernel) << " samples " << samples << " at " << i;
+            }
+
+            // Nothing written past the last accumulator
+            ASSERT_EQ(acc8.back(), 1000U);
+            ASSERT_EQ(acc16.back(), 1ULL << 40);
+        }
+    }
+}
+
+TEST(PixelKernels, StagingBufferReuse)
+{
+    StagingBuffer buffer;
+
+    uint8_t *data = buffer.get(6 * 1024 * 1024);
+    ASSERT_NE(data, nullptr);
+    data[6 * 1024 * 1024 - 1] = 1;
+
+    // Same or slightly smaller frames reuse the allocation
+    EXPECT_EQ(buffer.get(6 * 1024 * 1024), data);
+    EXPECT_EQ(buffer.get(4 * 1024 * 1024), data);
+    EXPECT_EQ(buffer.stats().allocations, 1U);
+    EXPECT_EQ(buffer.stats().reuses, 2U);
+
+    // Larger frame, or much smaller ROI, reallocates
+    ASSERT_NE(buffer.get(8 * 1024 * 1024), nullptr);
+    ASSERT_NE(buffer.get(1024), nullptr);
+    EXPECT_EQ(buffer.stats().allocations, 3U);
+    EXPECT_EQ(buffer.stats().capacity, 1024U);
+
+    buffer.release();
+    EXPECT_EQ(buffer.stats().capacity, 0U);
+}
+
+TEST(PixelKernels, IngestRaw)
+{
+    // Padded rows and masked borders like LibRaw raw_image; large enough to be split across threads
+    const int rawWidth = 1210, rawHeight = 1810, pitch = 1216 * 2;
+    std::vector<uint16_t> raw(pitch / 2 * rawHeight);
+    for (size_t i = 0; i < raw.size(); i++)
+        raw[i] = static_cast<uint16_t>(i * 7 & 0x3FFF);
+
+    RawImage image;
+    image.data = raw.data();
+    image.pitch = pitch;
+    image.left = 6;
+    image.top = 8;
+    image.width = rawWidth - 10;
+    image.height = rawHeight - 10;
+
+    RawWindow window;
+    window.x = 101;
+    window.y = 33;
+    window.width = 1001;
+    window.height = 1700;
+
+    for (unsigned threads : { 1U, 3U })
+        for (int shift : { 0, 2 })
+        {
+            std::vector<uint16_t> out(window.width * window.height + 1, 0xAAAA);
+            ASSERT_TRUE(ingestRaw(image, window, out.data(), shift, threads));
+
+            for (int y = 0; y < window.height; y++)
+                for (int x = 0; x < window.width; x++)
+                {
+                    uint16_t expected = raw[(image.top + window.y + y) * pitch / 2 + image.left + window.x + x] << shift;
+                    ASSERT_EQ(out[y * window.width + x], expected) << "threads " << threads << " at " << x << "," << y;
+                }
+
+            // Nothing written past the window
+            ASSERT_EQ(out.back(), 0xAAAA);
+        }
+
+    // Window outside of the visible area
+    std::vector<uint16_t> out(image.width * image.height);
+    window.x = image.width - window.width + 1;
+    EXPECT_FALSE(ingestRaw(image, window, out.data()));
+    EXPECT_TRUE(ingestRaw(image, out.data()));
+    EXPECT_EQ(out[0], raw[image.top * pitch / 2 + image.left]);
+
+    // A crop that does not fit falls back to the whole visible area and is cleared
+    RawWindow crop = window;
+    RawWindow fitted = fitRawWindow(image, &crop);
+    EXPECT_EQ(fitted.width, image.width);
+    EXPECT_EQ(fitted.height, image.height);
+    EXPECT_EQ(crop.width, 0);
+
+    crop.x = 2;
+    crop.y = 1;
+    crop.width = image.width - 2;
+    crop.height = 3;
+    fitted = fitRawWindow(image, &crop);
+    EXPECT_EQ(fitted.x, 2);
+    EXPECT_EQ(fitted.width, image.width - 2);
+    EXPECT_EQ(crop.width, image.width - 2);
+
+    fitted = fitRawWindow(image, nullptr);
+    EXPECT_EQ(fitted.x, 0);
+    EXPECT_EQ(fitted.width, image.width);
+}
+
+TEST(PixelKernels, IngestPackedRaw)
+{
+    // 10 and 12 bit CSI-2 rows with stride padding, unpacked from an odd column
+    const int width = 24, height = 5, stride = 40;
+    std::vector<uint16_t> expected(width * height);
+    for (size_t i = 0; i < expected.size(); i++)
+        expected[i] = static_cast<uint16_t>(i * 37 + 11);
+
+    for (int bits : { 10, 12 })
+    {
+        std::vector<uint8_t> packed(stride * height, 0);
+        for (int y = 0; y < height; y++)
+        {
+            uint8_t *row = packed.data() + y * stride;
+            for (int x = 0; x < width; x++)
+            {
+                uint16_t value = expected[y * width + x] & ((1 << bits) - 1);
+                if (bits == 10)
+                {
+                    row[(x / 4) * 5 + x % 4] = value >> 2;
+                    row[(x / 4) * 5 + 4] |= (value & 0x03) << (2 * (x % 4));
+                }
+                else
+                {
+                    row[(x / 2) * 3 + x % 2] = value >> 4;
+                    row[(x / 2) * 3 + 2] |= (value & 0x0F) << (4 * (x % 2));
+                }
+            }
+        }
+
+        RawImage image;
+        image.data = packed.data();
+        image.packing = (bits == 10) ? RAW_CSI2_10 : RAW_CSI2_12;
+        image.pitch = stride;
+        image.width = width;
+        image.height = height;
+
+        RawWindow window;
+        window.x = 3;
+        window.y = 1;
+        window.width = 17;
+        window.height = 3;
+
+        std::vector<uint16_t> out(window.width * window.height);
+        ASSERT_TRUE(ingestRaw(image, window, out.data()));
+
+        for (int y = 0; y < window.height; y++)
+            for (int x = 0; x < window.width; x++)
+                ASSERT_EQ(out[y * window.width + x], expected[(window.y + y) * width + window.x + x] & ((1 << bits) - 1))
+                        << bits << " bits at " << x << "," << y;
+    }
+}
+
+TEST(PixelKernels, WorkerPool)
+{
+    WorkerPool pool(4);
+    EXPECT_EQ(pool.threads(), 4U);
+
+    // Every item is visited once, blocks start aligned, and the pool is reused across calls
+    for (size_t count : { size_t(0), size_t(1), size_t(1000), size_t(1024 * 1024 + 3) })
+    {
+        for (int call = 0; call < 3; call++)
+        {
+            std::vector<std::atomic<int>> visits(count);
+            std::atomic<bool> aligned {true};
+            pool.parallelFor(count, 1, 64, [&](size_t from, size_t to)
+            {
+                if (from % 64 != 0)
+                    aligned = false;
+                for (size_t i = from; i < to; i++)
+                    visits[i]++;
+            });
+
+            EXPECT_TRUE(aligned);
+            for (size_t i = 0; i < count; i++)
+                ASSERT_EQ(visits[i], 1) << "item " << i << " of " << count;
+        }
+    }
+
+    // A thread limit of 1 runs on the calling thread
+    std::thread::id caller = std::this_thread::get_id();
+    pool.parallelFor(1024 * 1024, 1, 1, [&](size_t, size_t)
+    {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+    }, 1);
+}
@@ -0,0 +1,147 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "workerpool.h"
+
+#include <algorithm>
+
+namespace PixelKernels
+{
+
+WorkerPool::WorkerPool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    threads = std::max(1U, std::min(threads, MAX_THREADS));
+
+    m_Workers.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; i++)
+        m_Workers.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_all();
+
+    for (auto &worker : m_Workers)
+        worker.join();
+}
+
+WorkerPool &WorkerPool::shared()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+void WorkerPool::runBlocks()
+{
+    size_t index;
+    while ((index = m_Next.fetch_add(1)) < m_Blocks)
+    {
+        size_t from = index * m_Block;
+        (*m_Fn)(from, std::min(from + m_Block, m_Count));
+
+        if (m_Done.fetch_add(1) + 1 == m_Blocks)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Finished.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_Wake.wait(lock, [&]
+        {
+            return m_Stop || m_Generation != seen;
+        });
+        if (m_Stop)
+            return;
+
+        seen = m_Generation;
+        // Woken too late, the call is already over
+        if (m_Fn == nullptr)
+            continue;
+
+        m_Active++;
+        lock.unlock();
+        runBlocks();
+        lock.lock();
+        if (--m_Active == 0)
+            m_Finished.notify_all();
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, size_t itemBytes, size_t align,
+                             const std::function<void(size_t, size_t)> &fn, unsigned maxThreads)
+{
+    if (count == 0)
+        return;
+
+    unsigned threads = this->threads();
+    if (maxThreads > 0)
+        threads = std::min(threads, maxThreads);
+    if (count * itemBytes < PARALLEL_MIN_BYTES)
+        threads = 1;
+
+    align = std::max<size_t>(align, 1);
+    size_t block = (count / threads + align - 1) / align * align;
+    block = std::max(block, align);
+    size_t blocks = (count + block - 1) / block;
+
+    if (threads == 1 || blocks == 1)
+    {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> call(m_CallMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Fn     = &fn;
+        m_Count  = count;
+        m_Block  = block;
+        m_Blocks = blocks;
+        m_Next   = 0;
+        m_Done   = 0;
+        m_Generation++;
+    }
+    m_Wake.notify_all();
+
+    // The calling thread works too, then waits for the blocks still running on the pool
+    runBlocks();
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Finished.wait(lock, [this]
+    {
+        return m_Done == m_Blocks && m_Active == 0;
+    });
+    m_Fn = nullptr;
+}
+
+}
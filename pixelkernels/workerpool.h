@@ -0,0 +1,103 @@
+/*
+    Pixel Kernels
+
+    Copyright (C) 2026 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PixelKernels
+{
+
+/**
+ * @brief The WorkerPool class splits per frame loops across threads started once.
+ *
+ * The threads wait for work between calls, so a frame can be split at video rates without
+ * paying for thread creation every time. The calling thread takes part in the work and
+ * parallelFor() returns when all blocks are done. Calls from different threads are run
+ * one after the other.
+ */
+class WorkerPool
+{
+    public:
+        /** Work smaller than this is done on the calling thread alone */
+        static constexpr size_t PARALLEL_MIN_BYTES = 256 * 1024;
+        static constexpr unsigned MAX_THREADS = 8;
+
+    public:
+        /** @param threads threads taking part, the caller included. 0 picks one per core, up to MAX_THREADS. */
+        explicit WorkerPool(unsigned threads = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        /** Pool shared by the drivers of the process, started on first use */
+        static WorkerPool &shared();
+
+        /** Threads taking part in a call, the caller included */
+        unsigned threads() const
+        {
+            return static_cast<unsigned>(m_Workers.size()) + 1;
+        }
+
+        /**
+         * @brief Call fn(from, to) over contiguous blocks covering [0, count).
+         * @param count number of items, e.g. samples or rows
+         * @param itemBytes bytes per item, only used to skip the threads for small work
+         * @param align blocks start at multiples of this many items, so vector loops have no tails in between
+         * @param fn called on the pool threads and the calling thread, once per block
+         * @param maxThreads at most this many threads, 0 for all of them
+         */
+        void parallelFor(size_t count, size_t itemBytes, size_t align, const std::function<void(size_t, size_t)> &fn,
+                         unsigned maxThreads = 0);
+
+    private:
+        void workerLoop();
+        void runBlocks();
+
+        std::vector<std::thread> m_Workers;
+
+        // One parallelFor at a time
+        std::mutex m_CallMutex;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Wake;
+        std::condition_variable m_Finished;
+        uint64_t m_Generation {0};
+        unsigned m_Active {0};
+        bool m_Stop {false};
+
+        // Current call, set under m_Mutex before the workers are woken
+        const std::function<void(size_t, size_t)> *m_Fn {nullptr};
+        size_t m_Count {0};
+        size_t m_Block {0};
+        size_t m_Blocks {0};
+        std::atomic<size_t> m_Next {0};
+        std::atomic<size_t> m_Done {0};
+};
+
+}